@@ -8,7 +8,15 @@
 #include "EcDemoParms.h"
 #include "EcLogging.h"
 #include "EcOs.h"
+#include "motrotech.h"
 #include <thread>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 //[2026-01-16] 目的：不再用 EcLogMsg/EcDemoLogMsg使用BasicService的日志系统，而是使用tinylog
 #include <cstdarg>
 #include <cstdio>
@@ -24,6 +32,8 @@ BasicService::~BasicService()
 }
 
 // [2026-01-16] 目的：将 EC-Master 的日志回调映射到 tiny_framework 日志系统
+// [2026-10-16] 说明：启用 deferred_log 时只在延迟日志的格式化线程里调用（消息已格式化，fmt 为 "%s"），
+// 周期线程不再在这里做 vsnprintf / 写 tinylog
 static EC_T_DWORD EC_FNCALL EcMasterLogToTiny(struct _EC_T_LOG_CONTEXT*, EC_T_DWORD, const EC_T_CHAR* fmt, ...)
 {
     char buf[1024];
@@ -37,91 +47,663 @@ static EC_T_DWORD EC_FNCALL EcMasterLogToTiny(struct _EC_T_LOG_CONTEXT*, EC_T_DW
     return EC_E_NOERROR;
 }
 
-// [2026-01-16] 目的：在 BasicService 内启动 EC-Master demo（快速验证方案）
-// 说明：通过构造 demo 的命令行参数（网卡/ENI/周期/时长）复用原有 demo 逻辑
-static bool StartEcMasterDemo(const YAML::Node& busi_config)
+
+// [2026-10-16] 目的：多实例（一个进程驱动多个 EtherCAT 网段，各自一个 dwInstanceId / 网卡 / 定时任务 / 轴表），
+// 说明：每个实例一套 motrotech 上下文、周期计时追踪、抓包，进程级静态持有，demo 线程退出后统计仍可读取，
+// 定时发布和 CmdThread 的 trace 命令都可以安全访问；实例表在 demo 线程启动前建好，之后不再增删
+struct EcDemoInstance
 {
-    // [2026-01-16] 目的：没有配置时跳过 demo 启动，保证框架可空跑
-    if (!busi_config["ethercat_demo"])
+    EC_T_DWORD id = 0;
+    std::string tag;                    // 日志前缀，单实例时为空（与原输出一致）
+    T_MT_CONTEXT mt;
+    CEcCycleTrace cycle_trace;
+    CEcPcapMmapRecorder pcap_mmap;      // 内存映射分段抓包（pcap_capture），由 EcDemoApp 在主站实例创建后启动/停止
+    bool process_data_shm = false;      // 过程数据共享内存是否启用（启用时随 cycle_trace 发布控制器命令计数）
+    std::thread thread;
+
+    explicit EcDemoInstance(EC_T_DWORD instance_id)
+      : id(instance_id)
     {
-        LOG_I(BasicService) << "ethercat_demo not configured, skip demo start";
-        return true;
+        MT_ContextCreate(&mt, id);
     }
+    ~EcDemoInstance()
+    {
+        MT_ContextDelete(&mt);
+    }
+};
+static std::vector<std::unique_ptr<EcDemoInstance>> s_instances;
 
-    const auto if_name = busi_config["ethercat_demo"]["if_name"].as<std::string>("");
-    const auto eni_path = busi_config["ethercat_demo"]["eni_path"].as<std::string>("");
-    const auto cycle_us = busi_config["ethercat_demo"]["cycle_us"].as<uint32_t>(1000);
-    const auto duration_ms = busi_config["ethercat_demo"]["duration_ms"].as<uint32_t>(0);
+// [2026-10-16] 目的：延迟日志（JobTask 等周期线程的 EcLogMsg 只记录格式串指针 + 参数，格式化线程再交给 EcMasterLogToTiny）
+// 说明：G_pEcLogParms 是进程级的，所以延迟日志由所有实例共用：第一个实例启动、最后一个实例退出时停止
+static CEcDeferredLog s_deferred_log;
+static std::mutex s_deferred_log_lock;
+static uint32_t s_deferred_log_users = 0;
 
-    // [2026-01-16] 目的：关键参数缺失时直接报错，避免 demo 进入异常状态
-    if (if_name.empty() || eni_path.empty())
+// [2026-10-16] 目的：发布上一个发布周期内的周期计时统计（读取后清零，便于和同一时间段的 frame loss 对照）
+static void PublishCycleTrace()
+{
+    for (const auto& inst : s_instances)
+    {
+        if (!inst->cycle_trace.IsRunning())
+        {
+            continue;
+        }
+        static T_CYC_TRACE_SNAPSHOT snap;
+        inst->cycle_trace.GetSnapshot(&snap, EC_TRUE);
+
+        char buf[512];
+        int len = OsSnprintf(buf, sizeof(buf), "%scycle_trace: cycles=%llu frame_loss=%llu overruns=%llu missed=%llu dropped=%llu (p50/p99/p99.9/max us)",
+                             inst->tag.c_str(), (unsigned long long)snap.qwCycles, (unsigned long long)snap.qwFrameLoss,
+                             (unsigned long long)snap.qwOverruns, (unsigned long long)snap.qwMissed, (unsigned long long)snap.qwDropped);
+        for (EC_T_DWORD i = 0; (i < CYC_TRACE_METRIC_CNT) && (len > 0) && (len < (int)sizeof(buf)); i++)
+        {
+            const T_CYC_TRACE_METRIC& m = snap.aMetric[i];
+            if (m.qwCount == 0)
+            {
+                continue;
+            }
+            len += OsSnprintf(buf + len, sizeof(buf) - len, " %s=%.1f/%.1f/%.1f/%.1f", CEcCycleTrace::MetricName(i),
+                              m.dwP50 / 1000.0, m.dwP99 / 1000.0, m.dwP999 / 1000.0, m.dwMax / 1000.0);
+        }
+        LOG_I(BasicService) << buf;
+        if (snap.dwWorstCnt > 0)
+        {
+            const T_CYC_TRACE_REC& w = snap.aWorst[0];
+            LOG_I(BasicService) << inst->tag << "cycle_trace worst: cycle=" << w.qwCycle << " dispatch_ns=" << w.adwNsec[CYC_TRACE_DISPATCH]
+                                << " rx_ns=" << w.adwNsec[CYC_TRACE_RX] << " workpd_ns=" << w.adwNsec[CYC_TRACE_WORKPD]
+                                << " tx_ns=" << w.adwNsec[CYC_TRACE_TX] << " total_ns=" << w.adwNsec[CYC_TRACE_TOTAL]
+                                << " flags=" << w.dwFlags;
+        }
+    }
+    // [2026-10-16] 目的：同一发布周期内输出延迟日志计数（累计值），丢弃/合并的条数和 frame loss 一起看
+    if (s_deferred_log.IsRunning())
+    {
+        T_DEFLOG_STATS stats;
+        s_deferred_log.GetStats(&stats);
+        LOG_I(BasicService) << "deferred_log: logged=" << stats.qwLogged << " dropped=" << stats.qwDropped
+                            << " suppressed=" << stats.qwSuppressed << " preformatted=" << stats.qwPreformatted
+                            << " truncated=" << stats.qwTruncated << " direct=" << stats.qwDirect << " threads=" << stats.dwThreads;
+    }
+    for (const auto& inst : s_instances)
+    {
+        // [2026-10-16] 目的：抓包计数（累计值），dropped 非 0 说明这段时间的抓包不完整
+        if (inst->pcap_mmap.IsRunning())
+        {
+            T_PCAP_MMAP_STATS stats;
+            inst->pcap_mmap.GetStats(&stats);
+            LOG_I(BasicService) << inst->tag << "pcap_capture: frames=" << stats.qwFrames << " bytes=" << stats.qwBytes
+                                << " dropped=" << stats.qwDropped << " segments=" << stats.dwSegments
+                                << " deleted=" << stats.dwDeleted << " errors=" << stats.dwErrors;
+        }
+        // [2026-10-16] 目的：外部控制器命令计数（累计值），late 增长说明控制器跟不上总线周期
+        EC_T_UINT64 shm_cycle = 0, shm_taken = 0, shm_late = 0, shm_rejected = 0;
+        if (inst->process_data_shm && (EC_E_NOERROR == MT_GetShmStats(&inst->mt, &shm_cycle, &shm_taken, &shm_late, &shm_rejected)))
+        {
+            LOG_I(BasicService) << inst->tag << "process_data_shm: cycle=" << shm_cycle << " cmd_taken=" << shm_taken
+                                << " cmd_late=" << shm_late << " cmd_rejected=" << shm_rejected;
+        }
+    }
+    // [2026-10-16] 目的：多实例时输出聚合视图（全局轴数 + 各实例已发布的周期号，周期号差值即实例间的相位/进度偏差）
+    if (s_instances.size() > 1)
     {
-        LOG_COUT(BasicService) << "ethercat_demo.if_name or eni_path empty";
+        static std::vector<T_MT_CONTEXT*> contexts;
+        static std::vector<MotorState_> states;
+        static std::vector<EC_T_UINT64> cycles;
+        if (contexts.empty())
+        {
+            size_t axis_cap = 0;
+            for (const auto& inst : s_instances)
+            {
+                contexts.push_back(&inst->mt);
+                axis_cap += MT_SHM_MAX_AXIS;
+            }
+            states.resize(axis_cap);
+            cycles.resize(contexts.size());
+        }
+        EC_T_DWORD axis_cnt = 0;
+        if (EC_E_NOERROR == MT_GetAggregateStates(contexts.data(), (EC_T_DWORD)contexts.size(), states.data(),
+                                                  (EC_T_DWORD)states.size(), &axis_cnt, cycles.data()))
+        {
+            std::string line = "instances: count=" + std::to_string(contexts.size()) + " axes=" + std::to_string(axis_cnt) + " cycles=";
+            for (size_t c = 0; c < cycles.size(); c++)
+            {
+                line += (c == 0 ? "" : "/") + std::to_string(cycles[c]);
+            }
+            LOG_I(BasicService) << line;
+        }
+    }
+}
+
+// [2026-10-16] 目的：读取数字配置项，支持十六进制写法（如 index: 0x6041）
+static unsigned long YamlToUlong(const YAML::Node& node, unsigned long def)
+{
+    if (!node)
+    {
+        return def;
+    }
+    return std::strtoul(node.as<std::string>().c_str(), nullptr, 0);
+}
+
+
+// [2026-10-16] 目的：实例配置项优先取 instances[i] 下的同名项，没有时沿用 ethercat_demo 下的公共配置（整项替换，不逐字段合并）
+static YAML::Node InstanceConfig(const YAML::Node& inst_node, const YAML::Node& demo, const char* key)
+{
+    const YAML::Node value = inst_node[key];
+    return value ? value : demo[key];
+}
+
+// [2026-10-16] 目的：把 busi.yaml 的从站列表 / PDO 绑定表 / 绑定缓存路径交给 motrotech（必须在 EcDemoApp 前）
+// 说明：demo 库本身不依赖 yaml-cpp，这里解析后通过 MT_ConfigureSlaves/MT_SetPdoBindings 传入；多实例时写入各自的上下文
+static bool ConfigureEcMasterDemoPdo(EcDemoInstance* inst, const YAML::Node& inst_node, const YAML::Node& demo)
+{
+    T_MT_CONTEXT* mt = &inst->mt;
+    std::vector<SLAVE_MOTOR_TYPE> slaves;
+    for (const auto& node : InstanceConfig(inst_node, demo, "slaves"))
+    {
+        SLAVE_MOTOR_TYPE slave;
+        OsMemset(&slave, 0, sizeof(slave));
+        slave.wStationAddress = (EC_T_WORD)YamlToUlong(node["station"], 0);
+        slave.wAxisCnt = (EC_T_WORD)YamlToUlong(node["axes"], 1);
+        slaves.push_back(slave);
+    }
+    if (EC_E_NOERROR != MT_ConfigureSlaves(mt, slaves.empty() ? EC_NULL : slaves.data(), (EC_T_DWORD)slaves.size()))
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.slaves invalid";
         return false;
     }
 
-    // [2026-01-16] 目的：demo 在独立线程运行，避免阻塞 BasicService 初始化流程
-    static std::thread demo_thread;
-    if (demo_thread.joinable())
+    std::vector<T_MT_PDO_BINDING> bindings;
+    for (const auto& node : InstanceConfig(inst_node, demo, "pdo_bindings"))
     {
-        LOG_I(BasicService) << "ecmaster demo already running";
-        return true;
+        T_MT_PDO_BINDING binding;
+        OsMemset(&binding, 0, sizeof(binding));
+        const auto name = node["name"].as<std::string>("");
+        const auto type = node["type"].as<std::string>("");
+        const auto dir = node["dir"].as<std::string>("");
+        OsStrncpy(binding.szName, name.c_str(), sizeof(binding.szName) - 1);
+        binding.wIndex = (EC_T_WORD)YamlToUlong(node["index"], 0);
+        binding.wSubIndex = (EC_T_WORD)YamlToUlong(node["sub"], MT_PDO_SUBINDEX_ANY);
+        binding.wAxisStride = (EC_T_WORD)YamlToUlong(node["stride"], MT_PDO_DEFAULT_STRIDE);
+        if (name.empty() || !MT_PdoTypeFromName(type.c_str(), &binding.byType) || !MT_PdoDirFromName(dir.c_str(), &binding.byDir))
+        {
+            LOG_COUT(BasicService) << inst->tag << "ethercat_demo.pdo_bindings invalid entry: " << name;
+            return false;
+        }
+        bindings.push_back(binding);
+    }
+    if (EC_E_NOERROR != MT_SetPdoBindings(&mt->oPdo, bindings.empty() ? EC_NULL : bindings.data(), (EC_T_DWORD)bindings.size()))
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.pdo_bindings invalid (max " << MT_PDO_MAX_BINDINGS << " entries)";
+        return false;
     }
 
-    demo_thread = std::thread([if_name, eni_path, cycle_us, duration_ms]() {
-        // [2026-01-16] 目的：最小化复用 EcDemoMain.cpp 的上下文初始化流程
-        T_EC_DEMO_APP_CONTEXT AppContext;
-        OsMemset(&AppContext, 0, sizeof(AppContext));
+    // [2026-10-16] 轴组流式轨迹：轴号在 MT_Setup() 里按实际轴数校验（MT_ConfigureTrajGroups 会拷贝轴号）
+    std::vector<std::vector<EC_T_WORD>> groupAxes;
+    std::vector<T_MT_TRAJ_GROUP_CFG> groups;
+    for (const auto& node : InstanceConfig(inst_node, demo, "traj_groups"))
+    {
+        std::vector<EC_T_WORD> axes;
+        for (const auto& axis : node["axes"])
+        {
+            axes.push_back((EC_T_WORD)YamlToUlong(axis, 0));
+        }
+        T_MT_TRAJ_GROUP_CFG group;
+        OsMemset(&group, 0, sizeof(group));
+        group.dwAxisCnt = (EC_T_DWORD)axes.size();
+        group.dwQueueLen = (EC_T_DWORD)YamlToUlong(node["queue"], MT_TRAJ_DEFAULT_QUEUE);
+        group.fStopDecel = node["stop_decel"].as<double>(MT_TRAJ_DEFAULT_STOP_DECEL);
+        groupAxes.push_back(axes);
+        groups.push_back(group);
+    }
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        groups[g].pwAxis = groupAxes[g].empty() ? EC_NULL : groupAxes[g].data();
+    }
+    if (EC_E_NOERROR != MT_ConfigureTrajGroups(mt, groups.empty() ? EC_NULL : groups.data(), (EC_T_DWORD)groups.size()))
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.traj_groups invalid (max " << MT_TRAJ_MAX_GROUPS << " groups)";
+        return false;
+    }
 
-        // [2026-01-16] 目的：设置 demo 的运行标志，驱动主循环进入工作状态
-        bRun = EC_TRUE;
+    // [2026-10-16] 过程数据共享内存：MT_Setup() 按实际轴数创建，外部控制器按同名 shm_open（多实例时名字不能重复）
+    const auto shm = InstanceConfig(inst_node, demo, "process_data_shm");
+    inst->process_data_shm = shm["enable"].as<bool>(false);
+    const auto shm_name = inst->process_data_shm ? shm["name"].as<std::string>("") : std::string();
+    if ((inst->process_data_shm && shm_name.empty()) || (EC_E_NOERROR != MT_ConfigureShm(mt, shm_name.c_str())))
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.process_data_shm.name must look like /name (max "
+                               << (MT_SHM_NAME_SIZE - 1) << " chars)";
+        return false;
+    }
 
-        // [2026-01-16] 目的：初始化 demo 日志（输出到 stdout）
-        AppContext.LogParms.dwLogLevel = EC_LOG_LEVEL_INFO;
-        AppContext.LogParms.pfLogMsg = EcMasterLogToTiny;
-        AppContext.LogParms.pLogContext = EC_NULL;
-        OsMemcpy(G_pEcLogParms, &AppContext.LogParms, sizeof(EC_T_LOG_PARMS));
+    MT_SetPdoCachePath(&mt->oPdo, InstanceConfig(inst_node, demo, "pdo_cache").as<std::string>("").c_str());
+    LOG_I(BasicService) << inst->tag << "ethercat_demo: " << slaves.size() << " slaves, " << bindings.size() << " pdo bindings, "
+                        << groups.size() << " traj groups configured"
+                        << (inst->process_data_shm ? ", process data shm " + shm_name : std::string());
+    return true;
+}
 
-        AppContext.dwInstanceId = INSTANCE_MASTER_DEFAULT;
-        ResetAppParms(&AppContext, &AppContext.AppParms);
+// [2026-10-16] 目的：busi.yaml 的 realtime 段（各线程优先级/CPU、内存锁定、混合唤醒、超期策略）
+// 说明：在 demo 线程启动前解析并校验，在 demo 线程内写入 AppParms（ResetAppParms 之后）
+struct EcDemoRtConfig
+{
+    bool mem_lock = true;
+    uint32_t spin_us = 0;
+    EC_T_DWORD overrun = DEMO_RT_OVERRUN_SKIP;
+    int prio[DEMO_RT_THREAD_CNT] = {-1, -1, -1, -1}; // -1 = demo 默认优先级
+    int cpu[DEMO_RT_THREAD_CNT] = {-1, -1, -1, -1};  // -1 = 沿用公共 CPU 设置
+};
 
-        AppContext.AppParms.Os.dwSize = sizeof(EC_T_OS_PARMS);
-        AppContext.AppParms.Os.dwSignature = EC_OS_PARMS_SIGNATURE;
-        AppContext.AppParms.Os.dwSupportedFeatures = 0xFFFFFFFF;
-        AppContext.AppParms.Os.PlatformParms.bConfigMutex = EC_TRUE;
-        AppContext.AppParms.Os.PlatformParms.nMutexType = PTHREAD_MUTEX_RECURSIVE;
-        AppContext.AppParms.Os.PlatformParms.nMutexProtocol = PTHREAD_PRIO_NONE;
-        OsInit(&AppContext.AppParms.Os);
+static bool ParseEcMasterDemoRt(const YAML::Node& rt, EcDemoRtConfig* config)
+{
+    static const char* const thread_names[DEMO_RT_THREAD_CNT] = {"timer", "job", "notify", "log"};
+    if (!rt)
+    {
+        return true;
+    }
+    config->mem_lock = rt["mem_lock"].as<bool>(true);
+    config->spin_us = rt["spin_us"].as<uint32_t>(0);
+    const auto overrun = rt["overrun"].as<std::string>("skip");
+    if (overrun == "skip")
+    {
+        config->overrun = DEMO_RT_OVERRUN_SKIP;
+    }
+    else if (overrun == "catchup")
+    {
+        config->overrun = DEMO_RT_OVERRUN_CATCHUP;
+    }
+    else if (overrun == "resync")
+    {
+        config->overrun = DEMO_RT_OVERRUN_RESYNC;
+    }
+    else
+    {
+        LOG_COUT(BasicService) << "ethercat_demo.realtime.overrun invalid: " << overrun;
+        return false;
+    }
+    for (int i = 0; i < DEMO_RT_THREAD_CNT; i++)
+    {
+        const auto& node = rt["threads"][thread_names[i]];
+        config->prio[i] = node["prio"].as<int>(-1);
+        config->cpu[i] = node["cpu"].as<int>(-1);
+        if ((config->prio[i] != -1 && (config->prio[i] < 1 || config->prio[i] > 99))
+            || config->cpu[i] < -1 || config->cpu[i] >= (int)(sizeof(EC_T_CPUSET) * 8))
+        {
+            LOG_COUT(BasicService) << "ethercat_demo.realtime.threads." << thread_names[i] << " invalid";
+            return false;
+        }
+    }
+    return true;
+}
 
-        // [2026-01-16] 目的：构造 demo 命令行参数，复用 demo 的参数解析逻辑
-        EC_T_CHAR szCmd[COMMAND_LINE_BUFFER_LENGTH];
-        OsMemset(szCmd, 0, sizeof(szCmd));
-        if (duration_ms > 0)
+static void ApplyEcMasterDemoRt(const EcDemoRtConfig& config, T_EC_DEMO_APP_PARMS* parms)
+{
+    parms->bRtMemLock = config.mem_lock ? EC_TRUE : EC_FALSE;
+    parms->dwRtSpinUsec = config.spin_us;
+    parms->dwRtOverrunPolicy = config.overrun;
+    for (int i = 0; i < DEMO_RT_THREAD_CNT; i++)
+    {
+        if (config.prio[i] != -1)
         {
-            OsSnprintf(szCmd, sizeof(szCmd) - 1, "-sockraw %s -f \"%s\" -b %u -t %u",
-                       if_name.c_str(), eni_path.c_str(), cycle_us, duration_ms);
+            parms->aRtThread[i].dwPrio = (EC_T_DWORD)config.prio[i];
         }
-        else
+        if (config.cpu[i] != -1)
         {
-            OsSnprintf(szCmd, sizeof(szCmd) - 1, "-sockraw %s -f \"%s\" -b %u",
-                       if_name.c_str(), eni_path.c_str(), cycle_us);
+            EC_CPUSET_ZERO(parms->aRtThread[i].CpuSet);
+            EC_CPUSET_SET(parms->aRtThread[i].CpuSet, config.cpu[i]);
         }
+    }
+}
+
+
+// [2026-10-16] 目的：单个实例的启动参数（在 demo 线程启动前解析并校验，按值交给实例线程）
+struct EcDemoInstanceConfig
+{
+    std::string if_name;
+    std::string eni_path;
+    uint32_t cycle_us = 1000;
+    uint32_t duration_ms = 0;
+    bool trace_enable = true;
+    std::string trace_csv;
+    EcDemoRtConfig rt_config;
+    bool deflog_enable = true;
+    uint32_t deflog_burst = DEFLOG_DEFAULT_BURST;
+    uint32_t deflog_window_ms = DEFLOG_DEFAULT_WINDOW;
+    bool pcap_enable = false;
+    std::string pcap_prefix;
+    uint32_t pcap_segment_mb = PCAP_MMAP_DEFAULT_SEGMENT_MB;
+    uint32_t pcap_segment_s = PCAP_MMAP_DEFAULT_SEGMENT_SEC;
+    uint32_t pcap_max_segments = PCAP_MMAP_DEFAULT_MAX_SEGMENTS;
+    bool console = true;               // 本实例读 stdin 命令（一个进程只允许一个）
+    bool shared_clock = false;         // 周期起点对齐到 cycle 的整数倍（CLOCK_MONOTONIC），多实例相位一致
+    uint32_t clock_offset_us = 0;      // 本实例在共享时间栅格上的相位偏移
+};
+
+// [2026-01-16] 目的：初始化 demo 日志（输出到 tinylog）
+static void InitEcMasterLogParms(EC_T_LOG_PARMS* parms)
+{
+    OsMemset(parms, 0, sizeof(EC_T_LOG_PARMS));
+    parms->dwLogLevel = EC_LOG_LEVEL_INFO;
+    parms->pfLogMsg = EcMasterLogToTiny;
+    parms->pLogContext = EC_NULL;
+}
 
-        // [2026-01-16] 目的：将命令行参数写入 demo 参数结构体
-        if (EC_E_NOERROR != SetAppParmsFromCommandLine(&AppContext, szCmd, &AppContext.AppParms))
+// [2026-10-16] 目的：第一个实例启动延迟日志，之后所有 EcLogMsg 走 s_deferred_log（格式化线程按该实例的 log 线程配置调度），
+// 失败时保持同步的 EcMasterLogToTiny
+static void AcquireDeferredLog(const EcDemoInstanceConfig& config, T_EC_DEMO_APP_CONTEXT* ctx, const EC_T_LOG_PARMS& sink_log_parms)
+{
+    if (!config.deflog_enable)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(s_deferred_log_lock);
+    if (s_deferred_log_users == 0)
+    {
+        if (EC_E_NOERROR != s_deferred_log.Start(&sink_log_parms, GetRtThreadCpuSet(&ctx->AppParms, DEMO_RT_THREAD_LOG),
+                                                 ctx->AppParms.aRtThread[DEMO_RT_THREAD_LOG].dwPrio, config.deflog_burst, config.deflog_window_ms))
         {
-            LOG_COUT(BasicService) << "SetAppParmsFromCommandLine failed";
+            LOG_COUT(BasicService) << "deferred log start failed, continue with synchronous logging";
             return;
         }
+        EC_T_LOG_PARMS deflog_parms;
+        s_deferred_log.GetLogParms(&deflog_parms, sink_log_parms.dwLogLevel);
+        OsMemcpy(G_pEcLogParms, &deflog_parms, sizeof(EC_T_LOG_PARMS));
+    }
+    s_deferred_log_users++;
+    s_deferred_log.GetLogParms(&ctx->LogParms, sink_log_parms.dwLogLevel);
+    ctx->pDeferredLog = &s_deferred_log;
+}
+
+// [2026-10-16] 目的：最后一个实例退出时恢复同步日志后再停延迟日志（停止时把剩余记录全部输出）
+static void ReleaseDeferredLog(T_EC_DEMO_APP_CONTEXT* ctx, const EC_T_LOG_PARMS& sink_log_parms)
+{
+    if (ctx->pDeferredLog == EC_NULL)
+    {
+        return;
+    }
+    ctx->pDeferredLog = EC_NULL;
+    ctx->LogParms = sink_log_parms;
+    std::lock_guard<std::mutex> lock(s_deferred_log_lock);
+    if (--s_deferred_log_users == 0)
+    {
+        OsMemcpy(G_pEcLogParms, &sink_log_parms, sizeof(EC_T_LOG_PARMS));
+        s_deferred_log.Stop();
+    }
+}
+
+// [2026-01-16] 目的：demo 在独立线程运行，避免阻塞 BasicService 初始化流程
+// [2026-10-16] 说明：多实例时每个实例一个线程，各自的 AppContext / 网卡 / 定时任务 / JobTask（按本实例 realtime 配置绑核）
+static void RunEcMasterDemoInstance(EcDemoInstance* inst, const EcDemoInstanceConfig config)
+{
+    // [2026-01-16] 目的：最小化复用 EcDemoMain.cpp 的上下文初始化流程
+    T_EC_DEMO_APP_CONTEXT AppContext;
+    OsMemset(&AppContext, 0, sizeof(AppContext));
+
+    EC_T_LOG_PARMS sink_log_parms;
+    InitEcMasterLogParms(&sink_log_parms);
+    AppContext.LogParms = sink_log_parms;
+
+    // [2026-10-16] 说明：dwInstanceId 必须在解析命令行前设置（参数解析阶段就会按实例号访问主站），-id 保持一致
+    AppContext.dwInstanceId = inst->id;
+    AppContext.pMtContext = &inst->mt;
+    ResetAppParms(&AppContext, &AppContext.AppParms);
+
+    AppContext.AppParms.Os.dwSize = sizeof(EC_T_OS_PARMS);
+    AppContext.AppParms.Os.dwSignature = EC_OS_PARMS_SIGNATURE;
+    AppContext.AppParms.Os.dwSupportedFeatures = 0xFFFFFFFF;
+    AppContext.AppParms.Os.PlatformParms.bConfigMutex = EC_TRUE;
+    AppContext.AppParms.Os.PlatformParms.nMutexType = PTHREAD_MUTEX_RECURSIVE;
+    AppContext.AppParms.Os.PlatformParms.nMutexProtocol = PTHREAD_PRIO_NONE;
+    OsInit(&AppContext.AppParms.Os);
+
+    // [2026-01-16] 目的：构造 demo 命令行参数，复用 demo 的参数解析逻辑
+    EC_T_CHAR szCmd[COMMAND_LINE_BUFFER_LENGTH];
+    OsMemset(szCmd, 0, sizeof(szCmd));
+    if (config.duration_ms > 0)
+    {
+        OsSnprintf(szCmd, sizeof(szCmd) - 1, "-sockraw %s -f \"%s\" -b %u -t %u",
+                   config.if_name.c_str(), config.eni_path.c_str(), config.cycle_us, config.duration_ms);
+    }
+    else
+    {
+        OsSnprintf(szCmd, sizeof(szCmd) - 1, "-sockraw %s -f \"%s\" -b %u",
+                   config.if_name.c_str(), config.eni_path.c_str(), config.cycle_us);
+    }
+    if (config.pcap_enable)
+    {
+        const size_t len = OsStrlen(szCmd);
+        OsSnprintf(szCmd + len, sizeof(szCmd) - 1 - len, " -pcapmmap %s %u %u %u",
+                   config.pcap_prefix.c_str(), config.pcap_segment_mb, config.pcap_segment_s, config.pcap_max_segments);
+        AppContext.pPcapMmap = &inst->pcap_mmap;
+    }
+    // [2026-10-16] 目的：多实例参数：实例号、共享周期时钟（相位偏移）、只保留一个 stdin 命令台
+    {
+        size_t len = OsStrlen(szCmd);
+        OsSnprintf(szCmd + len, sizeof(szCmd) - 1 - len, " -id %u", inst->id);
+        if (config.shared_clock)
+        {
+            len = OsStrlen(szCmd);
+            OsSnprintf(szCmd + len, sizeof(szCmd) - 1 - len, " -rtclock %u", config.clock_offset_us);
+        }
+        if (!config.console)
+        {
+            len = OsStrlen(szCmd);
+            OsSnprintf(szCmd + len, sizeof(szCmd) - 1 - len, " -nocmd");
+        }
+    }
+
+    // [2026-01-16] 目的：将命令行参数写入 demo 参数结构体
+    if (EC_E_NOERROR != SetAppParmsFromCommandLine(&AppContext, szCmd, &AppContext.AppParms))
+    {
+        LOG_COUT(BasicService) << inst->tag << "SetAppParmsFromCommandLine failed";
+        return;
+    }
 
-        // [2026-01-16] 目的：正式运行 demo 主流程（主站初始化、进入 OP、周期任务）
-        (void)EcDemoApp(&AppContext);
+    // [2026-10-16] 目的：实时模式：内存锁定 + 栈预缺页，本线程（EcDemoApp 主循环）按 notify 配置调度；
+    // 说明：权限不足（非 root / 未加入 realtime 组）时只告警，demo 仍以普通调度运行
+    ApplyEcMasterDemoRt(config.rt_config, &AppContext.AppParms);
+    if (AppContext.AppParms.bRtMemLock && EC_E_NOERROR != DemoRtLockMemory(DEMO_RT_STACK_PREFAULT))
+    {
+        LOG_COUT(BasicService) << inst->tag << "realtime: mlockall failed, continue with paging enabled";
+    }
+    if (EC_E_NOERROR != DemoRtSetCurrentThread(&AppContext.AppParms, DEMO_RT_THREAD_NOTIFY))
+    {
+        LOG_COUT(BasicService) << inst->tag << "realtime: cannot set priority/affinity of the demo thread";
+    }
+
+    AcquireDeferredLog(config, &AppContext, sink_log_parms);
+
+    // [2026-10-16] 目的：启动周期计时追踪（必须在定时任务之前挂到 AppContext 上），失败不影响 demo 运行
+    if (config.trace_enable)
+    {
+        if (EC_E_NOERROR == inst->cycle_trace.Start(GetRtThreadCpuSet(&AppContext.AppParms, DEMO_RT_THREAD_LOG),
+                                                    AppContext.AppParms.aRtThread[DEMO_RT_THREAD_LOG].dwPrio))
+        {
+            AppContext.pCycleTrace = &inst->cycle_trace;
+        }
+        else
+        {
+            LOG_COUT(BasicService) << inst->tag << "cycle trace start failed, continue without";
+        }
+    }
 
-        // [2026-01-16] 目的：释放 demo 运行过程中分配的参数资源
+    // [2026-10-16] 目的：与 EcDemoMain 一致，由定时任务（clock_nanosleep）每周期唤醒 JobTask
+    // 说明：之前内嵌运行时没有定时任务，pvJobTaskEvent 为空，JobTask 无法按周期运行
+    CDemoTimingTaskPlatform timing_task(AppContext);
+    if (EC_E_NOERROR != timing_task.StartTimingTask(AppContext.AppParms.dwBusCycleTimeUsec * 1000))
+    {
+        LOG_COUT(BasicService) << inst->tag << "StartTimingTask failed";
+        inst->cycle_trace.Stop();
+        ReleaseDeferredLog(&AppContext, sink_log_parms);
         FreeAppParms(&AppContext, &AppContext.AppParms);
-    });
+        return;
+    }
+
+    // [2026-01-16] 目的：正式运行 demo 主流程（主站初始化、进入 OP、周期任务）
+    (void)EcDemoApp(&AppContext);
+
+    // [2026-10-16] 目的：先停定时任务再停追踪；配置了 csv_path 时导出最后的周期计时
+    timing_task.StopTimingTask();
+    T_DEMO_TIMING_STATS timing_stats;
+    timing_task.GetStats(&timing_stats);
+    LOG_I(BasicService) << inst->tag << "timing task: cycles=" << timing_stats.qwCycles << " overruns=" << timing_stats.qwOverruns
+                        << " missed=" << timing_stats.qwMissed << " skipped=" << timing_stats.qwSkipped
+                        << " catchup=" << timing_stats.qwCatchUp << " resync=" << timing_stats.qwResync
+                        << " max_late_ns=" << timing_stats.dwMaxLateNsec;
+    if (AppContext.pCycleTrace != EC_NULL && !config.trace_csv.empty())
+    {
+        inst->cycle_trace.DumpCsv(config.trace_csv.c_str());
+    }
+    inst->cycle_trace.Stop();
+
+    ReleaseDeferredLog(&AppContext, sink_log_parms);
+
+    // [2026-01-16] 目的：释放 demo 运行过程中分配的参数资源
+    FreeAppParms(&AppContext, &AppContext.AppParms);
+}
 
-    LOG_I(BasicService) << "ecmaster demo thread started";
+// [2026-10-16] 目的：解析并校验一个实例的配置（instances[i] 覆盖 ethercat_demo 下的公共配置），同时写入 motrotech 上下文
+static bool ParseEcMasterDemoInstance(EcDemoInstance* inst, const YAML::Node& inst_node, const YAML::Node& demo,
+                                      EcDemoInstanceConfig* config)
+{
+    config->if_name = InstanceConfig(inst_node, demo, "if_name").as<std::string>("");
+    config->eni_path = InstanceConfig(inst_node, demo, "eni_path").as<std::string>("");
+    config->cycle_us = InstanceConfig(inst_node, demo, "cycle_us").as<uint32_t>(1000);
+    config->duration_ms = demo["duration_ms"].as<uint32_t>(0);
+    const auto trace_config = InstanceConfig(inst_node, demo, "cycle_trace");
+    config->trace_enable = trace_config["enable"].as<bool>(true);
+    config->trace_csv = trace_config["csv_path"].as<std::string>("");
+    const auto& deflog_config = demo["deferred_log"];
+    config->deflog_enable = deflog_config["enable"].as<bool>(true);
+    config->deflog_burst = deflog_config["rate_burst"].as<uint32_t>(DEFLOG_DEFAULT_BURST);
+    config->deflog_window_ms = deflog_config["rate_window_ms"].as<uint32_t>(DEFLOG_DEFAULT_WINDOW);
+    const auto pcap_config = InstanceConfig(inst_node, demo, "pcap_capture");
+    config->pcap_enable = pcap_config["enable"].as<bool>(false);
+    config->pcap_prefix = pcap_config["prefix"].as<std::string>("");
+    config->pcap_segment_mb = pcap_config["segment_mb"].as<uint32_t>(PCAP_MMAP_DEFAULT_SEGMENT_MB);
+    config->pcap_segment_s = pcap_config["segment_s"].as<uint32_t>(PCAP_MMAP_DEFAULT_SEGMENT_SEC);
+    config->pcap_max_segments = pcap_config["max_segments"].as<uint32_t>(PCAP_MMAP_DEFAULT_MAX_SEGMENTS);
+    config->console = inst_node["console"].as<bool>(inst->id == 0);
+    config->shared_clock = demo["shared_clock"].as<bool>(false);
+    config->clock_offset_us = inst_node["clock_offset_us"].as<uint32_t>(0);
+
+    // [2026-01-16] 目的：关键参数缺失时直接报错，避免 demo 进入异常状态
+    if (config->if_name.empty() || config->eni_path.empty())
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.if_name or eni_path empty";
+        return false;
+    }
+    // [2026-10-16] 目的：prefix 作为命令行参数传给 demo，不能为空也不能含空格
+    if (config->pcap_enable && (config->pcap_prefix.empty() || config->pcap_prefix.find(' ') != std::string::npos))
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.pcap_capture.prefix empty or contains spaces";
+        return false;
+    }
+    if (config->shared_clock && config->clock_offset_us >= config->cycle_us)
+    {
+        LOG_COUT(BasicService) << inst->tag << "ethercat_demo.instances.clock_offset_us must be less than cycle_us";
+        return false;
+    }
+
+    if (!ConfigureEcMasterDemoPdo(inst, inst_node, demo))
+    {
+        return false;
+    }
+    return ParseEcMasterDemoRt(InstanceConfig(inst_node, demo, "realtime"), &config->rt_config);
+}
+
+// [2026-01-16] 目的：在 BasicService 内启动 EC-Master demo（快速验证方案）
+// 说明：通过构造 demo 的命令行参数（网卡/ENI/周期/时长）复用原有 demo 逻辑
+// [2026-10-16] 说明：配置了 ethercat_demo.instances 时按列表启动多个实例（实例号 = 列表下标），否则按原单实例配置启动实例 0
+static bool StartEcMasterDemo(const YAML::Node& busi_config)
+{
+    // [2026-01-16] 目的：没有配置时跳过 demo 启动，保证框架可空跑
+    const auto& demo = busi_config["ethercat_demo"];
+    if (!demo)
+    {
+        LOG_I(BasicService) << "ethercat_demo not configured, skip demo start";
+        return true;
+    }
+    if (!s_instances.empty())
+    {
+        LOG_I(BasicService) << "ecmaster demo already running";
+        return true;
+    }
+
+    std::vector<YAML::Node> inst_nodes;
+    const auto& instances = demo["instances"];
+    if (instances)
+    {
+        if (!instances.IsSequence() || instances.size() == 0 || instances.size() > MAX_NUMOF_MASTER_INSTANCES)
+        {
+            LOG_COUT(BasicService) << "ethercat_demo.instances must be a list of 1.." << MAX_NUMOF_MASTER_INSTANCES << " entries";
+            return false;
+        }
+        for (const auto& node : instances)
+        {
+            inst_nodes.push_back(node);
+        }
+    }
+    else
+    {
+        inst_nodes.push_back(YAML::Node());
+    }
+
+    // [2026-10-16] 目的：先把所有实例解析/校验完再启动线程，任何一个实例配置错误都不启动
+    std::vector<std::unique_ptr<EcDemoInstance>> new_instances;
+    std::vector<EcDemoInstanceConfig> configs;
+    std::set<std::string> if_names, pcap_prefixes, shm_names, csv_paths;
+    uint32_t console_cnt = 0;
+    for (size_t i = 0; i < inst_nodes.size(); i++)
+    {
+        std::unique_ptr<EcDemoInstance> inst(new EcDemoInstance((EC_T_DWORD)i));
+        if (inst_nodes.size() > 1)
+        {
+            inst->tag = "[instance " + std::to_string(i) + "] ";
+        }
+        EcDemoInstanceConfig config;
+        if (!ParseEcMasterDemoInstance(inst.get(), inst_nodes[i], demo, &config))
+        {
+            return false;
+        }
+        // 说明：多个实例不能共用网卡 / 抓包前缀 / 共享内存名 / csv 文件
+        const auto shm_name = inst->process_data_shm ? std::string(inst->mt.szCfgShm) : std::string();
+        if (!if_names.insert(config.if_name).second
+            || (config.pcap_enable && !pcap_prefixes.insert(config.pcap_prefix).second)
+            || (!shm_name.empty() && !shm_names.insert(shm_name).second)
+            || (!config.trace_csv.empty() && !csv_paths.insert(config.trace_csv).second))
+        {
+            LOG_COUT(BasicService) << inst->tag << "ethercat_demo.instances: if_name, pcap_capture.prefix, "
+                                   << "process_data_shm.name and cycle_trace.csv_path must differ between instances";
+            return false;
+        }
+        console_cnt += config.console ? 1 : 0;
+        new_instances.push_back(std::move(inst));
+        configs.push_back(config);
+    }
+    if (console_cnt > 1)
+    {
+        LOG_COUT(BasicService) << "ethercat_demo.instances: only one instance can have console: true";
+        return false;
+    }
+
+    // [2026-01-16] 目的：初始化 demo 日志（输出到 tinylog）
+    // [2026-10-16] 说明：G_pEcLogParms 是进程级的，只在启动实例线程之前写一次，之后只由延迟日志的启停切换
+    EC_T_LOG_PARMS log_parms;
+    InitEcMasterLogParms(&log_parms);
+    OsMemcpy(G_pEcLogParms, &log_parms, sizeof(EC_T_LOG_PARMS));
+
+    // [2026-01-16] 目的：设置 demo 的运行标志，驱动主循环进入工作状态（所有实例共用，清零时全部退出）
+    bRun = EC_TRUE;
+
+    s_instances = std::move(new_instances);
+    for (size_t i = 0; i < s_instances.size(); i++)
+    {
+        s_instances[i]->thread = std::thread(RunEcMasterDemoInstance, s_instances[i].get(), configs[i]);
+    }
+
+    LOG_I(BasicService) << "ecmaster demo thread started (" << s_instances.size() << " instance"
+                        << (s_instances.size() > 1 ? "s)" : ")") << (configs[0].shared_clock ? ", shared cycle clock" : "");
     return true;
 }
 
@@ -147,6 +729,26 @@ bool BasicService::initialize(const std::string& busi_config)
         return false;
     }
 
+    // [2026-10-16] 目的：周期性发布周期计时统计（p50/p99/p99.9/max + 最差周期），publish_ms=0 关闭
+    try
+    {
+        YAML::Node busi = YAML::LoadFile(busi_config);
+        const auto publish_ms = busi["ethercat_demo"]["cycle_trace"]["publish_ms"].as<uint32_t>(0);
+        if (publish_ms > 0)
+        {
+            // 说明：count 取最大值，相当于一直发布
+            event_loop_.post_timer_event(
+            "cycle_trace",
+            []() { PublishCycleTrace(); },
+            std::chrono::milliseconds(publish_ms),
+            std::numeric_limits<int32_t>::max());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LOG_COUT(BasicService) << "ethercat_demo.cycle_trace config invalid: " << e.what();
+    }
+
     // 【注意】需要app.yaml中daemon设置为true时，添加定时器才生效
     // 这里count需要声明为static，否则post_timer_event结束后，函数退出，count因退出作用域而会被销毁
     static uint32_t count = 0;
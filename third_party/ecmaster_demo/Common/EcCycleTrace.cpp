@@ -0,0 +1,606 @@
+/*-----------------------------------------------------------------------------
+ * EcCycleTrace.cpp
+ * Description              Always-on per-cycle timing trace of the job task
+ *---------------------------------------------------------------------------*/
+
+/*-LOGGING-------------------------------------------------------------------*/
+#define pEcLogParms G_pEcLogParms
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+#include "EcCycleTrace.h"
+#include <time.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define CYC_TRACE_RING_MASK     (CYC_TRACE_RING_SIZE - 1)
+#define CYC_TRACE_STOP_TIMEOUT  2000    /* ms */
+
+/* job task <-> aggregator ring indices (single producer / single consumer) */
+#define CYC_TRACE_LOAD_ACQ(p)       __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define CYC_TRACE_STORE_REL(p, v)   __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*-LOCAL VARIABLES-----------------------------------------------------------*/
+static const EC_T_CHAR* S_aszMetricName[CYC_TRACE_METRIC_CNT] =
+{
+    "wakeup", "dispatch", "rx", "workpd", "tx", "timer", "acyc", "total"
+};
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_DWORD CycTraceClamp(EC_T_UINT64 qwNsec)
+{
+    return (qwNsec > 0xFFFFFFFF) ? 0xFFFFFFFF : (EC_T_DWORD)qwNsec;
+}
+
+/* value -> histogram bucket, see CYC_TRACE_HIST_SUB_BITS */
+static EC_T_DWORD CycTraceBucket(EC_T_DWORD dwVal)
+{
+    EC_T_DWORD dwMsb   = CYC_TRACE_HIST_SUB_BITS;
+    EC_T_DWORD dwShift = 0;
+
+    if (dwVal < (1u << CYC_TRACE_HIST_SUB_BITS))
+    {
+        return dwVal;
+    }
+    while ((dwMsb < 31) && (dwVal >> (dwMsb + 1)))
+    {
+        dwMsb++;
+    }
+    dwShift = dwMsb - (CYC_TRACE_HIST_SUB_BITS - 1);
+    return (1u << CYC_TRACE_HIST_SUB_BITS) + (dwShift - 1) * CYC_TRACE_HIST_SUB_HALF + ((dwVal >> dwShift) - CYC_TRACE_HIST_SUB_HALF);
+}
+
+/* histogram bucket -> largest value of the bucket */
+static EC_T_DWORD CycTraceBucketMax(EC_T_DWORD dwBucket)
+{
+    EC_T_DWORD dwIdx   = 0;
+    EC_T_DWORD dwShift = 0;
+    EC_T_UINT64 qwSub  = 0;
+
+    if (dwBucket < (1u << CYC_TRACE_HIST_SUB_BITS))
+    {
+        return dwBucket;
+    }
+    dwIdx   = dwBucket - (1u << CYC_TRACE_HIST_SUB_BITS);
+    dwShift = dwIdx / CYC_TRACE_HIST_SUB_HALF + 1;
+    qwSub   = CYC_TRACE_HIST_SUB_HALF + dwIdx % CYC_TRACE_HIST_SUB_HALF;
+    return CycTraceClamp(((qwSub + 1) << dwShift) - 1);
+}
+
+/* smallest value with at least dwPer10k/10000 of the samples below or equal */
+static EC_T_DWORD CycTracePercentile(const EC_T_UINT64* aqwHist, EC_T_UINT64 qwCount, EC_T_DWORD dwPer10k, EC_T_DWORD dwMax)
+{
+    EC_T_UINT64 qwTarget = (qwCount * dwPer10k + 9999) / 10000;
+    EC_T_UINT64 qwSum    = 0;
+    EC_T_DWORD  dwBucket = 0;
+
+    for (dwBucket = 0; dwBucket < CYC_TRACE_HIST_BUCKETS; dwBucket++)
+    {
+        qwSum += aqwHist[dwBucket];
+        if ((qwSum >= qwTarget) && (0 != qwSum))
+        {
+            EC_T_DWORD dwVal = CycTraceBucketMax(dwBucket);
+            return (dwVal > dwMax) ? dwMax : dwVal;
+        }
+    }
+    return dwMax;
+}
+
+/* worst cycle key: deadline -> end of cycle */
+static EC_T_UINT64 CycTraceWorstKey(const T_CYC_TRACE_REC* pRec)
+{
+    return (EC_T_UINT64)pRec->adwNsec[CYC_TRACE_DISPATCH] + pRec->adwNsec[CYC_TRACE_TOTAL];
+}
+
+static EC_T_VOID CycTraceWriteRec(FILE* pFile, const EC_T_CHAR* szSection, const T_CYC_TRACE_REC* pRec)
+{
+    EC_T_CHAR szLine[256];
+    EC_T_INT  nLen = 0;
+
+    nLen = OsSnprintf(szLine, sizeof(szLine), "%s,%llu,%llu,%u,%u,%u,%u,%u,%u,%u,%u,0x%x,%u\n", szSection,
+        (unsigned long long)pRec->qwCycle, (unsigned long long)pRec->qwStartNsec,
+        pRec->adwNsec[CYC_TRACE_WAKEUP], pRec->adwNsec[CYC_TRACE_DISPATCH], pRec->adwNsec[CYC_TRACE_RX],
+        pRec->adwNsec[CYC_TRACE_WORKPD], pRec->adwNsec[CYC_TRACE_TX], pRec->adwNsec[CYC_TRACE_TIMER],
+        pRec->adwNsec[CYC_TRACE_ACYC], pRec->adwNsec[CYC_TRACE_TOTAL], pRec->dwFlags, pRec->dwMissed);
+    if (nLen > 0)
+    {
+        OsFwrite(szLine, (EC_T_DWORD)EC_MIN(nLen, (EC_T_INT)sizeof(szLine) - 1), 1, pFile);
+    }
+}
+
+/*-CLASS FUNCTIONS-----------------------------------------------------------*/
+/*****************************************************************************/
+/**
+ * \brief  Constructor. No OS resources are allocated before Start().
+ */
+CEcCycleTrace::CEcCycleTrace()
+    : m_qwCycle(0)
+    , m_qwPhaseNsec(0)
+    , m_qwDeadlineSeen(0)
+    , m_qwDropped(0)
+    , m_qwDeadlineNsec(0)
+    , m_dwWakeupNsec(0)
+    , m_dwMissed(0)
+    , m_aRing(EC_NULL)
+    , m_dwHead(0)
+    , m_dwTail(0)
+    , m_poLock(EC_NULL)
+    , m_aqwHist(EC_NULL)
+    , m_qwCycles(0)
+    , m_qwFrameLoss(0)
+    , m_qwOverruns(0)
+    , m_qwMissed(0)
+    , m_qwDroppedBase(0)
+    , m_dwWorstCnt(0)
+    , m_aHistory(EC_NULL)
+    , m_dwHistoryCnt(0)
+    , m_dwPeriodMsec(CYC_TRACE_DEFAULT_PERIOD)
+    , m_pvThread(EC_NULL)
+    , m_bShutdown(EC_FALSE)
+    , m_bThreadRunning(EC_FALSE)
+    , m_bRunning(EC_FALSE)
+{
+    OsMemset(&m_oCur, 0, sizeof(m_oCur));
+    OsMemset(m_aqwSum, 0, sizeof(m_aqwSum));
+    OsMemset(m_adwMin, 0, sizeof(m_adwMin));
+    OsMemset(m_adwMax, 0, sizeof(m_adwMax));
+    OsMemset(m_aWorst, 0, sizeof(m_aWorst));
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Destructor.
+ */
+CEcCycleTrace::~CEcCycleTrace()
+{
+    Stop();
+    SafeOsFree(m_aRing);
+    SafeOsFree(m_aqwHist);
+    SafeOsFree(m_aHistory);
+    SafeOsDeleteLock(m_poLock);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Allocate the ring/histograms and start the aggregator thread.
+ *
+ * \return EC_E_NOERROR on success, error code otherwise.
+ */
+EC_T_DWORD CEcCycleTrace::Start(
+    EC_T_CPUSET CpuSet,         /**< [in] CPU set of the aggregator thread */
+    EC_T_DWORD  dwPrio,         /**< [in] priority of the aggregator thread */
+    EC_T_DWORD  dwPeriodMsec    /**< [in] aggregator drain period in ms */
+                                )
+{
+    EC_T_DWORD dwRetVal = EC_E_ERROR;
+
+    if (m_bRunning)
+    {
+        dwRetVal = EC_E_INVALIDSTATE;
+        goto Exit;
+    }
+    /* the ring must not overflow between two drains at 10 kHz */
+    if ((0 == dwPeriodMsec) || (dwPeriodMsec * 10 >= CYC_TRACE_RING_SIZE))
+    {
+        dwRetVal = EC_E_INVALIDPARM;
+        goto Exit;
+    }
+    m_dwPeriodMsec = dwPeriodMsec;
+    m_bShutdown    = EC_FALSE;
+
+    if (EC_NULL == m_poLock)
+    {
+        m_poLock = OsCreateLock();
+    }
+    if (EC_NULL == m_aRing)
+    {
+        m_aRing = (T_CYC_TRACE_REC*)OsMalloc(CYC_TRACE_RING_SIZE * sizeof(T_CYC_TRACE_REC));
+    }
+    if (EC_NULL == m_aqwHist)
+    {
+        m_aqwHist = (EC_T_UINT64*)OsMalloc(CYC_TRACE_METRIC_CNT * CYC_TRACE_HIST_BUCKETS * sizeof(EC_T_UINT64));
+    }
+    if (EC_NULL == m_aHistory)
+    {
+        m_aHistory = (T_CYC_TRACE_REC*)OsMalloc(CYC_TRACE_HISTORY_SIZE * sizeof(T_CYC_TRACE_REC));
+    }
+    if ((EC_NULL == m_poLock) || (EC_NULL == m_aRing) || (EC_NULL == m_aqwHist) || (EC_NULL == m_aHistory))
+    {
+        dwRetVal = EC_E_NOMEMORY;
+        goto Exit;
+    }
+    OsMemset(m_aRing, 0, CYC_TRACE_RING_SIZE * sizeof(T_CYC_TRACE_REC));
+    OsMemset(m_aHistory, 0, CYC_TRACE_HISTORY_SIZE * sizeof(T_CYC_TRACE_REC));
+    m_dwHistoryCnt = 0;
+    CYC_TRACE_STORE_REL(&m_dwTail, CYC_TRACE_LOAD_ACQ(&m_dwHead));
+    ResetStats();
+
+    m_bThreadRunning = EC_TRUE;
+    m_pvThread = OsCreateThread("tEcCycleTrace", (EC_PF_THREADENTRY)CEcCycleTrace::AggregatorTaskWrapper,
+        CpuSet, dwPrio, JOBS_THREAD_STACKSIZE, this);
+    if (EC_NULL == m_pvThread)
+    {
+        m_bThreadRunning = EC_FALSE;
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot create cycle trace thread\n"));
+        dwRetVal = EC_E_ERROR;
+        goto Exit;
+    }
+    m_bRunning = EC_TRUE;
+
+    dwRetVal = EC_E_NOERROR;
+Exit:
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        Stop();
+    }
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Stop the aggregator thread. Statistics stay readable until destruction.
+ */
+EC_T_VOID CEcCycleTrace::Stop(EC_T_VOID)
+{
+    m_bRunning  = EC_FALSE;
+    m_bShutdown = EC_TRUE;
+    if (EC_NULL != m_pvThread)
+    {
+        CEcTimer oTimeout(CYC_TRACE_STOP_TIMEOUT);
+        while (m_bThreadRunning && !oTimeout.IsElapsed())
+        {
+            OsSleep(1);
+        }
+        OsDeleteThreadHandle(m_pvThread);
+        m_pvThread = EC_NULL;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  CLOCK_MONOTONIC in ns (same clock as the timing task deadlines).
+ */
+EC_T_UINT64 CEcCycleTrace::NowNsec(EC_T_VOID)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (EC_T_UINT64)ts.tv_sec * 1000000000ull + (EC_T_UINT64)ts.tv_nsec;
+}
+
+const EC_T_CHAR* CEcCycleTrace::MetricName(EC_T_DWORD dwMetric)
+{
+    return (dwMetric < CYC_TRACE_METRIC_CNT) ? S_aszMetricName[dwMetric] : "?";
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Timing task: deadline of this wakeup and the time the timer task actually ran.
+ *         dwMissed is the number of deadlines the timing task overran before this wakeup.
+ */
+EC_T_VOID CEcCycleTrace::TimerWakeup(EC_T_UINT64 qwDeadlineNsec, EC_T_UINT64 qwWakeNsec, EC_T_DWORD dwMissed)
+{
+    m_dwWakeupNsec = CycTraceClamp((qwWakeNsec > qwDeadlineNsec) ? (qwWakeNsec - qwDeadlineNsec) : 0);
+    m_dwMissed     = dwMissed;
+    CYC_TRACE_STORE_REL(&m_qwDeadlineNsec, qwDeadlineNsec);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Job task: start of a cycle (right after the timing event).
+ */
+EC_T_VOID CEcCycleTrace::Begin(EC_T_VOID)
+{
+    EC_T_UINT64 qwNow      = NowNsec();
+    EC_T_UINT64 qwDeadline = CYC_TRACE_LOAD_ACQ(&m_qwDeadlineNsec);
+
+    OsMemset(&m_oCur, 0, sizeof(m_oCur));
+    m_oCur.qwCycle     = m_qwCycle++;
+    m_oCur.qwStartNsec = qwNow;
+
+    /* deadline already consumed by the previous cycle: event timeout or link layer timing */
+    if ((0 == qwDeadline) || (qwDeadline == m_qwDeadlineSeen) || (qwDeadline > qwNow))
+    {
+        m_oCur.dwFlags |= CYC_TRACE_FLAG_NO_DEADLINE;
+    }
+    else
+    {
+        m_oCur.adwNsec[CYC_TRACE_WAKEUP]   = m_dwWakeupNsec;
+        m_oCur.adwNsec[CYC_TRACE_DISPATCH] = CycTraceClamp(qwNow - qwDeadline);
+        m_oCur.dwMissed                    = m_dwMissed;
+        if (0 != m_oCur.dwMissed)
+        {
+            m_oCur.dwFlags |= CYC_TRACE_FLAG_OVERRUN;
+        }
+    }
+    m_qwPhaseNsec = qwNow;
+    m_qwDeadlineSeen = qwDeadline;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Job task: end of a phase.
+ */
+EC_T_VOID CEcCycleTrace::Mark(EC_T_DWORD dwMetric)
+{
+    EC_T_UINT64 qwNow = NowNsec();
+
+    m_oCur.adwNsec[dwMetric] += CycTraceClamp(qwNow - m_qwPhaseNsec);
+    m_qwPhaseNsec = qwNow;
+}
+
+EC_T_VOID CEcCycleTrace::Skip(EC_T_VOID)
+{
+    m_qwPhaseNsec = NowNsec();
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Job task: end of a cycle, hand the record to the aggregator.
+ */
+EC_T_VOID CEcCycleTrace::End(EC_T_VOID)
+{
+    EC_T_DWORD dwHead = m_dwHead;
+    EC_T_DWORD dwTail = 0;
+
+    m_oCur.adwNsec[CYC_TRACE_TOTAL] = CycTraceClamp(NowNsec() - m_oCur.qwStartNsec);
+    if (EC_NULL == m_aRing)
+    {
+        return;
+    }
+    dwTail = CYC_TRACE_LOAD_ACQ(&m_dwTail);
+    if ((EC_T_DWORD)(dwHead - dwTail) >= CYC_TRACE_RING_SIZE)
+    {
+        m_qwDropped++;
+        return;
+    }
+    m_aRing[dwHead & CYC_TRACE_RING_MASK] = m_oCur;
+    CYC_TRACE_STORE_REL(&m_dwHead, dwHead + 1);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Statistics of all records aggregated so far (or since the last reset).
+ */
+EC_T_VOID CEcCycleTrace::GetSnapshot(T_CYC_TRACE_SNAPSHOT* pSnapshot, EC_T_BOOL bReset)
+{
+    EC_T_DWORD dwMetric = 0;
+
+    OsMemset(pSnapshot, 0, sizeof(T_CYC_TRACE_SNAPSHOT));
+    if (EC_NULL == m_poLock)
+    {
+        return;
+    }
+    OsLock(m_poLock);
+    pSnapshot->qwCycles    = m_qwCycles;
+    pSnapshot->qwDropped   = m_qwDropped - m_qwDroppedBase;
+    pSnapshot->qwFrameLoss = m_qwFrameLoss;
+    pSnapshot->qwOverruns  = m_qwOverruns;
+    pSnapshot->qwMissed    = m_qwMissed;
+    for (dwMetric = 0; dwMetric < CYC_TRACE_METRIC_CNT; dwMetric++)
+    {
+        const EC_T_UINT64*  aqwHist = &m_aqwHist[dwMetric * CYC_TRACE_HIST_BUCKETS];
+        T_CYC_TRACE_METRIC* pMetric = &pSnapshot->aMetric[dwMetric];
+        EC_T_UINT64         qwCount = 0;
+        EC_T_DWORD          dwBucket = 0;
+
+        for (dwBucket = 0; dwBucket < CYC_TRACE_HIST_BUCKETS; dwBucket++)
+        {
+            qwCount += aqwHist[dwBucket];
+        }
+        if (0 == qwCount)
+        {
+            continue;
+        }
+        pMetric->qwCount = qwCount;
+        pMetric->dwMin   = m_adwMin[dwMetric];
+        pMetric->dwMax   = m_adwMax[dwMetric];
+        pMetric->dwAvg   = CycTraceClamp(m_aqwSum[dwMetric] / qwCount);
+        pMetric->dwP50   = CycTracePercentile(aqwHist, qwCount, 5000, pMetric->dwMax);
+        pMetric->dwP99   = CycTracePercentile(aqwHist, qwCount, 9900, pMetric->dwMax);
+        pMetric->dwP999  = CycTracePercentile(aqwHist, qwCount, 9990, pMetric->dwMax);
+    }
+    pSnapshot->dwWorstCnt = m_dwWorstCnt;
+    OsMemcpy(pSnapshot->aWorst, m_aWorst, m_dwWorstCnt * sizeof(T_CYC_TRACE_REC));
+    if (bReset)
+    {
+        ResetStats();
+    }
+    OsUnlock(m_poLock);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Write summary, worst cycles and the most recent cycles as CSV.
+ *
+ * Called on demand from a non real-time thread, the job task is not affected.
+ *
+ * \return EC_E_NOERROR on success, error code otherwise.
+ */
+EC_T_DWORD CEcCycleTrace::DumpCsv(const EC_T_CHAR* szFileName)
+{
+    EC_T_DWORD            dwRetVal   = EC_E_ERROR;
+    T_CYC_TRACE_SNAPSHOT* pSnapshot  = EC_NULL;
+    T_CYC_TRACE_REC*      aHistory   = EC_NULL;
+    EC_T_DWORD            dwHistCnt  = 0;
+    EC_T_DWORD            dwFirst    = 0;
+    EC_T_DWORD            dwIdx      = 0;
+    FILE*                 pFile      = EC_NULL;
+    EC_T_CHAR             szLine[256];
+    EC_T_INT              nLen       = 0;
+
+    if ((EC_NULL == szFileName) || ('\0' == szFileName[0]))
+    {
+        dwRetVal = EC_E_INVALIDPARM;
+        goto Exit;
+    }
+    if (EC_NULL == m_poLock)
+    {
+        dwRetVal = EC_E_INVALIDSTATE;
+        goto Exit;
+    }
+    pSnapshot = (T_CYC_TRACE_SNAPSHOT*)OsMalloc(sizeof(T_CYC_TRACE_SNAPSHOT));
+    aHistory  = (T_CYC_TRACE_REC*)OsMalloc(CYC_TRACE_HISTORY_SIZE * sizeof(T_CYC_TRACE_REC));
+    if ((EC_NULL == pSnapshot) || (EC_NULL == aHistory))
+    {
+        dwRetVal = EC_E_NOMEMORY;
+        goto Exit;
+    }
+    GetSnapshot(pSnapshot);
+
+    /* copy the history oldest first, file I/O is done outside the lock */
+    OsLock(m_poLock);
+    dwHistCnt = EC_MIN(m_dwHistoryCnt, (EC_T_DWORD)CYC_TRACE_HISTORY_SIZE);
+    dwFirst   = (m_dwHistoryCnt > CYC_TRACE_HISTORY_SIZE) ? (m_dwHistoryCnt % CYC_TRACE_HISTORY_SIZE) : 0;
+    for (dwIdx = 0; dwIdx < dwHistCnt; dwIdx++)
+    {
+        aHistory[dwIdx] = m_aHistory[(dwFirst + dwIdx) % CYC_TRACE_HISTORY_SIZE];
+    }
+    OsUnlock(m_poLock);
+
+    pFile = (FILE*)OsFopen(szFileName, "w");
+    if (EC_NULL == pFile)
+    {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot open cycle trace file %s\n", szFileName));
+        dwRetVal = EC_E_OPENFAILED;
+        goto Exit;
+    }
+
+    nLen = OsSnprintf(szLine, sizeof(szLine), "section,metric,count,min_ns,p50_ns,p99_ns,p999_ns,max_ns,avg_ns,dropped,frame_loss,overruns,missed\n");
+    OsFwrite(szLine, (EC_T_DWORD)nLen, 1, pFile);
+    for (dwIdx = 0; dwIdx < CYC_TRACE_METRIC_CNT; dwIdx++)
+    {
+        const T_CYC_TRACE_METRIC* pMetric = &pSnapshot->aMetric[dwIdx];
+
+        nLen = OsSnprintf(szLine, sizeof(szLine), "summary,%s,%llu,%u,%u,%u,%u,%u,%u,%llu,%llu,%llu,%llu\n", MetricName(dwIdx),
+            (unsigned long long)pMetric->qwCount, pMetric->dwMin, pMetric->dwP50, pMetric->dwP99, pMetric->dwP999,
+            pMetric->dwMax, pMetric->dwAvg,
+            (unsigned long long)pSnapshot->qwDropped, (unsigned long long)pSnapshot->qwFrameLoss,
+            (unsigned long long)pSnapshot->qwOverruns, (unsigned long long)pSnapshot->qwMissed);
+        OsFwrite(szLine, (EC_T_DWORD)EC_MIN(nLen, (EC_T_INT)sizeof(szLine) - 1), 1, pFile);
+    }
+
+    nLen = OsSnprintf(szLine, sizeof(szLine), "section,cycle,start_ns,wakeup_ns,dispatch_ns,rx_ns,workpd_ns,tx_ns,timer_ns,acyc_ns,total_ns,flags,missed\n");
+    OsFwrite(szLine, (EC_T_DWORD)nLen, 1, pFile);
+    for (dwIdx = 0; dwIdx < pSnapshot->dwWorstCnt; dwIdx++)
+    {
+        CycTraceWriteRec(pFile, "worst", &pSnapshot->aWorst[dwIdx]);
+    }
+    for (dwIdx = 0; dwIdx < dwHistCnt; dwIdx++)
+    {
+        CycTraceWriteRec(pFile, "cycle", &aHistory[dwIdx]);
+    }
+    OsFclose(pFile);
+
+    dwRetVal = EC_E_NOERROR;
+Exit:
+    SafeOsFree(pSnapshot);
+    SafeOsFree(aHistory);
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Move all records from the ring into the statistics.
+ */
+EC_T_VOID CEcCycleTrace::Drain(EC_T_VOID)
+{
+    EC_T_DWORD dwHead = CYC_TRACE_LOAD_ACQ(&m_dwHead);
+    EC_T_DWORD dwTail = m_dwTail;
+
+    if (dwHead == dwTail)
+    {
+        return;
+    }
+    OsLock(m_poLock);
+    for (; dwTail != dwHead; dwTail++)
+    {
+        Aggregate(&m_aRing[dwTail & CYC_TRACE_RING_MASK]);
+    }
+    OsUnlock(m_poLock);
+    CYC_TRACE_STORE_REL(&m_dwTail, dwTail);
+}
+
+EC_T_VOID CEcCycleTrace::Aggregate(const T_CYC_TRACE_REC* pRec)
+{
+    EC_T_DWORD  dwMetric = (pRec->dwFlags & CYC_TRACE_FLAG_NO_DEADLINE) ? CYC_TRACE_RX : 0;
+    EC_T_UINT64 qwKey    = CycTraceWorstKey(pRec);
+    EC_T_DWORD  dwPos    = 0;
+
+    for (; dwMetric < CYC_TRACE_METRIC_CNT; dwMetric++)
+    {
+        EC_T_DWORD dwVal = pRec->adwNsec[dwMetric];
+
+        m_aqwHist[dwMetric * CYC_TRACE_HIST_BUCKETS + CycTraceBucket(dwVal)]++;
+        m_aqwSum[dwMetric] += dwVal;
+        if (dwVal < m_adwMin[dwMetric])
+        {
+            m_adwMin[dwMetric] = dwVal;
+        }
+        if (dwVal > m_adwMax[dwMetric])
+        {
+            m_adwMax[dwMetric] = dwVal;
+        }
+    }
+    m_qwCycles++;
+    if (pRec->dwFlags & CYC_TRACE_FLAG_FRAME_LOSS)
+    {
+        m_qwFrameLoss++;
+    }
+    if (pRec->dwFlags & CYC_TRACE_FLAG_OVERRUN)
+    {
+        m_qwOverruns++;
+        m_qwMissed += pRec->dwMissed;
+    }
+
+    m_aHistory[m_dwHistoryCnt % CYC_TRACE_HISTORY_SIZE] = *pRec;
+    m_dwHistoryCnt++;
+
+    /* worst N, sorted descending: insert and drop the last one */
+    if ((m_dwWorstCnt == CYC_TRACE_WORST_N) && (qwKey <= CycTraceWorstKey(&m_aWorst[CYC_TRACE_WORST_N - 1])))
+    {
+        return;
+    }
+    dwPos = (m_dwWorstCnt < CYC_TRACE_WORST_N) ? m_dwWorstCnt++ : (CYC_TRACE_WORST_N - 1);
+    for (; (dwPos > 0) && (qwKey > CycTraceWorstKey(&m_aWorst[dwPos - 1])); dwPos--)
+    {
+        m_aWorst[dwPos] = m_aWorst[dwPos - 1];
+    }
+    m_aWorst[dwPos] = *pRec;
+}
+
+EC_T_VOID CEcCycleTrace::ResetStats(EC_T_VOID)
+{
+    OsMemset(m_aqwHist, 0, CYC_TRACE_METRIC_CNT * CYC_TRACE_HIST_BUCKETS * sizeof(EC_T_UINT64));
+    OsMemset(m_aqwSum, 0, sizeof(m_aqwSum));
+    OsMemset(m_adwMin, 0xFF, sizeof(m_adwMin));
+    OsMemset(m_adwMax, 0, sizeof(m_adwMax));
+    OsMemset(m_aWorst, 0, sizeof(m_aWorst));
+    m_qwCycles      = 0;
+    m_qwFrameLoss   = 0;
+    m_qwOverruns    = 0;
+    m_qwMissed      = 0;
+    m_qwDroppedBase = m_qwDropped;
+    m_dwWorstCnt    = 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Aggregator thread: drain the ring periodically.
+ */
+EC_T_VOID CEcCycleTrace::AggregatorTask(EC_T_VOID)
+{
+    while (!m_bShutdown)
+    {
+        OsSleep(m_dwPeriodMsec);
+        Drain();
+    }
+    Drain();
+    m_bThreadRunning = EC_FALSE;
+}
+
+EC_T_VOID CEcCycleTrace::AggregatorTaskWrapper(EC_T_VOID* pvParms)
+{
+    ((CEcCycleTrace*)pvParms)->AggregatorTask();
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------
+ * EcCycleTrace.h
+ * Description              Always-on per-cycle timing trace of the job task
+ *---------------------------------------------------------------------------*/
+
+/* =============================================================================
+ * 文件解读：
+ * frame loss（“not all previously sent frames are received”）通常是周期抖动的结果，
+ * 但 PerfMeas 只给出每段的 min/avg/max，看不出“哪一个周期、哪一段”出了问题。本模块：
+ * - 定时任务在 clock_nanosleep 返回后记录“应唤醒时刻 / 实际唤醒时刻”（唤醒延迟）
+ * - JobTask 每周期在各个 ecatExecJob 前后打时间戳，形成一条定长记录
+ *   （唤醒延迟、事件派发延迟、RX / Workpd / TX / MasterTimer / Acyc 各段耗时、总耗时、frame loss 标志）
+ * - 记录写入单生产者/单消费者无锁环形缓冲（满则丢弃并计数，JobTask 永不阻塞、不分配内存）
+ * - 后台汇总线程取走记录：每个指标一张 HDR 风格（对数分段 + 段内线性）直方图，
+ *   给出 p50/p99/p99.9/max；另外保留“最差 N 个周期”的完整记录和最近若干周期的原始记录
+ * - GetSnapshot() 供周期性发布（BasicService 定时器 / trace 命令），DumpCsv() 按需导出
+ *
+ * 全部存储在 Start() 时一次性分配；时间基准为 CLOCK_MONOTONIC（与定时任务同一时钟）。
+ * ============================================================================= */
+
+#ifndef INC_ECCYCLETRACE_H
+#define INC_ECCYCLETRACE_H 1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#ifndef INC_ECMASTER
+#include "EcMaster.h"
+#endif
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define CYC_TRACE_RING_SIZE         4096    /* records between job task and aggregator, power of 2 */
+#define CYC_TRACE_HISTORY_SIZE      4096    /* most recent records kept for the CSV dump */
+#define CYC_TRACE_WORST_N           16      /* worst cycles kept with their full record */
+#define CYC_TRACE_DEFAULT_PERIOD    10      /* ms, aggregator drain period */
+
+/* HDR style histogram: values < 2^SUB_BITS are exact, above that every octave is split
+ * into 2^(SUB_BITS-1) linear sub-buckets (relative error < 1/2^(SUB_BITS-1)), range 0..2^32 ns */
+#define CYC_TRACE_HIST_SUB_BITS     5
+#define CYC_TRACE_HIST_SUB_HALF     (1 << (CYC_TRACE_HIST_SUB_BITS - 1))
+#define CYC_TRACE_HIST_BUCKETS      ((1 << CYC_TRACE_HIST_SUB_BITS) + (32 - CYC_TRACE_HIST_SUB_BITS) * CYC_TRACE_HIST_SUB_HALF)
+
+/* metrics of one cycle (ns) */
+#define CYC_TRACE_WAKEUP            0       /* clock_nanosleep deadline -> timing task running */
+#define CYC_TRACE_DISPATCH          1       /* deadline -> job task running (includes WAKEUP) */
+#define CYC_TRACE_RX                2       /* eUsrJob_ProcessAllRxFrames */
+#define CYC_TRACE_WORKPD            3       /* myAppWorkpd */
+#define CYC_TRACE_TX                4       /* eUsrJob_SendAllCycFrames */
+#define CYC_TRACE_TIMER             5       /* eUsrJob_MasterTimer */
+#define CYC_TRACE_ACYC              6       /* eUsrJob_SendAcycFrames */
+#define CYC_TRACE_TOTAL             7       /* job task running -> end of SendAcycFrames */
+#define CYC_TRACE_METRIC_CNT        8
+
+/* record flags */
+#define CYC_TRACE_FLAG_FRAME_LOSS   0x0001  /* not all cyclic frames of the previous cycle processed */
+#define CYC_TRACE_FLAG_NO_DEADLINE  0x0002  /* no timing task deadline, WAKEUP/DISPATCH invalid */
+#define CYC_TRACE_FLAG_WORKPD       0x0004  /* myAppWorkpd was called (SAFEOP/OP) */
+#define CYC_TRACE_FLAG_OVERRUN      0x0008  /* timing task missed deadlines before this cycle */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* one cycle, written by the job task */
+typedef struct _T_CYC_TRACE_REC
+{
+    EC_T_UINT64         qwCycle;                            /* job task cycle counter */
+    EC_T_UINT64         qwStartNsec;                        /* CLOCK_MONOTONIC, job task running */
+    EC_T_DWORD          adwNsec[CYC_TRACE_METRIC_CNT];      /* CYC_TRACE_WAKEUP .. CYC_TRACE_TOTAL */
+    EC_T_DWORD          dwFlags;                            /* CYC_TRACE_FLAG_xxx */
+    EC_T_DWORD          dwMissed;                           /* deadlines missed by the timing task before this cycle */
+} T_CYC_TRACE_REC;
+
+typedef struct _T_CYC_TRACE_METRIC
+{
+    EC_T_UINT64         qwCount;
+    EC_T_DWORD          dwMin;
+    EC_T_DWORD          dwP50;
+    EC_T_DWORD          dwP99;
+    EC_T_DWORD          dwP999;
+    EC_T_DWORD          dwMax;
+    EC_T_DWORD          dwAvg;
+} T_CYC_TRACE_METRIC;
+
+typedef struct _T_CYC_TRACE_SNAPSHOT
+{
+    EC_T_UINT64         qwCycles;                           /* records aggregated */
+    EC_T_UINT64         qwDropped;                          /* records dropped (ring full) */
+    EC_T_UINT64         qwFrameLoss;                        /* cycles with CYC_TRACE_FLAG_FRAME_LOSS */
+    EC_T_UINT64         qwOverruns;                         /* cycles with CYC_TRACE_FLAG_OVERRUN */
+    EC_T_UINT64         qwMissed;                           /* timing task deadlines missed */
+    T_CYC_TRACE_METRIC  aMetric[CYC_TRACE_METRIC_CNT];
+    EC_T_DWORD          dwWorstCnt;
+    T_CYC_TRACE_REC     aWorst[CYC_TRACE_WORST_N];          /* sorted, worst first (by DISPATCH + TOTAL) */
+} T_CYC_TRACE_SNAPSHOT;
+
+/*-CLASS---------------------------------------------------------------------*/
+class CEcCycleTrace
+{
+public:
+    CEcCycleTrace();
+    ~CEcCycleTrace();
+
+    EC_T_DWORD  Start(EC_T_CPUSET CpuSet, EC_T_DWORD dwPrio, EC_T_DWORD dwPeriodMsec = CYC_TRACE_DEFAULT_PERIOD);
+    EC_T_VOID   Stop(EC_T_VOID);
+    EC_T_BOOL   IsRunning(EC_T_VOID) { return m_bRunning; }
+
+    /* timing task: called right after the timer wakeup, dwMissed = deadlines passed while the task was late */
+    EC_T_VOID   TimerWakeup(EC_T_UINT64 qwDeadlineNsec, EC_T_UINT64 qwWakeNsec, EC_T_DWORD dwMissed = 0);
+
+    /* job task: one Begin()/Mark()/End() sequence per cycle, no locks, no allocation */
+    EC_T_VOID   Begin(EC_T_VOID);
+    EC_T_VOID   Mark(EC_T_DWORD dwMetric);                  /* duration since Begin() or the previous Mark() */
+    EC_T_VOID   Skip(EC_T_VOID);                            /* restart the phase clock without recording */
+    EC_T_VOID   SetFlags(EC_T_DWORD dwFlags) { m_oCur.dwFlags |= dwFlags; }
+    EC_T_VOID   End(EC_T_VOID);
+
+    /* consumer side */
+    EC_T_VOID   GetSnapshot(T_CYC_TRACE_SNAPSHOT* pSnapshot, EC_T_BOOL bReset = EC_FALSE);
+    EC_T_DWORD  DumpCsv(const EC_T_CHAR* szFileName);
+
+    static const EC_T_CHAR* MetricName(EC_T_DWORD dwMetric);
+    static EC_T_UINT64 NowNsec(EC_T_VOID);
+
+private:
+    EC_T_VOID   Drain(EC_T_VOID);
+    EC_T_VOID   Aggregate(const T_CYC_TRACE_REC* pRec);
+    EC_T_VOID   ResetStats(EC_T_VOID);
+    EC_T_VOID   AggregatorTask(EC_T_VOID);
+
+    static EC_T_VOID AggregatorTaskWrapper(EC_T_VOID* pvParms);
+
+private:
+    /* producer (job task) */
+    T_CYC_TRACE_REC     m_oCur;
+    EC_T_UINT64         m_qwCycle;
+    EC_T_UINT64         m_qwPhaseNsec;
+    EC_T_UINT64         m_qwDeadlineSeen;                   /* deadline used by the previous cycle */
+    volatile EC_T_UINT64 m_qwDropped;
+
+    /* timing task -> job task: deadline of the last wakeup and its latency */
+    volatile EC_T_UINT64 m_qwDeadlineNsec;
+    volatile EC_T_DWORD m_dwWakeupNsec;
+    volatile EC_T_DWORD m_dwMissed;
+
+    /* SPSC ring, indices are free running */
+    T_CYC_TRACE_REC*    m_aRing;
+    volatile EC_T_DWORD m_dwHead;                           /* written by the job task */
+    volatile EC_T_DWORD m_dwTail;                           /* written by the aggregator */
+
+    /* aggregated data, protected by m_poLock */
+    EC_T_VOID*          m_poLock;
+    EC_T_UINT64*        m_aqwHist;                          /* CYC_TRACE_METRIC_CNT * CYC_TRACE_HIST_BUCKETS */
+    EC_T_UINT64         m_aqwSum[CYC_TRACE_METRIC_CNT];
+    EC_T_DWORD          m_adwMin[CYC_TRACE_METRIC_CNT];
+    EC_T_DWORD          m_adwMax[CYC_TRACE_METRIC_CNT];
+    EC_T_UINT64         m_qwCycles;
+    EC_T_UINT64         m_qwFrameLoss;
+    EC_T_UINT64         m_qwOverruns;
+    EC_T_UINT64         m_qwMissed;
+    EC_T_UINT64         m_qwDroppedBase;                    /* m_qwDropped at the last reset */
+    EC_T_DWORD          m_dwWorstCnt;
+    T_CYC_TRACE_REC     m_aWorst[CYC_TRACE_WORST_N];
+    T_CYC_TRACE_REC*    m_aHistory;
+    EC_T_DWORD          m_dwHistoryCnt;                     /* total records written to m_aHistory */
+
+    EC_T_DWORD          m_dwPeriodMsec;
+    EC_T_VOID*          m_pvThread;
+    volatile EC_T_BOOL  m_bShutdown;
+    volatile EC_T_BOOL  m_bThreadRunning;
+    volatile EC_T_BOOL  m_bRunning;
+};
+
+#endif /* INC_ECCYCLETRACE_H */
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
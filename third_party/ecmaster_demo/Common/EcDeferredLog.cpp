@@ -0,0 +1,939 @@
+/*-----------------------------------------------------------------------------
+ * EcDeferredLog.cpp
+ * Description              Deferred binary logging (no formatting in the caller's thread)
+ *---------------------------------------------------------------------------*/
+
+/*-LOGGING-------------------------------------------------------------------*/
+#define pEcLogParms G_pEcLogParms
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+#include "EcDeferredLog.h"
+#include <stddef.h>
+#include <time.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define DEFLOG_RING_MASK            (DEFLOG_RING_SIZE - 1)
+#define DEFLOG_SIG_CACHE_MASK       (DEFLOG_SIG_CACHE_SIZE - 1)
+#define DEFLOG_MSG_SIZE             512     /* formatted message, same as MAX_MESSAGE_SIZE of CAtEmLogging */
+#define DEFLOG_SPEC_SIZE            32      /* one conversion specification, e.g. "%-08.3llx" */
+#define DEFLOG_STOP_TIMEOUT         2000    /* ms */
+#define DEFLOG_ARGS_TEXT            0xFF    /* T_DEFLOG_REC::byArgCnt: achText holds the formatted message */
+#define DEFLOG_TRUNC_MARK           "...(truncated)\n"
+
+/* producer <-> formatter ring indices (single producer / single consumer) */
+#define DEFLOG_LOAD_ACQ(p)          __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define DEFLOG_STORE_REL(p, v)      __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+/* m_bRunning <-> m_dwProducers: a caller either sees m_bRunning cleared or Stop() sees it counted */
+#define DEFLOG_LOAD_SEQ(p)          __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define DEFLOG_STORE_SEQ(p, v)      __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+
+/* argument kinds, read with va_arg() of the matching type */
+#define DEFLOG_KIND_PERCENT         0       /* "%%", no argument */
+#define DEFLOG_KIND_INT             1       /* int and everything promoted to int (c, hh, h) */
+#define DEFLOG_KIND_LONG            2       /* l */
+#define DEFLOG_KIND_LLONG           3       /* ll, q */
+#define DEFLOG_KIND_SIZE            4       /* z */
+#define DEFLOG_KIND_PTRDIFF         5       /* t */
+#define DEFLOG_KIND_INTMAX          6       /* j */
+#define DEFLOG_KIND_DOUBLE          7       /* e, f, g, a */
+#define DEFLOG_KIND_PTR             8       /* p */
+#define DEFLOG_KIND_STR             9       /* s, copied into T_DEFLOG_REC::achText */
+#define DEFLOG_KIND_INVALID         0xFF    /* n, L, wide characters, unknown: formatted by the caller */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+typedef union _T_DEFLOG_ARG
+{
+    EC_T_INT            n;
+    long                l;
+    long long           ll;
+    size_t              z;
+    ptrdiff_t           t;
+    intmax_t            j;
+    double              d;
+    const EC_T_VOID*    pv;
+    EC_T_DWORD          dwTextOffset;                       /* DEFLOG_KIND_STR */
+} T_DEFLOG_ARG;
+
+/* one message, written by the calling thread */
+typedef struct _T_DEFLOG_REC
+{
+    const EC_T_CHAR*    szFormat;
+    EC_T_UINT64         qwTimeNsec;                         /* CLOCK_MONOTONIC, merge order of the threads */
+    EC_T_DWORD          dwLogLevel;
+    EC_T_BYTE           byArgCnt;                           /* DEFLOG_ARGS_TEXT: pre-formatted */
+    EC_T_BYTE           abyKind[DEFLOG_MAX_ARGS];
+    T_DEFLOG_ARG        aArg[DEFLOG_MAX_ARGS];
+    EC_T_CHAR           achText[DEFLOG_TEXT_SIZE];          /* %s arguments, zero terminated, or the pre-formatted message */
+} T_DEFLOG_REC;
+
+/* argument kinds of one format string */
+typedef struct _T_DEFLOG_SIG
+{
+    const EC_T_CHAR*    szFormat;
+    EC_T_BYTE           byArgCnt;                           /* DEFLOG_ARGS_TEXT: format not supported */
+    EC_T_BYTE           abyKind[DEFLOG_MAX_ARGS];
+} T_DEFLOG_SIG;
+
+/* rate limit window of one format string */
+typedef struct _T_DEFLOG_RATE
+{
+    const EC_T_CHAR* volatile szFormat;                     /* written by the owner thread, quoted by the formatter */
+    EC_T_UINT64         qwWindowStartNsec;
+    EC_T_DWORD          dwWindowCnt;
+    EC_T_DWORD          dwLogLevel;
+    volatile EC_T_UINT64 qwSuppressed;                      /* written by the owner thread */
+    EC_T_UINT64         qwSuppressedReported;               /* formatter only */
+} T_DEFLOG_RATE;
+
+/* one conversion specification of a format string */
+typedef struct _T_DEFLOG_SPEC
+{
+    const EC_T_CHAR*    pszStart;                           /* '%' */
+    EC_T_DWORD          dwLen;
+    EC_T_DWORD          dwStars;                            /* '*' width/precision: int arguments in front of the value */
+    EC_T_BYTE           byKind;
+} T_DEFLOG_SPEC;
+
+typedef struct _T_DEFLOG_RING
+{
+    T_DEFLOG_REC        aRec[DEFLOG_RING_SIZE];
+    volatile EC_T_DWORD dwHead;                             /* written by the owner thread */
+    volatile EC_T_DWORD dwTail;                             /* written by the formatter */
+    volatile EC_T_BOOL  bOrphan;                            /* owner thread exited, released by the formatter once empty */
+
+    /* owner thread only */
+    T_DEFLOG_SIG        aSig[DEFLOG_SIG_CACHE_SIZE];
+    T_DEFLOG_RATE       aRate[DEFLOG_RATE_SLOTS];           /* rate limit: one window per format string */
+
+    /* written by the owner thread, read by GetStats() */
+    volatile EC_T_UINT64 qwDropped;
+    volatile EC_T_UINT64 qwSuppressed;
+    volatile EC_T_UINT64 qwPreformatted;
+    volatile EC_T_UINT64 qwTruncated;
+
+    /* formatter only */
+    EC_T_UINT64         qwSuppressedReportNsec;
+} T_DEFLOG_RING;
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_UINT64 DefLogNowNsec(EC_T_VOID)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (EC_T_UINT64)ts.tv_sec * 1000000000ull + (EC_T_UINT64)ts.tv_nsec;
+}
+
+/* next conversion specification at or after *ppszPos, EC_FALSE at the end of the format string */
+static EC_T_BOOL DefLogNextSpec(const EC_T_CHAR** ppszPos, T_DEFLOG_SPEC* pSpec)
+{
+    const EC_T_CHAR* psz = *ppszPos;
+    EC_T_DWORD dwLength  = 0;                               /* 1: h/hh, 2: l, 3: ll/q, 4: z, 5: t, 6: j, 7: L */
+
+    while (('\0' != *psz) && ('%' != *psz))
+    {
+        psz++;
+    }
+    if ('\0' == *psz)
+    {
+        *ppszPos = psz;
+        return EC_FALSE;
+    }
+    pSpec->pszStart = psz++;
+    pSpec->dwStars  = 0;
+    pSpec->byKind   = DEFLOG_KIND_INVALID;
+
+    /* flags, width, precision */
+    while (('-' == *psz) || ('+' == *psz) || (' ' == *psz) || ('#' == *psz) || ('0' == *psz) || ('\'' == *psz))
+    {
+        psz++;
+    }
+    for (; ('*' == *psz) || ('.' == *psz) || ((*psz >= '0') && (*psz <= '9')); psz++)
+    {
+        pSpec->dwStars += ('*' == *psz) ? 1 : 0;
+    }
+    /* length modifier */
+    switch (*psz)
+    {
+    case 'h': dwLength = 1; psz += ('h' == psz[1]) ? 2 : 1; break;
+    case 'l': dwLength = ('l' == psz[1]) ? 3 : 2; psz += ('l' == psz[1]) ? 2 : 1; break;
+    case 'q': dwLength = 3; psz++; break;
+    case 'z': dwLength = 4; psz++; break;
+    case 't': dwLength = 5; psz++; break;
+    case 'j': dwLength = 6; psz++; break;
+    case 'L': dwLength = 7; psz++; break;
+    default: break;
+    }
+    /* conversion */
+    switch (*psz)
+    {
+    case '%':
+        pSpec->byKind = (psz == pSpec->pszStart + 1) ? DEFLOG_KIND_PERCENT : DEFLOG_KIND_INVALID;
+        break;
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        {
+            static const EC_T_BYTE S_abyIntKind[7] = { DEFLOG_KIND_INT, DEFLOG_KIND_INT, DEFLOG_KIND_LONG, DEFLOG_KIND_LLONG,
+                                                       DEFLOG_KIND_SIZE, DEFLOG_KIND_PTRDIFF, DEFLOG_KIND_INTMAX };
+            pSpec->byKind = (dwLength < 7) ? S_abyIntKind[dwLength] : DEFLOG_KIND_INVALID;
+        }
+        break;
+    case 'c':
+        pSpec->byKind = (0 == dwLength) ? DEFLOG_KIND_INT : DEFLOG_KIND_INVALID;
+        break;
+    case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        pSpec->byKind = ((0 == dwLength) || (2 == dwLength)) ? DEFLOG_KIND_DOUBLE : DEFLOG_KIND_INVALID;
+        break;
+    case 'p':
+        pSpec->byKind = (0 == dwLength) ? DEFLOG_KIND_PTR : DEFLOG_KIND_INVALID;
+        break;
+    case 's':
+        pSpec->byKind = (0 == dwLength) ? DEFLOG_KIND_STR : DEFLOG_KIND_INVALID;
+        break;
+    default:
+        break;
+    }
+    if ('\0' != *psz)
+    {
+        psz++;
+    }
+    pSpec->dwLen = (EC_T_DWORD)(psz - pSpec->pszStart);
+    *ppszPos = psz;
+    return EC_TRUE;
+}
+
+/* argument kinds of szFormat */
+static EC_T_VOID DefLogBuildSig(const EC_T_CHAR* szFormat, T_DEFLOG_SIG* pSig)
+{
+    const EC_T_CHAR* pszPos = szFormat;
+    T_DEFLOG_SPEC    oSpec;
+    EC_T_DWORD       dwArgCnt = 0;
+    EC_T_DWORD       dwIdx    = 0;
+
+    pSig->szFormat = szFormat;
+    pSig->byArgCnt = DEFLOG_ARGS_TEXT;
+    while (DefLogNextSpec(&pszPos, &oSpec))
+    {
+        if (DEFLOG_KIND_PERCENT == oSpec.byKind)
+        {
+            continue;
+        }
+        if ((DEFLOG_KIND_INVALID == oSpec.byKind) || (oSpec.dwLen >= DEFLOG_SPEC_SIZE) || (dwArgCnt + oSpec.dwStars + 1 > DEFLOG_MAX_ARGS))
+        {
+            return;
+        }
+        for (dwIdx = 0; dwIdx < oSpec.dwStars; dwIdx++)
+        {
+            pSig->abyKind[dwArgCnt++] = DEFLOG_KIND_INT;
+        }
+        pSig->abyKind[dwArgCnt++] = oSpec.byKind;
+    }
+    pSig->byArgCnt = (EC_T_BYTE)dwArgCnt;
+}
+
+/* caller: format the whole message into pRec->achText, EC_TRUE if it had to be cut */
+static EC_T_BOOL DefLogPreformat(T_DEFLOG_REC* pRec, const EC_T_CHAR* szFormat, EC_T_VALIST vaArgs)
+{
+    EC_T_INT nLen = OsVsnprintf(pRec->achText, (EC_T_INT)sizeof(pRec->achText), szFormat, vaArgs);
+
+    pRec->byArgCnt = DEFLOG_ARGS_TEXT;
+    if (nLen < (EC_T_INT)sizeof(pRec->achText))
+    {
+        return EC_FALSE;
+    }
+    OsMemcpy(&pRec->achText[sizeof(pRec->achText) - sizeof(DEFLOG_TRUNC_MARK)], DEFLOG_TRUNC_MARK, sizeof(DEFLOG_TRUNC_MARK));
+    return EC_TRUE;
+}
+
+/* format one conversion with its '*' arguments, returns the characters written */
+static EC_T_DWORD DefLogFormatArg(EC_T_CHAR* pszDst, EC_T_DWORD dwSize, const EC_T_CHAR* szSpec, EC_T_DWORD dwStars,
+    const T_DEFLOG_ARG* aStar, EC_T_BYTE byKind, const T_DEFLOG_ARG* pArg, const EC_T_CHAR* achText)
+{
+    EC_T_INT nLen = 0;
+
+#define DEFLOG_SNPRINTF(val)                                                                            \
+    nLen = (0 == dwStars) ? OsSnprintf(pszDst, (EC_T_INT)dwSize, szSpec, val)                           \
+         : (1 == dwStars) ? OsSnprintf(pszDst, (EC_T_INT)dwSize, szSpec, aStar[0].n, val)               \
+         :                  OsSnprintf(pszDst, (EC_T_INT)dwSize, szSpec, aStar[0].n, aStar[1].n, val)
+    switch (byKind)
+    {
+    case DEFLOG_KIND_INT:     DEFLOG_SNPRINTF(pArg->n);  break;
+    case DEFLOG_KIND_LONG:    DEFLOG_SNPRINTF(pArg->l);  break;
+    case DEFLOG_KIND_LLONG:   DEFLOG_SNPRINTF(pArg->ll); break;
+    case DEFLOG_KIND_SIZE:    DEFLOG_SNPRINTF(pArg->z);  break;
+    case DEFLOG_KIND_PTRDIFF: DEFLOG_SNPRINTF(pArg->t);  break;
+    case DEFLOG_KIND_INTMAX:  DEFLOG_SNPRINTF(pArg->j);  break;
+    case DEFLOG_KIND_DOUBLE:  DEFLOG_SNPRINTF(pArg->d);  break;
+    case DEFLOG_KIND_PTR:     DEFLOG_SNPRINTF(pArg->pv); break;
+    case DEFLOG_KIND_STR:     DEFLOG_SNPRINTF(&achText[pArg->dwTextOffset]); break;
+    default: break;
+    }
+#undef DEFLOG_SNPRINTF
+    if (nLen < 0)
+    {
+        return 0;
+    }
+    return EC_MIN((EC_T_DWORD)nLen, dwSize - 1);
+}
+
+/* formatter: record -> text */
+static EC_T_VOID DefLogFormat(const T_DEFLOG_REC* pRec, EC_T_CHAR* szMsg, EC_T_DWORD dwSize)
+{
+    const EC_T_CHAR* pszPos = pRec->szFormat;
+    const EC_T_CHAR* pszLit = pRec->szFormat;
+    EC_T_CHAR        szSpec[DEFLOG_SPEC_SIZE];
+    T_DEFLOG_SPEC    oSpec;
+    EC_T_DWORD       dwOut = 0;
+    EC_T_DWORD       dwArg = 0;
+    EC_T_DWORD       dwLen = 0;
+
+    if (DEFLOG_ARGS_TEXT == pRec->byArgCnt)
+    {
+        OsStrncpy(szMsg, pRec->achText, dwSize - 1);
+        szMsg[dwSize - 1] = '\0';
+        return;
+    }
+    while (DefLogNextSpec(&pszPos, &oSpec) && (dwOut < dwSize - 1))
+    {
+        /* literal text in front of the conversion */
+        dwLen = EC_MIN((EC_T_DWORD)(oSpec.pszStart - pszLit), dwSize - 1 - dwOut);
+        OsMemcpy(&szMsg[dwOut], pszLit, dwLen);
+        dwOut += dwLen;
+        pszLit = pszPos;
+        if (DEFLOG_KIND_PERCENT == oSpec.byKind)
+        {
+            if (dwOut < dwSize - 1)
+            {
+                szMsg[dwOut++] = '%';
+            }
+            continue;
+        }
+        OsMemcpy(szSpec, oSpec.pszStart, oSpec.dwLen);
+        szSpec[oSpec.dwLen] = '\0';
+        dwOut += DefLogFormatArg(&szMsg[dwOut], dwSize - dwOut, szSpec, oSpec.dwStars, &pRec->aArg[dwArg],
+            pRec->abyKind[dwArg + oSpec.dwStars], &pRec->aArg[dwArg + oSpec.dwStars], pRec->achText);
+        dwArg += oSpec.dwStars + 1;
+    }
+    dwLen = EC_MIN((EC_T_DWORD)OsStrlen(pszLit), dwSize - 1 - dwOut);
+    OsMemcpy(&szMsg[dwOut], pszLit, dwLen);
+    dwOut += dwLen;
+    szMsg[dwOut] = '\0';
+}
+
+/*-CLASS FUNCTIONS-----------------------------------------------------------*/
+/*****************************************************************************/
+/**
+ * \brief  Constructor. No OS resources are allocated before Start().
+ */
+CEcDeferredLog::CEcDeferredLog()
+    : m_dwRateBurst(DEFLOG_DEFAULT_BURST)
+    , m_qwRateWindowNsec((EC_T_UINT64)DEFLOG_DEFAULT_WINDOW * 1000000)
+    , m_bRingKeyValid(EC_FALSE)
+    , m_poRingLock(EC_NULL)
+    , m_dwProducers(0)
+    , m_bStopStuck(EC_FALSE)
+    , m_szMsg(EC_NULL)
+    , m_qwLogged(0)
+    , m_qwDroppedReported(0)
+    , m_qwDirect(0)
+    , m_dwPeriodMsec(DEFLOG_DEFAULT_PERIOD)
+    , m_pvThread(EC_NULL)
+    , m_bShutdown(EC_FALSE)
+    , m_bThreadRunning(EC_FALSE)
+    , m_bRunning(EC_FALSE)
+{
+    OsMemset(&m_oSink, 0, sizeof(m_oSink));
+    OsMemset(m_apRing, 0, sizeof(m_apRing));
+    OsMemset(&m_oRetired, 0, sizeof(m_oRetired));
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Destructor.
+ */
+CEcDeferredLog::~CEcDeferredLog()
+{
+    /* the formatter or a caller may still use the buffers if Stop() timed out, leak them */
+    if (EC_E_NOERROR == Stop())
+    {
+        SafeOsFree(m_szMsg);
+        SafeOsDeleteLock(m_poRingLock);
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Start the formatter thread. Messages are forwarded to pSinkParms->pfLogMsg.
+ *
+ * \return EC_E_NOERROR on success, error code otherwise.
+ */
+EC_T_DWORD CEcDeferredLog::Start(
+    const EC_T_LOG_PARMS* pSinkParms,   /**< [in] callback/context the formatted messages are forwarded to */
+    EC_T_CPUSET CpuSet,                 /**< [in] CPU set of the formatter thread */
+    EC_T_DWORD  dwPrio,                 /**< [in] priority of the formatter thread */
+    EC_T_DWORD  dwRateBurst,            /**< [in] messages with the same format passed per window, 0 = no rate limit */
+    EC_T_DWORD  dwRateWindowMsec,       /**< [in] rate limit window in ms */
+    EC_T_DWORD  dwPeriodMsec            /**< [in] formatter drain period in ms */
+                                        )
+{
+    EC_T_DWORD dwRetVal = EC_E_ERROR;
+
+    if (m_bRunning || m_bStopStuck)
+    {
+        return EC_E_INVALIDSTATE;
+    }
+    if ((EC_NULL == pSinkParms) || (EC_NULL == pSinkParms->pfLogMsg) || (pSinkParms->pfLogMsg == CEcDeferredLog::LogMsgCallback) || (0 == dwPeriodMsec))
+    {
+        dwRetVal = EC_E_INVALIDPARM;
+        goto Exit;
+    }
+    OsMemcpy(&m_oSink, pSinkParms, sizeof(EC_T_LOG_PARMS));
+    m_dwRateBurst      = (0 == dwRateBurst) ? 0xFFFFFFFF : dwRateBurst;
+    m_qwRateWindowNsec = (EC_T_UINT64)dwRateWindowMsec * 1000000;
+    m_dwPeriodMsec     = dwPeriodMsec;
+    m_bShutdown        = EC_FALSE;
+
+    if (EC_NULL == m_poRingLock)
+    {
+        m_poRingLock = OsCreateLock();
+    }
+    if (EC_NULL == m_szMsg)
+    {
+        m_szMsg = (EC_T_CHAR*)OsMalloc(DEFLOG_MSG_SIZE);
+    }
+    if ((EC_NULL == m_poRingLock) || (EC_NULL == m_szMsg))
+    {
+        dwRetVal = EC_E_NOMEMORY;
+        goto Exit;
+    }
+    if (0 != pthread_key_create(&m_oRingKey, CEcDeferredLog::ThreadExit))
+    {
+        dwRetVal = EC_E_NOMEMORY;
+        goto Exit;
+    }
+    m_bRingKeyValid = EC_TRUE;
+
+    m_bThreadRunning = EC_TRUE;
+    m_pvThread = OsCreateThread("tEcDeferredLog", (EC_PF_THREADENTRY)CEcDeferredLog::FormatterTaskWrapper,
+        CpuSet, dwPrio, LOG_THREAD_STACKSIZE, this);
+    if (EC_NULL == m_pvThread)
+    {
+        m_bThreadRunning = EC_FALSE;
+        dwRetVal = EC_E_ERROR;
+        goto Exit;
+    }
+    DEFLOG_STORE_SEQ(&m_bRunning, EC_TRUE);
+
+    dwRetVal = EC_E_NOERROR;
+Exit:
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        Stop();
+    }
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Forward all pending messages and stop the formatter thread.
+ *
+ * The rings are freed only once the formatter has exited and no caller is inside LogMsgVa(), a caller which
+ * passed the m_bRunning check before Stop() may still be writing its ring.
+ *
+ * \return EC_E_NOERROR, EC_E_TIMEOUT if the formatter or a caller did not leave in time (rings are kept).
+ */
+EC_T_DWORD CEcDeferredLog::Stop(EC_T_VOID)
+{
+    EC_T_DWORD dwIdx = 0;
+
+    if (m_bStopStuck)
+    {
+        return EC_E_TIMEOUT;
+    }
+    DEFLOG_STORE_SEQ(&m_bRunning, EC_FALSE);
+    m_bShutdown = EC_TRUE;
+    {
+        CEcTimer oTimeout(DEFLOG_STOP_TIMEOUT);
+        while ((m_bThreadRunning || (0 != DEFLOG_LOAD_SEQ(&m_dwProducers))) && !oTimeout.IsElapsed())
+        {
+            OsSleep(1);
+        }
+    }
+    if (m_bThreadRunning || (0 != DEFLOG_LOAD_SEQ(&m_dwProducers)))
+    {
+        /* keep the thread handle, the TLS key and the rings, the instance must not be deleted */
+        m_bStopStuck = EC_TRUE;
+        if (EC_NULL != m_oSink.pfLogMsg)
+        {
+            m_oSink.pfLogMsg(m_oSink.pLogContext, EC_LOG_LEVEL_ERROR, "%s",
+                "ERROR: deferred log: formatter or caller did not stop, rings are kept\n");
+        }
+        return EC_E_TIMEOUT;
+    }
+    if (EC_NULL != m_pvThread)
+    {
+        OsDeleteThreadHandle(m_pvThread);
+        m_pvThread = EC_NULL;
+    }
+    if (m_bRingKeyValid)
+    {
+        pthread_key_delete(m_oRingKey);
+        m_bRingKeyValid = EC_FALSE;
+    }
+    /* keep the counters of the freed rings for GetStats() after Stop() */
+    if (EC_NULL == m_poRingLock)
+    {
+        return EC_E_NOERROR;
+    }
+    OsLock(m_poRingLock);
+    for (dwIdx = 0; dwIdx < DEFLOG_MAX_THREADS; dwIdx++)
+    {
+        T_DEFLOG_RING* pRing = m_apRing[dwIdx];
+        if (EC_NULL != pRing)
+        {
+            m_oRetired.qwDropped      += pRing->qwDropped;
+            m_oRetired.qwSuppressed   += pRing->qwSuppressed;
+            m_oRetired.qwPreformatted += pRing->qwPreformatted;
+            m_oRetired.qwTruncated    += pRing->qwTruncated;
+            SafeOsFree(m_apRing[dwIdx]);
+        }
+    }
+    OsUnlock(m_poRingLock);
+    return EC_E_NOERROR;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Log parameters which route EcLogMsg() through this instance.
+ */
+EC_T_VOID CEcDeferredLog::GetLogParms(EC_T_LOG_PARMS* pLogParms, EC_T_DWORD dwLogLevel)
+{
+    pLogParms->dwLogLevel  = dwLogLevel;
+    pLogParms->pfLogMsg    = CEcDeferredLog::LogMsgCallback;
+    pLogParms->pLogContext = (struct _EC_T_LOG_CONTEXT*)this;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Allocate the ring of the calling thread.
+ *
+ * \return EC_E_NOERROR on success, EC_E_NOMEMORY if all DEFLOG_MAX_THREADS rings are in use.
+ */
+EC_T_DWORD CEcDeferredLog::RegisterThread(EC_T_VOID)
+{
+    T_DEFLOG_RING* pRing = GetRing(EC_TRUE);
+
+    if (EC_NULL != pRing)
+    {
+        /* prefault the ring */
+        OsMemset(pRing->aRec, 0, sizeof(pRing->aRec));
+    }
+    return (EC_NULL != pRing) ? EC_E_NOERROR : EC_E_NOMEMORY;
+}
+
+EC_T_VOID CEcDeferredLog::GetStats(T_DEFLOG_STATS* pStats)
+{
+    EC_T_DWORD dwIdx = 0;
+
+    OsMemset(pStats, 0, sizeof(T_DEFLOG_STATS));
+    if (EC_NULL == m_poRingLock)
+    {
+        return;
+    }
+    OsLock(m_poRingLock);
+    OsMemcpy(pStats, &m_oRetired, sizeof(T_DEFLOG_STATS));
+    for (dwIdx = 0; dwIdx < DEFLOG_MAX_THREADS; dwIdx++)
+    {
+        T_DEFLOG_RING* pRing = m_apRing[dwIdx];
+        if (EC_NULL != pRing)
+        {
+            pStats->qwDropped      += pRing->qwDropped;
+            pStats->qwSuppressed   += pRing->qwSuppressed;
+            pStats->qwPreformatted += pRing->qwPreformatted;
+            pStats->qwTruncated    += pRing->qwTruncated;
+            pStats->dwThreads++;
+        }
+    }
+    pStats->qwLogged = m_qwLogged;
+    OsUnlock(m_poRingLock);
+    pStats->qwDirect = m_qwDirect;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  EC_T_LOG_PARMS::pfLogMsg: record the message, formatting is done by the formatter thread.
+ */
+EC_T_DWORD EC_FNCALL CEcDeferredLog::LogMsgCallback(struct _EC_T_LOG_CONTEXT* pContext, EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, ...)
+{
+    EC_T_DWORD  dwRetVal = EC_E_ERROR;
+    EC_T_VALIST vaArgs;
+
+    if ((EC_NULL == pContext) || (EC_NULL == szFormat))
+    {
+        return EC_E_INVALIDPARM;
+    }
+    EC_VASTART(vaArgs, szFormat);
+    dwRetVal = ((CEcDeferredLog*)pContext)->LogMsgVa(dwLogMsgSeverity, szFormat, vaArgs);
+    EC_VAEND(vaArgs);
+    return dwRetVal;
+}
+
+EC_T_DWORD CEcDeferredLog::LogMsgVa(EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, EC_T_VALIST vaArgs)
+{
+    T_DEFLOG_RING* pRing    = EC_NULL;
+    EC_T_DWORD     dwRetVal = EC_E_NOERROR;
+
+    /* counted while the ring is used, Stop() does not free the rings before the count is 0 */
+    __atomic_fetch_add(&m_dwProducers, 1, __ATOMIC_SEQ_CST);
+    pRing = DEFLOG_LOAD_SEQ(&m_bRunning) ? GetRing(EC_TRUE) : EC_NULL;
+    if (EC_NULL != pRing)
+    {
+        dwRetVal = Record(pRing, dwLogMsgSeverity, szFormat, vaArgs);
+    }
+    __atomic_fetch_sub(&m_dwProducers, 1, __ATOMIC_RELEASE);
+
+    if (EC_NULL == pRing)
+    {
+        /* not started or no ring left: format in the calling thread */
+        EC_T_CHAR szMsg[DEFLOG_MSG_SIZE];
+
+        OsVsnprintf(szMsg, sizeof(szMsg), szFormat, vaArgs);
+        __atomic_fetch_add(&m_qwDirect, 1, __ATOMIC_RELAXED);
+        if (EC_NULL != m_oSink.pfLogMsg)
+        {
+            m_oSink.pfLogMsg(m_oSink.pLogContext, dwLogMsgSeverity, "%s", szMsg);
+        }
+    }
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Write one message into the calling thread's ring.
+ */
+EC_T_DWORD CEcDeferredLog::Record(T_DEFLOG_RING* pRing, EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, EC_T_VALIST vaArgs)
+{
+    T_DEFLOG_REC*  pRec      = EC_NULL;
+    T_DEFLOG_SIG*  pSig      = EC_NULL;
+    T_DEFLOG_RATE* pRate     = EC_NULL;
+    T_DEFLOG_RATE* pOldest   = &pRing->aRate[0];
+    EC_T_UINT64    qwNow     = 0;
+    EC_T_DWORD     dwHead    = 0;
+    EC_T_DWORD     dwText    = 0;
+    EC_T_DWORD     dwIdx     = 0;
+    EC_T_BOOL      bTextFull = EC_FALSE;
+    EC_T_VALIST    vaCopy;
+
+    /* rate limit: at most m_dwRateBurst messages with the same format per window,
+     * a format without a slot takes the one with the oldest window */
+    qwNow = DefLogNowNsec();
+    for (dwIdx = 0; dwIdx < DEFLOG_RATE_SLOTS; dwIdx++)
+    {
+        if (szFormat == pRing->aRate[dwIdx].szFormat)
+        {
+            pRate = &pRing->aRate[dwIdx];
+            break;
+        }
+        if (pRing->aRate[dwIdx].qwWindowStartNsec < pOldest->qwWindowStartNsec)
+        {
+            pOldest = &pRing->aRate[dwIdx];
+        }
+    }
+    if ((EC_NULL != pRate) && ((qwNow - pRate->qwWindowStartNsec) < m_qwRateWindowNsec))
+    {
+        if (++pRate->dwWindowCnt > m_dwRateBurst)
+        {
+            pRate->qwSuppressed = pRate->qwSuppressed + 1;
+            pRing->qwSuppressed = pRing->qwSuppressed + 1;
+            return EC_E_NOERROR;
+        }
+    }
+    else
+    {
+        pRate = (EC_NULL != pRate) ? pRate : pOldest;
+        pRate->szFormat          = szFormat;
+        pRate->qwWindowStartNsec = qwNow;
+        pRate->dwWindowCnt       = 1;
+        pRate->dwLogLevel        = dwLogMsgSeverity;
+    }
+
+    dwHead = pRing->dwHead;
+    if ((dwHead - DEFLOG_LOAD_ACQ(&pRing->dwTail)) >= DEFLOG_RING_SIZE)
+    {
+        pRing->qwDropped = pRing->qwDropped + 1;
+        return EC_E_NOMEMORY;
+    }
+    pRec = &pRing->aRec[dwHead & DEFLOG_RING_MASK];
+
+    /* argument kinds, parsed once per format string */
+    pSig = &pRing->aSig[((EC_T_UINT64)(size_t)szFormat >> 2) & DEFLOG_SIG_CACHE_MASK];
+    if (pSig->szFormat != szFormat)
+    {
+        DefLogBuildSig(szFormat, pSig);
+    }
+
+    pRec->szFormat     = szFormat;
+    pRec->qwTimeNsec   = qwNow;
+    pRec->dwLogLevel   = dwLogMsgSeverity;
+    pRec->byArgCnt     = pSig->byArgCnt;
+    if (DEFLOG_ARGS_TEXT == pSig->byArgCnt)
+    {
+        if (DefLogPreformat(pRec, szFormat, vaArgs))
+        {
+            pRing->qwTruncated = pRing->qwTruncated + 1;
+        }
+        pRing->qwPreformatted = pRing->qwPreformatted + 1;
+    }
+    else
+    {
+        /* the %s arguments may not fit into achText, keep the arguments to pre-format the message then */
+        va_copy(vaCopy, vaArgs);
+        for (dwIdx = 0; (dwIdx < pSig->byArgCnt) && !bTextFull; dwIdx++)
+        {
+            T_DEFLOG_ARG* pArg = &pRec->aArg[dwIdx];
+
+            pRec->abyKind[dwIdx] = pSig->abyKind[dwIdx];
+            switch (pSig->abyKind[dwIdx])
+            {
+            case DEFLOG_KIND_INT:     pArg->n  = EC_VAARG(vaArgs, EC_T_INT);         break;
+            case DEFLOG_KIND_LONG:    pArg->l  = EC_VAARG(vaArgs, long);             break;
+            case DEFLOG_KIND_LLONG:   pArg->ll = EC_VAARG(vaArgs, long long);        break;
+            case DEFLOG_KIND_SIZE:    pArg->z  = EC_VAARG(vaArgs, size_t);           break;
+            case DEFLOG_KIND_PTRDIFF: pArg->t  = EC_VAARG(vaArgs, ptrdiff_t);        break;
+            case DEFLOG_KIND_INTMAX:  pArg->j  = EC_VAARG(vaArgs, intmax_t);         break;
+            case DEFLOG_KIND_DOUBLE:  pArg->d  = EC_VAARG(vaArgs, double);           break;
+            case DEFLOG_KIND_PTR:     pArg->pv = EC_VAARG(vaArgs, const EC_T_VOID*); break;
+            case DEFLOG_KIND_STR:
+                {
+                    const EC_T_CHAR* szStr = EC_VAARG(vaArgs, const EC_T_CHAR*);
+
+                    /* no room for the whole string: format the message here instead of cutting the string */
+                    if (dwText >= DEFLOG_TEXT_SIZE)
+                    {
+                        bTextFull = EC_TRUE;
+                        break;
+                    }
+                    pArg->dwTextOffset = dwText;
+                    szStr = (EC_NULL == szStr) ? "(null)" : szStr;
+                    while (('\0' != *szStr) && (dwText < DEFLOG_TEXT_SIZE - 1))
+                    {
+                        pRec->achText[dwText++] = *szStr++;
+                    }
+                    pRec->achText[dwText++] = '\0';
+                    bTextFull = ('\0' != *szStr);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        if (bTextFull)
+        {
+            if (DefLogPreformat(pRec, szFormat, vaCopy))
+            {
+                pRing->qwTruncated = pRing->qwTruncated + 1;
+            }
+            pRing->qwPreformatted = pRing->qwPreformatted + 1;
+        }
+        EC_VAEND(vaCopy);
+    }
+    DEFLOG_STORE_REL(&pRing->dwHead, dwHead + 1);
+    return EC_E_NOERROR;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Ring of the calling thread, allocated on first use if bCreate.
+ */
+T_DEFLOG_RING* CEcDeferredLog::GetRing(EC_T_BOOL bCreate)
+{
+    T_DEFLOG_RING* pRing = EC_NULL;
+    EC_T_DWORD     dwIdx = 0;
+
+    if (!m_bRingKeyValid)
+    {
+        return EC_NULL;
+    }
+    pRing = (T_DEFLOG_RING*)pthread_getspecific(m_oRingKey);
+    if ((EC_NULL != pRing) || !bCreate)
+    {
+        return pRing;
+    }
+
+    OsLock(m_poRingLock);
+    for (dwIdx = 0; dwIdx < DEFLOG_MAX_THREADS; dwIdx++)
+    {
+        if (EC_NULL == m_apRing[dwIdx])
+        {
+            pRing = (T_DEFLOG_RING*)OsMalloc(sizeof(T_DEFLOG_RING));
+            if (EC_NULL != pRing)
+            {
+                OsMemset(pRing, 0, sizeof(T_DEFLOG_RING));
+                m_apRing[dwIdx] = pRing;
+                pthread_setspecific(m_oRingKey, pRing);
+            }
+            break;
+        }
+    }
+    OsUnlock(m_poRingLock);
+    return pRing;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  TLS destructor: the owner thread exits, its ring is released once drained.
+ */
+EC_T_VOID CEcDeferredLog::ThreadExit(EC_T_VOID* pvRing)
+{
+    DEFLOG_STORE_REL(&((T_DEFLOG_RING*)pvRing)->bOrphan, EC_TRUE);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Formatter: forward all recorded messages in time stamp order.
+ *
+ * \return number of messages forwarded.
+ */
+EC_T_DWORD CEcDeferredLog::Drain(EC_T_VOID)
+{
+    T_DEFLOG_RING* apRing[DEFLOG_MAX_THREADS];
+    EC_T_DWORD     dwForwarded = 0;
+    EC_T_DWORD     dwIdx       = 0;
+    T_DEFLOG_STATS oStats;
+
+    /* rings are only freed by this thread, the copy stays valid during the drain */
+    OsLock(m_poRingLock);
+    OsMemcpy(apRing, m_apRing, sizeof(apRing));
+    OsUnlock(m_poRingLock);
+
+    for (;;)
+    {
+        T_DEFLOG_RING* pOldest = EC_NULL;
+        T_DEFLOG_REC*  pRec    = EC_NULL;
+
+        /* merge: oldest head record of all rings */
+        for (dwIdx = 0; dwIdx < DEFLOG_MAX_THREADS; dwIdx++)
+        {
+            T_DEFLOG_RING* pRing = apRing[dwIdx];
+            if ((EC_NULL == pRing) || (pRing->dwTail == DEFLOG_LOAD_ACQ(&pRing->dwHead)))
+            {
+                continue;
+            }
+            if ((EC_NULL == pOldest) || (pRing->aRec[pRing->dwTail & DEFLOG_RING_MASK].qwTimeNsec < pOldest->aRec[pOldest->dwTail & DEFLOG_RING_MASK].qwTimeNsec))
+            {
+                pOldest = pRing;
+            }
+        }
+        if (EC_NULL == pOldest)
+        {
+            break;
+        }
+        pRec = &pOldest->aRec[pOldest->dwTail & DEFLOG_RING_MASK];
+        DefLogFormat(pRec, m_szMsg, DEFLOG_MSG_SIZE);
+        Forward(pRec->dwLogLevel, m_szMsg);
+        DEFLOG_STORE_REL(&pOldest->dwTail, pOldest->dwTail + 1);
+        dwForwarded++;
+    }
+
+    /* rate limit summary at most once per window and thread, release the rings of exited threads */
+    OsLock(m_poRingLock);
+    for (dwIdx = 0; dwIdx < DEFLOG_MAX_THREADS; dwIdx++)
+    {
+        T_DEFLOG_RING* pRing = m_apRing[dwIdx];
+        EC_T_BOOL      bRelease = EC_FALSE;
+
+        if (EC_NULL == pRing)
+        {
+            continue;
+        }
+        bRelease = DEFLOG_LOAD_ACQ(&pRing->bOrphan) && (pRing->dwTail == DEFLOG_LOAD_ACQ(&pRing->dwHead));
+        ReportSuppressed(pRing, bRelease || m_bShutdown);
+        if (bRelease)
+        {
+            m_oRetired.qwDropped      += pRing->qwDropped;
+            m_oRetired.qwSuppressed   += pRing->qwSuppressed;
+            m_oRetired.qwPreformatted += pRing->qwPreformatted;
+            m_oRetired.qwTruncated    += pRing->qwTruncated;
+            SafeOsFree(m_apRing[dwIdx]);
+        }
+    }
+    m_qwLogged += dwForwarded;
+    OsUnlock(m_poRingLock);
+
+    /* report lost messages once per drain */
+    GetStats(&oStats);
+    if (oStats.qwDropped != m_qwDroppedReported)
+    {
+        OsSnprintf(m_szMsg, DEFLOG_MSG_SIZE, "WARNING: deferred log: %llu messages dropped (ring full)\n",
+            (unsigned long long)(oStats.qwDropped - m_qwDroppedReported));
+        Forward(EC_LOG_LEVEL_WARNING, m_szMsg);
+        m_qwDroppedReported = oStats.qwDropped;
+    }
+    return dwForwarded;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Formatter: number of messages collapsed by the rate limit since the last report, one line per format.
+ */
+EC_T_VOID CEcDeferredLog::ReportSuppressed(T_DEFLOG_RING* pRing, EC_T_BOOL bForce)
+{
+    EC_T_UINT64 qwNow  = DefLogNowNsec();
+    EC_T_DWORD  dwSlot = 0;
+
+    if (!bForce && ((qwNow - pRing->qwSuppressedReportNsec) < m_qwRateWindowNsec))
+    {
+        return;
+    }
+    for (dwSlot = 0; dwSlot < DEFLOG_RATE_SLOTS; dwSlot++)
+    {
+        T_DEFLOG_RATE*   pRate        = &pRing->aRate[dwSlot];
+        EC_T_UINT64      qwSuppressed = pRate->qwSuppressed;
+        const EC_T_CHAR* szFormat     = pRate->szFormat;
+        EC_T_DWORD       dwLen        = 0;
+
+        if (qwSuppressed == pRate->qwSuppressedReported)
+        {
+            continue;
+        }
+        /* the suppressed messages are not formatted, quote their format string without the line break
+         * (the slot's current format, a slot taken over by another format inside the window is reported under it) */
+        dwLen = (EC_T_DWORD)((EC_NULL == szFormat) ? 0 : OsStrlen(szFormat));
+        while ((dwLen > 0) && (('\n' == szFormat[dwLen - 1]) || ('\r' == szFormat[dwLen - 1])))
+        {
+            dwLen--;
+        }
+        OsSnprintf(m_szMsg, DEFLOG_MSG_SIZE, "(%llu repeated messages suppressed: \"%.*s\")\n",
+            (unsigned long long)(qwSuppressed - pRate->qwSuppressedReported), (EC_T_INT)EC_MIN(dwLen, (EC_T_DWORD)128), (EC_NULL == szFormat) ? "" : szFormat);
+        Forward(pRate->dwLogLevel, m_szMsg);
+        pRate->qwSuppressedReported = qwSuppressed;
+    }
+    pRing->qwSuppressedReportNsec = qwNow;
+}
+
+EC_T_VOID CEcDeferredLog::Forward(EC_T_DWORD dwLogLevel, const EC_T_CHAR* szMsg)
+{
+    m_oSink.pfLogMsg(m_oSink.pLogContext, dwLogLevel, "%s", szMsg);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Formatter thread: drain the rings periodically.
+ */
+EC_T_VOID CEcDeferredLog::FormatterTask(EC_T_VOID)
+{
+    while (!m_bShutdown)
+    {
+        OsSleep(m_dwPeriodMsec);
+        Drain();
+    }
+    Drain();
+    m_bThreadRunning = EC_FALSE;
+}
+
+EC_T_VOID CEcDeferredLog::FormatterTaskWrapper(EC_T_VOID* pvParms)
+{
+    ((CEcDeferredLog*)pvParms)->FormatterTask();
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,125 @@
+/*-----------------------------------------------------------------------------
+ * EcDeferredLog.h
+ * Description              Deferred binary logging (no formatting in the caller's thread)
+ *---------------------------------------------------------------------------*/
+
+/* =============================================================================
+ * 文件解读：
+ * EcLogMsg 原来在调用线程里同步 vsnprintf + 写日志缓冲 / tinylog，JobTask（MT_Workpd、frame loss 报错）
+ * 一旦连续报错，格式化和日志锁会把后面几个周期拖超时。本模块作为 EC_T_LOG_PARMS::pfLogMsg 挂在原有
+ * 日志回调前面：
+ * - 调用线程只记录格式串指针、时间戳和原始参数（%s 的内容拷贝进记录），写入本线程私有的
+ *   单生产者/单消费者环形缓冲：无锁、稳态无内存分配（环在线程第一次写日志或 RegisterThread() 时分配）
+ * - 格式串的参数类型表按格式串指针缓存在各线程的环里，同一条日志第二次起不再解析格式串
+ * - 后台格式化线程按时间戳合并各线程的记录，格式化后交给原来的回调（CAtEmLogging / tinylog）
+ * - 环满丢弃并计数；同一格式串在时间窗内超过 burst 条后被合并（每线程按格式串各计一个时间窗，最多
+ *   DEFLOG_RATE_SLOTS 个格式串同时限流），格式化线程每个时间窗输出一次“省略 N 条”
+ * - 不支持的格式（%n、long double、参数过多）或 %s 内容放不进记录时，退回到调用线程格式化成文本，仍然异步输出；
+ *   文本超过 DEFLOG_TEXT_SIZE 时截断并在行尾标出 "...(truncated)"，计入 qwTruncated
+ * - 环只在没有调用线程持有（进入 LogMsgVa 的线程计数为 0）且格式化线程已退出之后才释放；Stop() 超时则不释放
+ *
+ * 只用于 Linux（pthread TLS key 负责在线程退出时回收环）。
+ * ============================================================================= */
+
+#ifndef INC_ECDEFERREDLOG_H
+#define INC_ECDEFERREDLOG_H 1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#ifndef INC_ECMASTER
+#include "EcMaster.h"
+#endif
+
+#include <pthread.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define DEFLOG_MAX_THREADS          16      /* threads with a private ring, more threads log synchronously */
+#define DEFLOG_RING_SIZE            256     /* records per thread, power of 2 */
+#define DEFLOG_MAX_ARGS             12      /* arguments per message incl. '*' width/precision */
+#define DEFLOG_TEXT_SIZE            248     /* bytes per record for %s arguments or a pre-formatted message */
+#define DEFLOG_SIG_CACHE_SIZE       32      /* format signatures cached per thread, power of 2 */
+#define DEFLOG_RATE_SLOTS           8       /* formats rate limited at the same time per thread */
+#define DEFLOG_DEFAULT_PERIOD       5       /* ms, formatter drain period */
+#define DEFLOG_DEFAULT_BURST        8       /* messages with the same format passed per window */
+#define DEFLOG_DEFAULT_WINDOW       1000    /* ms, rate limit window */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+struct _T_DEFLOG_RING;
+
+typedef struct _T_DEFLOG_STATS
+{
+    EC_T_UINT64         qwLogged;                           /* messages forwarded to the sink */
+    EC_T_UINT64         qwDropped;                          /* messages lost (ring full) */
+    EC_T_UINT64         qwSuppressed;                       /* messages collapsed by the rate limit */
+    EC_T_UINT64         qwPreformatted;                     /* messages formatted by the caller (unsupported format, long %s) */
+    EC_T_UINT64         qwTruncated;                        /* pre-formatted messages cut at DEFLOG_TEXT_SIZE */
+    EC_T_UINT64         qwDirect;                           /* messages forwarded synchronously (no ring available) */
+    EC_T_DWORD          dwThreads;                          /* rings in use */
+} T_DEFLOG_STATS;
+
+/*-CLASS---------------------------------------------------------------------*/
+class CEcDeferredLog
+{
+public:
+    CEcDeferredLog();
+    ~CEcDeferredLog();
+
+    /* pSinkParms: callback the formatted messages are forwarded to (e.g. CAtEmLogging::LogMsgCallback) */
+    EC_T_DWORD  Start(const EC_T_LOG_PARMS* pSinkParms, EC_T_CPUSET CpuSet, EC_T_DWORD dwPrio,
+                      EC_T_DWORD dwRateBurst = DEFLOG_DEFAULT_BURST, EC_T_DWORD dwRateWindowMsec = DEFLOG_DEFAULT_WINDOW,
+                      EC_T_DWORD dwPeriodMsec = DEFLOG_DEFAULT_PERIOD);
+    /* all messages recorded so far are forwarded, the log parameters must no longer point to this instance;
+     * EC_E_TIMEOUT: the formatter or a caller is still inside, the rings are kept (do not delete the instance) */
+    EC_T_DWORD  Stop(EC_T_VOID);
+    EC_T_BOOL   IsRunning(EC_T_VOID) { return m_bRunning; }
+
+    /* EC_T_LOG_PARMS of this instance (pfLogMsg = LogMsgCallback, pLogContext = this) */
+    EC_T_VOID   GetLogParms(EC_T_LOG_PARMS* pLogParms, EC_T_DWORD dwLogLevel);
+
+    /* allocate the calling thread's ring up front, call once from real-time threads before the first cycle */
+    EC_T_DWORD  RegisterThread(EC_T_VOID);
+
+    EC_T_VOID   GetStats(T_DEFLOG_STATS* pStats);
+
+    /* EC_T_LOG_PARMS::pfLogMsg, pContext is the CEcDeferredLog instance */
+    static EC_T_DWORD EC_FNCALL LogMsgCallback(struct _EC_T_LOG_CONTEXT* pContext, EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, ...);
+
+private:
+    EC_T_DWORD  LogMsgVa(EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, EC_T_VALIST vaArgs);
+    EC_T_DWORD  Record(struct _T_DEFLOG_RING* pRing, EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, EC_T_VALIST vaArgs);
+    struct _T_DEFLOG_RING* GetRing(EC_T_BOOL bCreate);
+    EC_T_DWORD  Drain(EC_T_VOID);
+    EC_T_VOID   ReportSuppressed(struct _T_DEFLOG_RING* pRing, EC_T_BOOL bForce);
+    EC_T_VOID   Forward(EC_T_DWORD dwLogLevel, const EC_T_CHAR* szMsg);
+    EC_T_VOID   FormatterTask(EC_T_VOID);
+
+    static EC_T_VOID FormatterTaskWrapper(EC_T_VOID* pvParms);
+    static EC_T_VOID ThreadExit(EC_T_VOID* pvRing);
+
+private:
+    EC_T_LOG_PARMS      m_oSink;
+    EC_T_DWORD          m_dwRateBurst;
+    EC_T_UINT64         m_qwRateWindowNsec;
+
+    pthread_key_t       m_oRingKey;                         /* calling thread -> its ring */
+    EC_T_BOOL           m_bRingKeyValid;
+    struct _T_DEFLOG_RING* m_apRing[DEFLOG_MAX_THREADS];      /* slots claimed by the producers, released by the formatter */
+    EC_T_VOID*          m_poRingLock;                       /* ring allocation only, never taken per message */
+    volatile EC_T_DWORD m_dwProducers;                      /* threads inside LogMsgVa(), rings are not freed while > 0 */
+    EC_T_BOOL           m_bStopStuck;                       /* Stop() timed out, rings and buffers must not be freed */
+    T_DEFLOG_STATS      m_oRetired;                         /* counters of released rings, protected by m_poRingLock */
+
+    EC_T_CHAR*          m_szMsg;                            /* formatter output buffer */
+    EC_T_UINT64         m_qwLogged;
+    EC_T_UINT64         m_qwDroppedReported;
+    volatile EC_T_UINT64 m_qwDirect;
+
+    EC_T_DWORD          m_dwPeriodMsec;
+    EC_T_VOID*          m_pvThread;
+    volatile EC_T_BOOL  m_bShutdown;
+    volatile EC_T_BOOL  m_bThreadRunning;
+    volatile EC_T_BOOL  m_bRunning;
+};
+
+#endif /* INC_ECDEFERREDLOG_H */
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
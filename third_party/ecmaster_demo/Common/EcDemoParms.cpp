@@ -20,7 +20,14 @@ EC_T_VOID ResetAppParms(T_EC_DEMO_APP_CONTEXT* pAppContext, T_EC_DEMO_APP_PARMS*
 
     OsMemset(pAppParms, 0, sizeof(T_EC_DEMO_APP_PARMS));
     EC_CPUSET_ZERO(pAppParms->CpuSet);
-    pAppParms->dwJobsThreadPrio = JOBS_THREAD_PRIO;
+    pAppParms->aRtThread[DEMO_RT_THREAD_TIMER].dwPrio  = TIMER_THREAD_PRIO;
+    pAppParms->aRtThread[DEMO_RT_THREAD_JOB].dwPrio    = JOBS_THREAD_PRIO;
+    pAppParms->aRtThread[DEMO_RT_THREAD_NOTIFY].dwPrio = MAIN_THREAD_PRIO;
+    pAppParms->aRtThread[DEMO_RT_THREAD_LOG].dwPrio    = LOG_THREAD_PRIO;
+    pAppParms->bRtMemLock        = EC_TRUE;
+    pAppParms->dwRtSpinUsec      = 0;
+    pAppParms->dwRtOverrunPolicy = DEMO_RT_OVERRUN_SKIP;
+    pAppParms->bCmdConsole       = EC_TRUE;
     pAppParms->dwJobsThreadStackSize = JOBS_THREAD_STACKSIZE;
     G_dwJobsThreadStackSize = JOBS_THREAD_STACKSIZE;
 
@@ -32,6 +39,12 @@ EC_T_VOID ResetAppParms(T_EC_DEMO_APP_CONTEXT* pAppContext, T_EC_DEMO_APP_PARMS*
     pAppParms->dwBusCycleTimeUsec = DEFAULT_BUS_CYCLE_TIME_USEC;
     pAppParms->dwDemoDuration = DEFAULT_DEMO_DURATION;
     pAppParms->bConnectHcGroups = EC_TRUE;
+    pAppParms->bDeferredLog = EC_TRUE;
+    pAppParms->dwDefLogRateBurst = DEFLOG_DEFAULT_BURST;
+    pAppParms->dwDefLogRateWindowMsec = DEFLOG_DEFAULT_WINDOW;
+    pAppParms->dwPcapMmapSegmentMb = PCAP_MMAP_DEFAULT_SEGMENT_MB;
+    pAppParms->dwPcapMmapSegmentSec = PCAP_MMAP_DEFAULT_SEGMENT_SEC;
+    pAppParms->dwPcapMmapMaxSegments = PCAP_MMAP_DEFAULT_MAX_SEGMENTS;
 
 #if (defined INCLUDE_EC_LOGGING)
     pAppParms->dwLogBufferMaxMsgCnt = DEFAULT_LOG_MSG_BUFFER_SIZE;
@@ -651,6 +664,34 @@ EC_T_DWORD SetAppParmsFromCommandLine(T_EC_DEMO_APP_CONTEXT* pAppContext, const
                 bGetNextWord = EC_FALSE;
             }
         }
+        else if (0 == OsStricmp(ptcWord, "-deflog"))
+        {
+            ptcWord = OsStrtok(EC_NULL, " ");
+            if ((ptcWord == EC_NULL) || (OsStrncmp(ptcWord, "-", 1) == 0) || (OsStrncmp(ptcWord, "@", 1) == 0))
+            {
+                dwRetVal = EC_E_INVALIDPARM;
+                goto Exit;
+            }
+            if (0 == OsStricmp(ptcWord, "off"))
+            {
+                pAppParms->bDeferredLog = EC_FALSE;
+            }
+            else
+            {
+                pAppParms->bDeferredLog = EC_TRUE;
+                pAppParms->dwDefLogRateBurst = OsStrtol(ptcWord, EC_NULL, 0);
+
+                ptcWord = OsStrtok(EC_NULL, " ");
+                if ((ptcWord != EC_NULL) && (OsStrncmp(ptcWord, "-", 1) != 0) && (OsStrncmp(ptcWord, "@", 1) != 0))
+                {
+                    pAppParms->dwDefLogRateWindowMsec = OsStrtol(ptcWord, EC_NULL, 0);
+                }
+                else
+                {
+                    bGetNextWord = EC_FALSE;
+                }
+            }
+        }
         else if (0 == OsStricmp(ptcWord, "-mbxsrv"))
         {
             ptcWord = OsStrtok(EC_NULL, " ");
@@ -773,6 +814,35 @@ EC_T_DWORD SetAppParmsFromCommandLine(T_EC_DEMO_APP_CONTEXT* pAppContext, const
             }
         }
 #endif /* INCLUDE_PCAP_RECORDER || INCLUDE_EC_MONITOR */
+#if (defined INCLUDE_FRAME_SPY)
+        else if (0 == OsStricmp(ptcWord, "-pcapmmap"))
+        {
+            EC_T_DWORD* apdwOpt[] = { &pAppParms->dwPcapMmapSegmentMb, &pAppParms->dwPcapMmapSegmentSec, &pAppParms->dwPcapMmapMaxSegments };
+            EC_T_DWORD  dwOptIdx = 0;
+
+            ptcWord = OsStrtok(EC_NULL, " ");
+            if ((ptcWord == EC_NULL) || (OsStrncmp(ptcWord, "-", 1) == 0) || (OsStrncmp(ptcWord, "@", 1) == 0)
+                || (OsStrlen(ptcWord) >= sizeof(pAppParms->szPcapMmapPrefix)))
+            {
+                dwRetVal = EC_E_INVALIDPARM;
+                goto Exit;
+            }
+            pAppParms->bPcapMmap = EC_TRUE;
+            OsSnprintf(pAppParms->szPcapMmapPrefix, sizeof(pAppParms->szPcapMmapPrefix), "%s", ptcWord);
+
+            /* segment MB, segment sec, max segments (each optional) */
+            for (dwOptIdx = 0; dwOptIdx < sizeof(apdwOpt) / sizeof(apdwOpt[0]); dwOptIdx++)
+            {
+                ptcWord = OsStrtok(EC_NULL, " ");
+                if ((ptcWord == EC_NULL) || (OsStrncmp(ptcWord, "-", 1) == 0) || (OsStrncmp(ptcWord, "@", 1) == 0))
+                {
+                    bGetNextWord = EC_FALSE;
+                    break;
+                }
+                *apdwOpt[dwOptIdx] = OsStrtol(ptcWord, EC_NULL, 0);
+            }
+        }
+#endif /* INCLUDE_FRAME_SPY */
         else if (0 == OsStricmp(ptcWord, "-rem"))
         {
             const EC_T_CHAR* ptcTmp = EC_NULL;
@@ -894,6 +964,43 @@ EC_T_DWORD SetAppParmsFromCommandLine(T_EC_DEMO_APP_CONTEXT* pAppContext, const
         {
             pAppParms->bMasterRedPermanentStandby = EC_TRUE;
         }
+        else if (0 == OsStricmp(ptcWord, "-rtspin"))
+        {
+            ptcWord = OsStrtok(EC_NULL, " ");
+            if ((ptcWord == EC_NULL) || (OsStrncmp(ptcWord, "-", 1) == 0) || (OsStrncmp(ptcWord, "@", 1) == 0))
+            {
+                dwRetVal = EC_E_INVALIDPARM;
+                goto Exit;
+            }
+            pAppParms->dwRtSpinUsec = OsStrtol(ptcWord, EC_NULL, 0);
+        }
+        else if (0 == OsStricmp(ptcWord, "-rtoverrun"))
+        {
+            ptcWord = OsStrtok(EC_NULL, " ");
+            if      ((ptcWord != EC_NULL) && (0 == OsStricmp(ptcWord, "skip")))    pAppParms->dwRtOverrunPolicy = DEMO_RT_OVERRUN_SKIP;
+            else if ((ptcWord != EC_NULL) && (0 == OsStricmp(ptcWord, "catchup"))) pAppParms->dwRtOverrunPolicy = DEMO_RT_OVERRUN_CATCHUP;
+            else if ((ptcWord != EC_NULL) && (0 == OsStricmp(ptcWord, "resync")))  pAppParms->dwRtOverrunPolicy = DEMO_RT_OVERRUN_RESYNC;
+            else
+            {
+                dwRetVal = EC_E_INVALIDPARM;
+                goto Exit;
+            }
+        }
+        else if (0 == OsStricmp(ptcWord, "-rtclock"))
+        {
+            ptcWord = OsStrtok(EC_NULL, " ");
+            if ((ptcWord == EC_NULL) || (OsStrncmp(ptcWord, "-", 1) == 0) || (OsStrncmp(ptcWord, "@", 1) == 0))
+            {
+                dwRetVal = EC_E_INVALIDPARM;
+                goto Exit;
+            }
+            pAppParms->bRtSharedClock = EC_TRUE;
+            pAppParms->dwRtClockOffsetUsec = OsStrtol(ptcWord, EC_NULL, 0);
+        }
+        else if (0 == OsStricmp(ptcWord, "-nocmd"))
+        {
+            pAppParms->bCmdConsole = EC_FALSE;
+        }
         else if (0 == OsStricmp(ptcWord, "-t"))
         {
             ptcWord = OsStrtok(EC_NULL, " ");
@@ -1162,6 +1269,13 @@ EC_T_VOID ShowSyntaxCommon(T_EC_DEMO_APP_CONTEXT* pAppContext)
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     time            Time in msec, 0 = forever (default = %d)\n", DEFAULT_DEMO_DURATION));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -b                Bus cycle time\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     cycle time      Cycle time in usec\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -rtspin           Hybrid wakeup of the timing task\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     time            Spin time before the deadline in usec, 0 = sleep only (default)\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -rtoverrun        Timing task overrun policy\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     policy          skip (default) | catchup | resync\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -rtclock          Start cycles on multiples of the cycle time (phase alignment of several instances)\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     offset          Phase offset of this instance in usec\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -nocmd            Do not read motrotech commands from stdin (all but one instance per process)\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -a                CPU affinity\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     affinity        0 = first CPU, 1 = second, ...\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -v                Set verbosity level\n"));
@@ -1172,6 +1286,16 @@ EC_T_VOID ShowSyntaxCommon(T_EC_DEMO_APP_CONTEXT* pAppContext)
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -log              Use given file name prefix for log files\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     prefix          Prefix\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "    [msg cnt]        Messages count for log buffer allocation (default = %d, with %d bytes per message)\n", DEFAULT_LOG_MSG_BUFFER_SIZE, MAX_MESSAGE_SIZE));
+#endif
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -deflog           Deferred logging (formatting in the log thread, enabled by default)\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     burst|off       Messages with the same format per window, 0 = no rate limit (default = %d), off = synchronous logging\n", DEFLOG_DEFAULT_BURST));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "    [window]         Rate limit window in msec (default = %d)\n", DEFLOG_DEFAULT_WINDOW));
+#if (defined INCLUDE_FRAME_SPY)
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -pcapmmap         Capture frames into memory-mapped pcap segment files (<prefix>.<n>.pcap, numbering continues after existing files)\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     prefix          Segment file prefix, may contain a directory\n"));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "    [segMB]          Segment size in MB (default = %d)\n", PCAP_MMAP_DEFAULT_SEGMENT_MB));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "    [segSec]         Rotate after n seconds, 0 = by size only (default = %d)\n", PCAP_MMAP_DEFAULT_SEGMENT_SEC));
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "    [maxSeg]         Keep the newest n segments incl. earlier runs, 0 = keep all (default = %d)\n", PCAP_MMAP_DEFAULT_MAX_SEGMENTS));
 #endif
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "   -lic              Use License key\n"));
     EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "     key             License key\n"));
@@ -1201,4 +1325,14 @@ EC_T_VOID ShowSyntaxCommon(T_EC_DEMO_APP_CONTEXT* pAppContext)
 #endif
 }
 
+/* CPU set of a demo thread (DEMO_RT_THREAD_xxx), falls back to the common CPU set */
+EC_T_CPUSET GetRtThreadCpuSet(T_EC_DEMO_APP_PARMS* pAppParms, EC_T_DWORD dwThread)
+{
+    if ((dwThread < DEMO_RT_THREAD_CNT) && !EC_CPUSET_IS_ZERO(pAppParms->aRtThread[dwThread].CpuSet))
+    {
+        return pAppParms->aRtThread[dwThread].CpuSet;
+    }
+    return pAppParms->CpuSet;
+}
+
 /*-END OF SOURCE FILE--------------------------------------------------------*/
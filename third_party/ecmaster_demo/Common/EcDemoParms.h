@@ -51,14 +51,33 @@
 /* Motion */
 #define DEMO_CFG_DEFAULT_FILENAME                   (EC_T_CHAR*)"DemoConfig.xml"
 
+/* real-time mode: threads configured by T_EC_DEMO_APP_PARMS::aRtThread[] */
+#define DEMO_RT_THREAD_TIMER                   0    /* timing task (tDemoTimingTask) */
+#define DEMO_RT_THREAD_JOB                     1    /* job task (EcMasterJobTask) */
+#define DEMO_RT_THREAD_NOTIFY                  2    /* EcDemoApp() main loop (notifications, diagnosis) and SDO pipeline */
+#define DEMO_RT_THREAD_LOG                     3    /* message logging (tAtEmLog), cycle trace aggregator, pcap segments */
+#define DEMO_RT_THREAD_CNT                     4
+
+/* real-time mode: timing task reaction if a deadline has already passed when the next cycle is scheduled */
+#define DEMO_RT_OVERRUN_SKIP                   0    /* drop the missed cycles, stay on the original time grid */
+#define DEMO_RT_OVERRUN_CATCHUP                1    /* trigger the missed cycles back-to-back (at most DEMO_RT_CATCHUP_MAX) */
+#define DEMO_RT_OVERRUN_RESYNC                 2    /* restart the time grid at "now" */
+#define DEMO_RT_CATCHUP_MAX                    4    /* more missed cycles are resynchronized */
+
 /*-TYPEDEFS------------------------------------------------------------------*/
+/* scheduling of one demo thread */
+typedef struct _T_EC_DEMO_RT_THREAD
+{
+    EC_T_DWORD          dwPrio;                         /* SCHED_FIFO priority (1 lowest .. 99 highest) */
+    EC_T_CPUSET         CpuSet;                         /* CPU affinity, EC_CPUSET_ZERO: T_EC_DEMO_APP_PARMS::CpuSet */
+} T_EC_DEMO_RT_THREAD;
+
 /* demo application parameters */
 typedef struct _T_EC_DEMO_APP_PARMS
 {
     EC_T_OS_PARMS       Os;                             /* operating system parameters */
     EC_T_DWORD          dwCpuIndex;                     /* CPU index */
     EC_T_CPUSET         CpuSet;                         /* CPU-set for SMP systems */
-    EC_T_DWORD          dwJobsThreadPrio;               /* JobTask priority (default: JOBS_THREAD_PRIO) */
     EC_T_DWORD          dwJobsThreadStackSize;          /* JobTask stack size (default: JOBS_THREAD_STACKSIZE) */
 
     /* link layer */
@@ -75,15 +94,30 @@ typedef struct _T_EC_DEMO_APP_PARMS
     /* timing */
     EC_T_DWORD          dwBusCycleTimeUsec;             /* bus cycle time in usec */
     EC_T_DWORD          dwDemoDuration;                 /* demo duration in msec */
+    /* real-time mode */
+    T_EC_DEMO_RT_THREAD aRtThread[DEMO_RT_THREAD_CNT];  /* priority/affinity per thread, see DEMO_RT_THREAD_xxx */
+    EC_T_BOOL           bRtMemLock;                     /* lock all memory and prefault the stack at startup */
+    EC_T_DWORD          dwRtSpinUsec;                   /* hybrid wakeup: sleep until n usec before the deadline, then spin (0: sleep only) */
+    EC_T_DWORD          dwRtOverrunPolicy;              /* DEMO_RT_OVERRUN_xxx */
+    EC_T_BOOL           bRtSharedClock;                 /* start the time grid on multiples of the cycle time (CLOCK_MONOTONIC), phase aligned across instances */
+    EC_T_DWORD          dwRtClockOffsetUsec;            /* phase offset of this instance on the shared time grid in usec */
     /* logging */
     EC_T_INT            nVerbose;                       /* verbosity level */
     EC_T_DWORD          dwAppLogLevel;                  /* demo application log level (derived from verbosity level) */
     EC_T_DWORD          dwMasterLogLevel;               /* Master / Monitor / Simulator stack log level (derived from verbosity level) */
     EC_T_CHAR           szLogFileprefix[64];            /* log file prefix string */
     EC_T_DWORD          dwLogBufferMaxMsgCnt;           /* max number of buffered messages (DEFAULT_LOG_MSG_BUFFER_SIZE)  */
+    EC_T_BOOL           bDeferredLog;                   /* cyclic threads only record messages, formatted by the log thread */
+    EC_T_DWORD          dwDefLogRateBurst;              /* messages with the same format passed per window (0: no rate limit) */
+    EC_T_DWORD          dwDefLogRateWindowMsec;         /* rate limit window in msec */
     EC_T_BOOL           bPcapRecorder;                  /* EtherCAT packet capture in pcap format (wireshark) enabled */
     EC_T_CHAR           szPcapRecorderFileprefix[64];   /* log file prefix string */
     EC_T_DWORD          dwPcapRecorderBufferFrameCnt;   /* max number of buffered frames */
+    EC_T_BOOL           bPcapMmap;                      /* capture into preallocated memory-mapped pcap segments */
+    EC_T_CHAR           szPcapMmapPrefix[128];          /* segment file prefix (path), ".<n>.pcap" is appended */
+    EC_T_DWORD          dwPcapMmapSegmentMb;            /* segment size in MB (rotation by size) */
+    EC_T_DWORD          dwPcapMmapSegmentSec;           /* rotate after n seconds (0: by size only) */
+    EC_T_DWORD          dwPcapMmapMaxSegments;          /* keep the newest n closed segments (0: keep all) */
     /* RAS */
     EC_T_BOOL           bStartRasServer;
     EC_T_BYTE           abyRasServerIpAddress[4];       /* Remote Access Server (RAS) listen IP address */
@@ -105,6 +139,7 @@ typedef struct _T_EC_DEMO_APP_PARMS
     EC_T_BOOL           bMasterRedPermanentStandby;     /* Master redundancy instance in permanent standby */
     /* additional parameters for the different demos */
     EC_T_DWORD          dwMasterInstanceId;             /* Master instance id */
+    EC_T_BOOL           bCmdConsole;                    /* motrotech command console on stdin (only one instance per process) */
     EC_T_DWORD          dwPerfMeasLevel;                /* performance measurement level */
     EC_T_BOOL           bPerfMeasShowCyclic;            /* show performance values cyclically  */
     EC_T_WORD           bFlash;                         /* flashing process data (Master: OUTPUTs / Simulator: INPUTs) */
@@ -188,6 +223,33 @@ typedef struct _T_EC_DEMO_APP_CONTEXT
     struct _T_MASTER_RED_DEMO_PARMS* pMasterRedParms;   /* Master redundancy parameters */
     struct _T_EC_MONITOR_DEMO_PARMS* pMonitorParms;     /* EC-Monitor parameters */
     EC_T_VOID*                pTimingTaskContext;       /* Timing Task Context for various Busshift, Mastershift, MasterRefClock and DCX.Mastershift mode */
+#if (defined __cplusplus)
+    class CEcSdoPipeline*     pSdoPipeline;             /* asynchronous CoE SDO pipeline */
+#else
+    struct _T_CEcSdoPipeline* pSdoPipeline;             /* asynchronous CoE SDO pipeline */
+#endif
+#if (defined __cplusplus)
+    class CEcCycleTrace*      pCycleTrace;              /* per-cycle timing trace, owned by the caller of EcDemoApp() */
+#else
+    struct _T_CEcCycleTrace*  pCycleTrace;              /* per-cycle timing trace, owned by the caller of EcDemoApp() */
+#endif
+#if (defined __cplusplus)
+    class CEcDeferredLog*     pDeferredLog;             /* deferred logging, threads register their ring, owned by the caller */
+#else
+    struct _T_CEcDeferredLog* pDeferredLog;             /* deferred logging, threads register their ring, owned by the caller */
+#endif
+#if (defined __cplusplus)
+    class CEcPcapMmapRecorder* pPcapMmap;               /* memory-mapped pcap segment recorder, owned by the caller */
+#else
+    struct _T_CEcPcapMmapRecorder* pPcapMmap;           /* memory-mapped pcap segment recorder, owned by the caller */
+#endif
+#if (defined __cplusplus)
+    class CMtMasterAccess*    pMasterAccess;            /* master access used by motrotech (EC-Master or simulated), owned by EcDemoApp() */
+#else
+    struct _T_CMtMasterAccess* pMasterAccess;           /* master access used by motrotech (EC-Master or simulated), owned by EcDemoApp() */
+#endif
+    struct _T_MT_CONTEXT*     pMtContext;               /* motrotech axis tables of this instance, owned by the caller of EcDemoApp() */
+    volatile EC_T_BOOL        bInstanceRun;             /* run flag of this instance (bRun stops all instances) */
 } T_EC_DEMO_APP_CONTEXT;
 
 /*-GLOBAL VARIABLES-----------------------------------------------------------*/
@@ -203,6 +265,7 @@ EC_T_DWORD SetAppParmsFromCommandLine(T_EC_DEMO_APP_CONTEXT* pAppContext, const
 EC_T_DWORD SetAppParmsFromCommandLine(T_EC_DEMO_APP_CONTEXT* pAppContext, const EC_T_CHAR* szCommandLine, T_EC_DEMO_APP_PARMS* pAppParms, EC_T_CHAR** pszNextCommandLine);
 #endif
 EC_T_VOID  ShowSyntaxCommon(T_EC_DEMO_APP_CONTEXT* pAppContext);
+EC_T_CPUSET GetRtThreadCpuSet(T_EC_DEMO_APP_PARMS* pAppParms, EC_T_DWORD dwThread);
 
 /**
  * \brief convert a string to an unsigned long long
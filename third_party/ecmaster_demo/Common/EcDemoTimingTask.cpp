@@ -67,6 +67,11 @@ EC_T_VOID* CDemoTimingEvent::GetRaw()
 CDemoTimingTask::CDemoTimingTask()
     : m_pAppContext(EC_NULL)
     , m_dwCpuIndex(0)
+    , m_dwPrio(TIMER_THREAD_PRIO)
+    , m_dwSpinNsec(0)
+    , m_dwOverrunPolicy(DEMO_RT_OVERRUN_SKIP)
+    , m_bSharedClock(EC_FALSE)
+    , m_dwClockOffsetNsec(0)
     , m_dwInstanceId(0)
     , m_nCycleTimeNsec(1000)
     , m_nOriginalCycleTimeNsec(1000)
@@ -75,11 +80,20 @@ CDemoTimingTask::CDemoTimingTask()
     , m_pvTimingThread(EC_NULL)
     , m_oTimingEvent()
 {
+    OsMemset(&m_oStats, 0, sizeof(m_oStats));
+    EC_CPUSET_ZERO(m_CpuSet);
+    EC_CPUSET_SET(m_CpuSet, m_dwCpuIndex);
 }
 
 CDemoTimingTask::CDemoTimingTask(_T_EC_DEMO_APP_CONTEXT& rAppContext)
     : m_pAppContext(&rAppContext)
     , m_dwCpuIndex(m_pAppContext->AppParms.dwCpuIndex)
+    , m_CpuSet(GetRtThreadCpuSet(&m_pAppContext->AppParms, DEMO_RT_THREAD_TIMER))
+    , m_dwPrio(m_pAppContext->AppParms.aRtThread[DEMO_RT_THREAD_TIMER].dwPrio)
+    , m_dwSpinNsec(m_pAppContext->AppParms.dwRtSpinUsec * 1000)
+    , m_dwOverrunPolicy(m_pAppContext->AppParms.dwRtOverrunPolicy)
+    , m_bSharedClock(m_pAppContext->AppParms.bRtSharedClock)
+    , m_dwClockOffsetNsec(m_pAppContext->AppParms.dwRtClockOffsetUsec * 1000)
     , m_dwInstanceId(m_pAppContext->AppParms.dwMasterInstanceId)
     , m_nCycleTimeNsec(1000)
     , m_nOriginalCycleTimeNsec(1000)
@@ -88,6 +102,11 @@ CDemoTimingTask::CDemoTimingTask(_T_EC_DEMO_APP_CONTEXT& rAppContext)
     , m_pvTimingThread(EC_NULL)
     , m_oTimingEvent()
 {
+    OsMemset(&m_oStats, 0, sizeof(m_oStats));
+    if (EC_CPUSET_IS_ZERO(m_CpuSet))
+    {
+        EC_CPUSET_SET(m_CpuSet, m_dwCpuIndex);
+    }
     if (m_pAppContext)
     {
         m_pAppContext->pTimingTaskContext = this;
@@ -129,6 +148,7 @@ EC_T_DWORD CDemoTimingTask::StartTimingTask(EC_T_INT nCycleTimeNsec)
     m_nOriginalCycleTimeNsec = m_nCycleTimeNsec;
     m_bShutdown = EC_FALSE;
     m_bIsRunning = EC_FALSE;
+    OsMemset(&m_oStats, 0, sizeof(m_oStats));
 
     EC_T_DWORD ret = CreateTimingEvent();
     if (ret != EC_E_NOERROR)
@@ -183,9 +203,24 @@ EC_T_DWORD CDemoTimingTask::StopTimingTask()
     
     DeleteTimingEvent();
 
+    if (0 != m_oStats.qwOverruns)
+    {
+        EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING,
+            "Timing task: %llu cycles, %llu overruns, %llu deadlines missed (skipped %llu, caught up %llu, resync %llu), max. latency %u usec\n",
+            (unsigned long long)m_oStats.qwCycles, (unsigned long long)m_oStats.qwOverruns, (unsigned long long)m_oStats.qwMissed,
+            (unsigned long long)m_oStats.qwSkipped, (unsigned long long)m_oStats.qwCatchUp, (unsigned long long)m_oStats.qwResync,
+            m_oStats.dwMaxLateNsec / 1000));
+    }
+
     return EC_E_NOERROR;
 }
 
+EC_T_VOID CDemoTimingTask::GetStats(T_DEMO_TIMING_STATS* pStats)
+{
+    /* counters are written by the timing task, values may be a cycle apart while it is running */
+    OsMemcpy(pStats, &m_oStats, sizeof(T_DEMO_TIMING_STATS));
+}
+
 CDemoTimingTask::~CDemoTimingTask()
 {
     CDemoTimingTask::StopTimingTask();
@@ -198,16 +233,13 @@ CDemoTimingTask::~CDemoTimingTask()
 EC_T_DWORD CDemoTimingTask::CreateThread()
 {
     EC_T_CHAR   szThreadName[20];
-    EC_T_CPUSET CpuSet;
 
-    EC_CPUSET_ZERO(CpuSet);
-    EC_CPUSET_SET(CpuSet, m_dwCpuIndex);
     OsSnprintf(szThreadName, sizeof(szThreadName) - 1, "tDemoTimingTask_%d", m_dwInstanceId);
 
     m_pvTimingThread = OsCreateThread(szThreadName,
                                             (EC_PF_THREADENTRY)CDemoTimingTask::TimingTaskWrapper,
-                                            CpuSet,
-                                            TIMER_THREAD_PRIO,
+                                            m_CpuSet,
+                                            m_dwPrio,
                                             TIMER_THREAD_STACKSIZE,
                                             this);
     return m_pvTimingThread != EC_NULL ? EC_E_NOERROR : EC_E_ERROR;
@@ -232,6 +264,7 @@ EC_T_VOID CDemoTimingTask::TimingTask()
 
         /* trigger jobtask */
         SetTimingEvent();
+        m_oStats.qwCycles++;
     }
     m_bIsRunning = EC_FALSE;
 }
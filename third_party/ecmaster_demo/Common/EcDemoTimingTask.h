@@ -13,6 +13,18 @@
 
 struct _T_EC_DEMO_APP_CONTEXT;
 
+/* timing task deadline statistics (see DEMO_RT_OVERRUN_xxx) */
+typedef struct _T_DEMO_TIMING_STATS
+{
+    EC_T_UINT64 qwCycles;                 /* timing events set */
+    EC_T_UINT64 qwOverruns;               /* wakeups after the following deadline had already passed */
+    EC_T_UINT64 qwMissed;                 /* deadlines passed while the timing task was late */
+    EC_T_UINT64 qwSkipped;                /* DEMO_RT_OVERRUN_SKIP: cycles dropped */
+    EC_T_UINT64 qwCatchUp;                /* DEMO_RT_OVERRUN_CATCHUP: cycles triggered late, back-to-back */
+    EC_T_UINT64 qwResync;                 /* time grid restarted (DEMO_RT_OVERRUN_RESYNC or catch-up limit exceeded) */
+    EC_T_DWORD  dwMaxLateNsec;            /* worst wakeup latency */
+} T_DEMO_TIMING_STATS;
+
 class CDemoTimingEvent
 {
 public:
@@ -39,6 +51,7 @@ public:
     virtual EC_T_DWORD StartTimingTask(EC_T_INT nCycleTimeNsec);
     virtual EC_T_DWORD AdjustCycleTime(EC_T_INT nAdjustPermil);
     virtual EC_T_DWORD StopTimingTask();//~CDemoTimingTask() calls StopTimingTask() if overriden the destructor of the derived class must also call its StopTimingTask()
+    EC_T_VOID          GetStats(T_DEMO_TIMING_STATS* pStats);
     virtual ~CDemoTimingTask();
 
 protected:
@@ -49,9 +62,16 @@ protected:
 
 protected:
     _T_EC_DEMO_APP_CONTEXT* m_pAppContext;
+    T_DEMO_TIMING_STATS     m_oStats;     /* written by the timing task only */
 
 public:
     EC_T_DWORD m_dwCpuIndex;              /* SMP systems: CPU index */
+    EC_T_CPUSET m_CpuSet;                 /* timing task affinity (AppParms.aRtThread[DEMO_RT_THREAD_TIMER]) */
+    EC_T_DWORD m_dwPrio;                  /* timing task priority (AppParms.aRtThread[DEMO_RT_THREAD_TIMER]) */
+    EC_T_DWORD m_dwSpinNsec;              /* hybrid wakeup: spin time before the deadline, 0 = sleep only */
+    EC_T_DWORD m_dwOverrunPolicy;         /* DEMO_RT_OVERRUN_xxx */
+    EC_T_BOOL  m_bSharedClock;            /* deadlines on multiples of the cycle time + m_dwClockOffsetNsec (AppParms.bRtSharedClock) */
+    EC_T_DWORD m_dwClockOffsetNsec;       /* phase offset on the shared time grid */
     EC_T_DWORD m_dwInstanceId;
     EC_T_INT   m_nCycleTimeNsec;          /* Cycle Time to use in nano seconds */
     EC_T_INT   m_nOriginalCycleTimeNsec;  /* Original cycle time in nano seconds */
@@ -0,0 +1,1100 @@
+/*-----------------------------------------------------------------------------
+ * EcPcapMmap.cpp
+ * Description              Memory-mapped pcap segment recorder and indexed pcap reader
+ *---------------------------------------------------------------------------*/
+
+/*-LOGGING-------------------------------------------------------------------*/
+#define pEcLogParms G_pEcLogParms
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+#include "EcPcapMmap.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define PCAP_MMAP_STOP_TIMEOUT      2000    /* ms */
+#define PCAP_MMAP_SPIN_LIMIT        256     /* LogFrame() spins this often on the lock, then yields */
+#define PCAP_MMAP_YIELD_LIMIT       8       /* ... and drops the frame after this many yields */
+#define PCAP_MMAP_NAME_SIZE         (PCAP_MMAP_PREFIX_SIZE + 16)
+#define PCAP_MAGIC_USEC_SWAPPED     0xd4c3b2a1  /* written on a host with the other byte order */
+#define PCAP_MAGIC_NSEC_SWAPPED     0x4d3cb2a1
+
+/* T_PCAP_MMAP_SEG::dwState */
+#define PCAP_SEG_FREE               0       /* not mapped */
+#define PCAP_SEG_READY              1       /* mapped, file header written, waiting for rotation */
+#define PCAP_SEG_ACTIVE             2       /* written by LogFrame() */
+#define PCAP_SEG_FULL               3       /* rotated out, retired when the last writer left */
+
+#define PCAP_MMAP_LOAD_ACQ(p)       __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define PCAP_MMAP_STORE_REL(p, v)   __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define PCAP_MMAP_ADD(p, v)         __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+
+/* EtherCAT frame layout */
+#define ETHTYPE_VLAN                0x8100
+#define ETHTYPE_ECAT                0x88A4
+#define ECAT_HDR_LEN                2       /* length (11 bit), reserved, type */
+#define ECAT_DGRAM_HDR_LEN          10      /* cmd, idx, address, length/flags, irq */
+#define ECAT_DGRAM_WKC_LEN          2
+#define ECAT_DGRAM_LEN_MASK         0x07FF
+#define ECAT_DGRAM_MORE             0x8000
+#define ECAT_CMD_LRD                10
+#define ECAT_CMD_LWR                11
+#define ECAT_CMD_LRW                12
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+typedef struct _T_PCAP_MMAP_SEG
+{
+    EC_T_INT            nFd;
+    EC_T_BYTE*          pbyMap;
+    EC_T_UINT64         qwUsed;                             /* reserved bytes incl. file header, protected by the spin lock */
+    EC_T_UINT64         qwRotateNsec;                       /* time based rotation deadline, set on activation */
+    volatile EC_T_DWORD dwWriters;                          /* LogFrame() calls still copying into the segment */
+    volatile EC_T_DWORD dwState;                            /* PCAP_SEG_* */
+    EC_T_DWORD          dwSeq;                              /* segment file number */
+} T_PCAP_MMAP_SEG;
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_UINT64 PcapNowNsec(EC_T_VOID)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (EC_T_UINT64)ts.tv_sec * 1000000000ULL + (EC_T_UINT64)ts.tv_nsec;
+}
+
+static EC_INLINESTART EC_T_WORD PcapGetBe16(const EC_T_BYTE* pby)
+{
+    return (EC_T_WORD)((pby[0] << 8) | pby[1]);
+} EC_INLINESTOP
+
+static EC_INLINESTART EC_T_WORD PcapGetLe16(const EC_T_BYTE* pby)
+{
+    return (EC_T_WORD)(pby[0] | (pby[1] << 8));
+} EC_INLINESTOP
+
+static EC_INLINESTART EC_T_DWORD PcapGetLe32(const EC_T_BYTE* pby)
+{
+    return (EC_T_DWORD)pby[0] | ((EC_T_DWORD)pby[1] << 8) | ((EC_T_DWORD)pby[2] << 16) | ((EC_T_DWORD)pby[3] << 24);
+} EC_INLINESTOP
+
+static EC_INLINESTART EC_T_BOOL PcapIsLogicalCmd(EC_T_BYTE byCmd)
+{
+    return (EC_T_BOOL)((ECAT_CMD_LRD == byCmd) || (ECAT_CMD_LWR == byCmd) || (ECAT_CMD_LRW == byCmd));
+} EC_INLINESTOP
+
+/*-CLASS FUNCTIONS-----------------------------------------------------------*/
+/*****************************************************************************/
+/**
+ * \brief  Constructor. No OS resources are allocated before Start().
+ */
+CEcPcapMmapRecorder::CEcPcapMmapRecorder()
+    : m_qwSegmentSize(0)
+    , m_qwSegmentNsec(0)
+    , m_dwMaxSegments(PCAP_MMAP_DEFAULT_MAX_SEGMENTS)
+    , m_aSeg(EC_NULL)
+    , m_pActive(EC_NULL)
+    , m_dwLock(0)
+    , m_dwNextSeq(0)
+    , m_dwOldestSeq(0)
+    , m_dwClosedCnt(0)
+    , m_qwFrames(0)
+    , m_qwBytes(0)
+    , m_qwDropped(0)
+    , m_dwSegments(0)
+    , m_dwDeleted(0)
+    , m_dwErrors(0)
+    , m_dwPeriodMsec(PCAP_MMAP_DEFAULT_PERIOD)
+    , m_pvThread(EC_NULL)
+    , m_bShutdown(EC_FALSE)
+    , m_bThreadRunning(EC_FALSE)
+    , m_bRunning(EC_FALSE)
+{
+    OsMemset(m_szPrefix, 0, sizeof(m_szPrefix));
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Destructor.
+ */
+CEcPcapMmapRecorder::~CEcPcapMmapRecorder()
+{
+    Stop();
+    SafeOsFree(m_aSeg);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Prepare and activate the first segment, start the segment thread.
+ *
+ * \return EC_E_NOERROR on success, error code otherwise.
+ */
+EC_T_DWORD CEcPcapMmapRecorder::Start(
+    const EC_T_CHAR* szPrefix,  /**< [in] segment file name prefix, may contain a directory */
+    EC_T_CPUSET CpuSet,         /**< [in] CPU set of the segment thread */
+    EC_T_DWORD  dwPrio,         /**< [in] priority of the segment thread */
+    EC_T_DWORD  dwSegmentMb,    /**< [in] segment file size in MB */
+    EC_T_DWORD  dwSegmentSec,   /**< [in] rotate after n seconds, 0 = size based only */
+    EC_T_DWORD  dwMaxSegments,  /**< [in] closed segments kept on disk, 0 = keep all */
+    EC_T_DWORD  dwPeriodMsec    /**< [in] segment preparation / retirement period in ms */
+                                )
+{
+    EC_T_DWORD dwRetVal = EC_E_ERROR;
+    EC_T_DWORD dwRes = EC_E_ERROR;
+
+    if (m_bRunning)
+    {
+        dwRetVal = EC_E_INVALIDSTATE;
+        goto Exit;
+    }
+    if ((EC_NULL == szPrefix) || ('\0' == szPrefix[0]) || (OsStrlen(szPrefix) >= PCAP_MMAP_PREFIX_SIZE)
+     || (0 == dwSegmentMb) || (dwSegmentMb > 4096) || (0 == dwPeriodMsec))
+    {
+        dwRetVal = EC_E_INVALIDPARM;
+        goto Exit;
+    }
+    OsSnprintf(m_szPrefix, sizeof(m_szPrefix), "%s", szPrefix);
+    m_qwSegmentSize = (EC_T_UINT64)dwSegmentMb * 1024 * 1024;
+    m_qwSegmentNsec = (EC_T_UINT64)dwSegmentSec * 1000000000ULL;
+    m_dwMaxSegments = dwMaxSegments;
+    m_dwPeriodMsec  = dwPeriodMsec;
+    m_bShutdown     = EC_FALSE;
+
+    m_pActive     = EC_NULL;
+    m_dwLock      = 0;
+    m_dwNextSeq   = 0;
+    m_dwOldestSeq = 0;
+    m_dwClosedCnt = 0;
+    m_qwFrames    = 0;
+    m_qwBytes     = 0;
+    m_qwDropped   = 0;
+    m_dwSegments  = 0;
+    m_dwDeleted   = 0;
+    m_dwErrors    = 0;
+
+    /* continue after the segments of earlier runs, apply dwMaxSegments to them as well */
+    ScanSegments();
+    DeleteOldSegments();
+
+    if (EC_NULL == m_aSeg)
+    {
+        m_aSeg = (T_PCAP_MMAP_SEG*)OsMalloc(PCAP_MMAP_SLOT_CNT * sizeof(T_PCAP_MMAP_SEG));
+        if (EC_NULL == m_aSeg)
+        {
+            dwRetVal = EC_E_NOMEMORY;
+            goto Exit;
+        }
+    }
+    OsMemset(m_aSeg, 0, PCAP_MMAP_SLOT_CNT * sizeof(T_PCAP_MMAP_SEG));
+    for (EC_T_DWORD dwIdx = 0; dwIdx < PCAP_MMAP_SLOT_CNT; dwIdx++)
+    {
+        m_aSeg[dwIdx].nFd = -1;
+    }
+
+    /* first segment synchronously, the next one is prepared by the segment thread */
+    dwRes = PrepareSegment(&m_aSeg[0]);
+    if (EC_E_NOERROR != dwRes)
+    {
+        dwRetVal = dwRes;
+        goto Exit;
+    }
+    m_aSeg[0].qwRotateNsec = PcapNowNsec() + m_qwSegmentNsec;
+    m_aSeg[0].dwState = PCAP_SEG_ACTIVE;
+    PCAP_MMAP_STORE_REL(&m_pActive, &m_aSeg[0]);
+
+    m_bThreadRunning = EC_TRUE;
+    m_pvThread = OsCreateThread("tEcPcapMmap", (EC_PF_THREADENTRY)CEcPcapMmapRecorder::SegmentTaskWrapper,
+        CpuSet, dwPrio, LOG_THREAD_STACKSIZE, this);
+    if (EC_NULL == m_pvThread)
+    {
+        m_bThreadRunning = EC_FALSE;
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot create pcap segment thread\n"));
+        dwRetVal = EC_E_ERROR;
+        goto Exit;
+    }
+    m_bRunning = EC_TRUE;
+
+    dwRetVal = EC_E_NOERROR;
+Exit:
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        Stop();
+    }
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Stop the segment thread, truncate the active segment and delete the unused prepared one.
+ */
+EC_T_VOID CEcPcapMmapRecorder::Stop(EC_T_VOID)
+{
+    T_PCAP_MMAP_SEG* pSeg = EC_NULL;
+    EC_T_DWORD dwIdx = 0;
+
+    m_bRunning  = EC_FALSE;
+    m_bShutdown = EC_TRUE;
+    if (EC_NULL != m_pvThread)
+    {
+        CEcTimer oTimeout(PCAP_MMAP_STOP_TIMEOUT);
+        while (m_bThreadRunning && !oTimeout.IsElapsed())
+        {
+            OsSleep(1);
+        }
+        OsDeleteThreadHandle(m_pvThread);
+        m_pvThread = EC_NULL;
+    }
+    if (EC_NULL == m_aSeg)
+    {
+        return;
+    }
+    /* no new writers after this, the active segment is retired like a rotated one */
+    while (__atomic_exchange_n(&m_dwLock, 1, __ATOMIC_ACQUIRE))
+    {
+    }
+    pSeg = m_pActive;
+    PCAP_MMAP_STORE_REL(&m_pActive, (T_PCAP_MMAP_SEG*)EC_NULL);
+    if (EC_NULL != pSeg)
+    {
+        PCAP_MMAP_STORE_REL(&pSeg->dwState, (EC_T_DWORD)PCAP_SEG_FULL);
+    }
+    PCAP_MMAP_STORE_REL(&m_dwLock, (EC_T_DWORD)0);
+
+    for (dwIdx = 0; dwIdx < PCAP_MMAP_SLOT_CNT; dwIdx++)
+    {
+        pSeg = &m_aSeg[dwIdx];
+        if (PCAP_SEG_FULL == PCAP_MMAP_LOAD_ACQ(&pSeg->dwState))
+        {
+            CEcTimer oTimeout(PCAP_MMAP_STOP_TIMEOUT);
+            while ((0 != PCAP_MMAP_LOAD_ACQ(&pSeg->dwWriters)) && !oTimeout.IsElapsed())
+            {
+                OsSleep(1);
+            }
+            RetireSegment(pSeg);
+        }
+        else if (PCAP_SEG_READY == pSeg->dwState)
+        {
+            EC_T_CHAR szName[PCAP_MMAP_NAME_SIZE];
+
+            /* never written: removed, its number is the highest one and the next Start() reuses it */
+            munmap(pSeg->pbyMap, (size_t)m_qwSegmentSize);
+            close(pSeg->nFd);
+            SegmentName(pSeg->dwSeq, szName, sizeof(szName));
+            unlink(szName);
+            pSeg->pbyMap = EC_NULL;
+            pSeg->nFd = -1;
+            pSeg->dwState = PCAP_SEG_FREE;
+            m_dwSegments--;
+        }
+    }
+}
+
+EC_T_VOID CEcPcapMmapRecorder::GetStats(T_PCAP_MMAP_STATS* pStats)
+{
+    pStats->qwFrames   = __atomic_load_n(&m_qwFrames, __ATOMIC_RELAXED);
+    pStats->qwBytes    = __atomic_load_n(&m_qwBytes, __ATOMIC_RELAXED);
+    pStats->qwDropped  = __atomic_load_n(&m_qwDropped, __ATOMIC_RELAXED);
+    pStats->dwSegments = m_dwSegments;
+    pStats->dwDeleted  = m_dwDeleted;
+    pStats->dwErrors   = m_dwErrors;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Record one frame.
+ *
+ * The space is reserved under a spin lock (a few loads/stores, no system call), the record header and the
+ * frame are then copied straight into the mapped segment. If the lock holder was preempted and does not
+ * release the lock within a few yields, or no segment is ready, the frame is dropped and counted.
+ */
+EC_T_VOID CEcPcapMmapRecorder::LogFrame(EC_T_DWORD dwFrameSize, const EC_T_BYTE* pbyFrame)
+{
+    T_PCAP_MMAP_SEG* pSeg = EC_NULL;
+    T_PCAP_MMAP_SEG* pNext = EC_NULL;
+    T_PCAP_REC_HDR   oHdr;
+    EC_T_UINT64      qwNeed = sizeof(T_PCAP_REC_HDR) + (EC_T_UINT64)dwFrameSize;
+    EC_T_UINT64      qwOffset = 0;
+    EC_T_UINT64      qwNow = 0;
+    EC_T_DWORD       dwSpin = 0;
+    EC_T_DWORD       dwIdx = 0;
+
+    if (!m_bRunning)
+    {
+        return;
+    }
+    if ((dwFrameSize > PCAP_SNAPLEN) || (qwNeed > m_qwSegmentSize - sizeof(T_PCAP_FILE_HDR)))
+    {
+        PCAP_MMAP_ADD(&m_qwDropped, 1);
+        return;
+    }
+    while (__atomic_exchange_n(&m_dwLock, 1, __ATOMIC_ACQUIRE))
+    {
+        /* the holder was preempted: give it the CPU a few times (same core, same or lower priority only helps
+         * under SCHED_OTHER), a real-time caller never waits longer than a few yields */
+        if (++dwSpin >= PCAP_MMAP_SPIN_LIMIT)
+        {
+            if (dwSpin >= PCAP_MMAP_SPIN_LIMIT + PCAP_MMAP_YIELD_LIMIT)
+            {
+                PCAP_MMAP_ADD(&m_qwDropped, 1);
+                return;
+            }
+            sched_yield();
+        }
+    }
+    /* timestamp under the lock: the records of all threads are in time order */
+    qwNow = PcapNowNsec();
+    pSeg = m_pActive;
+    if ((EC_NULL == pSeg) || (pSeg->qwUsed + qwNeed > m_qwSegmentSize) || ((0 != m_qwSegmentNsec) && (qwNow >= pSeg->qwRotateNsec)))
+    {
+        /* rotate to the prepared segment (the segment thread keeps at most one) */
+        for (dwIdx = 0; dwIdx < PCAP_MMAP_SLOT_CNT; dwIdx++)
+        {
+            if (PCAP_SEG_READY == PCAP_MMAP_LOAD_ACQ(&m_aSeg[dwIdx].dwState))
+            {
+                pNext = &m_aSeg[dwIdx];
+                break;
+            }
+        }
+        if ((EC_NULL != pNext) && (EC_NULL != pSeg))
+        {
+            pNext->qwRotateNsec = qwNow + m_qwSegmentNsec;
+            PCAP_MMAP_STORE_REL(&pNext->dwState, (EC_T_DWORD)PCAP_SEG_ACTIVE);
+            PCAP_MMAP_STORE_REL(&pSeg->dwState, (EC_T_DWORD)PCAP_SEG_FULL);
+            PCAP_MMAP_STORE_REL(&m_pActive, pNext);
+            pSeg = pNext;
+        }
+        /* no prepared segment: continue in the current one until it is full (time based rotation is late) */
+        if ((EC_NULL == pSeg) || (pSeg->qwUsed + qwNeed > m_qwSegmentSize))
+        {
+            PCAP_MMAP_STORE_REL(&m_dwLock, (EC_T_DWORD)0);
+            PCAP_MMAP_ADD(&m_qwDropped, 1);
+            return;
+        }
+    }
+    qwOffset = pSeg->qwUsed;
+    pSeg->qwUsed += qwNeed;
+    __atomic_add_fetch(&pSeg->dwWriters, 1, __ATOMIC_ACQ_REL);
+    PCAP_MMAP_STORE_REL(&m_dwLock, (EC_T_DWORD)0);
+
+    oHdr.dwSec    = (EC_T_DWORD)(qwNow / 1000000000ULL);
+    oHdr.dwFrac   = (EC_T_DWORD)(qwNow % 1000000000ULL);
+    oHdr.dwCapLen = dwFrameSize;
+    oHdr.dwLen    = dwFrameSize;
+    OsMemcpy(pSeg->pbyMap + qwOffset, &oHdr, sizeof(oHdr));
+    OsMemcpy(pSeg->pbyMap + qwOffset + sizeof(oHdr), pbyFrame, dwFrameSize);
+    __atomic_sub_fetch(&pSeg->dwWriters, 1, __ATOMIC_RELEASE);
+
+    PCAP_MMAP_ADD(&m_qwFrames, 1);
+    PCAP_MMAP_ADD(&m_qwBytes, qwNeed);
+}
+
+EC_T_VOID EC_FNCALL CEcPcapMmapRecorder::LogFrameCallback(EC_T_VOID* pvContext, EC_T_DWORD dwLogFlags, EC_T_DWORD dwFrameSize, EC_T_BYTE* pbyFrame)
+{
+    EC_UNREFPARM(dwLogFlags);
+    ((CEcPcapMmapRecorder*)pvContext)->LogFrame(dwFrameSize, pbyFrame);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Find the segment files of earlier runs with the same prefix.
+ *
+ * Sets m_dwNextSeq behind the highest file number, m_dwOldestSeq to the lowest one and counts the files as
+ * closed segments, so a restart neither overwrites an earlier capture nor keeps more than dwMaxSegments files.
+ */
+EC_T_VOID CEcPcapMmapRecorder::ScanSegments(EC_T_VOID)
+{
+    EC_T_CHAR  szDir[PCAP_MMAP_PREFIX_SIZE];
+    const EC_T_CHAR* szBase = m_szPrefix;
+    const EC_T_CHAR* szSlash = strrchr(m_szPrefix, '/');
+    EC_T_DWORD dwBaseLen = 0;
+    EC_T_DWORD dwMinSeq = 0;
+    EC_T_DWORD dwMaxSeq = 0;
+    EC_T_DWORD dwCnt = 0;
+    DIR* pDir = EC_NULL;
+    struct dirent* pEntry = EC_NULL;
+
+    if (EC_NULL == szSlash)
+    {
+        OsSnprintf(szDir, sizeof(szDir), ".");
+    }
+    else
+    {
+        OsSnprintf(szDir, sizeof(szDir), "%.*s", (int)((szSlash == m_szPrefix) ? 1 : (szSlash - m_szPrefix)), m_szPrefix);
+        szBase = szSlash + 1;
+    }
+    dwBaseLen = (EC_T_DWORD)OsStrlen(szBase);
+    pDir = opendir(szDir);
+    if (EC_NULL == pDir)
+    {
+        return;
+    }
+    while (EC_NULL != (pEntry = readdir(pDir)))
+    {
+        const EC_T_CHAR* szNum = pEntry->d_name + dwBaseLen + 1;
+        EC_T_CHAR* szEnd = EC_NULL;
+        unsigned long ulSeq = 0;
+
+        /* <base>.<digits>.pcap */
+        if ((0 != OsStrncmp(pEntry->d_name, szBase, dwBaseLen)) || ('.' != pEntry->d_name[dwBaseLen])
+         || (*szNum < '0') || (*szNum > '9'))
+        {
+            continue;
+        }
+        ulSeq = strtoul(szNum, &szEnd, 10);
+        if ((0 != OsStrcmp(szEnd, ".pcap")) || (ulSeq >= 0xFFFFFFFFUL))
+        {
+            continue;
+        }
+        if ((0 == dwCnt) || ((EC_T_DWORD)ulSeq < dwMinSeq))
+        {
+            dwMinSeq = (EC_T_DWORD)ulSeq;
+        }
+        if ((0 == dwCnt) || ((EC_T_DWORD)ulSeq > dwMaxSeq))
+        {
+            dwMaxSeq = (EC_T_DWORD)ulSeq;
+        }
+        dwCnt++;
+    }
+    closedir(pDir);
+    if (0 != dwCnt)
+    {
+        m_dwOldestSeq = dwMinSeq;
+        m_dwNextSeq   = dwMaxSeq + 1;
+        m_dwClosedCnt = dwCnt;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Create, preallocate and map the next segment file, write the pcap file header.
+ *
+ * posix_fallocate() reserves the disk blocks up front (no SIGBUS on a full disk while writing the mapping),
+ * MAP_POPULATE sets up the page tables so that LogFrame() only takes minor faults.
+ */
+EC_T_DWORD CEcPcapMmapRecorder::PrepareSegment(T_PCAP_MMAP_SEG* pSeg)
+{
+    EC_T_DWORD dwRetVal = EC_E_ERROR;
+    EC_T_CHAR  szName[PCAP_MMAP_NAME_SIZE];
+    T_PCAP_FILE_HDR oFileHdr;
+    EC_T_INT   nFd = -1;
+    EC_T_INT   nRes = 0;
+    EC_T_VOID* pvMap = MAP_FAILED;
+
+    SegmentName(m_dwNextSeq, szName, sizeof(szName));
+    nFd = open(szName, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (nFd < 0)
+    {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot create pcap segment %s (errno %d)\n", szName, errno));
+        goto Exit;
+    }
+    nRes = posix_fallocate(nFd, 0, (off_t)m_qwSegmentSize);
+    if (0 != nRes)
+    {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot allocate %llu bytes for pcap segment %s (errno %d)\n",
+            (unsigned long long)m_qwSegmentSize, szName, nRes));
+        goto Exit;
+    }
+    pvMap = mmap(EC_NULL, (size_t)m_qwSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, nFd, 0);
+    if (MAP_FAILED == pvMap)
+    {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot map pcap segment %s (errno %d)\n", szName, errno));
+        goto Exit;
+    }
+    OsMemset(&oFileHdr, 0, sizeof(oFileHdr));
+    oFileHdr.dwMagic       = PCAP_MAGIC_NSEC;
+    oFileHdr.wVersionMajor = 2;
+    oFileHdr.wVersionMinor = 4;
+    oFileHdr.dwSnapLen     = PCAP_SNAPLEN;
+    oFileHdr.dwLinkType    = PCAP_LINKTYPE_ETHERNET;
+    OsMemcpy(pvMap, &oFileHdr, sizeof(oFileHdr));
+
+    pSeg->nFd       = nFd;
+    pSeg->pbyMap    = (EC_T_BYTE*)pvMap;
+    pSeg->qwUsed    = sizeof(T_PCAP_FILE_HDR);
+    pSeg->dwWriters = 0;
+    pSeg->dwSeq     = m_dwNextSeq;
+    PCAP_MMAP_STORE_REL(&pSeg->dwState, (EC_T_DWORD)PCAP_SEG_READY);
+    m_dwNextSeq++;
+    m_dwSegments++;
+
+    dwRetVal = EC_E_NOERROR;
+Exit:
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        if (nFd >= 0)
+        {
+            close(nFd);
+            unlink(szName);
+        }
+        m_dwErrors++;
+    }
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Truncate a rotated segment to its used size and unmap it. All writers must have left.
+ */
+EC_T_VOID CEcPcapMmapRecorder::RetireSegment(T_PCAP_MMAP_SEG* pSeg)
+{
+    munmap(pSeg->pbyMap, (size_t)m_qwSegmentSize);
+    if (0 != ftruncate(pSeg->nFd, (off_t)pSeg->qwUsed))
+    {
+        m_dwErrors++;
+    }
+    close(pSeg->nFd);
+    pSeg->pbyMap = EC_NULL;
+    pSeg->nFd = -1;
+    PCAP_MMAP_STORE_REL(&pSeg->dwState, (EC_T_DWORD)PCAP_SEG_FREE);
+
+    m_dwClosedCnt++;
+    DeleteOldSegments();
+}
+
+EC_T_VOID CEcPcapMmapRecorder::DeleteOldSegments(EC_T_VOID)
+{
+    EC_T_CHAR szName[PCAP_MMAP_NAME_SIZE];
+
+    /* segments are activated in file number order, so the oldest files are always closed ones;
+     * numbers missing on disk (files of earlier runs removed by hand) are skipped without being counted */
+    while ((0 != m_dwMaxSegments) && (m_dwClosedCnt > m_dwMaxSegments) && (m_dwOldestSeq < m_dwNextSeq))
+    {
+        SegmentName(m_dwOldestSeq, szName, sizeof(szName));
+        m_dwOldestSeq++;
+        if (0 == unlink(szName))
+        {
+            m_dwDeleted++;
+            m_dwClosedCnt--;
+        }
+        else if (ENOENT != errno)
+        {
+            m_dwErrors++;
+            m_dwClosedCnt--;
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Retire rotated segments and keep one segment prepared.
+ */
+EC_T_VOID CEcPcapMmapRecorder::Maintain(EC_T_VOID)
+{
+    T_PCAP_MMAP_SEG* pFree = EC_NULL;
+    EC_T_BOOL bReady = EC_FALSE;
+    EC_T_DWORD dwIdx = 0;
+
+    for (dwIdx = 0; dwIdx < PCAP_MMAP_SLOT_CNT; dwIdx++)
+    {
+        T_PCAP_MMAP_SEG* pSeg = &m_aSeg[dwIdx];
+        EC_T_DWORD dwState = PCAP_MMAP_LOAD_ACQ(&pSeg->dwState);
+
+        if ((PCAP_SEG_FULL == dwState) && (0 == PCAP_MMAP_LOAD_ACQ(&pSeg->dwWriters)))
+        {
+            RetireSegment(pSeg);
+            dwState = PCAP_SEG_FREE;
+        }
+        if (PCAP_SEG_READY == dwState)
+        {
+            bReady = EC_TRUE;
+        }
+        else if ((PCAP_SEG_FREE == dwState) && (EC_NULL == pFree))
+        {
+            pFree = pSeg;
+        }
+    }
+    if (!bReady && (EC_NULL != pFree))
+    {
+        PrepareSegment(pFree);
+    }
+}
+
+EC_T_VOID CEcPcapMmapRecorder::SegmentName(EC_T_DWORD dwSeq, EC_T_CHAR* szName, EC_T_DWORD dwSize)
+{
+    OsSnprintf(szName, (EC_T_INT)dwSize, "%s.%05u.pcap", m_szPrefix, dwSeq);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Segment thread: prepare the next segment ahead of rotation, retire the rotated ones.
+ */
+EC_T_VOID CEcPcapMmapRecorder::SegmentTask(EC_T_VOID)
+{
+    while (!m_bShutdown)
+    {
+        Maintain();
+        OsSleep(m_dwPeriodMsec);
+    }
+    m_bThreadRunning = EC_FALSE;
+}
+
+EC_T_VOID CEcPcapMmapRecorder::SegmentTaskWrapper(EC_T_VOID* pvParms)
+{
+    ((CEcPcapMmapRecorder*)pvParms)->SegmentTask();
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Constructor.
+ */
+CEcPcapIndexReader::CEcPcapIndexReader()
+    : m_nFd(-1)
+    , m_pbyMap(EC_NULL)
+    , m_qwMapSize(0)
+    , m_bSwapped(EC_FALSE)
+    , m_bNsec(EC_FALSE)
+    , m_aIdx(EC_NULL)
+    , m_dwFrameCnt(0)
+    , m_dwIdxSize(0)
+    , m_adwCycleFirst(EC_NULL)
+    , m_dwCycleCnt(0)
+    , m_bMarkerValid(EC_FALSE)
+    , m_byMarkerCmd(0)
+    , m_dwMarkerAddr(0)
+{
+}
+
+CEcPcapIndexReader::~CEcPcapIndexReader()
+{
+    Close();
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Map a pcap file and build the frame and cycle index.
+ *
+ * \return EC_E_NOERROR on success, EC_E_OPENFAILED / EC_E_INVALIDDATA / EC_E_NOMEMORY otherwise.
+ */
+EC_T_DWORD CEcPcapIndexReader::Open(const EC_T_CHAR* szFileName)
+{
+    EC_T_DWORD dwRetVal = EC_E_ERROR;
+    T_PCAP_FILE_HDR oFileHdr;
+    struct stat oStat;
+    EC_T_VOID* pvMap = MAP_FAILED;
+
+    Close();
+
+    m_nFd = open(szFileName, O_RDONLY | O_CLOEXEC);
+    if ((m_nFd < 0) || (0 != fstat(m_nFd, &oStat)))
+    {
+        dwRetVal = EC_E_OPENFAILED;
+        goto Exit;
+    }
+    if ((EC_T_UINT64)oStat.st_size < sizeof(T_PCAP_FILE_HDR))
+    {
+        dwRetVal = EC_E_INVALIDDATA;
+        goto Exit;
+    }
+    pvMap = mmap(EC_NULL, (size_t)oStat.st_size, PROT_READ, MAP_PRIVATE, m_nFd, 0);
+    if (MAP_FAILED == pvMap)
+    {
+        dwRetVal = EC_E_OPENFAILED;
+        goto Exit;
+    }
+    m_pbyMap    = (const EC_T_BYTE*)pvMap;
+    m_qwMapSize = (EC_T_UINT64)oStat.st_size;
+    madvise(pvMap, (size_t)m_qwMapSize, MADV_SEQUENTIAL);
+
+    OsMemcpy(&oFileHdr, m_pbyMap, sizeof(oFileHdr));
+    switch (oFileHdr.dwMagic)
+    {
+    case PCAP_MAGIC_USEC:                   m_bSwapped = EC_FALSE; m_bNsec = EC_FALSE; break;
+    case PCAP_MAGIC_NSEC:                   m_bSwapped = EC_FALSE; m_bNsec = EC_TRUE;  break;
+    case PCAP_MAGIC_USEC_SWAPPED:           m_bSwapped = EC_TRUE;  m_bNsec = EC_FALSE; break;
+    case PCAP_MAGIC_NSEC_SWAPPED:           m_bSwapped = EC_TRUE;  m_bNsec = EC_TRUE;  break;
+    default:
+        dwRetVal = EC_E_INVALIDDATA;
+        goto Exit;
+    }
+    dwRetVal = BuildIndex();
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        goto Exit;
+    }
+    dwRetVal = BuildCycleIndex();
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        goto Exit;
+    }
+    /* later accesses follow the index (binary search, decoding a cycle range) */
+    madvise(pvMap, (size_t)m_qwMapSize, MADV_NORMAL);
+
+Exit:
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        Close();
+    }
+    return dwRetVal;
+}
+
+EC_T_VOID CEcPcapIndexReader::Close(EC_T_VOID)
+{
+    if (EC_NULL != m_pbyMap)
+    {
+        munmap((EC_T_VOID*)m_pbyMap, (size_t)m_qwMapSize);
+        m_pbyMap = EC_NULL;
+    }
+    if (m_nFd >= 0)
+    {
+        close(m_nFd);
+        m_nFd = -1;
+    }
+    SafeOsFree(m_aIdx);
+    SafeOsFree(m_adwCycleFirst);
+    m_qwMapSize    = 0;
+    m_dwFrameCnt   = 0;
+    m_dwIdxSize    = 0;
+    m_dwCycleCnt   = 0;
+    m_bMarkerValid = EC_FALSE;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  One pass over the records: offset, timestamp, length, EtherCAT / direction flags.
+ */
+EC_T_DWORD CEcPcapIndexReader::BuildIndex(EC_T_VOID)
+{
+    EC_T_UINT64 qwOffset = sizeof(T_PCAP_FILE_HDR);
+    T_PCAP_REC_HDR oHdr;
+
+    /* minimum Ethernet frame: 60 bytes + 16 bytes record header */
+    m_dwIdxSize  = (EC_T_DWORD)EC_MIN((m_qwMapSize / 256) + 1024, (EC_T_UINT64)0x10000000);
+    m_aIdx       = (T_PCAP_FRAME_IDX*)OsMalloc(m_dwIdxSize * sizeof(T_PCAP_FRAME_IDX));
+    m_dwFrameCnt = 0;
+    if (EC_NULL == m_aIdx)
+    {
+        return EC_E_NOMEMORY;
+    }
+    while (qwOffset + sizeof(T_PCAP_REC_HDR) <= m_qwMapSize)
+    {
+        T_PCAP_FRAME_IDX* pIdx = EC_NULL;
+        const EC_T_BYTE* pbyFrame = EC_NULL;
+        EC_T_DWORD dwEcatOffset = 14;
+
+        OsMemcpy(&oHdr, m_pbyMap + qwOffset, sizeof(oHdr));
+        if (m_bSwapped)
+        {
+            oHdr.dwSec    = __builtin_bswap32(oHdr.dwSec);
+            oHdr.dwFrac   = __builtin_bswap32(oHdr.dwFrac);
+            oHdr.dwCapLen = __builtin_bswap32(oHdr.dwCapLen);
+            oHdr.dwLen    = __builtin_bswap32(oHdr.dwLen);
+        }
+        /* zero-filled tail of a segment whose recorder was killed before truncating it */
+        if ((0 == oHdr.dwSec) && (0 == oHdr.dwCapLen))
+        {
+            break;
+        }
+        /* truncated last record */
+        if ((oHdr.dwCapLen > PCAP_SNAPLEN) || (qwOffset + sizeof(T_PCAP_REC_HDR) + oHdr.dwCapLen > m_qwMapSize))
+        {
+            break;
+        }
+        if (m_dwFrameCnt == m_dwIdxSize)
+        {
+            T_PCAP_FRAME_IDX* aIdx = EC_NULL;
+
+            if (m_dwIdxSize >= 0x80000000)
+            {
+                break;
+            }
+            aIdx = (T_PCAP_FRAME_IDX*)OsRealloc(m_aIdx, 2 * (size_t)m_dwIdxSize * sizeof(T_PCAP_FRAME_IDX));
+            if (EC_NULL == aIdx)
+            {
+                return EC_E_NOMEMORY;
+            }
+            m_aIdx = aIdx;
+            m_dwIdxSize *= 2;
+        }
+        pIdx = &m_aIdx[m_dwFrameCnt++];
+        pbyFrame = m_pbyMap + qwOffset + sizeof(T_PCAP_REC_HDR);
+
+        pIdx->qwOffset   = qwOffset + sizeof(T_PCAP_REC_HDR);
+        pIdx->qwTimeNsec = (EC_T_UINT64)oHdr.dwSec * 1000000000ULL + (m_bNsec ? oHdr.dwFrac : (EC_T_UINT64)oHdr.dwFrac * 1000);
+        pIdx->dwCycle    = PCAP_IDX_NO_CYCLE;
+        pIdx->wCapLen    = (EC_T_WORD)oHdr.dwCapLen;
+        pIdx->byFlags    = (EC_T_BYTE)((oHdr.dwCapLen < oHdr.dwLen) ? PCAP_IDX_FLAG_TRUNCATED : 0);
+        pIdx->byEcatOffset = 0;
+        if (oHdr.dwCapLen >= 18)
+        {
+            EC_T_WORD wType = PcapGetBe16(pbyFrame + 12);
+
+            if (ETHTYPE_VLAN == wType)
+            {
+                wType = PcapGetBe16(pbyFrame + 16);
+                dwEcatOffset = 18;
+            }
+            if ((ETHTYPE_ECAT == wType) && (oHdr.dwCapLen >= dwEcatOffset + ECAT_HDR_LEN + ECAT_DGRAM_HDR_LEN))
+            {
+                pIdx->byFlags |= PCAP_IDX_FLAG_ECAT;
+                pIdx->byEcatOffset = (EC_T_BYTE)dwEcatOffset;
+            }
+            /* the first slave sets the locally administered bit of the source MAC */
+            if (0 != (pbyFrame[6] & 0x02))
+            {
+                pIdx->byFlags |= PCAP_IDX_FLAG_RX;
+            }
+        }
+        qwOffset += sizeof(T_PCAP_REC_HDR) + oHdr.dwCapLen;
+    }
+    return EC_E_NOERROR;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Mark the frames matching the cycle marker and number the cycles.
+ */
+EC_T_DWORD CEcPcapIndexReader::BuildCycleIndex(EC_T_VOID)
+{
+    EC_T_DWORD dwFrame = 0;
+    EC_T_DWORD dwCycle = PCAP_IDX_NO_CYCLE;
+    EC_T_DWORD dwCycleSize = 0;
+
+    SafeOsFree(m_adwCycleFirst);
+    m_dwCycleCnt = 0;
+    if (!m_bMarkerValid)
+    {
+        for (dwFrame = 0; dwFrame < m_dwFrameCnt; dwFrame++)
+        {
+            const T_PCAP_FRAME_IDX* pIdx = &m_aIdx[dwFrame];
+            const EC_T_BYTE* pbyDgram = m_pbyMap + pIdx->qwOffset + pIdx->byEcatOffset + ECAT_HDR_LEN;
+
+            if (((pIdx->byFlags & (PCAP_IDX_FLAG_ECAT | PCAP_IDX_FLAG_RX)) == PCAP_IDX_FLAG_ECAT) && PcapIsLogicalCmd(pbyDgram[0]))
+            {
+                m_byMarkerCmd  = pbyDgram[0];
+                m_dwMarkerAddr = PcapGetLe32(pbyDgram + 2);
+                m_bMarkerValid = EC_TRUE;
+                break;
+            }
+        }
+    }
+    /* one cycle per marker frame is an upper bound, the array is shrunk below */
+    for (dwFrame = 0; dwFrame < m_dwFrameCnt; dwFrame++)
+    {
+        T_PCAP_FRAME_IDX* pIdx = &m_aIdx[dwFrame];
+        const EC_T_BYTE* pbyDgram = m_pbyMap + pIdx->qwOffset + pIdx->byEcatOffset + ECAT_HDR_LEN;
+
+        pIdx->byFlags &= (EC_T_BYTE)~PCAP_IDX_FLAG_MARKER;
+        if (m_bMarkerValid && (0 != (pIdx->byFlags & PCAP_IDX_FLAG_ECAT))
+         && (pbyDgram[0] == m_byMarkerCmd) && (PcapGetLe32(pbyDgram + 2) == m_dwMarkerAddr))
+        {
+            pIdx->byFlags |= PCAP_IDX_FLAG_MARKER;
+            if (0 == (pIdx->byFlags & PCAP_IDX_FLAG_RX))
+            {
+                dwCycleSize++;
+            }
+        }
+    }
+    if (0 == dwCycleSize)
+    {
+        for (dwFrame = 0; dwFrame < m_dwFrameCnt; dwFrame++)
+        {
+            m_aIdx[dwFrame].dwCycle = PCAP_IDX_NO_CYCLE;
+        }
+        return EC_E_NOERROR;
+    }
+    m_adwCycleFirst = (EC_T_DWORD*)OsMalloc(dwCycleSize * sizeof(EC_T_DWORD));
+    if (EC_NULL == m_adwCycleFirst)
+    {
+        return EC_E_NOMEMORY;
+    }
+    for (dwFrame = 0; dwFrame < m_dwFrameCnt; dwFrame++)
+    {
+        T_PCAP_FRAME_IDX* pIdx = &m_aIdx[dwFrame];
+
+        if ((pIdx->byFlags & (PCAP_IDX_FLAG_MARKER | PCAP_IDX_FLAG_RX)) == PCAP_IDX_FLAG_MARKER)
+        {
+            dwCycle = m_dwCycleCnt++;
+            m_adwCycleFirst[dwCycle] = dwFrame;
+        }
+        pIdx->dwCycle = dwCycle;
+    }
+    return EC_E_NOERROR;
+}
+
+EC_T_DWORD CEcPcapIndexReader::SetCycleMarker(EC_T_BYTE byCmd, EC_T_DWORD dwAddr)
+{
+    if (EC_NULL == m_pbyMap)
+    {
+        return EC_E_INVALIDSTATE;
+    }
+    m_byMarkerCmd  = byCmd;
+    m_dwMarkerAddr = dwAddr;
+    m_bMarkerValid = EC_TRUE;
+    return BuildCycleIndex();
+}
+
+EC_T_DWORD CEcPcapIndexReader::GetFrame(EC_T_DWORD dwFrame, T_PCAP_FRAME* pFrame)
+{
+    const T_PCAP_FRAME_IDX* pIdx = EC_NULL;
+
+    if ((dwFrame >= m_dwFrameCnt) || (EC_NULL == pFrame))
+    {
+        return EC_E_INVALIDPARM;
+    }
+    pIdx = &m_aIdx[dwFrame];
+    pFrame->pbyData    = m_pbyMap + pIdx->qwOffset;
+    pFrame->dwLen      = pIdx->wCapLen;
+    pFrame->qwTimeNsec = pIdx->qwTimeNsec;
+    pFrame->dwCycle    = pIdx->dwCycle;
+    pFrame->dwFlags    = pIdx->byFlags;
+    return EC_E_NOERROR;
+}
+
+EC_T_DWORD CEcPcapIndexReader::FindFrameByTime(EC_T_UINT64 qwTimeNsec)
+{
+    EC_T_DWORD dwLow = 0;
+    EC_T_DWORD dwHigh = m_dwFrameCnt;
+
+    while (dwLow < dwHigh)
+    {
+        EC_T_DWORD dwMid = dwLow + (dwHigh - dwLow) / 2;
+
+        if (m_aIdx[dwMid].qwTimeNsec < qwTimeNsec)
+        {
+            dwLow = dwMid + 1;
+        }
+        else
+        {
+            dwHigh = dwMid;
+        }
+    }
+    return dwLow;
+}
+
+EC_T_DWORD CEcPcapIndexReader::GetCycleFirstFrame(EC_T_DWORD dwCycle)
+{
+    return (dwCycle < m_dwCycleCnt) ? m_adwCycleFirst[dwCycle] : m_dwFrameCnt;
+}
+
+EC_T_BOOL CEcPcapIndexReader::FrameMatches(const T_PCAP_FRAME_IDX* pIdx, EC_T_DWORD dwFrameFilter)
+{
+    EC_T_DWORD dwDir = (0 != (pIdx->byFlags & PCAP_IDX_FLAG_RX)) ? PCAP_DECODE_RX : PCAP_DECODE_TX;
+
+    if (0 == (dwFrameFilter & dwDir))
+    {
+        return EC_FALSE;
+    }
+    if ((0 != (dwFrameFilter & PCAP_DECODE_MARKER)) && (0 == (pIdx->byFlags & PCAP_IDX_FLAG_MARKER)))
+    {
+        return EC_FALSE;
+    }
+    return EC_TRUE;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Extract a process data value by logical address.
+ *
+ * Walks the datagrams of every matching EtherCAT frame and takes the value from the first LRD/LWR/LRW
+ * datagram covering [dwLogAddr, dwLogAddr + dwSize). Frames without such a datagram produce no sample.
+ * If dwMaxSamples is reached, continue with dwFirstFrame = last sample's dwFrame + 1.
+ *
+ * \return EC_E_NOERROR on success, EC_E_INVALIDPARM otherwise.
+ */
+EC_T_DWORD CEcPcapIndexReader::DecodeLogical(EC_T_DWORD dwLogAddr, EC_T_DWORD dwSize, EC_T_DWORD dwFrameFilter,
+    EC_T_DWORD dwFirstFrame, EC_T_DWORD dwEndFrame,
+    T_PCAP_PD_SAMPLE* pSamples, EC_T_DWORD dwMaxSamples, EC_T_DWORD* pdwSampleCnt)
+{
+    EC_T_DWORD dwCnt = 0;
+    EC_T_DWORD dwFrame = 0;
+
+    if ((0 == dwSize) || (dwSize > sizeof(pSamples->abyData)) || (EC_NULL == pSamples) || (EC_NULL == pdwSampleCnt))
+    {
+        return EC_E_INVALIDPARM;
+    }
+    dwEndFrame = EC_MIN(dwEndFrame, m_dwFrameCnt);
+    for (dwFrame = dwFirstFrame; (dwFrame < dwEndFrame) && (dwCnt < dwMaxSamples); dwFrame++)
+    {
+        const T_PCAP_FRAME_IDX* pIdx = &m_aIdx[dwFrame];
+        const EC_T_BYTE* pbyFrame = EC_NULL;
+        EC_T_DWORD dwPos = 0;
+        EC_T_DWORD dwEnd = 0;
+
+        if ((0 == (pIdx->byFlags & PCAP_IDX_FLAG_ECAT)) || !FrameMatches(pIdx, dwFrameFilter))
+        {
+            continue;
+        }
+        pbyFrame = m_pbyMap + pIdx->qwOffset;
+        dwPos = pIdx->byEcatOffset + ECAT_HDR_LEN;
+        dwEnd = EC_MIN((EC_T_DWORD)pIdx->wCapLen, dwPos + (PcapGetLe16(pbyFrame + pIdx->byEcatOffset) & ECAT_DGRAM_LEN_MASK));
+        while (dwPos + ECAT_DGRAM_HDR_LEN <= dwEnd)
+        {
+            const EC_T_BYTE* pbyDgram = pbyFrame + dwPos;
+            EC_T_WORD  wLenFlags = PcapGetLe16(pbyDgram + 6);
+            EC_T_DWORD dwDataLen = wLenFlags & ECAT_DGRAM_LEN_MASK;
+            EC_T_DWORD dwAddr = PcapGetLe32(pbyDgram + 2);
+
+            if (dwPos + ECAT_DGRAM_HDR_LEN + dwDataLen + ECAT_DGRAM_WKC_LEN > dwEnd)
+            {
+                break;
+            }
+            if (PcapIsLogicalCmd(pbyDgram[0]) && (dwLogAddr >= dwAddr) && ((EC_T_UINT64)dwLogAddr + dwSize <= (EC_T_UINT64)dwAddr + dwDataLen))
+            {
+                T_PCAP_PD_SAMPLE* pSample = &pSamples[dwCnt++];
+
+                pSample->qwTimeNsec = pIdx->qwTimeNsec;
+                pSample->dwCycle    = pIdx->dwCycle;
+                pSample->dwFrame    = dwFrame;
+                pSample->wWkc       = PcapGetLe16(pbyDgram + ECAT_DGRAM_HDR_LEN + dwDataLen);
+                OsMemset(pSample->abyData, 0, sizeof(pSample->abyData));
+                OsMemcpy(pSample->abyData, pbyDgram + ECAT_DGRAM_HDR_LEN + (dwLogAddr - dwAddr), dwSize);
+                break;
+            }
+            if (0 == (wLenFlags & ECAT_DGRAM_MORE))
+            {
+                break;
+            }
+            dwPos += ECAT_DGRAM_HDR_LEN + dwDataLen + ECAT_DGRAM_WKC_LEN;
+        }
+    }
+    *pdwSampleCnt = dwCnt;
+    return EC_E_NOERROR;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Extract dwSize bytes at a byte offset of the Ethernet frame.
+ *
+ * \return EC_E_NOERROR on success, EC_E_INVALIDPARM otherwise.
+ */
+EC_T_DWORD CEcPcapIndexReader::DecodeFrameOffset(EC_T_DWORD dwOffset, EC_T_DWORD dwSize, EC_T_DWORD dwFrameFilter,
+    EC_T_DWORD dwFirstFrame, EC_T_DWORD dwEndFrame,
+    T_PCAP_PD_SAMPLE* pSamples, EC_T_DWORD dwMaxSamples, EC_T_DWORD* pdwSampleCnt)
+{
+    EC_T_DWORD dwCnt = 0;
+    EC_T_DWORD dwFrame = 0;
+
+    if ((0 == dwSize) || (dwSize > sizeof(pSamples->abyData)) || (EC_NULL == pSamples) || (EC_NULL == pdwSampleCnt))
+    {
+        return EC_E_INVALIDPARM;
+    }
+    dwEndFrame = EC_MIN(dwEndFrame, m_dwFrameCnt);
+    for (dwFrame = dwFirstFrame; (dwFrame < dwEndFrame) && (dwCnt < dwMaxSamples); dwFrame++)
+    {
+        const T_PCAP_FRAME_IDX* pIdx = &m_aIdx[dwFrame];
+        T_PCAP_PD_SAMPLE* pSample = EC_NULL;
+
+        if (((EC_T_UINT64)dwOffset + dwSize > pIdx->wCapLen) || !FrameMatches(pIdx, dwFrameFilter))
+        {
+            continue;
+        }
+        pSample = &pSamples[dwCnt++];
+        pSample->qwTimeNsec = pIdx->qwTimeNsec;
+        pSample->dwCycle    = pIdx->dwCycle;
+        pSample->dwFrame    = dwFrame;
+        pSample->wWkc       = 0;
+        OsMemset(pSample->abyData, 0, sizeof(pSample->abyData));
+        OsMemcpy(pSample->abyData, m_pbyMap + pIdx->qwOffset + dwOffset, dwSize);
+    }
+    *pdwSampleCnt = dwCnt;
+    return EC_E_NOERROR;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
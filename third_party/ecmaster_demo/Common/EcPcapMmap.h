@@ -0,0 +1,253 @@
+/*-----------------------------------------------------------------------------
+ * EcPcapMmap.h
+ * Description              Memory-mapped pcap segment recorder and indexed pcap reader
+ *---------------------------------------------------------------------------*/
+
+/* =============================================================================
+ * 文件解读：
+ * CPcapRecorder（EcLogging.cpp）把每帧拷贝进 FIFO，再由刷新线程 fwrite；长时间 1~4 kHz 抓包时
+ * FIFO 拷贝 + 文件锁 + 按帧的 write 调用会拖住刷新线程，满了之后直接丢帧且应用看不到。
+ * CPcapFileReader 只能顺序读 / 按帧数跳过，分析几小时的抓包要几分钟。本模块：
+ *
+ * CEcPcapMmapRecorder（录制）：
+ * - 段文件预先 posix_fallocate 到固定大小并 mmap（MAP_SHARED），每段是一个完整的 pcap 文件
+ *   （纳秒时间戳格式 0xa1b23c4d，Wireshark / tcpdump 可直接打开）
+ * - 帧回调（EC_T_PFLOGFRAME_CB）在自旋锁里只预留空间，然后把记录头和帧直接拷贝进映射的段：
+ *   帧数据只拷贝一次、没有中间缓冲、没有系统调用，页缓存由内核回写
+ * - 按大小（帧不跨段）或时间轮转；下一段由后台线程提前准备好，轮转时只是切换指针；
+ *   没有准备好的段（磁盘慢 / 准备失败）时丢帧并计数（GetStats().qwDropped）
+ * - 写满的段由后台线程等写者退出后截断到实际长度、解除映射；超过 dwMaxSegments 时删除最旧的段
+ * - Start() 先扫描已有的 <prefix>.<n>.pcap：编号接在最大的编号之后（重启不会覆盖上次的抓包），
+ *   已有的段同样计入 dwMaxSegments
+ *
+ * CEcPcapIndexReader（离线分析）：
+ * - mmap 整个抓包文件，一次顺序扫描建立帧索引（文件偏移、纳秒时间戳、长度、方向、周期号）
+ * - 周期号：TX 帧中第一个数据报与“周期标记”（默认取第一个含逻辑寻址命令的 TX 帧的第一个数据报的
+ *   命令 + 地址）相同的帧开始一个新周期；RX 帧按源 MAC 的 locally administered 位识别（从站置位）
+ * - FindFrameByTime() / GetCycleFirstFrame() 二分 / 直接查找，GetFrame() 返回指向映射内的帧（不拷贝）
+ * - DecodeLogical() 按逻辑地址在各帧的 LRD/LWR/LRW 数据报中取过程数据，DecodeFrameOffset() 按帧内字节偏移取
+ *
+ * 只用于 Linux（mmap / posix_fallocate）。录制与读取的结构体不依赖 INCLUDE_PCAP_RECORDER / INCLUDE_PCAP_READER。
+ * ============================================================================= */
+
+#ifndef INC_ECPCAPMMAP_H
+#define INC_ECPCAPMMAP_H 1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#ifndef INC_ECMASTER
+#include "EcMaster.h"
+#endif
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define PCAP_MMAP_DEFAULT_SEGMENT_MB    64      /* segment file size in MB */
+#define PCAP_MMAP_DEFAULT_SEGMENT_SEC   0       /* rotate after n seconds as well, 0 = size based only */
+#define PCAP_MMAP_DEFAULT_MAX_SEGMENTS  32      /* closed segments kept on disk, oldest deleted first, 0 = keep all */
+#define PCAP_MMAP_DEFAULT_PERIOD        10      /* ms, segment preparation / retirement period */
+#define PCAP_MMAP_SLOT_CNT              4       /* mapped segments: active, prepared and retiring ones */
+#define PCAP_MMAP_PREFIX_SIZE           128
+
+#define PCAP_MAGIC_USEC                 0xa1b2c3d4
+#define PCAP_MAGIC_NSEC                 0xa1b23c4d
+#define PCAP_LINKTYPE_ETHERNET          1
+#define PCAP_SNAPLEN                    65535
+
+/* T_PCAP_FRAME_IDX::byFlags */
+#define PCAP_IDX_FLAG_ECAT              0x01    /* EtherCAT frame (EtherType 0x88A4, optionally VLAN tagged) */
+#define PCAP_IDX_FLAG_RX                0x02    /* frame processed by the slaves (source MAC locally administered) */
+#define PCAP_IDX_FLAG_MARKER            0x04    /* first datagram matches the cycle marker, a TX marker frame starts a cycle */
+#define PCAP_IDX_FLAG_TRUNCATED         0x08    /* caplen < len */
+
+#define PCAP_IDX_NO_CYCLE               0xFFFFFFFF  /* frames before the first cycle marker */
+
+/* CEcPcapIndexReader::DecodeLogical() / DecodeFrameOffset() dwFrameFilter */
+#define PCAP_DECODE_RX                  0x01    /* frames returned by the slaves (inputs, WKC) */
+#define PCAP_DECODE_TX                  0x02    /* frames sent by the master (outputs) */
+#define PCAP_DECODE_MARKER              0x04    /* cycle marker frames only (the cyclic frame, one per cycle and direction) */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* pcap file header, native byte order */
+typedef struct _T_PCAP_FILE_HDR
+{
+    EC_T_DWORD          dwMagic;                            /* PCAP_MAGIC_USEC / PCAP_MAGIC_NSEC */
+    EC_T_WORD           wVersionMajor;                      /* 2 */
+    EC_T_WORD           wVersionMinor;                      /* 4 */
+    EC_T_INT            nThisZone;
+    EC_T_DWORD          dwSigFigs;
+    EC_T_DWORD          dwSnapLen;
+    EC_T_DWORD          dwLinkType;                         /* PCAP_LINKTYPE_ETHERNET */
+} T_PCAP_FILE_HDR;
+
+/* pcap record header */
+typedef struct _T_PCAP_REC_HDR
+{
+    EC_T_DWORD          dwSec;
+    EC_T_DWORD          dwFrac;                             /* us or ns, see T_PCAP_FILE_HDR::dwMagic */
+    EC_T_DWORD          dwCapLen;                           /* bytes stored */
+    EC_T_DWORD          dwLen;                              /* bytes on the wire */
+} T_PCAP_REC_HDR;
+
+typedef struct _T_PCAP_MMAP_STATS
+{
+    EC_T_UINT64         qwFrames;                           /* frames written */
+    EC_T_UINT64         qwBytes;                            /* bytes written incl. record headers */
+    EC_T_UINT64         qwDropped;                          /* frames lost: no prepared segment, frame larger than a segment */
+    EC_T_DWORD          dwSegments;                         /* segment files created */
+    EC_T_DWORD          dwDeleted;                          /* segment files deleted (dwMaxSegments) */
+    EC_T_DWORD          dwErrors;                           /* segment preparation / retirement errors */
+} T_PCAP_MMAP_STATS;
+
+/* one frame of the reader's index */
+typedef struct _T_PCAP_FRAME_IDX
+{
+    EC_T_UINT64         qwOffset;                           /* file offset of the frame data */
+    EC_T_UINT64         qwTimeNsec;                         /* timestamp in ns since the epoch */
+    EC_T_DWORD          dwCycle;                            /* cycle number, PCAP_IDX_NO_CYCLE before the first marker */
+    EC_T_WORD           wCapLen;
+    EC_T_BYTE           byFlags;                            /* PCAP_IDX_FLAG_* */
+    EC_T_BYTE           byEcatOffset;                       /* offset of the EtherCAT header (14 or 18 with VLAN) */
+} T_PCAP_FRAME_IDX;
+
+/* frame returned by CEcPcapIndexReader::GetFrame(), points into the mapping */
+typedef struct _T_PCAP_FRAME
+{
+    const EC_T_BYTE*    pbyData;
+    EC_T_DWORD          dwLen;
+    EC_T_UINT64         qwTimeNsec;
+    EC_T_DWORD          dwCycle;
+    EC_T_DWORD          dwFlags;                            /* PCAP_IDX_FLAG_* */
+} T_PCAP_FRAME;
+
+/* one decoded value */
+typedef struct _T_PCAP_PD_SAMPLE
+{
+    EC_T_UINT64         qwTimeNsec;
+    EC_T_DWORD          dwCycle;
+    EC_T_DWORD          dwFrame;                            /* frame index */
+    EC_T_WORD           wWkc;                               /* working counter of the datagram (DecodeLogical() only) */
+    EC_T_BYTE           abyData[8];                         /* up to 8 bytes, little endian as on the wire */
+} T_PCAP_PD_SAMPLE;
+
+struct _T_PCAP_MMAP_SEG;
+
+/*-CLASS---------------------------------------------------------------------*/
+class CEcPcapMmapRecorder
+{
+public:
+    CEcPcapMmapRecorder();
+    ~CEcPcapMmapRecorder();
+
+    /* segment files are named <szPrefix>.<00000>.pcap, numbering continues after the highest existing file and
+     * existing files count against dwMaxSegments; the first segment is prepared before returning */
+    EC_T_DWORD  Start(const EC_T_CHAR* szPrefix, EC_T_CPUSET CpuSet, EC_T_DWORD dwPrio,
+                      EC_T_DWORD dwSegmentMb = PCAP_MMAP_DEFAULT_SEGMENT_MB, EC_T_DWORD dwSegmentSec = PCAP_MMAP_DEFAULT_SEGMENT_SEC,
+                      EC_T_DWORD dwMaxSegments = PCAP_MMAP_DEFAULT_MAX_SEGMENTS, EC_T_DWORD dwPeriodMsec = PCAP_MMAP_DEFAULT_PERIOD);
+    /* the frame callback must be removed before, the active segment is truncated to its used size */
+    EC_T_VOID   Stop(EC_T_VOID);
+    EC_T_BOOL   IsRunning(EC_T_VOID) { return m_bRunning; }
+
+    EC_T_VOID   GetStats(T_PCAP_MMAP_STATS* pStats);
+
+    /* record one frame, may be called from several threads */
+    EC_T_VOID   LogFrame(EC_T_DWORD dwFrameSize, const EC_T_BYTE* pbyFrame);
+
+    /* EC_T_PFLOGFRAME_CB for CFrameLogMultiplexer::AddFrameLogger(), pvContext is the CEcPcapMmapRecorder instance */
+    static EC_T_VOID EC_FNCALL LogFrameCallback(EC_T_VOID* pvContext, EC_T_DWORD dwLogFlags, EC_T_DWORD dwFrameSize, EC_T_BYTE* pbyFrame);
+
+private:
+    EC_T_VOID   ScanSegments(EC_T_VOID);
+    EC_T_DWORD  PrepareSegment(struct _T_PCAP_MMAP_SEG* pSeg);
+    EC_T_VOID   RetireSegment(struct _T_PCAP_MMAP_SEG* pSeg);
+    EC_T_VOID   DeleteOldSegments(EC_T_VOID);
+    EC_T_VOID   Maintain(EC_T_VOID);
+    EC_T_VOID   SegmentName(EC_T_DWORD dwSeq, EC_T_CHAR* szName, EC_T_DWORD dwSize);
+    EC_T_VOID   SegmentTask(EC_T_VOID);
+
+    static EC_T_VOID SegmentTaskWrapper(EC_T_VOID* pvParms);
+
+private:
+    EC_T_CHAR           m_szPrefix[PCAP_MMAP_PREFIX_SIZE];
+    EC_T_UINT64         m_qwSegmentSize;
+    EC_T_UINT64         m_qwSegmentNsec;                    /* 0: size based rotation only */
+    EC_T_DWORD          m_dwMaxSegments;
+
+    struct _T_PCAP_MMAP_SEG* m_aSeg;                        /* [PCAP_MMAP_SLOT_CNT] */
+    struct _T_PCAP_MMAP_SEG* m_pActive;                     /* written by LogFrame(), protected by m_dwLock */
+    volatile EC_T_DWORD m_dwLock;                           /* spin lock, held for the space reservation only */
+    EC_T_DWORD          m_dwNextSeq;                        /* next segment file to prepare (segment thread) */
+    EC_T_DWORD          m_dwOldestSeq;                      /* oldest segment file on disk (segment thread) */
+    EC_T_DWORD          m_dwClosedCnt;                      /* closed segment files on disk (segment thread) */
+
+    volatile EC_T_UINT64 m_qwFrames;
+    volatile EC_T_UINT64 m_qwBytes;
+    volatile EC_T_UINT64 m_qwDropped;
+    volatile EC_T_DWORD m_dwSegments;
+    volatile EC_T_DWORD m_dwDeleted;
+    volatile EC_T_DWORD m_dwErrors;
+
+    EC_T_DWORD          m_dwPeriodMsec;
+    EC_T_VOID*          m_pvThread;
+    volatile EC_T_BOOL  m_bShutdown;
+    volatile EC_T_BOOL  m_bThreadRunning;
+    volatile EC_T_BOOL  m_bRunning;
+};
+
+class CEcPcapIndexReader
+{
+public:
+    CEcPcapIndexReader();
+    ~CEcPcapIndexReader();
+
+    /* map the file and build the index; a truncated last record (recorder killed) ends the index */
+    EC_T_DWORD  Open(const EC_T_CHAR* szFileName);
+    EC_T_VOID   Close(EC_T_VOID);
+
+    /* cycle marker: first datagram command and address of the TX frame that starts a cycle, rebuilds the cycle index;
+     * by default the first TX frame with a logical command (LRD/LWR/LRW) in its first datagram defines the marker */
+    EC_T_DWORD  SetCycleMarker(EC_T_BYTE byCmd, EC_T_DWORD dwAddr);
+
+    EC_T_DWORD  GetFrameCnt(EC_T_VOID) { return m_dwFrameCnt; }
+    EC_T_DWORD  GetCycleCnt(EC_T_VOID) { return m_dwCycleCnt; }
+    const T_PCAP_FRAME_IDX* GetIndex(EC_T_VOID) { return m_aIdx; }
+
+    EC_T_DWORD  GetFrame(EC_T_DWORD dwFrame, T_PCAP_FRAME* pFrame);
+    /* first frame with a timestamp >= qwTimeNsec (GetFrameCnt() if none) */
+    EC_T_DWORD  FindFrameByTime(EC_T_UINT64 qwTimeNsec);
+    /* first frame of the cycle (GetFrameCnt() if the cycle does not exist) */
+    EC_T_DWORD  GetCycleFirstFrame(EC_T_DWORD dwCycle);
+
+    /* dwSize (1..8) bytes at logical address dwLogAddr from every matching frame in [dwFirstFrame, dwEndFrame)
+     * covered by a single LRD/LWR/LRW datagram, up to dwMaxSamples samples */
+    EC_T_DWORD  DecodeLogical(EC_T_DWORD dwLogAddr, EC_T_DWORD dwSize, EC_T_DWORD dwFrameFilter,
+                              EC_T_DWORD dwFirstFrame, EC_T_DWORD dwEndFrame,
+                              T_PCAP_PD_SAMPLE* pSamples, EC_T_DWORD dwMaxSamples, EC_T_DWORD* pdwSampleCnt);
+    /* dwSize (1..8) bytes at dwOffset of the Ethernet frame from every matching frame in [dwFirstFrame, dwEndFrame) */
+    EC_T_DWORD  DecodeFrameOffset(EC_T_DWORD dwOffset, EC_T_DWORD dwSize, EC_T_DWORD dwFrameFilter,
+                                  EC_T_DWORD dwFirstFrame, EC_T_DWORD dwEndFrame,
+                                  T_PCAP_PD_SAMPLE* pSamples, EC_T_DWORD dwMaxSamples, EC_T_DWORD* pdwSampleCnt);
+
+private:
+    EC_T_DWORD  BuildIndex(EC_T_VOID);
+    EC_T_DWORD  BuildCycleIndex(EC_T_VOID);
+    EC_T_BOOL   FrameMatches(const T_PCAP_FRAME_IDX* pIdx, EC_T_DWORD dwFrameFilter);
+
+private:
+    EC_T_INT            m_nFd;
+    const EC_T_BYTE*    m_pbyMap;
+    EC_T_UINT64         m_qwMapSize;
+    EC_T_BOOL           m_bSwapped;                         /* file written with the other byte order */
+    EC_T_BOOL           m_bNsec;
+
+    T_PCAP_FRAME_IDX*   m_aIdx;
+    EC_T_DWORD          m_dwFrameCnt;
+    EC_T_DWORD          m_dwIdxSize;
+    EC_T_DWORD*         m_adwCycleFirst;                    /* [m_dwCycleCnt] first frame of each cycle */
+    EC_T_DWORD          m_dwCycleCnt;
+
+    EC_T_BOOL           m_bMarkerValid;
+    EC_T_BYTE           m_byMarkerCmd;
+    EC_T_DWORD          m_dwMarkerAddr;
+};
+
+#endif /* INC_ECPCAPMMAP_H */
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
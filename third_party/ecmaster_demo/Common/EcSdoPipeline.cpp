@@ -0,0 +1,672 @@
+/*-----------------------------------------------------------------------------
+ * EcSdoPipeline.cpp
+ * Description              Asynchronous, coalescing CoE SDO pipeline
+ *---------------------------------------------------------------------------*/
+
+/*-LOGGING-------------------------------------------------------------------*/
+#define pEcLogParms (&(m_pAppContext->LogParms))
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+#include "EcSdoPipeline.h"
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define SDO_PIPE_LANE_WAIT      100     /* ms, lane wakes up at least this often to check for shutdown */
+#define SDO_PIPE_STOP_TIMEOUT   5000    /* ms, added to the SDO timeout so that a running transfer can finish */
+
+/* run flags are also read outside the lock (IsRunning(), Stop() polling the lanes) */
+#define SDO_PIPE_LOAD_ACQ(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SDO_PIPE_STORE_REL(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*-LOCAL TYPES---------------------------------------------------------------*/
+/* snapshot of a finished entry, completions are signalled outside the lock */
+typedef struct _T_SDO_PIPE_DONE
+{
+    EC_T_WORD           wIndex;
+    EC_T_BYTE           bySubIndex;
+    EC_T_DWORD          dwResult;
+    EC_T_DWORD          dwOutDataLen;
+    EC_T_DWORD          dwWaiterCnt;
+    T_SDO_PIPE_WAITER   aWaiter[SDO_PIPE_MAX_WAITERS];
+} T_SDO_PIPE_DONE;
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_VOID SdoPipeSignal(EC_T_WORD wStationAddress, T_SDO_PIPE_DONE* pDone)
+{
+    EC_T_DWORD dwIdx = 0;
+
+    for (dwIdx = 0; dwIdx < pDone->dwWaiterCnt; dwIdx++)
+    {
+        T_SDO_PIPE_WAITER* pWaiter = &pDone->aWaiter[dwIdx];
+
+        if (EC_NULL != pWaiter->pHandle)
+        {
+            pWaiter->pHandle->dwResult     = pDone->dwResult;
+            pWaiter->pHandle->dwOutDataLen = pDone->dwOutDataLen;
+            SDO_PIPE_HANDLE_SET_DONE(pWaiter->pHandle);
+        }
+        if (EC_NULL != pWaiter->pfnDone)
+        {
+            pWaiter->pfnDone(pWaiter->pvContext, wStationAddress, pDone->wIndex, pDone->bySubIndex, pDone->dwResult);
+        }
+    }
+}
+
+/* batch order: by object, and by enqueue order for the same object (read after write) */
+static EC_T_BOOL SdoPipeEntryLess(const T_SDO_PIPE_ENTRY* pA, const T_SDO_PIPE_ENTRY* pB)
+{
+    if (pA->wIndex != pB->wIndex)         return pA->wIndex < pB->wIndex;
+    if (pA->bySubIndex != pB->bySubIndex) return pA->bySubIndex < pB->bySubIndex;
+    return (EC_T_INT)(pA->dwSeq - pB->dwSeq) < 0;
+}
+
+/*-CLASS FUNCTIONS-----------------------------------------------------------*/
+/*****************************************************************************/
+/**
+ * \brief  Constructor.
+ */
+CEcSdoPipeline::CEcSdoPipeline(struct _T_EC_DEMO_APP_CONTEXT* pAppContext)
+    : m_pAppContext(pAppContext)
+    , m_poLock(EC_NULL)
+    , m_aSlave(EC_NULL)
+    , m_dwSeq(0)
+    , m_dwNumLanes(0)
+    , m_dwTimeout(SDO_PIPE_DEFAULT_TIMEOUT)
+    , m_bShutdown(EC_FALSE)
+    , m_bRunning(EC_FALSE)
+    , m_bLaneStuck(EC_FALSE)
+{
+    OsMemset(m_apvLaneEvent, 0, sizeof(m_apvLaneEvent));
+    OsMemset(m_apvLaneThread, 0, sizeof(m_apvLaneThread));
+    OsMemset((EC_T_VOID*)m_abLaneRunning, 0, sizeof(m_abLaneRunning));
+    OsMemset(m_aLaneParms, 0, sizeof(m_aLaneParms));
+    OsMemset(&m_oStats, 0, sizeof(m_oStats));
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Destructor.
+ */
+CEcSdoPipeline::~CEcSdoPipeline()
+{
+    /* a lane still inside an SDO transfer uses the slave table and the lock: leak them */
+    if (EC_E_NOERROR != Stop())
+    {
+        return;
+    }
+    SafeOsFree(m_aSlave);
+    SafeOsDeleteLock(m_poLock);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Allocate slave tables and start the worker lanes.
+ *
+ * \return EC_E_NOERROR on success, error code otherwise.
+ */
+EC_T_DWORD CEcSdoPipeline::Start(
+    EC_T_DWORD  dwNumLanes,     /**< [in] number of worker threads (1..SDO_PIPE_MAX_LANES) */
+    EC_T_CPUSET CpuSet,         /**< [in] CPU set of the worker threads */
+    EC_T_DWORD  dwPrio,         /**< [in] priority of the worker threads */
+    EC_T_DWORD  dwTimeout       /**< [in] timeout of a single SDO transfer in ms */
+                                )
+{
+    EC_T_DWORD dwRetVal = EC_E_ERROR;
+    EC_T_DWORD dwLane   = 0;
+    EC_T_CHAR  szThreadName[20];
+
+    if (SDO_PIPE_LOAD_ACQ(&m_bRunning) || m_bLaneStuck)
+    {
+        return EC_E_INVALIDSTATE;
+    }
+    if ((0 == dwNumLanes) || (dwNumLanes > SDO_PIPE_MAX_LANES))
+    {
+        dwRetVal = EC_E_INVALIDPARM;
+        goto Exit;
+    }
+    m_dwNumLanes = dwNumLanes;
+    m_dwTimeout  = dwTimeout;
+    m_bShutdown  = EC_FALSE;
+
+    /* pre-allocate everything, queueing must not allocate */
+    if (EC_NULL == m_poLock)
+    {
+        m_poLock = OsCreateLock();
+        if (EC_NULL == m_poLock)
+        {
+            dwRetVal = EC_E_NOMEMORY;
+            goto Exit;
+        }
+    }
+    if (EC_NULL == m_aSlave)
+    {
+        m_aSlave = (T_SDO_PIPE_SLAVE*)OsMalloc(SDO_PIPE_MAX_SLAVES * sizeof(T_SDO_PIPE_SLAVE));
+        if (EC_NULL == m_aSlave)
+        {
+            dwRetVal = EC_E_NOMEMORY;
+            goto Exit;
+        }
+    }
+    OsMemset(m_aSlave, 0, SDO_PIPE_MAX_SLAVES * sizeof(T_SDO_PIPE_SLAVE));
+
+    for (dwLane = 0; dwLane < m_dwNumLanes; dwLane++)
+    {
+        m_apvLaneEvent[dwLane] = OsCreateEvent();
+        if (EC_NULL == m_apvLaneEvent[dwLane])
+        {
+            dwRetVal = EC_E_NOMEMORY;
+            goto Exit;
+        }
+        m_aLaneParms[dwLane].pThis  = this;
+        m_aLaneParms[dwLane].dwLane = dwLane;
+
+        /* set before the thread exists, Stop() must not take a lane that has not started yet as exited */
+        SDO_PIPE_STORE_REL(&m_abLaneRunning[dwLane], EC_TRUE);
+        OsSnprintf(szThreadName, sizeof(szThreadName) - 1, "tEcSdoPipe_%d", dwLane);
+        m_apvLaneThread[dwLane] = OsCreateThread(szThreadName, (EC_PF_THREADENTRY)CEcSdoPipeline::LaneTaskWrapper,
+            CpuSet, dwPrio, JOBS_THREAD_STACKSIZE, &m_aLaneParms[dwLane]);
+        if (EC_NULL == m_apvLaneThread[dwLane])
+        {
+            SDO_PIPE_STORE_REL(&m_abLaneRunning[dwLane], EC_FALSE);
+            EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot create SDO pipeline lane %d\n", dwLane));
+            dwRetVal = EC_E_ERROR;
+            goto Exit;
+        }
+    }
+    SDO_PIPE_STORE_REL(&m_bRunning, EC_TRUE);
+
+    dwRetVal = EC_E_NOERROR;
+Exit:
+    if (EC_E_NOERROR != dwRetVal)
+    {
+        Stop();
+    }
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Stop the worker lanes, cancel all requests not executed yet.
+ *
+ * New requests are rejected from the moment m_bRunning is cleared under the lock,
+ * Enqueue() signals its lane event under the same lock, so no event is used after
+ * it has been deleted here.
+ * A lane inside an SDO transfer finishes it (at most the SDO timeout). If a lane
+ * does not exit in time its thread, event and the slave tables are kept alive,
+ * the in-flight requests are completed by the lane itself.
+ *
+ * \return EC_E_NOERROR if all lanes exited, EC_E_TIMEOUT otherwise (do not delete the pipeline then).
+ */
+EC_T_DWORD CEcSdoPipeline::Stop(EC_T_VOID)
+{
+    EC_T_DWORD dwLane  = 0;
+    EC_T_DWORD dwSlave = 0;
+    EC_T_DWORD dwEntry = 0;
+
+    if (EC_NULL != m_poLock)
+    {
+        OsLock(m_poLock);
+    }
+    SDO_PIPE_STORE_REL(&m_bRunning, EC_FALSE);
+    m_bShutdown = EC_TRUE;
+    if (EC_NULL != m_poLock)
+    {
+        OsUnlock(m_poLock);
+    }
+    for (dwLane = 0; dwLane < SDO_PIPE_MAX_LANES; dwLane++)
+    {
+        if (EC_NULL != m_apvLaneEvent[dwLane])
+        {
+            OsSetEvent(m_apvLaneEvent[dwLane]);
+        }
+    }
+    {
+        CEcTimer oTimeout(m_dwTimeout + SDO_PIPE_STOP_TIMEOUT);
+
+        for (dwLane = 0; dwLane < SDO_PIPE_MAX_LANES; dwLane++)
+        {
+            if (EC_NULL == m_apvLaneThread[dwLane])
+            {
+                SafeOsDeleteEvent(m_apvLaneEvent[dwLane]);
+                continue;
+            }
+            while (SDO_PIPE_LOAD_ACQ(&m_abLaneRunning[dwLane]) && !oTimeout.IsElapsed())
+            {
+                OsSleep(1);
+            }
+            if (SDO_PIPE_LOAD_ACQ(&m_abLaneRunning[dwLane]))
+            {
+                /* still inside emCoeSdoUpload/emCoeSdoDownload: keep its thread handle and event */
+                if (!m_bLaneStuck)
+                {
+                    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: SDO pipeline lane %d did not stop, storage kept\n", dwLane));
+                }
+                m_bLaneStuck = EC_TRUE;
+                continue;
+            }
+            OsDeleteThreadHandle(m_apvLaneThread[dwLane]);
+            m_apvLaneThread[dwLane] = EC_NULL;
+            SafeOsDeleteEvent(m_apvLaneEvent[dwLane]);
+        }
+    }
+
+    /* nobody executes the queued requests any more, release their waiters;
+       in-flight entries belong to their lane, it completes them itself */
+    if (EC_NULL != m_aSlave)
+    {
+        for (dwSlave = 0; dwSlave < SDO_PIPE_MAX_SLAVES; dwSlave++)
+        {
+            T_SDO_PIPE_SLAVE* pSlave = &m_aSlave[dwSlave];
+            T_SDO_PIPE_DONE   aDone[SDO_PIPE_MAX_ENTRIES];
+            EC_T_DWORD        dwDoneCnt = 0;
+
+            OsLock(m_poLock);
+            for (dwEntry = 0; dwEntry < SDO_PIPE_MAX_ENTRIES; dwEntry++)
+            {
+                T_SDO_PIPE_ENTRY* pEntry = &pSlave->aEntry[dwEntry];
+                T_SDO_PIPE_DONE*  pDone  = &aDone[dwDoneCnt];
+
+                if (!pEntry->bUsed || pEntry->bInFlight)
+                {
+                    continue;
+                }
+                OsMemset(pDone, 0, sizeof(T_SDO_PIPE_DONE));
+                pDone->wIndex      = pEntry->wIndex;
+                pDone->bySubIndex  = pEntry->bySubIndex;
+                pDone->dwResult    = EC_E_CANCEL;
+                pDone->dwWaiterCnt = pEntry->dwWaiterCnt;
+                OsMemcpy(pDone->aWaiter, pEntry->aWaiter, sizeof(pDone->aWaiter));
+                pEntry->bUsed = EC_FALSE;
+                dwDoneCnt++;
+            }
+            pSlave->dwPendingCnt = 0;
+            OsUnlock(m_poLock);
+
+            for (dwEntry = 0; dwEntry < dwDoneCnt; dwEntry++)
+            {
+                SdoPipeSignal(pSlave->wStationAddress, &aDone[dwEntry]);
+            }
+        }
+    }
+    return m_bLaneStuck ? EC_E_TIMEOUT : EC_E_NOERROR;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Queue a CoE SDO download.
+ *
+ * A pending (not yet executed) download of the same object is overwritten, the
+ * new request is then completed together with the merged one.
+ *
+ * \return EC_E_NOERROR if queued, error code otherwise.
+ */
+EC_T_DWORD CEcSdoPipeline::Write(
+    EC_T_WORD               wStationAddress,
+    EC_T_WORD               wIndex,
+    EC_T_BYTE               bySubIndex,
+    const EC_T_BYTE*        pbyData,
+    EC_T_DWORD              dwDataLen,
+    T_SDO_PIPE_HANDLE*      pHandle,
+    EC_PF_SDO_PIPE_DONE     pfnDone,
+    EC_T_VOID*              pvContext)
+{
+    if ((EC_NULL == pbyData) || (0 == dwDataLen))
+    {
+        return EC_E_INVALIDPARM;
+    }
+    if (dwDataLen > SDO_PIPE_MAX_DATA_LEN)
+    {
+        return EC_E_INVALIDSIZE;
+    }
+    return Enqueue(EC_FALSE, wStationAddress, wIndex, bySubIndex, (EC_T_BYTE*)pbyData, dwDataLen, pHandle, pfnDone, pvContext);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Queue a CoE SDO upload.
+ *
+ * \return EC_E_NOERROR if queued, error code otherwise.
+ */
+EC_T_DWORD CEcSdoPipeline::Read(
+    EC_T_WORD               wStationAddress,
+    EC_T_WORD               wIndex,
+    EC_T_BYTE               bySubIndex,
+    EC_T_BYTE*              pbyData,
+    EC_T_DWORD              dwDataLen,
+    T_SDO_PIPE_HANDLE*      pHandle,
+    EC_PF_SDO_PIPE_DONE     pfnDone,
+    EC_T_VOID*              pvContext)
+{
+    if ((EC_NULL == pbyData) || (0 == dwDataLen))
+    {
+        return EC_E_INVALIDPARM;
+    }
+    return Enqueue(EC_TRUE, wStationAddress, wIndex, bySubIndex, pbyData, dwDataLen, pHandle, pfnDone, pvContext);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Wait for completion of a queued request.
+ *
+ * \return result of the SDO transfer, EC_E_TIMEOUT if not done within dwTimeout.
+ */
+EC_T_DWORD CEcSdoPipeline::Wait(T_SDO_PIPE_HANDLE* pHandle, EC_T_DWORD dwTimeout)
+{
+    CEcTimer oTimeout(dwTimeout);
+
+    if (EC_NULL == pHandle)
+    {
+        return EC_E_INVALIDPARM;
+    }
+    while (!SDO_PIPE_HANDLE_DONE(pHandle) && !oTimeout.IsElapsed())
+    {
+        OsSleep(1);
+    }
+    return SDO_PIPE_HANDLE_DONE(pHandle) ? pHandle->dwResult : EC_E_TIMEOUT;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Copy of the pipeline counters.
+ */
+EC_T_VOID CEcSdoPipeline::GetStats(T_SDO_PIPE_STATS* pStats)
+{
+    if ((EC_NULL == pStats) || (EC_NULL == m_poLock))
+    {
+        return;
+    }
+    OsLock(m_poLock);
+    OsMemcpy(pStats, &m_oStats, sizeof(T_SDO_PIPE_STATS));
+    OsUnlock(m_poLock);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Insert a request into the table of its slave.
+ */
+EC_T_DWORD CEcSdoPipeline::Enqueue(
+    EC_T_BOOL               bRead,
+    EC_T_WORD               wStationAddress,
+    EC_T_WORD               wIndex,
+    EC_T_BYTE               bySubIndex,
+    EC_T_BYTE*              pbyData,
+    EC_T_DWORD              dwDataLen,
+    T_SDO_PIPE_HANDLE*      pHandle,
+    EC_PF_SDO_PIPE_DONE     pfnDone,
+    EC_T_VOID*              pvContext)
+{
+    EC_T_DWORD          dwRetVal = EC_E_ERROR;
+    T_SDO_PIPE_SLAVE*   pSlave   = EC_NULL;
+    T_SDO_PIPE_ENTRY*   pEntry   = EC_NULL;
+    T_SDO_PIPE_ENTRY*   pNewest  = EC_NULL;
+    EC_T_DWORD          dwLane   = 0;
+    EC_T_DWORD          dwIdx    = 0;
+
+    if (!SDO_PIPE_LOAD_ACQ(&m_bRunning))
+    {
+        return EC_E_INVALIDSTATE;
+    }
+    if (EC_NULL != pHandle)
+    {
+        pHandle->bDone        = EC_FALSE;
+        pHandle->dwResult     = EC_E_BUSY;
+        pHandle->dwOutDataLen = 0;
+    }
+
+    OsLock(m_poLock);
+    if (!SDO_PIPE_LOAD_ACQ(&m_bRunning))
+    {
+        /* Stop() in progress, it would not cancel a request queued after its sweep */
+        dwRetVal = EC_E_INVALIDSTATE;
+        goto Exit;
+    }
+    pSlave = GetSlave(wStationAddress);
+    if (EC_NULL == pSlave)
+    {
+        m_oStats.dwRejected++;
+        dwRetVal = EC_E_NOMEMORY;
+        goto Exit;
+    }
+
+    /* coalesce: the newest not yet executed request of this object is a write -> overwrite its value */
+    if (!bRead)
+    {
+        for (dwIdx = 0; dwIdx < SDO_PIPE_MAX_ENTRIES; dwIdx++)
+        {
+            T_SDO_PIPE_ENTRY* pCur = &pSlave->aEntry[dwIdx];
+
+            if (pCur->bUsed && !pCur->bInFlight && (pCur->wIndex == wIndex) && (pCur->bySubIndex == bySubIndex))
+            {
+                if ((EC_NULL == pNewest) || ((EC_T_INT)(pCur->dwSeq - pNewest->dwSeq) > 0))
+                {
+                    pNewest = pCur;
+                }
+            }
+        }
+        if ((EC_NULL != pNewest) && !pNewest->bRead && (pNewest->dwWaiterCnt < SDO_PIPE_MAX_WAITERS))
+        {
+            pEntry = pNewest;
+            m_oStats.dwCoalesced++;
+        }
+    }
+    if (EC_NULL == pEntry)
+    {
+        for (dwIdx = 0; dwIdx < SDO_PIPE_MAX_ENTRIES; dwIdx++)
+        {
+            if (!pSlave->aEntry[dwIdx].bUsed)
+            {
+                pEntry = &pSlave->aEntry[dwIdx];
+                break;
+            }
+        }
+        if (EC_NULL == pEntry)
+        {
+            m_oStats.dwRejected++;
+            dwRetVal = EC_E_BUSY;
+            goto Exit;
+        }
+        OsMemset(pEntry, 0, sizeof(T_SDO_PIPE_ENTRY));
+        pEntry->bUsed      = EC_TRUE;
+        pEntry->bRead      = bRead;
+        pEntry->dwSeq      = m_dwSeq++;
+        pEntry->wIndex     = wIndex;
+        pEntry->bySubIndex = bySubIndex;
+        pSlave->dwPendingCnt++;
+    }
+
+    pEntry->dwDataLen = dwDataLen;
+    if (bRead)
+    {
+        pEntry->pbyReadData = pbyData;
+    }
+    else
+    {
+        OsMemcpy(pEntry->abyData, pbyData, dwDataLen);
+    }
+    pEntry->aWaiter[pEntry->dwWaiterCnt].pHandle   = pHandle;
+    pEntry->aWaiter[pEntry->dwWaiterCnt].pfnDone   = pfnDone;
+    pEntry->aWaiter[pEntry->dwWaiterCnt].pvContext = pvContext;
+    pEntry->dwWaiterCnt++;
+
+    m_oStats.dwQueued++;
+    dwLane = pSlave->dwLane;
+    dwRetVal = EC_E_NOERROR;
+
+Exit:
+    if (EC_E_NOERROR == dwRetVal)
+    {
+        /* still under the lock: Stop() clears m_bRunning under it before it deletes the lane events */
+        OsSetEvent(m_apvLaneEvent[dwLane]);
+    }
+    OsUnlock(m_poLock);
+    return dwRetVal;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Find or register the table of a slave, caller holds the lock.
+ */
+T_SDO_PIPE_SLAVE* CEcSdoPipeline::GetSlave(EC_T_WORD wStationAddress)
+{
+    EC_T_DWORD dwIdx = 0;
+
+    for (dwIdx = 0; dwIdx < SDO_PIPE_MAX_SLAVES; dwIdx++)
+    {
+        if (m_aSlave[dwIdx].bUsed && (m_aSlave[dwIdx].wStationAddress == wStationAddress))
+        {
+            return &m_aSlave[dwIdx];
+        }
+    }
+    for (dwIdx = 0; dwIdx < SDO_PIPE_MAX_SLAVES; dwIdx++)
+    {
+        if (!m_aSlave[dwIdx].bUsed)
+        {
+            /* one slave always on the same lane: requests of a slave stay in order */
+            m_aSlave[dwIdx].bUsed           = EC_TRUE;
+            m_aSlave[dwIdx].wStationAddress = wStationAddress;
+            m_aSlave[dwIdx].dwLane          = dwIdx % m_dwNumLanes;
+            return &m_aSlave[dwIdx];
+        }
+    }
+    return EC_NULL;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Execute all pending requests of one slave as one batch.
+ */
+EC_T_VOID CEcSdoPipeline::ProcessSlave(T_SDO_PIPE_SLAVE* pSlave)
+{
+    T_SDO_PIPE_ENTRY* apBatch[SDO_PIPE_MAX_ENTRIES];
+    T_SDO_PIPE_DONE   aDone[SDO_PIPE_MAX_ENTRIES];
+    EC_T_DWORD        dwBatchCnt = 0;
+    EC_T_DWORD        dwFailed   = 0;
+    EC_T_DWORD        dwSlaveId  = INVALID_SLAVE_ID;
+    EC_T_DWORD        dwIdx      = 0;
+    EC_T_DWORD        dwSort     = 0;
+
+    /* take all pending entries, from now on they are no longer coalesced */
+    OsLock(m_poLock);
+    for (dwIdx = 0; dwIdx < SDO_PIPE_MAX_ENTRIES; dwIdx++)
+    {
+        T_SDO_PIPE_ENTRY* pEntry = &pSlave->aEntry[dwIdx];
+
+        if (pEntry->bUsed && !pEntry->bInFlight)
+        {
+            pEntry->bInFlight = EC_TRUE;
+
+            /* insertion sort, the batch is small */
+            for (dwSort = dwBatchCnt; (dwSort > 0) && SdoPipeEntryLess(pEntry, apBatch[dwSort - 1]); dwSort--)
+            {
+                apBatch[dwSort] = apBatch[dwSort - 1];
+            }
+            apBatch[dwSort] = pEntry;
+            dwBatchCnt++;
+        }
+    }
+    pSlave->dwPendingCnt = 0;
+    OsUnlock(m_poLock);
+
+    if (0 == dwBatchCnt)
+    {
+        return;
+    }
+
+    /* in-flight entries are owned by this lane, no lock needed while transferring */
+    dwSlaveId = emGetSlaveId(m_pAppContext->dwInstanceId, pSlave->wStationAddress);
+    for (dwIdx = 0; dwIdx < dwBatchCnt; dwIdx++)
+    {
+        T_SDO_PIPE_ENTRY* pEntry = apBatch[dwIdx];
+        T_SDO_PIPE_DONE*  pDone  = &aDone[dwIdx];
+
+        pDone->wIndex       = pEntry->wIndex;
+        pDone->bySubIndex   = pEntry->bySubIndex;
+        pDone->dwOutDataLen = 0;
+        if (INVALID_SLAVE_ID == dwSlaveId)
+        {
+            pDone->dwResult = EC_E_NOTFOUND;
+        }
+        else if (m_bShutdown)
+        {
+            pDone->dwResult = EC_E_CANCEL;
+        }
+        else if (pEntry->bRead)
+        {
+            pDone->dwResult = emCoeSdoUpload(m_pAppContext->dwInstanceId, dwSlaveId, pEntry->wIndex, pEntry->bySubIndex,
+                pEntry->pbyReadData, pEntry->dwDataLen, &pDone->dwOutDataLen, m_dwTimeout, 0);
+        }
+        else
+        {
+            pDone->dwResult = emCoeSdoDownload(m_pAppContext->dwInstanceId, dwSlaveId, pEntry->wIndex, pEntry->bySubIndex,
+                pEntry->abyData, pEntry->dwDataLen, m_dwTimeout, 0);
+        }
+        if (EC_E_NOERROR != pDone->dwResult)
+        {
+            dwFailed++;
+            if (EC_E_CANCEL != pDone->dwResult)
+            {
+                EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "SDO pipeline: %s 0x%04X:%d of slave %d failed: %s (0x%lx)\n",
+                    pEntry->bRead ? "upload" : "download", pEntry->wIndex, pEntry->bySubIndex, pSlave->wStationAddress,
+                    ecatGetText(pDone->dwResult), pDone->dwResult));
+            }
+        }
+    }
+
+    /* release the entries, then signal the waiters without holding the lock */
+    OsLock(m_poLock);
+    for (dwIdx = 0; dwIdx < dwBatchCnt; dwIdx++)
+    {
+        aDone[dwIdx].dwWaiterCnt = apBatch[dwIdx]->dwWaiterCnt;
+        OsMemcpy(aDone[dwIdx].aWaiter, apBatch[dwIdx]->aWaiter, sizeof(aDone[dwIdx].aWaiter));
+        apBatch[dwIdx]->bUsed     = EC_FALSE;
+        apBatch[dwIdx]->bInFlight = EC_FALSE;
+    }
+    m_oStats.dwBatches++;
+    m_oStats.dwExecuted += dwBatchCnt;
+    m_oStats.dwFailed   += dwFailed;
+    OsUnlock(m_poLock);
+
+    for (dwIdx = 0; dwIdx < dwBatchCnt; dwIdx++)
+    {
+        SdoPipeSignal(pSlave->wStationAddress, &aDone[dwIdx]);
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Worker lane: serves all slaves assigned to it.
+ */
+EC_T_VOID CEcSdoPipeline::LaneTask(EC_T_DWORD dwLane)
+{
+    EC_T_DWORD dwIdx    = 0;
+    EC_T_BOOL  bPending = EC_FALSE;
+
+    while (!m_bShutdown)
+    {
+        OsWaitForEvent(m_apvLaneEvent[dwLane], SDO_PIPE_LANE_WAIT);
+
+        for (dwIdx = 0; (dwIdx < SDO_PIPE_MAX_SLAVES) && !m_bShutdown; dwIdx++)
+        {
+            T_SDO_PIPE_SLAVE* pSlave = &m_aSlave[dwIdx];
+
+            OsLock(m_poLock);
+            bPending = pSlave->bUsed && (pSlave->dwLane == dwLane) && (0 != pSlave->dwPendingCnt);
+            OsUnlock(m_poLock);
+            if (bPending)
+            {
+                ProcessSlave(pSlave);
+            }
+        }
+    }
+    /* last access to the pipeline from this lane, Stop() may free the storage right after */
+    SDO_PIPE_STORE_REL(&m_abLaneRunning[dwLane], EC_FALSE);
+}
+
+EC_T_VOID CEcSdoPipeline::LaneTaskWrapper(EC_T_VOID* pvParms)
+{
+    struct _T_LANE_PARMS* pParms = (struct _T_LANE_PARMS*)pvParms;
+
+    pParms->pThis->LaneTask(pParms->dwLane);
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,169 @@
+/*-----------------------------------------------------------------------------
+ * EcSdoPipeline.h
+ * Description              Asynchronous, coalescing CoE SDO pipeline
+ *---------------------------------------------------------------------------*/
+
+/* =============================================================================
+ * 文件解读：
+ * 非 PDO 对象（例如 kp/kd 的 0x3500/0x3501）只能走 CoE SDO，而 `ecatCoeSdoDownload()`
+ * 是阻塞调用，一次往返要若干个总线周期。本模块把这些 SDO 请求从调用线程里剥离出来：
+ * - 每个从站一张“待处理对象表”，同一对象 (index, subindex) 的多次写入只保留最新值（合并）
+ * - 工作线程一次取走某个从站的全部待处理对象，按 index 顺序连续执行（批处理）
+ * - 多个 lane（工作线程）并行服务不同从站；同一从站固定落在同一 lane，保证顺序
+ * - 请求以 handle（T_SDO_PIPE_HANDLE，调用方持有）和/或回调返回结果，调用方不阻塞
+ *
+ * 全部存储在 Start() 时一次性分配，入队路径只有一次加锁 + 拷贝，不做动态内存分配。
+ * ============================================================================= */
+
+#ifndef INC_ECSDOPIPELINE_H
+#define INC_ECSDOPIPELINE_H 1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#ifndef INC_ECMASTER
+#include "EcMaster.h"
+#endif
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define SDO_PIPE_MAX_SLAVES         32      /* max. number of slaves served by the pipeline */
+#define SDO_PIPE_MAX_ENTRIES        16      /* max. number of pending objects per slave */
+#define SDO_PIPE_MAX_WAITERS        4       /* max. number of requests coalesced into one object write */
+#define SDO_PIPE_MAX_LANES          4       /* max. number of worker threads */
+#define SDO_PIPE_MAX_DATA_LEN       8       /* max. size of a coalesced write (bytes) */
+#define SDO_PIPE_DEFAULT_TIMEOUT    1000    /* default timeout of a single SDO transfer (ms) */
+
+/* handle completion: dwResult/dwOutDataLen are written first, then bDone is published with release,
+ * pollers load bDone with acquire before they read the result fields */
+#define SDO_PIPE_HANDLE_DONE(pHandle)       __atomic_load_n(&(pHandle)->bDone, __ATOMIC_ACQUIRE)
+#define SDO_PIPE_HANDLE_SET_DONE(pHandle)   __atomic_store_n(&(pHandle)->bDone, EC_TRUE, __ATOMIC_RELEASE)
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* completion callback, called from the worker thread (keep it short) */
+typedef EC_T_VOID (*EC_PF_SDO_PIPE_DONE)(
+    EC_T_VOID*  pvContext,
+    EC_T_WORD   wStationAddress,
+    EC_T_WORD   wIndex,
+    EC_T_BYTE   bySubIndex,
+    EC_T_DWORD  dwResult);
+
+/* caller owned completion handle, must stay valid until bDone is set */
+typedef struct _T_SDO_PIPE_HANDLE
+{
+    EC_T_BOOL           bDone;              /* EC_TRUE when the request has been executed, see SDO_PIPE_HANDLE_DONE() */
+    EC_T_DWORD          dwResult;           /* result of the SDO transfer */
+    EC_T_DWORD          dwOutDataLen;       /* read: number of bytes uploaded */
+} T_SDO_PIPE_HANDLE;
+
+typedef struct _T_SDO_PIPE_WAITER
+{
+    T_SDO_PIPE_HANDLE*  pHandle;
+    EC_PF_SDO_PIPE_DONE pfnDone;
+    EC_T_VOID*          pvContext;
+} T_SDO_PIPE_WAITER;
+
+typedef struct _T_SDO_PIPE_ENTRY
+{
+    EC_T_BOOL           bUsed;              /* slot holds a request */
+    EC_T_BOOL           bInFlight;          /* request taken by the worker, no more coalescing */
+    EC_T_BOOL           bRead;              /* EC_TRUE: upload, EC_FALSE: download */
+    EC_T_DWORD          dwSeq;              /* enqueue order */
+    EC_T_WORD           wIndex;
+    EC_T_BYTE           bySubIndex;
+    EC_T_DWORD          dwDataLen;
+    EC_T_BYTE           abyData[SDO_PIPE_MAX_DATA_LEN]; /* write: latest value */
+    EC_T_BYTE*          pbyReadData;        /* read: caller buffer */
+    EC_T_DWORD          dwWaiterCnt;
+    T_SDO_PIPE_WAITER   aWaiter[SDO_PIPE_MAX_WAITERS];
+} T_SDO_PIPE_ENTRY;
+
+typedef struct _T_SDO_PIPE_SLAVE
+{
+    EC_T_BOOL           bUsed;
+    EC_T_WORD           wStationAddress;
+    EC_T_DWORD          dwLane;             /* worker lane serving this slave */
+    EC_T_DWORD          dwPendingCnt;       /* entries not yet taken by the worker */
+    T_SDO_PIPE_ENTRY    aEntry[SDO_PIPE_MAX_ENTRIES];
+} T_SDO_PIPE_SLAVE;
+
+typedef struct _T_SDO_PIPE_STATS
+{
+    EC_T_DWORD          dwQueued;           /* requests accepted */
+    EC_T_DWORD          dwCoalesced;        /* writes merged into a pending object */
+    EC_T_DWORD          dwExecuted;         /* SDO transfers executed */
+    EC_T_DWORD          dwBatches;          /* per-slave batches executed */
+    EC_T_DWORD          dwFailed;           /* SDO transfers failed */
+    EC_T_DWORD          dwRejected;         /* requests rejected (queue full) */
+} T_SDO_PIPE_STATS;
+
+/*-CLASS---------------------------------------------------------------------*/
+class CEcSdoPipeline
+{
+public:
+    explicit CEcSdoPipeline(struct _T_EC_DEMO_APP_CONTEXT* pAppContext);
+    ~CEcSdoPipeline();
+
+    EC_T_DWORD  Start(EC_T_DWORD dwNumLanes, EC_T_CPUSET CpuSet, EC_T_DWORD dwPrio, EC_T_DWORD dwTimeout = SDO_PIPE_DEFAULT_TIMEOUT);
+    /* EC_E_TIMEOUT: a lane is still inside an SDO transfer, its storage is kept (do not delete the pipeline) */
+    EC_T_DWORD  Stop(EC_T_VOID);
+    EC_T_BOOL   IsRunning(EC_T_VOID) { return __atomic_load_n(&m_bRunning, __ATOMIC_ACQUIRE); }
+
+    /* queue a download, a pending write of the same object is overwritten with the new value */
+    EC_T_DWORD  Write(
+        EC_T_WORD               wStationAddress,
+        EC_T_WORD               wIndex,
+        EC_T_BYTE               bySubIndex,
+        const EC_T_BYTE*        pbyData,
+        EC_T_DWORD              dwDataLen,
+        T_SDO_PIPE_HANDLE*      pHandle   = EC_NULL,
+        EC_PF_SDO_PIPE_DONE     pfnDone   = EC_NULL,
+        EC_T_VOID*              pvContext = EC_NULL);
+
+    /* queue an upload into pbyData (must stay valid until completion) */
+    EC_T_DWORD  Read(
+        EC_T_WORD               wStationAddress,
+        EC_T_WORD               wIndex,
+        EC_T_BYTE               bySubIndex,
+        EC_T_BYTE*              pbyData,
+        EC_T_DWORD              dwDataLen,
+        T_SDO_PIPE_HANDLE*      pHandle   = EC_NULL,
+        EC_PF_SDO_PIPE_DONE     pfnDone   = EC_NULL,
+        EC_T_VOID*              pvContext = EC_NULL);
+
+    /* poll a handle until done or timeout */
+    static EC_T_DWORD Wait(T_SDO_PIPE_HANDLE* pHandle, EC_T_DWORD dwTimeout);
+
+    EC_T_VOID   GetStats(T_SDO_PIPE_STATS* pStats);
+
+private:
+    EC_T_DWORD  Enqueue(EC_T_BOOL bRead, EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                        EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                        T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext);
+    T_SDO_PIPE_SLAVE* GetSlave(EC_T_WORD wStationAddress);
+    EC_T_VOID   ProcessSlave(T_SDO_PIPE_SLAVE* pSlave);
+    EC_T_VOID   LaneTask(EC_T_DWORD dwLane);
+
+    static EC_T_VOID LaneTaskWrapper(EC_T_VOID* pvParms);
+
+private:
+    struct _T_EC_DEMO_APP_CONTEXT* m_pAppContext;
+    EC_T_VOID*          m_poLock;                           /* protects slave tables and stats */
+    T_SDO_PIPE_SLAVE*   m_aSlave;                           /* SDO_PIPE_MAX_SLAVES entries */
+    EC_T_DWORD          m_dwSeq;
+    EC_T_DWORD          m_dwNumLanes;
+    EC_T_DWORD          m_dwTimeout;
+    EC_T_VOID*          m_apvLaneEvent[SDO_PIPE_MAX_LANES];
+    EC_T_VOID*          m_apvLaneThread[SDO_PIPE_MAX_LANES];
+    EC_T_BOOL           m_abLaneRunning[SDO_PIPE_MAX_LANES];    /* acquire/release, cleared by the lane on exit */
+    struct _T_LANE_PARMS
+    {
+        CEcSdoPipeline* pThis;
+        EC_T_DWORD      dwLane;
+    }                   m_aLaneParms[SDO_PIPE_MAX_LANES];
+    volatile EC_T_BOOL  m_bShutdown;
+    EC_T_BOOL           m_bRunning;     /* acquire/release, also read without the lock */
+    EC_T_BOOL           m_bLaneStuck;                       /* a lane did not exit in Stop(), storage must not be freed */
+    T_SDO_PIPE_STATS    m_oStats;
+};
+
+#endif /* INC_ECSDOPIPELINE_H */
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
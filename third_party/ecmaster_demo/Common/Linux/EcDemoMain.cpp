@@ -12,6 +12,7 @@
 
 /*-INCLUDES------------------------------------------------------------------*/
 #include "EcDemoApp.h"
+#include "motrotech.h"
 
 #include <sys/mman.h>
 #include <sys/utsname.h>
@@ -125,14 +126,7 @@ EC_T_DWORD EnableRealtimeEnvironment(EC_T_VOID)
         goto Exit;
     }
 
-    /* disable paging */
-    nRetval = mlockall(MCL_CURRENT | MCL_FUTURE);
-    if (nRetval == -1)
-    {
-        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR - cannot disable paging!\n"));
-        dwResult = EC_E_ERROR;
-        goto Exit;
-    }
+    /* paging is disabled by DemoRtLockMemory() once the command line is parsed (AppParms.bRtMemLock) */
 
     /* check if high resolution timers are available */
     if (clock_getres(CLOCK_MONOTONIC, &ts))
@@ -186,10 +180,17 @@ int main(int nArgc, char* ppArgv[])
     CAtEmLogging             oLogging;
     EC_T_BOOL                bLogInitialized = EC_FALSE;
 #endif
+    CEcCycleTrace            oCycleTrace;
+    CEcDeferredLog           oDeferredLog;
+    CEcPcapMmapRecorder      oPcapMmap;
+    T_MT_CONTEXT             oMtContext;
+    EC_T_LOG_PARMS           oSinkLogParms;
     EC_T_CHAR                szCommandLine[COMMAND_LINE_BUFFER_LENGTH];
     OsMemset(szCommandLine, '\0', COMMAND_LINE_BUFFER_LENGTH);
 
     OsMemset(&AppContext, 0, sizeof(AppContext));
+    MT_ContextCreate(&oMtContext, INSTANCE_MASTER_DEFAULT);
+    AppContext.pMtContext = &oMtContext;
 
     /* printf logging until logging initialized */
     AppContext.LogParms.dwLogLevel = EC_LOG_LEVEL_ERROR;
@@ -240,11 +241,19 @@ int main(int nArgc, char* ppArgv[])
         dwRetVal = EC_E_INVALIDPARM;
         goto Exit;
     }
+    /* -id selects the master instance for the EC-Master API calls as well, not only for the timing task */
+    AppContext.dwInstanceId = AppContext.AppParms.dwMasterInstanceId;
+    oMtContext.dwInstanceId = AppContext.dwInstanceId;
+    /* disable paging, prefault the main thread stack */
+    if (AppContext.AppParms.bRtMemLock)
+    {
+        DemoRtLockMemory(DEMO_RT_STACK_PREFAULT);
+    }
     /* initialize logging */
     if ((EC_LOG_LEVEL_SILENT != AppContext.AppParms.dwAppLogLevel) || (EC_LOG_LEVEL_SILENT != AppContext.AppParms.dwMasterLogLevel))
     {
 #if (defined INCLUDE_EC_LOGGING)
-        dwRes = oLogging.InitLogging(INSTANCE_MASTER_DEFAULT, LOG_ROLLOVER, LOG_THREAD_PRIO, AppContext.AppParms.CpuSet, AppContext.AppParms.szLogFileprefix, LOG_THREAD_STACKSIZE, AppContext.AppParms.dwLogBufferMaxMsgCnt);
+        dwRes = oLogging.InitLogging(INSTANCE_MASTER_DEFAULT, LOG_ROLLOVER, AppContext.AppParms.aRtThread[DEMO_RT_THREAD_LOG].dwPrio, GetRtThreadCpuSet(&AppContext.AppParms, DEMO_RT_THREAD_LOG), AppContext.AppParms.szLogFileprefix, LOG_THREAD_STACKSIZE, AppContext.AppParms.dwLogBufferMaxMsgCnt);
         if (EC_E_NOERROR != dwRes)
         {
             dwRetVal = dwRes;
@@ -260,6 +269,18 @@ int main(int nArgc, char* ppArgv[])
     {
         AppContext.LogParms.dwLogLevel = EC_LOG_LEVEL_SILENT;
     }
+    /* deferred logging: callers only record the message, the log thread formats and forwards it to the callback above */
+    OsMemcpy(&oSinkLogParms, &AppContext.LogParms, sizeof(EC_T_LOG_PARMS));
+    if (AppContext.AppParms.bDeferredLog && (EC_LOG_LEVEL_SILENT != AppContext.LogParms.dwLogLevel))
+    {
+        dwRes = oDeferredLog.Start(&oSinkLogParms, GetRtThreadCpuSet(&AppContext.AppParms, DEMO_RT_THREAD_LOG), AppContext.AppParms.aRtThread[DEMO_RT_THREAD_LOG].dwPrio,
+            AppContext.AppParms.dwDefLogRateBurst, AppContext.AppParms.dwDefLogRateWindowMsec);
+        if (EC_E_NOERROR == dwRes)
+        {
+            oDeferredLog.GetLogParms(&AppContext.LogParms, AppContext.LogParms.dwLogLevel);
+            AppContext.pDeferredLog = &oDeferredLog;
+        }
+    }
     OsMemcpy(G_pEcLogParms, &AppContext.LogParms, sizeof(EC_T_LOG_PARMS));
 
     EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "%s V%s for %s %s\n", EC_DEMO_APP_NAME, EC_VERSION_NUM_STR, ATECAT_PLATFORMSTR, EC_COPYRIGHT));
@@ -300,6 +321,20 @@ int main(int nArgc, char* ppArgv[])
         }
     }
 
+    /* memory-mapped pcap segment recorder, started by EcDemoApp() with -pcapmmap once the master instance exists */
+    AppContext.pPcapMmap = &oPcapMmap;
+
+    /* per-cycle timing trace (timing task wakeup, job task phases), must be set before the timing task starts */
+    dwRes = oCycleTrace.Start(GetRtThreadCpuSet(&AppContext.AppParms, DEMO_RT_THREAD_LOG), AppContext.AppParms.aRtThread[DEMO_RT_THREAD_LOG].dwPrio);
+    if (EC_E_NOERROR == dwRes)
+    {
+        AppContext.pCycleTrace = &oCycleTrace;
+    }
+    else
+    {
+        EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING, "Cycle trace not available: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
+    }
+
 #if (defined EXECUTE_DEMOTIMINGTASK)
     if (IsLinkLayerTimingSet(AppContext.AppParms.apLinkParms))
     {
@@ -339,6 +374,20 @@ Exit:
 
     EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "%s stop.\n", EC_DEMO_APP_NAME));
 
+    /* stop deferred logging, pending messages are flushed to the log callback */
+    if (EC_NULL != AppContext.pDeferredLog)
+    {
+        T_DEFLOG_STATS oStats;
+
+        OsMemcpy(&AppContext.LogParms, &oSinkLogParms, sizeof(EC_T_LOG_PARMS));
+        OsMemcpy(G_pEcLogParms, &AppContext.LogParms, sizeof(EC_T_LOG_PARMS));
+        oDeferredLog.Stop();
+        oDeferredLog.GetStats(&oStats);
+        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "Deferred log: %llu logged, %llu dropped, %llu suppressed, %llu pre-formatted, %llu truncated, %llu direct\n",
+            (unsigned long long)oStats.qwLogged, (unsigned long long)oStats.qwDropped, (unsigned long long)oStats.qwSuppressed,
+            (unsigned long long)oStats.qwPreformatted, (unsigned long long)oStats.qwTruncated, (unsigned long long)oStats.qwDirect));
+        AppContext.pDeferredLog = EC_NULL;
+    }
     /* de-initialize message logging */
 #if (defined INCLUDE_EC_LOGGING)
     if (bLogInitialized)
@@ -351,6 +400,8 @@ Exit:
 #endif
     /* free app parameters */
     FreeAppParms(&AppContext, &AppContext.AppParms);
+    MT_ContextDelete(&oMtContext);
+    AppContext.pMtContext = EC_NULL;
 
     return (EC_E_NOERROR == dwRetVal) ? 0 : -1;
 }
@@ -0,0 +1,74 @@
+/*-----------------------------------------------------------------------------
+ * EcDemoRtPlatform.cpp
+ * Description              Real-time setup of the demo process and threads (Linux)
+ *----------------------------------------------------------------------------*/
+
+/*-LOGGING-------------------------------------------------------------------*/
+#define pEcLogParms G_pEcLogParms
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*-FUNCTION-DEFINITIONS------------------------------------------------------*/
+EC_T_DWORD DemoRtLockMemory(EC_T_DWORD dwStackPrefault)
+{
+    /* disable paging */
+    if (-1 == mlockall(MCL_CURRENT | MCL_FUTURE))
+    {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR - cannot disable paging!\n"));
+        return EC_E_ERROR;
+    }
+
+    /* freed heap memory stays locked: no trimming, no mmap() for large blocks */
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    DemoRtPrefaultStack(dwStackPrefault);
+    return EC_E_NOERROR;
+}
+
+EC_T_VOID DemoRtPrefaultStack(EC_T_DWORD dwBytes)
+{
+    volatile EC_T_BYTE* pbyStack = (volatile EC_T_BYTE*)alloca(dwBytes);
+    EC_T_DWORD          dwPage   = (EC_T_DWORD)sysconf(_SC_PAGESIZE);
+    EC_T_DWORD          dwOffset = 0;
+
+    for (dwOffset = 0; dwOffset < dwBytes; dwOffset += dwPage)
+    {
+        pbyStack[dwOffset] = 0;
+    }
+}
+
+EC_T_DWORD DemoRtSetCurrentThread(T_EC_DEMO_APP_PARMS* pAppParms, EC_T_DWORD dwThread)
+{
+    EC_T_DWORD         dwRetVal = EC_E_NOERROR;
+    EC_T_CPUSET        CpuSet   = GetRtThreadCpuSet(pAppParms, dwThread);
+    struct sched_param oSchedParam;
+
+    if (dwThread >= DEMO_RT_THREAD_CNT)
+    {
+        return EC_E_INVALIDPARM;
+    }
+    OsMemset(&oSchedParam, 0, sizeof(oSchedParam));
+    oSchedParam.sched_priority = (int)pAppParms->aRtThread[dwThread].dwPrio;
+    if (0 != pthread_setschedparam(pthread_self(), SCHED_FIFO, &oSchedParam))
+    {
+        EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING, "WARNING - cannot set SCHED_FIFO priority %d (root privilege or realtime group required)\n", oSchedParam.sched_priority));
+        dwRetVal = EC_E_ERROR;
+    }
+    if (!EC_CPUSET_IS_ZERO(CpuSet) && (EC_E_NOERROR != OsSetThreadAffinity(EC_NULL, CpuSet)))
+    {
+        EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING, "WARNING - cannot set CPU affinity\n"));
+        dwRetVal = EC_E_ERROR;
+    }
+    return dwRetVal;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
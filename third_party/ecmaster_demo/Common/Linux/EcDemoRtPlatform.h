@@ -0,0 +1,19 @@
+/*-----------------------------------------------------------------------------
+ * EcDemoRtPlatform.h
+ * Description              Real-time setup of the demo process and threads (Linux)
+ *----------------------------------------------------------------------------*/
+
+#pragma once
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define DEMO_RT_STACK_PREFAULT      (64 * 1024)     /* bytes of the calling thread's stack touched by DemoRtLockMemory() */
+
+/*-FUNCTION DECLARATION------------------------------------------------------*/
+/* mlockall(), keep freed heap memory mapped and prefault dwStackPrefault bytes of the calling thread's stack */
+EC_T_DWORD DemoRtLockMemory(EC_T_DWORD dwStackPrefault);
+
+/* touch dwBytes of the calling thread's stack so that the first deep call in the cycle does not page fault */
+EC_T_VOID  DemoRtPrefaultStack(EC_T_DWORD dwBytes);
+
+/* SCHED_FIFO priority and CPU affinity of the calling thread according to T_EC_DEMO_APP_PARMS::aRtThread[dwThread] */
+EC_T_DWORD DemoRtSetCurrentThread(T_EC_DEMO_APP_PARMS* pAppParms, EC_T_DWORD dwThread);
@@ -13,6 +13,19 @@
 
 #define NSEC_PER_SEC                (1000000000)
 
+/* [2026-10-16] 目的：共享周期时钟：截止时刻取 CLOCK_MONOTONIC 上“周期整数倍 + 偏移”的下一个点，
+ * 同一进程内的多个主站实例（各自的定时任务）周期起点相位对齐，偏移错开各网段的发送时刻
+ */
+static EC_T_UINT64 SharedClockDeadline(EC_T_UINT64 qwNow, EC_T_UINT64 qwCycle, EC_T_UINT64 qwOffset)
+{
+    qwOffset %= qwCycle;
+    if (qwNow < qwOffset)
+    {
+        return qwOffset;
+    }
+    return ((qwNow - qwOffset) / qwCycle + 1) * qwCycle + qwOffset;
+}
+
 CDemoTimingTaskPlatform::CDemoTimingTaskPlatform()
     : TBaseClass()
 {
@@ -25,25 +38,31 @@ CDemoTimingTaskPlatform::CDemoTimingTaskPlatform(_T_EC_DEMO_APP_CONTEXT& rAppCon
 
 EC_T_VOID CDemoTimingTaskPlatform::TimingTask()
 {
-    EC_T_CPUSET       CpuSet;
     struct timespec t;
-    OsMemset(&CpuSet, 0, sizeof(EC_T_CPUSET));
+    EC_T_UINT64     qwDeadline = 0;
+    EC_T_UINT64     qwNow      = 0;
+    EC_T_UINT64     qwLate     = 0;
+    EC_T_UINT64     qwCycle    = 0;
+    EC_T_DWORD      dwMissed   = 0;
+    EC_T_DWORD      dwCatchUp  = 0;     /* missed cycles still to be triggered back-to-back */
+    EC_T_BOOL       bCatchUp   = EC_FALSE;
     OsMemset(&t, 0, sizeof(struct timespec));
 
-    EC_CPUSET_ZERO(CpuSet);
-    EC_CPUSET_SET(CpuSet, this->m_dwCpuIndex);
-    OsSetThreadAffinity(EC_NULL, CpuSet);
-
-    /* get current time */
-    clock_gettime(CLOCK_MONOTONIC, &t);
-
-    t.tv_nsec = t.tv_nsec + this->m_nCycleTimeNsec;
+    OsSetThreadAffinity(EC_NULL, this->m_CpuSet);
+    if ((EC_NULL != this->m_pAppContext) && this->m_pAppContext->AppParms.bRtMemLock)
+    {
+        DemoRtPrefaultStack(TIMER_THREAD_STACKSIZE / 2);
+    }
 
-    /* norm time */
-    while (t.tv_nsec >= NSEC_PER_SEC)
+    /* first shot one cycle from now (shared clock: the first grid point at least one cycle from now) */
+    qwNow = CEcCycleTrace::NowNsec();
+    if (this->m_bSharedClock)
+    {
+        qwDeadline = SharedClockDeadline(qwNow + (EC_T_UINT64)this->m_nCycleTimeNsec, (EC_T_UINT64)this->m_nCycleTimeNsec, this->m_dwClockOffsetNsec);
+    }
+    else
     {
-        t.tv_nsec = t.tv_nsec - NSEC_PER_SEC;
-        t.tv_sec++;
+        qwDeadline = qwNow + (EC_T_UINT64)this->m_nCycleTimeNsec;
     }
 
     /* timing task started */
@@ -52,30 +71,91 @@ EC_T_VOID CDemoTimingTaskPlatform::TimingTask()
     /* periodically generate events as long as the application runs */
     while (!this->m_bShutdown)
     {
-        /* wait for the next cycle */
-        /* Use the Linux high resolution timer. This API offers resolution
-         * below the systick (i.e. 50us cycle is possible) if the Linux
-         * kernel is patched with the RT-PREEMPT patch.
-         */
-
-        /* wait until next shot */
-        if (0 != clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL))
+        /* cycle time may be changed by AdjustCycleTime() */
+        qwCycle = (EC_T_UINT64)this->m_nCycleTimeNsec;
+
+        bCatchUp = (0 != dwCatchUp);
+        if (bCatchUp)
+        {
+            /* DEMO_RT_OVERRUN_CATCHUP: deadline already passed, trigger immediately */
+            dwCatchUp--;
+            qwNow = CEcCycleTrace::NowNsec();
+        }
+        else
+        {
+            /* wait for the next cycle */
+            /* Use the Linux high resolution timer. This API offers resolution
+             * below the systick (i.e. 50us cycle is possible) if the Linux
+             * kernel is patched with the RT-PREEMPT patch.
+             * Hybrid wakeup: sleep until m_dwSpinNsec before the deadline and spin
+             * the rest to remove the timer wakeup latency from the cycle start.
+             */
+            EC_T_UINT64 qwWake = qwDeadline - EC_MIN((EC_T_UINT64)this->m_dwSpinNsec, qwCycle);
+
+            t.tv_sec  = (time_t)(qwWake / NSEC_PER_SEC);
+            t.tv_nsec = (long)(qwWake % NSEC_PER_SEC);
+
+            /* wait until next shot */
+            if (0 != clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL))
+            {
+               perror("clock_nanosleep failed");
+               this->m_bShutdown = EC_TRUE;
+            }
+            do
+            {
+                qwNow = CEcCycleTrace::NowNsec();
+            } while (qwNow < qwDeadline);
+        }
+
+        /* deadlines of the following cycles that have already passed */
+        qwLate   = qwNow - qwDeadline;
+        dwMissed = bCatchUp ? 0 : (EC_T_DWORD)(qwLate / qwCycle);
+        if (qwLate > this->m_oStats.dwMaxLateNsec)
         {
-           perror("clock_nanosleep failed");
-           this->m_bShutdown = EC_TRUE;
+            this->m_oStats.dwMaxLateNsec = (EC_T_DWORD)EC_MIN(qwLate, (EC_T_UINT64)0xFFFFFFFF);
+        }
+
+        /* [2026-10-16] wakeup latency for the cycle trace (deadline -> running) */
+        if ((EC_NULL != this->m_pAppContext) && (EC_NULL != this->m_pAppContext->pCycleTrace))
+        {
+            this->m_pAppContext->pCycleTrace->TimerWakeup(qwDeadline, qwNow, dwMissed);
         }
 
         /* trigger jobtask */
         this->SetTimingEvent();
+        this->m_oStats.qwCycles++;
 
-        /* calculate next shot. t.tv_nsec is always < 1000000000 */
-        t.tv_nsec = t.tv_nsec + this->m_nCycleTimeNsec;
+        /* calculate next shot */
+        qwDeadline += qwCycle;
+        if (0 == dwMissed)
+        {
+            continue;
+        }
 
-        /* norm time */
-        while (t.tv_nsec >= NSEC_PER_SEC)
+        /* [2026-10-16] 目的：定时任务超期（下一个截止时刻已过）时按 AppParms.dwRtOverrunPolicy 处理并计数 */
+        this->m_oStats.qwOverruns++;
+        this->m_oStats.qwMissed += dwMissed;
+        switch (this->m_dwOverrunPolicy)
         {
-           t.tv_nsec = t.tv_nsec - NSEC_PER_SEC;
-           t.tv_sec++;
+        case DEMO_RT_OVERRUN_SKIP:
+            qwDeadline += dwMissed * qwCycle;
+            this->m_oStats.qwSkipped += dwMissed;
+            break;
+        case DEMO_RT_OVERRUN_CATCHUP:
+            if (dwMissed <= DEMO_RT_CATCHUP_MAX)
+            {
+                dwCatchUp = dwMissed;
+                this->m_oStats.qwCatchUp += dwMissed;
+                break;
+            }
+            /* too far behind: resync */
+            /* fall through */
+        case DEMO_RT_OVERRUN_RESYNC:
+        default:
+            /* shared clock: back onto the common grid instead of "now" */
+            qwDeadline = this->m_bSharedClock ? SharedClockDeadline(qwNow, qwCycle, this->m_dwClockOffsetNsec) : (qwNow + qwCycle);
+            this->m_oStats.qwResync++;
+            break;
         }
     }
 
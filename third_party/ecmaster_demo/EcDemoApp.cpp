@@ -53,6 +53,9 @@
 
 #define MBX_TIMEOUT 5000
 
+/* [2026-10-16] 目的：SDO 流水线工作线程数（不同从站并行，同一从站串行） */
+#define SDO_PIPE_LANES         2
+
 #define DCM_ENABLE_LOGFILE
 
 /*-LOCAL VARIABLES-----------------------------------------------------------*/
@@ -165,6 +168,18 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     }
     OsMemset(pAppContext->pMyAppDesc, 0, sizeof(T_MY_APP_DESC));
 
+    /* 4.1) [2026-10-16] 目的：创建 motrotech 的主站访问接口（EC‑Master 实现）
+     * - motrotech 的过程映像/变量表/主站状态/SDO 都经 pAppContext->pMasterAccess，不再直接调用 ecat*
+     * - 无硬件的仿真/基准（bench/MtSimBench.cpp）换成 CMtSimMaster，motrotech 代码不变
+     */
+    pAppContext->pMasterAccess = EC_NEW(CMtEcMasterAccess(pAppContext));
+    if (EC_NULL == pAppContext->pMasterAccess)
+    {
+        dwRetVal = EC_E_NOMEMORY;
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot create master access\n"));
+        goto Exit;
+    }
+
     /* 5) 应用层初始化回调（此工程内会初始化 Motrotech 模块） */
     dwRes = myAppInit(pAppContext);
     if (EC_E_NOERROR != dwRes)
@@ -216,6 +231,8 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     /* 6) 初始化 EtherCAT 主站（最核心一步）
      * - 绑定 OS 参数、LinkLayer、周期时间、最大从站数、异步帧额度、日志级别等
      * - 成功后，主站栈已就绪，但还未加载 ENI/未进入 OP
+     * [2026-10-16] 多实例：本文件的主站调用一律用 em*(pAppContext->dwInstanceId, ...)（ecat* 只访问实例 0），
+     *   同一进程里每个实例（网段）各自一套 LinkLayer/定时任务/JobTask/轴表
      */
     {
         EC_T_INIT_MASTER_PARMS oInitParms;
@@ -260,7 +277,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
             oInitParms.PerfMeasInternalParms.bEnabled = EC_FALSE;
         }
 
-        dwRes = ecatInitMaster(&oInitParms);
+        dwRes = emInitMaster(pAppContext->dwInstanceId, &oInitParms);
         if (dwRes != EC_E_NOERROR)
         {
             dwRetVal = dwRes;
@@ -270,7 +287,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         /* 7) 许可：评估版/授权版会在这里设置 license key（为空则跳过） */
         if (0 != OsStrlen(pAppParms->szLicenseKey))
         {
-            dwRes = ecatSetLicenseKey(pAppParms->szLicenseKey);
+            dwRes = emSetLicenseKey(pAppContext->dwInstanceId, pAppParms->szLicenseKey);
             if (dwRes != EC_E_NOERROR)
             {
                 dwRetVal = dwRes;
@@ -292,7 +309,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
             oPerfMeasAppParms.HistogramParms.dwBinCount = 202;
         }
 
-        dwRes = ecatPerfMeasAppCreate(&oPerfMeasAppParms, &pAppContext->pvPerfMeas);
+        dwRes = emPerfMeasAppCreate(pAppContext->dwInstanceId, &oPerfMeasAppParms, &pAppContext->pvPerfMeas);
         if (dwRes != EC_E_NOERROR)
         {
             dwRetVal = dwRes;
@@ -307,7 +324,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         ETHERNET_ADDRESS oSrcMacAddress;
         OsMemset(&oSrcMacAddress, 0, sizeof(ETHERNET_ADDRESS));
 
-        dwRes = ecatGetSrcMacAddress(&oSrcMacAddress);
+        dwRes = emGetSrcMacAddress(pAppContext->dwInstanceId, &oSrcMacAddress);
         if (dwRes != EC_E_NOERROR)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot get MAC address: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
@@ -337,6 +354,23 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     }
 #endif /* INCLUDE_PCAP_RECORDER */
 
+    /* 10b) 内存映射分段抓包（可选，-pcapmmap）：帧回调里只把帧拷进预分配的映射段，轮转/落盘由后台线程完成 */
+#if (defined INCLUDE_FRAME_SPY)
+    if (pAppParms->bPcapMmap && (EC_NULL != pAppContext->pPcapMmap))
+    {
+        dwRes = pAppContext->pPcapMmap->Start(pAppParms->szPcapMmapPrefix, GetRtThreadCpuSet(pAppParms, DEMO_RT_THREAD_LOG),
+            pAppParms->aRtThread[DEMO_RT_THREAD_LOG].dwPrio, pAppParms->dwPcapMmapSegmentMb, pAppParms->dwPcapMmapSegmentSec,
+            pAppParms->dwPcapMmapMaxSegments);
+        if (dwRes != EC_E_NOERROR)
+        {
+            dwRetVal = dwRes;
+            EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: %d: Starting pcap segment recorder failed: %s (0x%lx)\n", pAppContext->dwInstanceId, ecatGetText(dwRes), dwRes));
+            goto Exit;
+        }
+        CFrameLogMultiplexer::AddFrameLogger(pAppContext->dwInstanceId, (EC_T_VOID*)pAppContext->pPcapMmap, CEcPcapMmapRecorder::LogFrameCallback);
+    }
+#endif /* INCLUDE_FRAME_SPY */
+
     /* 11) 创建 JobTask 线程：真正的“每周期收发帧/处理 PDO”都在这个线程中完成
      * - JobTask 由 scheduler 唤醒（pvJobTaskEvent），因此需要正确的 TimingTask/调度器配置
      */
@@ -345,8 +379,8 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
 
         pAppContext->bJobTaskRunning  = EC_FALSE;
         pAppContext->bJobTaskShutdown = EC_FALSE;
-        pvJobTaskHandle = OsCreateThread((EC_T_CHAR*)"EcMasterJobTask", EcMasterJobTask, pAppParms->CpuSet,
-            pAppParms->dwJobsThreadPrio, pAppParms->dwJobsThreadStackSize, (EC_T_VOID*)pAppContext);
+        pvJobTaskHandle = OsCreateThread((EC_T_CHAR*)"EcMasterJobTask", EcMasterJobTask, GetRtThreadCpuSet(pAppParms, DEMO_RT_THREAD_JOB),
+            pAppParms->aRtThread[DEMO_RT_THREAD_JOB].dwPrio, pAppParms->dwJobsThreadStackSize, (EC_T_VOID*)pAppContext);
 
         /* wait until thread is running */
         while (!oTimeout.IsElapsed() && !pAppContext->bJobTaskRunning)
@@ -364,7 +398,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     /* 12) 设置 OEM key（如有） */
     if (0 != pAppParms->qwOemKey)
     {
-        dwRes = ecatSetOemKey(pAppParms->qwOemKey);
+        dwRes = emSetOemKey(pAppContext->dwInstanceId, pAppParms->qwOemKey);
         if (dwRes != EC_E_NOERROR)
         {
             dwRetVal = dwRes;
@@ -374,7 +408,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     }
     if (pAppParms->eJunctionRedMode != eJunctionRedundancyMode_Disabled)
     {
-        dwRes = ecatIoCtl(EC_IOCTL_SB_SET_JUNCTION_REDUNDANCY_MODE, &pAppParms->eJunctionRedMode, sizeof(EC_T_JUNCTION_REDUNDANCY_MODE), EC_NULL, 0, EC_NULL);
+        dwRes = emIoCtl(pAppContext->dwInstanceId, EC_IOCTL_SB_SET_JUNCTION_REDUNDANCY_MODE, &pAppParms->eJunctionRedMode, sizeof(EC_T_JUNCTION_REDUNDANCY_MODE), EC_NULL, 0, EC_NULL);
         if (dwRes != EC_E_NOERROR)
         {
             dwRetVal = dwRes;
@@ -386,7 +420,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
      * - eCnfType/pbyCnfData/dwCnfDataLen 由命令行 -f 指定 ENI 后解析得到
      * - 如果不提供 ENI，这里也会生成一个“临时 ENI”（功能有限）
      */
-    dwRes = ecatConfigureNetwork(pAppParms->eCnfType, pAppParms->pbyCnfData, pAppParms->dwCnfDataLen);
+    dwRes = emConfigureNetwork(pAppContext->dwInstanceId, pAppParms->eCnfType, pAppParms->pbyCnfData, pAppParms->dwCnfDataLen);
     if (dwRes != EC_E_NOERROR)
     {
         dwRetVal = dwRes;
@@ -395,7 +429,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     }
 
     /* 14) 注册通知回调：主站会把事件通过 EcMasterNotifyCallback 通知到应用 */
-    dwRes = ecatRegisterClient(EcMasterNotifyCallback, pAppContext, &RegisterClientResults);
+    dwRes = emRegisterClient(pAppContext->dwInstanceId, EcMasterNotifyCallback, pAppContext, &RegisterClientResults);
     if (dwRes != EC_E_NOERROR)
     {
         dwRetVal = dwRes;
@@ -404,6 +438,21 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     }
     pAppContext->pNotificationHandler->SetClientID(RegisterClientResults.dwClntId);
 
+    /* 14.1) [2026-10-16] 目的：启动异步 SDO 流水线
+     * - 非 PDO 对象（如 kp/kd 0x3500/0x3501）的读写由流水线线程执行，调用方（CmdThread 等）不再阻塞
+     * - 同一对象的连续写入只下发最新值；启动失败时 motrotech 退回到阻塞式 SDO
+     */
+    pAppContext->pSdoPipeline = EC_NEW(CEcSdoPipeline(pAppContext));
+    if (EC_NULL != pAppContext->pSdoPipeline)
+    {
+        dwRes = pAppContext->pSdoPipeline->Start(SDO_PIPE_LANES, GetRtThreadCpuSet(pAppParms, DEMO_RT_THREAD_NOTIFY), pAppParms->aRtThread[DEMO_RT_THREAD_NOTIFY].dwPrio);
+        if (EC_E_NOERROR != dwRes)
+        {
+            EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot start SDO pipeline: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
+            SafeDelete(pAppContext->pSdoPipeline);
+        }
+    }
+
     /* 15) 配置 DC/DCM
      * - DC（Distributed Clocks）负责从站时钟同步
      * - DCM（Drift Compensation Mechanism）负责更高层的同步/偏移控制（不同模式）
@@ -435,7 +484,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                 oDcConfigure.bAcycDistributionDisabled = EC_TRUE;
             }
 
-            dwRes = ecatDcConfigure(&oDcConfigure);
+            dwRes = emDcConfigure(pAppContext->dwInstanceId, &oDcConfigure);
             if (dwRes != EC_E_NOERROR )
             {
                 dwRetVal = dwRes;
@@ -447,7 +496,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         if (pAppParms->bDcmLogEnabled && !pAppParms->bDcmConfigure)
         {
             EC_T_BOOL bBusShiftConfiguredByEni = EC_FALSE;
-            dwRes = ecatDcmGetBusShiftConfigured(&bBusShiftConfiguredByEni);
+            dwRes = emDcmGetBusShiftConfigured(pAppContext->dwInstanceId, &bBusShiftConfiguredByEni);
             if (dwRes != EC_E_NOERROR)
             {
                 EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "Cannot check if BusShift is configured  (Result = 0x%x)\n", dwRes));
@@ -558,7 +607,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                 goto Exit;
 
             }
-            dwRes = ecatDcmConfigure(&oDcmConfig, 0);
+            dwRes = emDcmConfigure(pAppContext->dwInstanceId, &oDcmConfig, 0);
             switch (dwRes)
             {
             case EC_E_NOERROR:
@@ -583,12 +632,12 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     {
         EC_T_DWORD dwPeriodMs = 1000;
 
-        dwRes = ecatIoCtl(EC_IOCTL_SET_SLVSTAT_PERIOD, (EC_T_BYTE*)&dwPeriodMs, sizeof(EC_T_DWORD), EC_NULL, 0, EC_NULL);
+        dwRes = emIoCtl(pAppContext->dwInstanceId, EC_IOCTL_SET_SLVSTAT_PERIOD, (EC_T_BYTE*)&dwPeriodMs, sizeof(EC_T_DWORD), EC_NULL, 0, EC_NULL);
         if (dwRes != EC_E_NOERROR)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot set slave statistics period: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
         }
-        dwRes = ecatClearSlaveStatistics(INVALID_SLAVE_ID);
+        dwRes = emClearSlaveStatistics(pAppContext->dwInstanceId, INVALID_SLAVE_ID);
         if (dwRes != EC_E_NOERROR)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot reset slave statistics: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
@@ -600,7 +649,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     /* 16) （可选）扫描总线并打印从站信息：用于确认拓扑/从站识别是否正常 */
     if (pAppParms->dwAppLogLevel >= EC_LOG_LEVEL_VERBOSE)
     {
-        dwRes = ecatScanBus(ETHERCAT_SCANBUS_TIMEOUT);
+        dwRes = emScanBus(pAppContext->dwInstanceId, ETHERCAT_SCANBUS_TIMEOUT);
         pAppContext->pNotificationHandler->ProcessNotificationJobs();
         switch (dwRes)
         {
@@ -633,7 +682,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
      * - OP：过程数据收发正常，开始真正控制设备
      */
     /* 17.1) set master to INIT（重新回到 INIT，确保状态干净） */
-    dwRes = ecatSetMasterState(ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_INIT);
+    dwRes = emSetMasterState(pAppContext->dwInstanceId, ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_INIT);
     pAppContext->pNotificationHandler->ProcessNotificationJobs();
     if (dwRes != EC_E_NOERROR)
     {
@@ -652,7 +701,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     }
 
     /* 17.3) PREOP：此后可以进行 SDO/OD/映射等设置 */
-    dwRes = ecatSetMasterState(ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_PREOP);
+    dwRes = emSetMasterState(pAppContext->dwInstanceId, ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_PREOP);
     pAppContext->pNotificationHandler->ProcessNotificationJobs();
     if (dwRes != EC_E_NOERROR)
     {
@@ -674,7 +723,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         }
 
         /* 17.5) SAFEOP：此处常见失败原因是 DCM 未能 InSync（所以 timeout 更长） */
-        dwRes = ecatSetMasterState(ETHERCAT_DCM_TIMEOUT + ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_SAFEOP);
+        dwRes = emSetMasterState(pAppContext->dwInstanceId, ETHERCAT_DCM_TIMEOUT + ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_SAFEOP);
         pAppContext->pNotificationHandler->ProcessNotificationJobs();
         if (dwRes != EC_E_NOERROR)
         {
@@ -686,7 +735,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
             EC_T_DWORD dwStatus = 0;
             EC_T_INT   nDiffCur = 0, nDiffAvg = 0, nDiffMax = 0;
 
-                dwRes = ecatDcmGetStatus(&dwStatus, &nDiffCur, &nDiffAvg, &nDiffMax);
+                dwRes = emDcmGetStatus(pAppContext->dwInstanceId, &dwStatus, &nDiffCur, &nDiffAvg, &nDiffMax);
                 if (dwRes == EC_E_NOERROR)
                 {
                     if (dwStatus != EC_E_NOERROR)
@@ -704,7 +753,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         }
 
         /* 17.6) OP：进入正式运行态（PDO 每周期收发） */
-        dwRes = ecatSetMasterState(ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_OP);
+        dwRes = emSetMasterState(pAppContext->dwInstanceId, ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_OP);
         pAppContext->pNotificationHandler->ProcessNotificationJobs();
         if (dwRes != EC_E_NOERROR)
         {
@@ -720,12 +769,12 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
 
     if (pAppContext->dwPerfMeasLevel > 0)
     {
-        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "\nJob times during startup <INIT> to <%s>:\n", ecatStateToStr(ecatGetMasterState())));
+        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "\nJob times during startup <INIT> to <%s>:\n", ecatStateToStr(emGetMasterState(pAppContext->dwInstanceId))));
         PRINT_PERF_MEAS();
         EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "\n"));
         /* clear job times of startup phase */
-        ecatPerfMeasAppReset(pAppContext->pvPerfMeas, EC_PERF_MEAS_ALL);
-        ecatPerfMeasReset(EC_PERF_MEAS_ALL);
+        emPerfMeasAppReset(pAppContext->dwInstanceId, pAppContext->pvPerfMeas, EC_PERF_MEAS_ALL);
+        emPerfMeasReset(pAppContext->dwInstanceId, EC_PERF_MEAS_ALL);
     }
 
     /* 18) demo 主循环：
@@ -739,7 +788,8 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "%s will stop in %ds...\n", EC_DEMO_APP_NAME, pAppParms->dwDemoDuration / 1000));
         oAppDuration.Start(pAppParms->dwDemoDuration);
     }
-    bRun = EC_TRUE;
+    /* [2026-10-16] 多实例：每个实例只清自己的 bInstanceRun；全局 bRun 由调用方置位，清掉则所有实例退出 */
+    pAppContext->bInstanceRun = EC_TRUE;
     {
         CEcTimer oPerfMeasPrintTimer;
 
@@ -751,7 +801,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
         /* [2026-01-20] 安全修改：开机默认不自动下发 START 命令，保持在未使能状态 */
         // MT_SetSwitch(COMMAND_START); 
 
-        while (bRun)
+        while (bRun && pAppContext->bInstanceRun)
         {
             if (oPerfMeasPrintTimer.IsElapsed())
             {
@@ -760,11 +810,17 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
             }
 
             /* check if demo shall terminate */
-            bRun = !(OsTerminateAppRequest() || oAppDuration.IsElapsed());
+            if (OsTerminateAppRequest() || oAppDuration.IsElapsed())
+            {
+                pAppContext->bInstanceRun = EC_FALSE;
+            }
 
             /* 轻量级诊断钩子（默认空实现，可放报警/状态打印等） */
             myAppDiagnosis(pAppContext);
 
+            /* [2026-10-16] 目的：kp/kd 在这里（非周期线程）下发/完成/重试，周期线程只记录要求值 */
+            MT_ServiceGains(pAppContext->pMtContext);
+
             if (EC_NULL != pAppParms->pbyCnfData)
             {
                 if ((eDcmMode_Off != pAppParms->eDcmMode) && (eDcmMode_LinkLayerRefClock != pAppParms->eDcmMode))
@@ -779,12 +835,12 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                         oDcmStatusTimer.Start(5000);
                     }
 
-                    dwRes = ecatDcmGetStatus(&dwStatus, &nDiffCur, &nDiffAvg, &nDiffMax);
+                    dwRes = emDcmGetStatus(pAppContext->dwInstanceId, &dwStatus, &nDiffCur, &nDiffAvg, &nDiffMax);
                     if (dwRes == EC_E_NOERROR)
                     {
                         if (bFirstDcmStatus)
                         {
-                            EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "DCM during startup (<INIT> to <%s>)\n", ecatStateToStr(ecatGetMasterState())));
+                            EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "DCM during startup (<INIT> to <%s>)\n", ecatStateToStr(emGetMasterState(pAppContext->dwInstanceId))));
                         }
                         if ((dwStatus != EC_E_NOTREADY) && (dwStatus != EC_E_BUSY) && (dwStatus != EC_E_NOERROR))
                         {
@@ -797,7 +853,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                     }
                     else
                     {
-                        if ((eEcatState_OP == ecatGetMasterState()) || (eEcatState_SAFEOP == ecatGetMasterState()))
+                        if ((eEcatState_OP == emGetMasterState(pAppContext->dwInstanceId)) || (eEcatState_SAFEOP == emGetMasterState(pAppContext->dwInstanceId)))
                         {
                             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "Cannot get DCM status! %s (0x%08X)\n", ecatGetText(dwRes), dwRes));
                         }
@@ -805,12 +861,12 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                     if (eDcmMode_Dcx == pAppParms->eDcmMode && EC_E_NOERROR == dwRes)
                     {
                     EC_T_INT64 nTimeStampDiff = 0;
-                        dwRes = ecatDcxGetStatus(&dwStatus, &nDiffCur, &nDiffAvg, &nDiffMax, &nTimeStampDiff);
+                        dwRes = emDcxGetStatus(pAppContext->dwInstanceId, &dwStatus, &nDiffCur, &nDiffAvg, &nDiffMax, &nTimeStampDiff);
                         if (EC_E_NOERROR == dwRes)
                         {
                             if (bFirstDcmStatus)
                             {
-                                EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "DCX during startup (<INIT> to <%s>)\n", ecatStateToStr(ecatGetMasterState())));
+                                EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "DCX during startup (<INIT> to <%s>)\n", ecatStateToStr(emGetMasterState(pAppContext->dwInstanceId))));
                             }
                             if ((dwStatus != EC_E_NOTREADY) && (dwStatus != EC_E_BUSY) && (dwStatus != EC_E_NOERROR))
                             {
@@ -823,7 +879,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                         }
                         else
                         {
-                            if ((eEcatState_OP == ecatGetMasterState()) || (eEcatState_SAFEOP == ecatGetMasterState()))
+                            if ((eEcatState_OP == emGetMasterState(pAppContext->dwInstanceId)) || (eEcatState_SAFEOP == emGetMasterState(pAppContext->dwInstanceId)))
                             {
                                 EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "Cannot get DCX status! %s (0x%08X)\n", ecatGetText(dwRes), dwRes));
                             }
@@ -832,7 +888,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
                     if (bFirstDcmStatus && (EC_E_NOERROR == dwRes))
                     {
                         bFirstDcmStatus = EC_FALSE;
-                        ecatDcmResetStatus();
+                        emDcmResetStatus(pAppContext->dwInstanceId);
                     }
                 }
             }
@@ -847,7 +903,7 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
     {
         EC_T_DWORD dwCurrentUsage = 0;
         EC_T_DWORD dwMaxUsage = 0;
-        dwRes = ecatGetMemoryUsage(&dwCurrentUsage, &dwMaxUsage);
+        dwRes = emGetMemoryUsage(pAppContext->dwInstanceId, &dwCurrentUsage, &dwMaxUsage);
         if (EC_E_NOERROR != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot read memory usage of master: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
@@ -871,10 +927,25 @@ EC_T_DWORD EcDemoApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
 
 Exit:
     /* 19) 退出/清理：先让轴进入 shutdown（demo 的 Motrotech 行为），再停主站/线程 */
-    MT_SetSwitch(COMMAND_SHUTDOWN);
+    MT_SetSwitch(pAppContext->pMtContext, COMMAND_SHUTDOWN);
+
+    /* [2026-10-16] 目的：先停 SDO 流水线（未执行的请求以 EC_E_CANCEL 结束），再切 INIT */
+    if (EC_NULL != pAppContext->pSdoPipeline)
+    {
+        if (EC_E_NOERROR == pAppContext->pSdoPipeline->Stop())
+        {
+            SafeDelete(pAppContext->pSdoPipeline);
+        }
+        else
+        {
+            /* 说明：lane 仍卡在 SDO 传输里（超过 SDO 超时），对象不能释放，留给进程退出回收 */
+            EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "SDO pipeline did not stop, leaking it\n"));
+            pAppContext->pSdoPipeline = EC_NULL;
+        }
+    }
     
     /* set master state to INIT */
-    if (eEcatState_UNKNOWN != ecatGetMasterState())
+    if (eEcatState_UNKNOWN != emGetMasterState(pAppContext->dwInstanceId))
     {
         if (pAppParms->dwPerfMeasLevel > 0)
         {
@@ -886,7 +957,7 @@ Exit:
             PRINT_HISTOGRAM();
         }
 
-        dwRes = ecatSetMasterState(ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_INIT);
+        dwRes = emSetMasterState(pAppContext->dwInstanceId, ETHERCAT_STATE_CHANGE_TIMEOUT, eEcatState_INIT);
         pAppContext->pNotificationHandler->ProcessNotificationJobs();
         if (EC_E_NOERROR != dwRes)
         {
@@ -898,13 +969,27 @@ Exit:
     SafeDelete(pPcapRecorder);
 #endif /* INCLUDE_PCAP_RECORDER */
 
+#if (defined INCLUDE_FRAME_SPY)
+    if ((EC_NULL != pAppContext->pPcapMmap) && pAppContext->pPcapMmap->IsRunning())
+    {
+        T_PCAP_MMAP_STATS oPcapStats;
+
+        CFrameLogMultiplexer::RemoveFrameLogger(pAppContext->dwInstanceId, (EC_T_VOID*)pAppContext->pPcapMmap, CEcPcapMmapRecorder::LogFrameCallback);
+        pAppContext->pPcapMmap->Stop();
+        pAppContext->pPcapMmap->GetStats(&oPcapStats);
+        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "pcap segments: %llu frames, %llu bytes, %llu dropped, %u segments (%u deleted), %u errors\n",
+            (unsigned long long)oPcapStats.qwFrames, (unsigned long long)oPcapStats.qwBytes, (unsigned long long)oPcapStats.qwDropped,
+            oPcapStats.dwSegments, oPcapStats.dwDeleted, oPcapStats.dwErrors));
+    }
+#endif /* INCLUDE_FRAME_SPY */
+
     /* unregister client */
     if (EC_NULL != pAppContext->pNotificationHandler)
     {
         EC_T_DWORD dwClientId = pAppContext->pNotificationHandler->GetClientID();
         if (INVALID_CLIENT_ID != dwClientId)
         {
-            dwRes = ecatUnregisterClient(dwClientId);
+            dwRes = emUnregisterClient(pAppContext->dwInstanceId, dwClientId);
             if (EC_E_NOERROR != dwRes)
             {
                 EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "Cannot unregister client: %s (0x%lx))\n", ecatGetText(dwRes), dwRes));
@@ -942,13 +1027,14 @@ Exit:
     }
 
     /* 21) 反初始化主站（释放内部资源） */
-    dwRes = ecatDeinitMaster();
+    dwRes = emDeinitMaster(pAppContext->dwInstanceId);
     if (EC_E_NOERROR != dwRes)
     {
         EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: Cannot de-initialize EtherCAT-Master: %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
     }
 
     SafeDelete(pAppContext->pNotificationHandler);
+    SafeDelete(pAppContext->pMasterAccess);
     if (EC_NULL != pAppContext->pMyAppDesc)
     {
         SafeOsFree(pAppContext->pMyAppDesc->pbyFlashBuf);
@@ -969,10 +1055,22 @@ static EC_T_VOID EcMasterJobTask(EC_T_VOID* pvAppContext)
     EC_T_INT   nOverloadCounter = 0;               /* counter to check if cycle time is to short */
     T_EC_DEMO_APP_CONTEXT* pAppContext = (T_EC_DEMO_APP_CONTEXT*)pvAppContext;
     T_EC_DEMO_APP_PARMS*   pAppParms   = &pAppContext->AppParms;
+    CEcCycleTrace*         pTrace      = pAppContext->pCycleTrace;  /* [2026-10-16] per-cycle timing trace (optional) */
 
     EC_T_USER_JOB_PARMS oJobParms;
     OsMemset(&oJobParms, 0, sizeof(EC_T_USER_JOB_PARMS));
 
+    /* [2026-10-16] 目的：实时模式下预先触碰栈页，避免首个深调用周期里的缺页 */
+    if (pAppParms->bRtMemLock)
+    {
+        DemoRtPrefaultStack(pAppParms->dwJobsThreadStackSize / 2);
+    }
+    /* [2026-10-16] 目的：周期线程的日志环在进入循环前分配，循环内 EcLogMsg 只做记录（无分配、无锁） */
+    if (EC_NULL != pAppContext->pDeferredLog)
+    {
+        pAppContext->pDeferredLog->RegisterThread();
+    }
+
     /* 周期任务主循环：由 scheduler 通过 pvJobTaskEvent 触发（一般一周期触发一次） */
     pAppContext->bJobTaskRunning = EC_TRUE;
     do
@@ -985,6 +1083,10 @@ static EC_T_VOID EcMasterJobTask(EC_T_VOID* pvAppContext)
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: OsWaitForEvent(): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
             OsSleep(500);
         }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Begin();
+        }
 
         /* 下面是“每周期固定顺序”的主站工作流（高频路径）：
          * 1) StartTask：PerfMeas 辅助（增强测量）
@@ -996,23 +1098,35 @@ static EC_T_VOID EcMasterJobTask(EC_T_VOID* pvAppContext)
          * 7) StopTask：PerfMeas 辅助（增强测量）
          */
         /* start Task (required for enhanced performance measurement) */
-        dwRes = ecatExecJob(eUsrJob_StartTask, EC_NULL);
+        dwRes = emExecJob(pAppContext->dwInstanceId, eUsrJob_StartTask, EC_NULL);
         if (EC_E_NOERROR != dwRes && EC_E_INVALIDSTATE != dwRes && EC_E_LINK_DISCONNECTED != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: ecatExecJob(eUsrJob_StartTask): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
         }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Skip();
+        }
 
         /* 处理所有收到的帧（读入最新输入过程数据） */
-        dwRes = ecatExecJob(eUsrJob_ProcessAllRxFrames, &oJobParms);
+        dwRes = emExecJob(pAppContext->dwInstanceId, eUsrJob_ProcessAllRxFrames, &oJobParms);
         if (EC_E_NOERROR != dwRes && EC_E_INVALIDSTATE != dwRes && EC_E_LINK_DISCONNECTED != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: ecatExecJob(eUsrJob_ProcessAllRxFrames): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
         }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Mark(CYC_TRACE_RX);
+        }
 
         if (EC_E_NOERROR == dwRes)
         {
             if (!oJobParms.bAllCycFramesProcessed)
             {
+                if (EC_NULL != pTrace)
+                {
+                    pTrace->SetFlags(CYC_TRACE_FLAG_FRAME_LOSS);
+                }
                 /* 连续 frame loss 说明系统过载/周期太短/抖动太大（demo 用计数器做简单告警节流） */
                 nOverloadCounter += 10;
                 if (nOverloadCounter >= 50)
@@ -1043,66 +1157,92 @@ static EC_T_VOID EcMasterJobTask(EC_T_VOID* pvAppContext)
 
             if (pAppContext->dwPerfMeasLevel > 0)
             {
-                ecatPerfMeasAppStart(pAppContext->pvPerfMeas, PERF_DCM_Logfile);
+                emPerfMeasAppStart(pAppContext->dwInstanceId, pAppContext->pvPerfMeas, PERF_DCM_Logfile);
             }
-            ecatDcmGetLog(&pszLog);
+            emDcmGetLog(pAppContext->dwInstanceId, &pszLog);
             if ((EC_NULL != pszLog))
             {
                 ((CAtEmLogging*)pEcLogContext)->LogDcm(pszLog);
             }
             if (pAppContext->dwPerfMeasLevel > 0)
             {
-                ecatPerfMeasAppEnd(pAppContext->pvPerfMeas, PERF_DCM_Logfile);
+                emPerfMeasAppEnd(pAppContext->dwInstanceId, pAppContext->pvPerfMeas, PERF_DCM_Logfile);
             }
         }
 #endif
+        /* 超限告警日志、DCM 日志不计入各段耗时 */
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Skip();
+        }
 
         if (pAppContext->dwPerfMeasLevel > 0)
         {
-            ecatPerfMeasAppStart(pAppContext->pvPerfMeas, PERF_myAppWorkpd);
+            emPerfMeasAppStart(pAppContext->dwInstanceId, pAppContext->pvPerfMeas, PERF_myAppWorkpd);
         }
         {   /* 只有 SAFEOP/OP 才调用 myAppWorkpd（因为 PDO 才有意义） */
-            EC_T_STATE eMasterState = ecatGetMasterState();
+            EC_T_STATE eMasterState = emGetMasterState(pAppContext->dwInstanceId);
 
             if ((eEcatState_SAFEOP == eMasterState) || (eEcatState_OP == eMasterState))
             {
                 myAppWorkpd(pAppContext);
+                if (EC_NULL != pTrace)
+                {
+                    pTrace->SetFlags(CYC_TRACE_FLAG_WORKPD);
+                }
             }
         }
         if (pAppContext->dwPerfMeasLevel > 0)
         {
-            ecatPerfMeasAppEnd(pAppContext->pvPerfMeas, PERF_myAppWorkpd);
+            emPerfMeasAppEnd(pAppContext->dwInstanceId, pAppContext->pvPerfMeas, PERF_myAppWorkpd);
+        }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Mark(CYC_TRACE_WORKPD);
         }
 
         /* 发送本周期所有 cyclic 帧（把 PdOut 写到从站） */
-        dwRes = ecatExecJob(eUsrJob_SendAllCycFrames, &oJobParms);
+        dwRes = emExecJob(pAppContext->dwInstanceId, eUsrJob_SendAllCycFrames, &oJobParms);
         if (EC_E_NOERROR != dwRes && EC_E_INVALIDSTATE != dwRes && EC_E_LINK_DISCONNECTED != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ecatExecJob( eUsrJob_SendAllCycFrames,    EC_NULL ): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
         }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Mark(CYC_TRACE_TX);
+        }
 
         /* remove this code when using licensed version */
         if (EC_E_EVAL_EXPIRED == dwRes)
         {
-            bRun = EC_FALSE; /* set shutdown flag */
+            pAppContext->bInstanceRun = EC_FALSE; /* set shutdown flag */
         }
 
         /* 主站内部维护（无总线流量） */
-        dwRes = ecatExecJob(eUsrJob_MasterTimer, EC_NULL);
+        dwRes = emExecJob(pAppContext->dwInstanceId, eUsrJob_MasterTimer, EC_NULL);
         if (EC_E_NOERROR != dwRes && EC_E_INVALIDSTATE != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ecatExecJob(eUsrJob_MasterTimer, EC_NULL): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
         }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Mark(CYC_TRACE_TIMER);
+        }
 
         /* 发送排队的异步帧（mailbox/SDO 等），该路径一般是低频/按需 */
-        dwRes = ecatExecJob(eUsrJob_SendAcycFrames, EC_NULL);
+        dwRes = emExecJob(pAppContext->dwInstanceId, eUsrJob_SendAcycFrames, EC_NULL);
         if (EC_E_NOERROR != dwRes && EC_E_INVALIDSTATE != dwRes && EC_E_LINK_DISCONNECTED != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ecatExecJob(eUsrJob_SendAcycFrames, EC_NULL): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
         }
+        if (EC_NULL != pTrace)
+        {
+            pTrace->Mark(CYC_TRACE_ACYC);
+            pTrace->End();
+        }
 
         /* stop Task (required for enhanced performance measurement) */
-        dwRes = ecatExecJob(eUsrJob_StopTask, EC_NULL);
+        dwRes = emExecJob(pAppContext->dwInstanceId, eUsrJob_StopTask, EC_NULL);
         if (EC_E_NOERROR != dwRes && EC_E_INVALIDSTATE != dwRes && EC_E_LINK_DISCONNECTED != dwRes)
         {
             EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: ecatExecJob(eUsrJob_StopTask): %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
@@ -1199,10 +1339,15 @@ Exit:
 static EC_T_DWORD myAppInit(T_EC_DEMO_APP_CONTEXT* pAppContext)
 {
     MT_Init(pAppContext);
-    pthread_t tid;
-    pthread_create(&tid, nullptr, CmdThread, nullptr);
-    pthread_detach(tid);
-    EC_UNREFPARM(pAppContext);
+    /* [2026-10-16] 目的：trace/pcap 命令使用的周期计时、抓包对象（由 EcDemoApp 的调用方持有，生命周期长于命令线程）
+     * 多实例时只有一个实例开命令线程（stdin 只有一个，-nocmd 关闭）
+     */
+    if (pAppContext->AppParms.bCmdConsole)
+    {
+        pthread_t tid;
+        pthread_create(&tid, nullptr, CmdThread, pAppContext);
+        pthread_detach(tid);
+    }
 
     return EC_E_NOERROR;
 }
@@ -1223,10 +1368,16 @@ static EC_T_DWORD myAppPrepare(T_EC_DEMO_APP_CONTEXT* pAppContext)
 
     if (EC_NULL != pAppContext->AppParms.pbyCnfData)
     {
-        /* [修改] 增加到 7 个电机，站号从 1001 到 1007 */
-        for (int i = 0; i < 7; i++) {
-            My_Slave[i].wStationAddress = (EC_T_WORD)(1001 + i);
-            My_Slave[i].wAxisCnt = 1;
+        /* [修改] 增加到 7 个电机，站号从 1001 到 1007
+         * [2026-10-16] 仅在未配置从站列表（busi.yaml ethercat_demo.slaves）时使用，配置了则 MT_Init() 已填好 pSlave[]
+         */
+        T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+        if (0 == MT_GetConfiguredSlaveCnt(pMt))
+        {
+            for (int i = 0; (i < 7) && ((EC_T_DWORD)i < MT_GetSlaveCapacity(pMt)); i++) {
+                pMt->pSlave[i].wStationAddress = (EC_T_WORD)(1001 + i);
+                pMt->pSlave[i].wAxisCnt = 1;
+            }
         }
 
         MT_Prepare(pAppContext);
@@ -1240,7 +1391,7 @@ static EC_T_DWORD myAppPrepare(T_EC_DEMO_APP_CONTEXT* pAppContext)
         if (wFlashSlaveAddr != INVALID_FIXED_ADDR)
         {
             /* get slave's process data offset and some other infos */
-            dwRes = ecatGetCfgSlaveInfo(EC_TRUE, wFlashSlaveAddr, &oCfgSlaveInfo);
+            dwRes = emGetCfgSlaveInfo(pAppContext->dwInstanceId, EC_TRUE, wFlashSlaveAddr, &oCfgSlaveInfo);
             if (dwRes != EC_E_NOERROR)
             {
                 EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: myAppPrepare: ecatGetCfgSlaveInfo() returns with error=0x%x, slave address=%d\n", dwRes, wFlashSlaveAddr));
@@ -1263,7 +1414,7 @@ static EC_T_DWORD myAppPrepare(T_EC_DEMO_APP_CONTEXT* pAppContext)
             EC_T_MEMREQ_DESC oPdMemorySize;
             OsMemset(&oPdMemorySize, 0, sizeof(EC_T_MEMREQ_DESC));
 
-            dwRes = ecatIoCtl(EC_IOCTL_GET_PDMEMORYSIZE, EC_NULL, 0, &oPdMemorySize, sizeof(EC_T_MEMREQ_DESC), EC_NULL);
+            dwRes = emIoCtl(pAppContext->dwInstanceId, EC_IOCTL_GET_PDMEMORYSIZE, EC_NULL, 0, &oPdMemorySize, sizeof(EC_T_MEMREQ_DESC), EC_NULL);
             if (dwRes != EC_E_NOERROR)
             {
                 EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: myAppPrepare: ecatIoControl(EC_IOCTL_GET_PDMEMORYSIZE) returns with error=0x%x\n", dwRes));
@@ -1303,7 +1454,13 @@ static EC_T_DWORD myAppSetup(T_EC_DEMO_APP_CONTEXT* pAppContext)
     EC_T_DWORD dwRetVal = EC_E_NOERROR;
     EC_T_DWORD dwRes    = EC_E_NOERROR;
 
-    MT_Setup(pAppContext);
+    dwRes = MT_Setup(pAppContext);
+    if (dwRes != EC_E_NOERROR)
+    {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: myAppSetup: MT_Setup %s (0x%lx)\n", ecatGetText(dwRes), dwRes));
+        dwRetVal = dwRes;
+        goto Exit;
+    }
 
     /* read CoE object dictionary from device */
     if (pAppContext->AppParms.bReadOD)
@@ -1332,7 +1489,7 @@ Exit:
 static EC_T_DWORD myAppWorkpd(T_EC_DEMO_APP_CONTEXT* pAppContext)
 {
     T_MY_APP_DESC* pMyAppDesc = pAppContext->pMyAppDesc;
-    EC_T_BYTE*     pbyPdOut   = ecatGetProcessImageOutputPtr();
+    EC_T_BYTE*     pbyPdOut   = emGetProcessImageOutputPtr(pAppContext->dwInstanceId);
 
     MT_Workpd(pAppContext);
 
@@ -1428,9 +1585,13 @@ EC_T_VOID ShowSyntaxApp(T_EC_DEMO_APP_CONTEXT* pAppContext)
 #endif
 }
 //2026-1-13 输入线程
-static void* CmdThread(void*)
+static void* CmdThread(void* pvAppContext)
 {
     char line[256];
+    T_EC_DEMO_APP_CONTEXT* pAppContext = (T_EC_DEMO_APP_CONTEXT*)pvAppContext;
+    T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+    CEcCycleTrace* pTrace = pAppContext->pCycleTrace;
+    CEcPcapMmapRecorder* pPcap = pAppContext->pPcapMmap;
 
     /* [2026-01-14] 目的：启动后先选择运行模式（0自动demo / 1手动命令） */
     printf("[CMD] 请选择模式: 0=自动demo  1=手动命令\n");
@@ -1443,12 +1604,12 @@ static void* CmdThread(void*)
     sscanf(line, "%d", &m);
     if (m == 1)
     {
-        MT_SetRunMode(MT_RUNMODE_MANUAL);
+        MT_SetRunMode(pMt, MT_RUNMODE_MANUAL);
         printf("[CMD] 已切换为: 手动模式 (MANUAL)\n");
     }
     else
     {
-        MT_SetRunMode(MT_RUNMODE_AUTO);
+        MT_SetRunMode(pMt, MT_RUNMODE_AUTO);
         printf("[CMD] 已切换为: 自动模式 (AUTO)\n");
     }
     fflush(stdout);
@@ -1465,6 +1626,11 @@ static void* CmdThread(void*)
     printf("  aging <axis> <speed>                        (启动老化往复测试)\n");
     printf("  stop <axis>                                 (安全停机/释放)\n");
     printf("  mode <0|1>                                  (0自动/1手动)\n");
+    printf("  sdo_get <axis> <index> [sub]                (异步 SDO 读取, 如 sdo_get 1 0x3500)\n");
+    printf("  trace [reset]                               (周期计时统计 p50/p99/p99.9/max)\n");
+    printf("  trace csv <file>                            (导出周期计时 CSV)\n");
+    printf("  pcap                                        (分段抓包统计：帧数/丢帧/段数)\n");
+    printf("  traj [stop|reset|release <group>]           (轴组流式轨迹状态/停止/解锁/交还 MotorCmd_)\n");
     fflush(stdout);
 
     while (fgets(line, sizeof(line), stdin) != nullptr) {
@@ -1479,12 +1645,12 @@ static void* CmdThread(void*)
             {
                 if (m == 1)
                 {
-                    MT_SetRunMode(MT_RUNMODE_MANUAL);
+                    MT_SetRunMode(pMt, MT_RUNMODE_MANUAL);
                     printf("[CMD] OK: mode=1 (MANUAL)\n");
                 }
                 else
                 {
-                    MT_SetRunMode(MT_RUNMODE_AUTO);
+                    MT_SetRunMode(pMt, MT_RUNMODE_AUTO);
                     printf("[CMD] OK: mode=0 (AUTO)\n");
                 }
             }
@@ -1498,10 +1664,10 @@ static void* CmdThread(void*)
 
         /* [2026-01-20] 一键查看所有轴位置 (显示为 1-7 号轴) */
         if (strcmp(line, "show") == 0) {
-            printf("\n[CMD] --- Current 7-Axis Positions (rad) ---\n");
-            for (int i = 0; i < 7; i++) {
+            printf("\n[CMD] --- Current %u-Axis Positions (rad) ---\n", MT_GetAxisCount(pMt));
+            for (int i = 0; (EC_T_DWORD)i < MT_GetAxisCount(pMt); i++) {
                 MotorState_ st;
-                if (MT_GetMotorState((EC_T_WORD)i, &st)) {
+                if (MT_GetMotorState(pMt, (EC_T_WORD)i, &st)) {
                     printf("  Axis %d: %8.4f\n", i + 1, st.q_fb);
                 }
             }
@@ -1514,7 +1680,7 @@ static void* CmdThread(void*)
         if (strncmp(line, "teach_min ", 10) == 0) {
             int axis = 0;
             if (sscanf(line + 10, "%d", &axis) == 1) {
-                MT_TeachLimit((EC_T_WORD)(axis - 1), EC_FALSE);
+                MT_TeachLimit(pMt, (EC_T_WORD)(axis - 1), EC_FALSE);
                 printf("[CMD] OK: Recorded MIN limit for Axis %d\n", axis);
             }
             continue;
@@ -1522,7 +1688,7 @@ static void* CmdThread(void*)
         if (strncmp(line, "teach_max ", 10) == 0) {
             int axis = 0;
             if (sscanf(line + 10, "%d", &axis) == 1) {
-                MT_TeachLimit((EC_T_WORD)(axis - 1), EC_TRUE);
+                MT_TeachLimit(pMt, (EC_T_WORD)(axis - 1), EC_TRUE);
                 printf("[CMD] OK: Recorded MAX limit for Axis %d\n", axis);
             }
             continue;
@@ -1535,7 +1701,7 @@ static void* CmdThread(void*)
             if (sscanf(line + 7, "%d", &axis) == 1) {
                 MotorState_ st;
                 MotorCmd_ cmd{};
-                if (MT_GetMotorState((EC_T_WORD)(axis - 1), &st)) {
+                if (MT_GetMotorState(pMt, (EC_T_WORD)(axis - 1), &st)) {
                     cmd.q = st.q_fb;
                 } else {
                     cmd.q = 0;
@@ -1543,7 +1709,7 @@ static void* CmdThread(void*)
                 cmd.kp = 32.0f;
                 cmd.kd = 30.0f;
                 cmd.mode = 8; 
-                MT_SetMotorCmd((EC_T_WORD)(axis - 1), &cmd);
+                MT_SetMotorCmd(pMt, (EC_T_WORD)(axis - 1), &cmd);
                 printf("[CMD] OK: enabling axis %d at pos %.3f with default KP/KD\n", axis, cmd.q);
             }
             continue;
@@ -1559,7 +1725,7 @@ static void* CmdThread(void*)
                 cmd.dq   = speed; // 设置运行速度
                 cmd.kp   = 32.0f; // 保持锁死力量
                 cmd.kd   = 30.0f;
-                MT_SetMotorCmd((EC_T_WORD)(axis - 1), &cmd);
+                MT_SetMotorCmd(pMt, (EC_T_WORD)(axis - 1), &cmd);
                 printf("[CMD] OK: Start aging for Axis %d at speed %.3f rad/s\n", axis, speed);
             } else {
                 printf("[CMD] 用法: aging <1-7> <速度>\n");
@@ -1571,7 +1737,7 @@ static void* CmdThread(void*)
             if (sscanf(line + 8, "%d", &axis) == 1) {
                 MotorCmd_ cmd{};
                 cmd.mode = 0; // Shutdown
-                MT_SetMotorCmd((EC_T_WORD)(axis - 1), &cmd);
+                MT_SetMotorCmd(pMt, (EC_T_WORD)(axis - 1), &cmd);
                 printf("[CMD] OK: disabling axis %d\n", axis);
             }
             continue;
@@ -1594,7 +1760,7 @@ static void* CmdThread(void*)
                 cmd.kp   = (num >= 6) ? kp : 32.0f; 
                 cmd.kd   = (num >= 7) ? kd : 30.0f;
                 
-                MT_SetMotorCmd((EC_T_WORD)(axis - 1), &cmd);
+                MT_SetMotorCmd(pMt, (EC_T_WORD)(axis - 1), &cmd);
                 printf("[CMD] OK: axis=%d mode=0x%02X q=%.3f dq=%.3f tau=%.3f kp=%.1f kd=%.1f\n", 
                        axis, mode, q, dq, tau, cmd.kp, cmd.kd);
             } else {
@@ -1612,7 +1778,7 @@ static void* CmdThread(void*)
             {
                 MotorState_ st;
                 OsMemset(&st, 0, sizeof(st));
-                if (MT_GetMotorState((EC_T_WORD)(axis - 1), &st))
+                if (MT_GetMotorState(pMt, (EC_T_WORD)(axis - 1), &st))
                 {
                     printf("[CMD] --- Axis %d Feedback ---\n", axis);
                     printf("  Mode: 0x%02X | Status: 0x%08X\n", st.mode, st.motorstate);
@@ -1620,6 +1786,15 @@ static void* CmdThread(void*)
                            st.q_fb, st.dq_fb, st.tau_fb);
                     printf("  Vol: %.1f V | Temp: MCU %.1f degC, Motor %.1f degC\n", 
                            st.vol, (float)st.temperature[0]*0.1f, (float)st.temperature[1]*0.1f);
+                    /* [2026-10-16] 绑定表里的扩展变量（非 My_Motor_Type 字段，如配置新增的对象）按原始值打印 */
+                    EC_T_BOOL bExtra = EC_FALSE;
+                    const T_MT_PDO_BINDING* pBinding = EC_NULL;
+                    for (EC_T_DWORD b = 0; (pBinding = MT_GetPdoBinding(&pMt->oPdo, b, &bExtra)) != EC_NULL; b++) {
+                        EC_T_LREAL fVal = 0;
+                        if (bExtra && MT_GetPdoVar(&pMt->oPdo, (EC_T_WORD)(axis - 1), pBinding->szName, &fVal)) {
+                            printf("  %s (0x%04X): %g\n", pBinding->szName, pBinding->wIndex, fVal);
+                        }
+                    }
                 }
                 else
                 {
@@ -1634,12 +1809,123 @@ static void* CmdThread(void*)
             continue;
         }
 
+        /* [2026-10-16] 目的：经 SDO 流水线读取任意对象（演示异步读 + handle 等待） */
+        if (strncmp(line, "sdo_get ", 8) == 0) {
+            int axis = 0;
+            int idx = 0, sub = 0;
+            /* static：等待超时后流水线仍可能回写 handle/缓冲区，上一个请求完成（bDone）前不接受新请求 */
+            static EC_T_BYTE abyData[SDO_PIPE_MAX_DATA_LEN];
+            static T_SDO_PIPE_HANDLE oHandle;
+            static EC_T_BOOL bPending = EC_FALSE;
+            if ((sscanf(line + 8, "%d %i %i", &axis, &idx, &sub) < 2)
+                || (idx < 0) || (idx > 0xFFFF) || (sub < 0) || (sub > 0xFF)) {
+                printf("[CMD] 用法: sdo_get <1-7> <index 0..0xFFFF> [sub 0..0xFF]\n");
+            } else if (bPending && !SDO_PIPE_HANDLE_DONE(&oHandle)) {
+                printf("[CMD] FAIL: sdo_get 上一个请求尚未完成，请稍后重试\n");
+            } else {
+                OsMemset(abyData, 0, sizeof(abyData));
+                OsMemset(&oHandle, 0, sizeof(oHandle));
+                EC_T_DWORD dwRes = MT_SdoUpload(pMt, (EC_T_WORD)(axis - 1), (EC_T_WORD)idx, (EC_T_BYTE)sub, abyData, sizeof(abyData), &oHandle);
+                bPending = (dwRes == EC_E_NOERROR);
+                if (dwRes == EC_E_NOERROR) {
+                    dwRes = CEcSdoPipeline::Wait(&oHandle, 2 * SDO_PIPE_DEFAULT_TIMEOUT);
+                }
+                if (dwRes == EC_E_NOERROR) {
+                    EC_T_DWORD dwRaw = 0;
+                    EC_T_REAL  fVal  = 0;
+                    OsMemcpy(&dwRaw, abyData, sizeof(dwRaw));
+                    OsMemcpy(&fVal, abyData, sizeof(fVal));
+                    printf("[CMD] OK: axis=%d 0x%04X:%d len=%u raw=0x%08X (real=%.3f)\n",
+                           axis, idx, sub, oHandle.dwOutDataLen, dwRaw, fVal);
+                } else {
+                    printf("[CMD] FAIL: sdo_get axis=%d 0x%04X:%d -> 0x%08X\n", axis, idx, sub, dwRes);
+                }
+            }
+            fflush(stdout);
+            continue;
+        }
+
+        /* [2026-10-16] 目的：查看/导出周期计时（唤醒延迟、各 ecatExecJob 段耗时，与 frame loss 对照） */
+        if ((strcmp(line, "trace") == 0) || (strncmp(line, "trace ", 6) == 0)) {
+            if (pTrace == EC_NULL) {
+                printf("[CMD] FAIL: cycle trace not enabled\n");
+            } else if (strncmp(line, "trace csv ", 10) == 0) {
+                EC_T_DWORD dwRes = pTrace->DumpCsv(line + 10);
+                printf("[CMD] %s: trace csv %s (0x%08X)\n", (dwRes == EC_E_NOERROR) ? "OK" : "FAIL", line + 10, dwRes);
+            } else {
+                static T_CYC_TRACE_SNAPSHOT oSnap;
+                pTrace->GetSnapshot(&oSnap, (strcmp(line, "trace reset") == 0) ? EC_TRUE : EC_FALSE);
+                printf("\n[CMD] --- cycle trace: %llu cycles, %llu frame loss, %llu dropped (us) ---\n",
+                       (unsigned long long)oSnap.qwCycles, (unsigned long long)oSnap.qwFrameLoss, (unsigned long long)oSnap.qwDropped);
+                printf("  %-9s %9s %9s %9s %9s %9s\n", "", "min", "p50", "p99", "p99.9", "max");
+                for (EC_T_DWORD i = 0; i < CYC_TRACE_METRIC_CNT; i++) {
+                    const T_CYC_TRACE_METRIC* pM = &oSnap.aMetric[i];
+                    if (pM->qwCount == 0) continue;
+                    printf("  %-9s %9.1f %9.1f %9.1f %9.1f %9.1f\n", CEcCycleTrace::MetricName(i),
+                           pM->dwMin / 1000.0, pM->dwP50 / 1000.0, pM->dwP99 / 1000.0, pM->dwP999 / 1000.0, pM->dwMax / 1000.0);
+                }
+                for (EC_T_DWORD i = 0; (i < oSnap.dwWorstCnt) && (i < 3); i++) {
+                    const T_CYC_TRACE_REC* pR = &oSnap.aWorst[i];
+                    printf("  worst#%u cycle=%llu dispatch=%.1f rx=%.1f workpd=%.1f tx=%.1f total=%.1f flags=0x%x\n", i + 1,
+                           (unsigned long long)pR->qwCycle, pR->adwNsec[CYC_TRACE_DISPATCH] / 1000.0, pR->adwNsec[CYC_TRACE_RX] / 1000.0,
+                           pR->adwNsec[CYC_TRACE_WORKPD] / 1000.0, pR->adwNsec[CYC_TRACE_TX] / 1000.0, pR->adwNsec[CYC_TRACE_TOTAL] / 1000.0, pR->dwFlags);
+                }
+            }
+            fflush(stdout);
+            continue;
+        }
+
+        /* [2026-10-16] 目的：查看分段抓包统计（丢帧数非 0 说明抓包不完整：段来不及准备或帧回调争用） */
+        if (strcmp(line, "pcap") == 0) {
+            if ((pPcap == EC_NULL) || !pPcap->IsRunning()) {
+                printf("[CMD] FAIL: pcap segment recorder not running (-pcapmmap)\n");
+            } else {
+                T_PCAP_MMAP_STATS oStats;
+                pPcap->GetStats(&oStats);
+                printf("[CMD] pcap: %llu frames, %llu bytes, %llu dropped, %u segments (%u deleted), %u errors\n",
+                       (unsigned long long)oStats.qwFrames, (unsigned long long)oStats.qwBytes, (unsigned long long)oStats.qwDropped,
+                       oStats.dwSegments, oStats.dwDeleted, oStats.dwErrors);
+            }
+            fflush(stdout);
+            continue;
+        }
+
+        /* [2026-10-16] 目的：查看轴组流式轨迹状态；stop=受控停止并丢弃已推送点，reset=解除欠载锁定，release=HOLD 的组交还 MotorCmd_ */
+        if ((strcmp(line, "traj") == 0) || (strncmp(line, "traj ", 5) == 0)) {
+            static const char* s_aszTrajState[] = { "IDLE", "RUN", "STOP", "HOLD" };
+            char szOp[16] = { 0 };
+            unsigned int group = 0;
+            if (sscanf(line + 4, "%15s %u", szOp, &group) == 2) {
+                EC_T_DWORD dwRes = EC_E_INVALIDPARM;
+                if (strcmp(szOp, "stop") == 0) {
+                    dwRes = MT_TrajStop(pMt, group);
+                } else if (strcmp(szOp, "reset") == 0) {
+                    dwRes = MT_TrajReset(pMt, group);
+                } else if (strcmp(szOp, "release") == 0) {
+                    dwRes = MT_TrajRelease(pMt, group);
+                }
+                printf("[CMD] %s: traj %s %u (0x%08X)\n", (dwRes == EC_E_NOERROR) ? "OK" : "FAIL", szOp, group, dwRes);
+            } else {
+                printf("\n[CMD] --- traj groups: %u ---\n", MT_TrajGetGroupCnt(pMt));
+                for (EC_T_DWORD g = 0; g < MT_TrajGetGroupCnt(pMt); g++) {
+                    T_MT_TRAJ_STATUS oStatus;
+                    if (MT_TrajGetStatus(pMt, g, &oStatus) != EC_E_NOERROR) continue;
+                    printf("  group %u: %-4s%s t=%.3f buffered=%.3fs queued=%u free=%u streams=%u underruns=%u aborts=%u points=%llu\n",
+                           g, s_aszTrajState[oStatus.dwState & 3], oStatus.bLatched ? " (latched)" : "", oStatus.fTime, oStatus.fBufferedSec,
+                           oStatus.dwQueued, oStatus.dwFree, oStatus.dwStreams, oStatus.dwUnderruns, oStatus.dwAborts,
+                           (unsigned long long)oStatus.qwPoints);
+                }
+            }
+            fflush(stdout);
+            continue;
+        }
+
         if (strncmp(line, "stop ", 5) == 0) {
             int axis = 0;
             if (sscanf(line + 5, "%d", &axis) == 1) {
                 MotorCmd_ cmd{};
                 cmd.mode = 0; // Shutdown
-                MT_SetMotorCmd((EC_T_WORD)(axis - 1), &cmd);
+                MT_SetMotorCmd(pMt, (EC_T_WORD)(axis - 1), &cmd);
                 printf("[CMD] OK: stop axis=%d\n", axis);
             } else {
                 printf("[CMD] 用法: stop <1-7>\n");
@@ -1652,7 +1938,7 @@ static void* CmdThread(void*)
             int axis = 0;
             double cpr = 0, ratio = 0;
             if (sscanf(line + 6, "%d %lf %lf", &axis, &cpr, &ratio) == 3) {
-                if (MT_SetAxisUnitScale((EC_T_WORD)(axis - 1), (EC_T_LREAL)cpr, (EC_T_LREAL)ratio)) {
+                if (MT_SetAxisUnitScale(pMt, (EC_T_WORD)(axis - 1), (EC_T_LREAL)cpr, (EC_T_LREAL)ratio)) {
                     printf("[CMD] OK: scale axis=%d cpr=%.0f ratio=%.6f\n", axis, cpr, ratio);
                 } else {
                     printf("[CMD] FAIL: scale 参数不合法\n");
@@ -37,9 +37,14 @@
 #include "EcLogging.h"
 #include "EcNotification.h"
 #include "EcSdoServices.h"
+#include "EcSdoPipeline.h"
+#include "EcCycleTrace.h"
+#include "EcDeferredLog.h"
+#include "EcPcapMmap.h"
 #include "EcSelectLinkLayer.h"
 #include "EcSlaveInfo.h"
 #include "EcDemoTimingTaskPlatform.h"
+#include "EcDemoRtPlatform.h"
 
 /*-DEFINES-------------------------------------------------------------------*/
 /* demo 名称：会用于启动日志、帮助信息等显示 */
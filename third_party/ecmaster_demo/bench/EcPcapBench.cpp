@@ -0,0 +1,306 @@
+/*-----------------------------------------------------------------------------
+ * EcPcapBench.cpp
+ *
+ * 作用：CEcPcapMmapRecorder / CEcPcapIndexReader 的吞吐基准 + 回归（不需要 EC‑Master 库和网卡）。
+ *
+ * - 录制：主线程按周期生成 EtherCAT 帧（TX：LRW 0x00010000 64 字节，输出 0..3 = 周期计数 c；
+ *   RX：源 MAC 置 locally administered 位，输入 8..11 = 3*c，WKC = 3），另一线程同时写非周期帧（FPRD），
+ *   覆盖多写者和按大小轮转；统计 LogFrame() 的 ns/帧
+ * - 读取：逐段 Open（mmap + 建索引）、DecodeLogical() 取每周期 RX 的输入值，统计 ns/帧
+ * - 校验（任一失败返回非 0）：
+ *   1) 写入 + 丢弃 == 生成；各段索引到的帧数之和 == 写入
+ *   2) 无丢帧时：每个周期的 RX 输入 == 3 * 同一周期 TX 标记帧的输出（周期号关联正确），段内 c 连续递增
+ *   3) 时间戳单调，FindFrameByTime() 与索引一致
+ *   4) 周期线程 LogFrame() 的平均 ns/帧不超过 [max-ns-per-frame]（ctest 用 CMake 里的 ECM_BENCH_PCAP_MAX_NS）
+ *   5) 同一前缀重启：编号接在上次最大的段之后、不改动已有的段，已有的段计入 dwMaxSegments（删除最旧的）
+ *
+ * 构建：cmake -DECM_BUILD_BENCH=ON ... && make EcPcapBench
+ * 运行：./EcPcapBench [cycles] [dir] [max-ns-per-frame]     （默认 200000 周期，/tmp，2000 ns；上限给 0 表示不限）
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+#include "EcPcapMmap.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define BENCH_DEFAULT_CYCLES    200000
+#define BENCH_SEGMENT_MB        8       /* 小段，保证基准里发生多次轮转 */
+#define BENCH_PERIOD_MSEC       1
+#define BENCH_LOG_ADDR          0x00010000
+#define BENCH_PD_LEN            64
+#define BENCH_IN_OFFSET         8       /* 输入值在 LRW 数据里的偏移 */
+#define BENCH_ACYC_FRAMES       20000   /* 非周期线程写的帧数 */
+#define BENCH_BURST             2000    /* 每 BENCH_BURST 周期让出 1ms，模拟周期节拍给段线程留时间 */
+#define BENCH_MAX_SEGMENTS      4096
+#define BENCH_DEFAULT_MAX_NS    2000    /* 周期线程 ns/帧上限（x86 Release 约 150 ns） */
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_VOID BenchPutLe32(EC_T_BYTE* pby, EC_T_DWORD dw)
+{
+  pby[0] = (EC_T_BYTE)dw;
+  pby[1] = (EC_T_BYTE)(dw >> 8);
+  pby[2] = (EC_T_BYTE)(dw >> 16);
+  pby[3] = (EC_T_BYTE)(dw >> 24);
+}
+
+static EC_T_DWORD BenchGetLe32(const EC_T_BYTE* pby)
+{
+  return (EC_T_DWORD)pby[0] | ((EC_T_DWORD)pby[1] << 8) | ((EC_T_DWORD)pby[2] << 16) | ((EC_T_DWORD)pby[3] << 24);
+}
+
+/* 单数据报 EtherCAT 帧，返回帧长 */
+static EC_T_DWORD BenchBuildFrame(EC_T_BYTE* pby, EC_T_BOOL bRx, EC_T_BYTE byCmd, EC_T_DWORD dwAddr, EC_T_DWORD dwCounter)
+{
+  const EC_T_DWORD dwEcatLen = 10 + BENCH_PD_LEN + 2;
+  EC_T_BYTE* pbyDgram = pby + 16;
+
+  OsMemset(pby, 0, 14 + 2 + dwEcatLen);
+  OsMemset(pby, 0xFF, 6);
+  pby[6] = (EC_T_BYTE)(bRx ? 0x02 : 0x00);
+  pby[7] = 0x01; pby[8] = 0x05; pby[9] = 0x11; pby[10] = 0x22; pby[11] = 0x33;
+  pby[12] = 0x88; pby[13] = 0xA4;
+  pby[14] = (EC_T_BYTE)dwEcatLen;
+  pby[15] = (EC_T_BYTE)(0x10 | ((dwEcatLen >> 8) & 0x07));
+  pbyDgram[0] = byCmd;
+  BenchPutLe32(pbyDgram + 2, dwAddr);
+  pbyDgram[6] = (EC_T_BYTE)BENCH_PD_LEN;
+  pbyDgram[7] = 0;
+  BenchPutLe32(pbyDgram + 10, dwCounter);
+  if (bRx) {
+    BenchPutLe32(pbyDgram + 10 + BENCH_IN_OFFSET, 3 * dwCounter);
+    pbyDgram[10 + BENCH_PD_LEN] = 3;
+  }
+  return 14 + 2 + dwEcatLen;
+}
+
+/* 非周期线程：FPRD 帧（不是周期标记），与主线程同时写 */
+static EC_T_VOID BenchAcycThread(CEcPcapMmapRecorder* pRec)
+{
+  EC_T_BYTE abyFrame[256];
+  for (EC_T_DWORD i = 0; i < BENCH_ACYC_FRAMES; i++) {
+    const EC_T_DWORD dwLen = BenchBuildFrame(abyFrame, (EC_T_BOOL)(i & 1), 4 /* FPRD */, 0x01300000 | i, i);
+    pRec->LogFrame(dwLen, abyFrame);
+    if ((i % 256) == 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/* 读一段：建索引、解码、校验，累计帧数与耗时 */
+static EC_T_BOOL BenchReadSegment(const EC_T_CHAR* szName, EC_T_BOOL bExpectContiguous, EC_T_UINT64* pqwFrames, EC_T_UINT64* pqwCycles,
+                                  double* pfOpenNs, double* pfDecodeNs, T_PCAP_PD_SAMPLE* aSample, EC_T_DWORD dwMaxSamples)
+{
+  CEcPcapIndexReader oReader;
+  EC_T_DWORD dwSamples = 0;
+  EC_T_DWORD dwRes = EC_E_NOERROR;
+  T_PCAP_FRAME oFrame;
+
+  auto t0 = std::chrono::steady_clock::now();
+  dwRes = oReader.Open(szName);
+  auto t1 = std::chrono::steady_clock::now();
+  if (dwRes != EC_E_NOERROR) {
+    printf("  %s: open failed 0x%x\n", szName, dwRes);
+    return EC_FALSE;
+  }
+  dwRes = oReader.DecodeLogical(BENCH_LOG_ADDR + BENCH_IN_OFFSET, 4, PCAP_DECODE_RX | PCAP_DECODE_MARKER,
+                                0, oReader.GetFrameCnt(), aSample, dwMaxSamples, &dwSamples);
+  auto t2 = std::chrono::steady_clock::now();
+  *pfOpenNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+  *pfDecodeNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+  *pqwFrames += oReader.GetFrameCnt();
+  *pqwCycles += oReader.GetCycleCnt();
+  if ((dwRes != EC_E_NOERROR) || (dwSamples == 0)) {
+    printf("  %s: no samples (0x%x)\n", szName, dwRes);
+    return EC_FALSE;
+  }
+
+  /* 2) RX 输入 == 3 * 同周期 TX 输出 */
+  for (EC_T_DWORD i = 0; i < dwSamples; i++) {
+    const T_PCAP_PD_SAMPLE* pSample = &aSample[i];
+    const EC_T_DWORD dwIn = BenchGetLe32(pSample->abyData);
+    EC_T_DWORD dwOut = 0;
+
+    /* 轮转可能把一个周期的 TX 和 RX 分到两段：段首的 RX 帧没有周期号 */
+    if ((i == 0) && (pSample->dwCycle == PCAP_IDX_NO_CYCLE)) {
+      continue;
+    }
+    if ((pSample->dwCycle == PCAP_IDX_NO_CYCLE) || (pSample->wWkc != 3)
+        || (EC_E_NOERROR != oReader.GetFrame(oReader.GetCycleFirstFrame(pSample->dwCycle), &oFrame))) {
+      printf("  %s: sample %u without cycle\n", szName, i);
+      return EC_FALSE;
+    }
+    dwOut = BenchGetLe32(oFrame.pbyData + 16 + 10);
+    /* 丢掉的 TX 标记帧会让其 RX 帧归到上一个周期：有丢帧时不做此项检查 */
+    if (bExpectContiguous && (dwIn != 3 * dwOut)) {
+      printf("  %s: cycle %u in=%u out=%u\n", szName, pSample->dwCycle, dwIn, dwOut);
+      return EC_FALSE;
+    }
+    if (bExpectContiguous && (i > 0) && (dwIn != BenchGetLe32(aSample[i - 1].abyData) + 3)) {
+      printf("  %s: gap after cycle %u\n", szName, aSample[i - 1].dwCycle);
+      return EC_FALSE;
+    }
+  }
+
+  /* 3) 时间戳单调，按时间查找落在第一个同时间戳的帧 */
+  const T_PCAP_FRAME_IDX* aIdx = oReader.GetIndex();
+  for (EC_T_DWORD i = 1; i < oReader.GetFrameCnt(); i++) {
+    if (aIdx[i].qwTimeNsec < aIdx[i - 1].qwTimeNsec) {
+      printf("  %s: timestamp of frame %u goes back\n", szName, i);
+      return EC_FALSE;
+    }
+  }
+  for (EC_T_DWORD i = 0; i < oReader.GetFrameCnt(); i += 997) {
+    const EC_T_DWORD dwFound = oReader.FindFrameByTime(aIdx[i].qwTimeNsec);
+    if ((dwFound > i) || (aIdx[dwFound].qwTimeNsec != aIdx[i].qwTimeNsec) || ((dwFound > 0) && (aIdx[dwFound - 1].qwTimeNsec >= aIdx[i].qwTimeNsec))) {
+      printf("  %s: FindFrameByTime(frame %u) = %u\n", szName, i, dwFound);
+      return EC_FALSE;
+    }
+  }
+  return EC_TRUE;
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+int main(int nArgc, char* ppArgv[])
+{
+  EC_T_DWORD dwCycles = BENCH_DEFAULT_CYCLES;
+  const EC_T_CHAR* szDir = "/tmp";
+  EC_T_CHAR szPrefix[PCAP_MMAP_PREFIX_SIZE];
+  EC_T_CHAR szName[PCAP_MMAP_PREFIX_SIZE + 16];
+  EC_T_BYTE abyTx[256];
+  EC_T_BYTE abyRx[256];
+  CEcPcapMmapRecorder oRec;
+  T_PCAP_MMAP_STATS oStats;
+  EC_T_CPUSET CpuSet;
+  EC_T_UINT64 qwFrames = 0;
+  EC_T_UINT64 qwCycles = 0;
+  double fRecordNs = 0;
+  double fMaxNsPerFrame = BENCH_DEFAULT_MAX_NS;
+  double fOpenNs = 0;
+  double fDecodeNs = 0;
+  T_PCAP_PD_SAMPLE* aSample = EC_NULL;
+  EC_T_BOOL bOk = EC_TRUE;
+
+  if (nArgc > 1) {
+    dwCycles = (EC_T_DWORD)strtoul(ppArgv[1], EC_NULL, 0);
+  }
+  if (dwCycles == 0) {
+    dwCycles = BENCH_DEFAULT_CYCLES;
+  }
+  if (nArgc > 2) {
+    szDir = ppArgv[2];
+  }
+  if (nArgc > 3) {
+    fMaxNsPerFrame = strtod(ppArgv[3], EC_NULL);
+  }
+  OsSnprintf(szPrefix, sizeof(szPrefix), "%s/EcPcapBench.%d", szDir, (int)getpid());
+  EC_CPUSET_ZERO(CpuSet);
+  printf("EcPcapBench: %u cycles (%u frames + %u acyclic), segment %u MB, prefix %s\n",
+         dwCycles, 2 * dwCycles, BENCH_ACYC_FRAMES, BENCH_SEGMENT_MB, szPrefix);
+
+  /* 录制：保留全部段（dwMaxSegments = 0），读取后删除 */
+  if (EC_E_NOERROR != oRec.Start(szPrefix, CpuSet, 0, BENCH_SEGMENT_MB, 0, 0, BENCH_PERIOD_MSEC)) {
+    printf("recorder start failed\n");
+    return 1;
+  }
+  std::thread oAcyc(BenchAcycThread, &oRec);
+  for (EC_T_DWORD c = 0; c < dwCycles; c++) {
+    const EC_T_DWORD dwTxLen = BenchBuildFrame(abyTx, EC_FALSE, 12 /* LRW */, BENCH_LOG_ADDR, c);
+    const EC_T_DWORD dwRxLen = BenchBuildFrame(abyRx, EC_TRUE, 12 /* LRW */, BENCH_LOG_ADDR, c);
+    auto t0 = std::chrono::steady_clock::now();
+    oRec.LogFrame(dwTxLen, abyTx);
+    oRec.LogFrame(dwRxLen, abyRx);
+    fRecordNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    if ((c % BENCH_BURST) == BENCH_BURST - 1) {
+      OsSleep(1);
+    }
+  }
+  oAcyc.join();
+  oRec.Stop();
+  oRec.GetStats(&oStats);
+  printf("record: %llu frames, %llu bytes, %llu dropped, %u segments, %u errors, %.1f ns/frame (cyclic thread)\n",
+         (unsigned long long)oStats.qwFrames, (unsigned long long)oStats.qwBytes, (unsigned long long)oStats.qwDropped,
+         oStats.dwSegments, oStats.dwErrors, fRecordNs / (2.0 * dwCycles));
+
+  /* 4) 录制耗时 */
+  if ((fMaxNsPerFrame > 0) && (fRecordNs / (2.0 * dwCycles) > fMaxNsPerFrame)) {
+    printf("FAIL: %.1f ns/frame exceeds limit %.1f\n", fRecordNs / (2.0 * dwCycles), fMaxNsPerFrame);
+    bOk = EC_FALSE;
+  }
+
+  /* 1) 计数 */
+  if (oStats.qwFrames + oStats.qwDropped != 2ULL * dwCycles + BENCH_ACYC_FRAMES) {
+    printf("FAIL: frames %llu + dropped %llu != generated %llu\n", (unsigned long long)oStats.qwFrames,
+           (unsigned long long)oStats.qwDropped, 2ULL * dwCycles + BENCH_ACYC_FRAMES);
+    bOk = EC_FALSE;
+  }
+  if ((oStats.dwSegments < 2) || (oStats.dwSegments > BENCH_MAX_SEGMENTS)) {
+    printf("FAIL: %u segments (rotation not exercised)\n", oStats.dwSegments);
+    bOk = EC_FALSE;
+  }
+
+  /* 读取 + 校验 */
+  aSample = (T_PCAP_PD_SAMPLE*)OsMalloc(sizeof(T_PCAP_PD_SAMPLE) * dwCycles);
+  if (aSample == EC_NULL) {
+    return 1;
+  }
+  for (EC_T_DWORD dwSeq = 0; dwSeq < oStats.dwSegments; dwSeq++) {
+    OsSnprintf(szName, sizeof(szName), "%s.%05u.pcap", szPrefix, dwSeq);
+    if (bOk && !BenchReadSegment(szName, (EC_T_BOOL)(oStats.qwDropped == 0), &qwFrames, &qwCycles, &fOpenNs, &fDecodeNs, aSample, dwCycles)) {
+      bOk = EC_FALSE;
+    }
+  }
+  OsFree(aSample);
+  if (bOk && (qwFrames != oStats.qwFrames)) {
+    printf("FAIL: reader indexed %llu frames, recorder wrote %llu\n", (unsigned long long)qwFrames, (unsigned long long)oStats.qwFrames);
+    bOk = EC_FALSE;
+  }
+  if (qwFrames > 0) {
+    printf("read:   %llu frames, %llu cycles, open+index %.1f ns/frame (%.0f Mframes/s), decode %.1f ns/frame\n",
+           (unsigned long long)qwFrames, (unsigned long long)qwCycles, fOpenNs / (double)qwFrames,
+           (double)qwFrames * 1000.0 / fOpenNs, fDecodeNs / (double)qwFrames);
+  }
+
+  /* 5) 重启：保留 dwSegments 段，新的一段关闭后共 dwSegments + 1 段，最旧的 0 号被删除 */
+  if (bOk) {
+    struct stat oStat;
+    T_PCAP_MMAP_STATS oRestart;
+    off_t nSize1 = -1;
+
+    OsSnprintf(szName, sizeof(szName), "%s.%05u.pcap", szPrefix, 1u);
+    if (0 == stat(szName, &oStat)) {
+      nSize1 = oStat.st_size;
+    }
+    if (EC_E_NOERROR != oRec.Start(szPrefix, CpuSet, 0, BENCH_SEGMENT_MB, 0, oStats.dwSegments, BENCH_PERIOD_MSEC)) {
+      printf("FAIL: recorder restart failed\n");
+      bOk = EC_FALSE;
+    } else {
+      const EC_T_DWORD dwTxLen = BenchBuildFrame(abyTx, EC_FALSE, 12 /* LRW */, BENCH_LOG_ADDR, 0);
+      oRec.LogFrame(dwTxLen, abyTx);
+      oRec.Stop();
+      oRec.GetStats(&oRestart);
+      OsSnprintf(szName, sizeof(szName), "%s.%05u.pcap", szPrefix, oStats.dwSegments);
+      bOk = (oRestart.dwSegments == 1) && (oRestart.dwDeleted == 1) && (0 == stat(szName, &oStat));
+      OsSnprintf(szName, sizeof(szName), "%s.%05u.pcap", szPrefix, 0u);
+      bOk = bOk && (0 != stat(szName, &oStat));
+      OsSnprintf(szName, sizeof(szName), "%s.%05u.pcap", szPrefix, 1u);
+      bOk = bOk && (0 == stat(szName, &oStat)) && (oStat.st_size == nSize1);
+      printf("restart: %u segment(s), %u deleted, numbering continued at %u: %s\n",
+             oRestart.dwSegments, oRestart.dwDeleted, oStats.dwSegments, bOk ? "ok" : "FAIL");
+    }
+  }
+  for (EC_T_DWORD dwSeq = 0; dwSeq <= oStats.dwSegments; dwSeq++) {
+    OsSnprintf(szName, sizeof(szName), "%s.%05u.pcap", szPrefix, dwSeq);
+    unlink(szName);
+  }
+  printf("%s\n", bOk ? "PASS" : "FAIL");
+  return bOk ? 0 : 1;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
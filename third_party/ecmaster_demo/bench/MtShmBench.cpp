@@ -0,0 +1,312 @@
+/*-----------------------------------------------------------------------------
+ * MtShmBench.cpp
+ *
+ * 作用：过程数据共享内存（motrotech_shm.cpp）的跨进程回归 + 时延统计（不需要 EC‑Master 库和从站）。
+ *
+ * - 服务端（本进程主线程）：按总线周期（clock_nanosleep 绝对时间）模拟 MT_Workpd()：
+ *   周期开始 MtShmTakeCmd()，周期末把所有轴所有字段填成周期号 c 再 MtShmPublish()
+ * - 控制器（fork 出的子进程）：MtShmWaitCycle() 跟随周期，读全部轴快照，
+ *   按快照周期号 c 填命令（所有轴 q = c、reserve = c）并 MtShmPostCmd(qwStateCycle = c)
+ * - 旁路读者（服务端进程里另一线程）：不停地读快照，和控制器一起验证多读者
+ * - 校验（任一失败返回非 0）：
+ *   1) 两个读者都没有读到撕裂的快照（所有轴所有字段 == 快照周期号）
+ *   2) 服务端取到的每块命令都是完整的（所有轴 == 块的 qwStateCycle），没有被拒绝的块
+ *   3) 控制器确实跟上了周期（取到的命令块数 > 0，服务端退出后控制器正常结束）
+ *   4) 唤醒时延 p99 不超过 [max-p99-usec]（ctest 用 CMake 里的 ECM_BENCH_SHM_MAX_P99_USEC）
+ * - 统计：唤醒时延（发布 -> 控制器醒来读完）p50/p99/max，反馈 -> 命令生效的周期数（1 为按时，> 1 计入迟到）
+ *
+ * 构建：cmake -DECM_BUILD_BENCH=ON ... && make MtShmBench
+ * 运行：./MtShmBench [cycles] [axes] [cycle_usec] [max-p99-usec]     （默认 5000 周期，32 轴，1000 us，200 us；上限给 0 表示不限）
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+#include "motrotech_shm.h"
+
+#include <algorithm>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define BENCH_DEFAULT_CYCLES    5000
+#define BENCH_DEFAULT_AXES      32
+#define BENCH_DEFAULT_USEC      1000
+#define BENCH_DEFAULT_MAX_P99   200     /* 唤醒时延 p99 上限（us），x86 上约 10 us */
+#define BENCH_OPEN_RETRY        1000    /* 控制器等服务端初始化完，每次 1ms */
+#define BENCH_WAIT_MSEC         100
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_UINT64 BenchNowNsec(EC_T_VOID)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (EC_T_UINT64)ts.tv_sec * 1000000000ULL + (EC_T_UINT64)ts.tv_nsec;
+}
+
+/* 服务端：周期 c 的状态（所有字段都由 c 得到，读者据此判断是否撕裂） */
+static EC_T_VOID BenchFillState(MotorState_* pSt, EC_T_UINT64 qwCycle)
+{
+  const EC_T_DWORD dwCycle = (EC_T_DWORD)qwCycle;
+
+  pSt->mode = (EC_T_BYTE)dwCycle;
+  pSt->q_fb = (EC_T_REAL)dwCycle;
+  pSt->dq_fb = (EC_T_REAL)dwCycle;
+  pSt->ddq_fb = (EC_T_REAL)dwCycle;
+  pSt->tau_fb = (EC_T_REAL)dwCycle;
+  pSt->temperature[0] = (EC_T_WORD)dwCycle;
+  pSt->temperature[1] = (EC_T_WORD)(dwCycle >> 16);
+  pSt->vol = (EC_T_REAL)dwCycle;
+  pSt->sensor[0] = dwCycle;
+  pSt->sensor[1] = ~dwCycle;
+  pSt->motorstate = dwCycle;
+}
+
+static EC_T_BOOL BenchCheckState(const MotorState_* aState, EC_T_DWORD dwCnt, EC_T_UINT64 qwCycle)
+{
+  MotorState_ oRef;
+
+  OsMemset(&oRef, 0, sizeof(oRef));
+  BenchFillState(&oRef, qwCycle);
+  for (EC_T_DWORD i = 0; i < dwCnt; i++) {
+    if (OsMemcmp(&aState[i], &oRef, sizeof(MotorState_)) != 0) {
+      return EC_FALSE;
+    }
+  }
+  return EC_TRUE;
+}
+
+static EC_T_UINT64 BenchPercentile(EC_T_UINT64* aqw, EC_T_DWORD dwCnt, EC_T_DWORD dwPermille)
+{
+  if (dwCnt == 0) {
+    return 0;
+  }
+  std::sort(aqw, aqw + dwCnt);
+  return aqw[((EC_T_UINT64)(dwCnt - 1) * dwPermille) / 1000];
+}
+
+/* 控制器进程：返回值即进程退出码 */
+static int BenchController(const EC_T_CHAR* szName, EC_T_DWORD dwCycles, EC_T_DWORD dwMaxP99Usec)
+{
+  T_MT_SHM oShm = {};
+  MotorState_* aState = EC_NULL;
+  MotorCmd_* aCmd = EC_NULL;
+  EC_T_UINT64* aqwWake = EC_NULL;
+  EC_T_DWORD dwWake = 0;
+  EC_T_DWORD dwTorn = 0;
+  EC_T_DWORD dwTimeout = 0;
+  EC_T_UINT64 qwSeq = 0;
+  EC_T_UINT64 qwCycle = 0;
+  EC_T_UINT64 qwTimeNsec = 0;
+  EC_T_UINT64 qwP99 = 0;
+  EC_T_DWORD dwRes = EC_E_BUSY;
+  int nRes = 0;
+
+  for (EC_T_DWORD i = 0; (i < BENCH_OPEN_RETRY) && (dwRes != EC_E_NOERROR); i++) {
+    dwRes = MtShmOpen(&oShm, szName);
+    if (dwRes != EC_E_NOERROR) {
+      usleep(1000);
+    }
+  }
+  if (dwRes != EC_E_NOERROR) {
+    printf("controller: open %s failed 0x%x\n", szName, dwRes);
+    return 2;
+  }
+  aState = (MotorState_*)OsMalloc(oShm.dwAxisCnt * sizeof(MotorState_));
+  aCmd = (MotorCmd_*)OsMalloc(oShm.dwAxisCnt * sizeof(MotorCmd_));
+  aqwWake = (EC_T_UINT64*)OsMalloc((dwCycles + 1) * sizeof(EC_T_UINT64));
+  if ((aState == EC_NULL) || (aCmd == EC_NULL) || (aqwWake == EC_NULL)) {
+    MtShmClose(&oShm);
+    return 2;
+  }
+  OsMemset(aCmd, 0, oShm.dwAxisCnt * sizeof(MotorCmd_));
+
+  for (;;) {
+    dwRes = MtShmWaitCycle(&oShm, BENCH_WAIT_MSEC);
+    if (dwRes == EC_E_INVALIDSTATE) {
+      break; /* 服务端退出 */
+    }
+    if (dwRes == EC_E_TIMEOUT) {
+      dwTimeout++;
+      continue;
+    }
+    if (EC_E_NOERROR != MtShmReadState(&oShm, 0, oShm.dwAxisCnt, aState, &qwCycle, &qwTimeNsec, EC_NULL)) {
+      continue;
+    }
+    if (!BenchCheckState(aState, oShm.dwAxisCnt, qwCycle)) {
+      dwTorn++;
+    }
+    if (dwWake <= dwCycles) {
+      aqwWake[dwWake++] = BenchNowNsec() - qwTimeNsec;
+    }
+    /* 依据这份快照算出的命令：所有轴同一个值，服务端据此判断命令块是否完整 */
+    for (EC_T_DWORD i = 0; i < oShm.dwAxisCnt; i++) {
+      aCmd[i].mode = 8;
+      aCmd[i].q = (EC_T_REAL)(EC_T_DWORD)qwCycle;
+      aCmd[i].reserve = (EC_T_DWORD)qwCycle;
+    }
+    MtShmPostCmd(&oShm, aCmd, EC_NULL, oShm.dwAxisCnt, ++qwSeq, qwCycle);
+  }
+
+  qwP99 = BenchPercentile(aqwWake, dwWake, 990);
+  printf("controller: %u wakeups, %u timeouts, %u torn, wake latency p50 %llu ns, p99 %llu ns, max %llu ns\n",
+         dwWake, dwTimeout, dwTorn, (unsigned long long)BenchPercentile(aqwWake, dwWake, 500),
+         (unsigned long long)qwP99, (unsigned long long)BenchPercentile(aqwWake, dwWake, 1000));
+  nRes = ((dwTorn == 0) && (dwWake > 0)) ? 0 : 1;
+  if ((dwMaxP99Usec != 0) && (qwP99 > (EC_T_UINT64)dwMaxP99Usec * 1000)) {
+    printf("controller: FAIL wake latency p99 %llu ns exceeds limit %u us\n", (unsigned long long)qwP99, dwMaxP99Usec);
+    nRes = 1;
+  }
+  MtShmClose(&oShm);
+  OsFree(aState);
+  OsFree(aCmd);
+  OsFree(aqwWake);
+  return nRes;
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+int main(int nArgc, char* ppArgv[])
+{
+  EC_T_DWORD dwCycles = BENCH_DEFAULT_CYCLES;
+  EC_T_DWORD dwAxes = BENCH_DEFAULT_AXES;
+  EC_T_DWORD dwCycleUsec = BENCH_DEFAULT_USEC;
+  EC_T_DWORD dwMaxP99Usec = BENCH_DEFAULT_MAX_P99;
+  EC_T_CHAR szName[MT_SHM_NAME_SIZE];
+  T_MT_SHM oShm = {};
+  MotorState_* aState = EC_NULL;
+  EC_T_UINT64 aqwDelay[4] = {0, 0, 0, 0};   /* 命令生效 - 依据的状态周期：0/1/2/>2 */
+  EC_T_DWORD dwCmdTorn = 0;
+  EC_T_DWORD dwReaderTorn = 0;
+  EC_T_DWORD dwReaderReads = 0;
+  volatile EC_T_BOOL bReaderRun = EC_TRUE;
+  struct timespec oNext;
+  pid_t nPid = -1;
+  int nStatus = 0;
+  EC_T_DWORD dwRes = EC_E_NOERROR;
+  EC_T_BOOL bOk = EC_TRUE;
+
+  if (nArgc > 1) {
+    dwCycles = (EC_T_DWORD)strtoul(ppArgv[1], EC_NULL, 0);
+  }
+  if (nArgc > 2) {
+    dwAxes = (EC_T_DWORD)strtoul(ppArgv[2], EC_NULL, 0);
+  }
+  if (nArgc > 3) {
+    dwCycleUsec = (EC_T_DWORD)strtoul(ppArgv[3], EC_NULL, 0);
+  }
+  if (nArgc > 4) {
+    dwMaxP99Usec = (EC_T_DWORD)strtoul(ppArgv[4], EC_NULL, 0);
+  }
+  if ((dwCycles == 0) || (dwAxes == 0) || (dwAxes > MT_SHM_MAX_AXIS) || (dwCycleUsec == 0)) {
+    printf("usage: MtShmBench [cycles] [axes 1..%u] [cycle_usec] [max-p99-usec]\n", MT_SHM_MAX_AXIS);
+    return 1;
+  }
+  OsSnprintf(szName, sizeof(szName), "/MtShmBench.%d", (int)getpid());
+  printf("MtShmBench: %u cycles, %u axes, %u us cycle, p99 limit %u us, shm %s\n", dwCycles, dwAxes, dwCycleUsec, dwMaxP99Usec, szName);
+
+  /* 先 fork 再创建：控制器要经过“服务端尚未初始化完”的 MtShmOpen() 重试路径 */
+  fflush(stdout);
+  nPid = fork();
+  if (nPid < 0) {
+    printf("fork failed\n");
+    return 1;
+  }
+  if (nPid == 0) {
+    nStatus = BenchController(szName, dwCycles, dwMaxP99Usec);
+    fflush(stdout);
+    _exit(nStatus);
+  }
+
+  dwRes = MtShmCreate(&oShm, szName, dwAxes, dwCycleUsec);
+  aState = (MotorState_*)OsMalloc(dwAxes * sizeof(MotorState_));
+  if ((dwRes != EC_E_NOERROR) || (aState == EC_NULL)) {
+    printf("create %s failed 0x%x\n", szName, dwRes);
+    kill(nPid, SIGKILL);
+    waitpid(nPid, &nStatus, 0);
+    return 1;
+  }
+  OsMemset(aState, 0, dwAxes * sizeof(MotorState_));
+
+  /* 旁路读者：和周期线程并发读快照（单核上靠 yield 让出） */
+  std::thread oReader([&]() {
+    MotorState_* aRead = (MotorState_*)OsMalloc(dwAxes * sizeof(MotorState_));
+    EC_T_UINT64 qwCycle = 0;
+    while (bReaderRun && (aRead != EC_NULL)) {
+      if ((EC_E_NOERROR == MtShmReadState(&oShm, 0, dwAxes, aRead, &qwCycle, EC_NULL, EC_NULL)) && (qwCycle != 0)) {
+        dwReaderReads++;
+        if (!BenchCheckState(aRead, dwAxes, qwCycle)) {
+          dwReaderTorn++;
+        }
+      }
+      std::this_thread::yield();
+    }
+    OsFree(aRead);
+  });
+
+  clock_gettime(CLOCK_MONOTONIC, &oNext);
+  for (EC_T_UINT64 qwCycle = 1; qwCycle <= dwCycles; qwCycle++) {
+    const EC_T_BYTE* pbyValid = EC_NULL;
+    const MotorCmd_* pCmd = EC_NULL;
+    const T_MT_SHM_CMD_BLK* pBlk = EC_NULL;
+
+    oNext.tv_nsec += (long)dwCycleUsec * 1000;
+    while (oNext.tv_nsec >= 1000000000L) {
+      oNext.tv_nsec -= 1000000000L;
+      oNext.tv_sec++;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &oNext, EC_NULL);
+
+    /* 周期开始：取控制器的命令（MT_Workpd() 里 MtLoadMotorCmds() 的位置） */
+    pBlk = MtShmTakeCmd(&oShm, qwCycle, &pbyValid, &pCmd);
+    if (pBlk != EC_NULL) {
+      const EC_T_UINT64 qwDelay = qwCycle - pBlk->qwStateCycle;
+      aqwDelay[(qwDelay > 3) ? 3 : qwDelay]++;
+      for (EC_T_DWORD i = 0; i < dwAxes; i++) {
+        if ((pbyValid[i] == 0) || (pCmd[i].reserve != (EC_T_DWORD)pBlk->qwStateCycle)
+            || (pCmd[i].q != (EC_T_REAL)(EC_T_DWORD)pBlk->qwStateCycle)) {
+          dwCmdTorn++;
+          break;
+        }
+      }
+    }
+
+    /* 周期末：整体发布 */
+    for (EC_T_DWORD i = 0; i < dwAxes; i++) {
+      BenchFillState(&aState[i], qwCycle);
+    }
+    MtShmPublish(&oShm, qwCycle, BenchNowNsec(), aState);
+  }
+
+  bReaderRun = EC_FALSE;
+  oReader.join();
+  printf("server: %llu cmd blocks taken, %llu late, %llu rejected, %u torn; delay (cycles) 1: %llu, 2: %llu, >2: %llu\n",
+         (unsigned long long)oShm.pHdr->qwCmdTaken, (unsigned long long)oShm.pHdr->qwCmdLate,
+         (unsigned long long)oShm.pHdr->qwCmdRejected, dwCmdTorn, (unsigned long long)aqwDelay[1],
+         (unsigned long long)aqwDelay[2], (unsigned long long)aqwDelay[3]);
+  printf("reader: %u reads, %u torn\n", dwReaderReads, dwReaderTorn);
+  if ((oShm.pHdr->qwCmdTaken == 0) || (oShm.pHdr->qwCmdRejected != 0) || (dwCmdTorn != 0) || (aqwDelay[0] != 0)) {
+    printf("FAIL: command path\n");
+    bOk = EC_FALSE;
+  }
+  if (dwReaderTorn != 0) {
+    printf("FAIL: reader saw torn snapshots\n");
+    bOk = EC_FALSE;
+  }
+
+  /* 服务端退出：控制器应从 MtShmWaitCycle() 得到 EC_E_INVALIDSTATE 并结束 */
+  MtShmDelete(&oShm);
+  OsFree(aState);
+  waitpid(nPid, &nStatus, 0);
+  if (!WIFEXITED(nStatus) || (WEXITSTATUS(nStatus) != 0)) {
+    printf("FAIL: controller exit status 0x%x\n", nStatus);
+    bOk = EC_FALSE;
+  }
+  printf("%s\n", bOk ? "PASS" : "FAIL");
+  return bOk ? 0 : 1;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,533 @@
+/*-----------------------------------------------------------------------------
+ * MtSimBench.cpp
+ *
+ * 作用：无硬件的 motrotech 周期基准 + 状态机回归（CMtSimMaster 代替 EC‑Master，x86 与 ARM64 均可运行）。
+ *
+ * - N = 1..64 轴（每从站 1 轴，站地址 1001..），MT_Init/MT_Prepare/MT_Setup 走与实机相同的路径
+ *   （绑定表解析 -> MtPdoBind），每周期 sim.Cycle() + MT_Workpd()，自动模式
+ * - 校验：
+ *   1) 上电使能：所有轴从 Not ready 经 shutdown/switch on/enable operation 到 OP_ENABLED
+ *   2) 故障复位：所有轴注入 fault（保持若干周期），demo 的 fault reset 流程把轴重新带回 OP_ENABLED
+ *   3) SDO：MT_SdoDownload/MT_SdoUpload 往返一致
+ *   4) 轴组流式轨迹（计时之后，手动模式）：所有轴一个组，按 50Hz 规划节拍推送 10ms 间隔的航点，
+ *      设定值与解析轨迹的偏差、到终点保持、实际位置跟上；再推送一段不完整的流，校验欠载受控停止与锁定/复位
+ *   6) kp 下发失败（从站掉线）后由 MT_ServiceGains() 重试成功（只在第一个轴数做一次）
+ *   7) 多实例（最后单独跑一次）：两个 T_MT_CONTEXT 各带一个仿真主站交替跑周期，只给实例 1 注入 fault，
+ *      实例 0 不受影响；聚合状态视图的轴数/顺序与全局轴号映射正确
+ * - 计时：ns/cycle（sim + MT_Workpd）与其中 MT_Workpd 的部分，以及 ns/axis
+ * - 任何校验失败或 N 轴的 ns/cycle 超过 base-ns + N * ns-per-axis 时返回非 0
+ *   （ctest 用 CMake 里的 ECM_BENCH_MTSIM_BASE_NS/ECM_BENCH_MTSIM_NS_PER_AXIS，按构建类型取默认值）
+ *
+ * 构建：cmake -DECM_BUILD_BENCH=ON ... && make MtSimBench
+ * 运行：./MtSimBench [cycles] [base-ns] [ns-per-axis]     （默认 20000，400 + 100/轴 ns；两者都给 0 表示不限）
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech_sim.h"
+#include "EcDemoApp.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define BENCH_MAX_AXIS          64
+#define BENCH_STATION_BASE      1001
+#define BENCH_CYCLE_USEC        1000
+#define BENCH_DEFAULT_CYCLES    20000
+#define BENCH_DEFAULT_BASE_NS   400     /* ns/cycle 上限的固定部分（Release/x86 实测约 75 ns） */
+#define BENCH_DEFAULT_NS_PER_AXIS 100   /* ns/cycle 上限的每轴部分（Release/x86 实测约 56 ns/轴，64 轴约 3.6us） */
+#define BENCH_ENABLE_TIMEOUT    500     /* 使能/复位最多等多少周期 */
+#define BENCH_FAULT_HOLD        30      /* 注入 fault 后复位无效的周期数 */
+#define BENCH_FAULT_CODE        0x7500  /* 0x603F：communication error（示例） */
+#define BENCH_TRAJ_CPR          131072  /* 轨迹校验用的编码器分辨率（默认 1 count/rad 太粗） */
+#define BENCH_TRAJ_PLAN_CYCLES  20      /* 规划节拍：每 20 周期（50Hz）推送一次 */
+#define BENCH_TRAJ_STEP         0.01    /* 航点间隔（s） */
+#define BENCH_TRAJ_LEAD         0.05    /* 规划提前量（s） */
+#define BENCH_TRAJ_DURATION     1.0     /* 完整流时长（s） */
+#define BENCH_TRAJ_AMPL         0.5     /* rad */
+#define BENCH_TRAJ_TOL          1e-3    /* 设定值偏差上限（rad） */
+#define BENCH_TRAJ_STOP_DECEL   20.0    /* rad/s^2 */
+#define BENCH_MULTI_INST        2       /* 多实例校验的实例数 */
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+/* 只打印 error（demo 的 info 日志在周期里很多） */
+static EC_T_DWORD BenchLogMsg(struct _EC_T_LOG_CONTEXT* pContext, EC_T_DWORD dwLogMsgSeverity, const EC_T_CHAR* szFormat, ...)
+{
+  va_list vaArgs;
+  EC_UNREFPARM(pContext);
+  EC_UNREFPARM(dwLogMsgSeverity);
+  va_start(vaArgs, szFormat);
+  vfprintf(stderr, szFormat, vaArgs);
+  va_end(vaArgs);
+  fprintf(stderr, "\n");
+  return EC_E_NOERROR;
+}
+
+static EC_T_VOID BenchCycle(T_EC_DEMO_APP_CONTEXT* pAppContext, CMtSimMaster* pSim)
+{
+  pSim->Cycle();
+  MT_Workpd(pAppContext);
+}
+
+/* 所有轴（demo 解析的 wActState 与模型状态）都在 OP_ENABLED */
+static EC_T_BOOL BenchAllEnabled(T_MT_CONTEXT* pMt, CMtSimMaster* pSim, EC_T_DWORD dwAxisCnt)
+{
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    if ((pMt->pMotor[i].wActState != DRV_DEV_STATE_OP_ENABLED) || (pSim->GetAxis(i)->eState != DRV_DEV_STATE_OP_ENABLED)) {
+      return EC_FALSE;
+    }
+  }
+  return EC_TRUE;
+}
+
+/* 跑到全部 OP_ENABLED，返回用了多少周期（超时返回 0） */
+static EC_T_DWORD BenchRunUntilEnabled(T_EC_DEMO_APP_CONTEXT* pAppContext, CMtSimMaster* pSim, EC_T_DWORD dwAxisCnt)
+{
+  for (EC_T_DWORD dwCycle = 1; dwCycle <= BENCH_ENABLE_TIMEOUT; dwCycle++) {
+    BenchCycle(pAppContext, pSim);
+    if (BenchAllEnabled(pAppContext->pMtContext, pSim, dwAxisCnt)) {
+      return dwCycle;
+    }
+  }
+  return 0;
+}
+
+static EC_T_VOID BenchDumpAxes(T_MT_CONTEXT* pMt, CMtSimMaster* pSim, EC_T_DWORD dwAxisCnt)
+{
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    const T_MT_SIM_AXIS* pAxis = pSim->GetAxis(i);
+    if ((pMt->pMotor[i].wActState != DRV_DEV_STATE_OP_ENABLED) || (pAxis->eState != DRV_DEV_STATE_OP_ENABLED)) {
+      printf("  axis %u: sim state %d, demo state %d, ctrl 0x%04x, error 0x%04x\n",
+             i, (int)pAxis->eState, (int)pMt->pMotor[i].wActState, pAxis->wLastCtrl, pAxis->wErrorCode);
+    }
+  }
+}
+
+/* 一轴做一次 SDO 往返（同步完成） */
+static EC_T_BOOL BenchSdoRoundTrip(T_MT_CONTEXT* pMt, EC_T_WORD wAxis)
+{
+  T_SDO_PIPE_HANDLE oWr;
+  T_SDO_PIPE_HANDLE oRd;
+  EC_T_DWORD dwOut = 0x12345678 + wAxis;
+  EC_T_DWORD dwIn = 0;
+
+  OsMemset(&oWr, 0, sizeof(oWr));
+  OsMemset(&oRd, 0, sizeof(oRd));
+  if ((EC_E_NOERROR != MT_SdoDownload(pMt, wAxis, DRV_OBJ_PROFILE_VELOCITY, 0, (EC_T_BYTE*)&dwOut, sizeof(dwOut), &oWr))
+      || (EC_E_NOERROR != MT_SdoUpload(pMt, wAxis, DRV_OBJ_PROFILE_VELOCITY, 0, (EC_T_BYTE*)&dwIn, sizeof(dwIn), &oRd))) {
+    return EC_FALSE;
+  }
+  return SDO_PIPE_HANDLE_DONE(&oWr) && SDO_PIPE_HANDLE_DONE(&oRd) && (oWr.dwResult == EC_E_NOERROR) && (oRd.dwResult == EC_E_NOERROR)
+      && (oRd.dwOutDataLen == sizeof(dwIn)) && (dwIn == dwOut);
+}
+
+/* [2026-10-16] 目的：kp 下发失败（从站掉线）不丢，从站恢复、过了重试间隔之后由 MT_ServiceGains() 补发 */
+static EC_T_BOOL BenchGainRetry(T_MT_CONTEXT* pMt, CMtSimMaster* pSim)
+{
+  const EC_T_WORD wStation = pMt->pMotor[0].wStationAddress;
+  const EC_T_REAL fKp = pMt->pGain[0].afApplied[MT_GAIN_KP] + 8.0f;
+  MotorCmd_ oCmd = pMt->pMotorCmd[0];
+  T_SDO_PIPE_HANDLE oRd;
+  EC_T_REAL fIn = 0.0f;
+  EC_T_BOOL bOk = EC_TRUE;
+
+  oCmd.kp = fKp;
+  pSim->SetSlavePresent(wStation, EC_FALSE);
+  MT_SetMotorCmd(pMt, 0, &oCmd);
+  bOk = (pMt->pGain[0].afApplied[MT_GAIN_KP] != fKp) && (pMt->pGain[0].adwLastErr[MT_GAIN_KP] != EC_E_NOERROR);
+  pSim->SetSlavePresent(wStation, EC_TRUE);
+  MT_ServiceGains(pMt);
+  bOk = bOk && (pMt->pGain[0].afApplied[MT_GAIN_KP] != fKp);     /* 重试间隔未到 */
+  OsSleep(MT_GAIN_RETRY_MSEC + 20);
+  MT_ServiceGains(pMt);
+  OsMemset(&oRd, 0, sizeof(oRd));
+  return bOk && (pMt->pGain[0].afApplied[MT_GAIN_KP] == fKp)
+      && (EC_E_NOERROR == MT_SdoUpload(pMt, 0, DRV_OBJ_POSITION_KP, 0, (EC_T_BYTE*)&fIn, sizeof(fIn), &oRd))
+      && SDO_PIPE_HANDLE_DONE(&oRd) && (oRd.dwResult == EC_E_NOERROR) && (fIn == fKp);
+}
+
+/* 第 i 轴的解析轨迹：q0 + A*(1-cos(2*pi*t/T))/2，两端速度为 0 */
+static EC_T_LREAL BenchTrajQ(EC_T_LREAL fQ0, EC_T_DWORD dwAxis, EC_T_LREAL fTime)
+{
+  const EC_T_LREAL fAmpl = (dwAxis & 1) ? -BENCH_TRAJ_AMPL : BENCH_TRAJ_AMPL;
+  return fQ0 + fAmpl * 0.5 * (1.0 - cos(2.0 * 3.14159265358979323846 * fTime / BENCH_TRAJ_DURATION));
+}
+
+/* 推送 (*pfPushed, fUntil] 的航点（间隔 BENCH_TRAJ_STEP），pfQ0 为各轴起点 */
+static EC_T_BOOL BenchTrajPush(T_MT_CONTEXT* pMt, EC_T_DWORD dwAxisCnt, const EC_T_LREAL* pfQ0, EC_T_LREAL* pfPushed, EC_T_LREAL fUntil,
+                               EC_T_BOOL bRamp, EC_T_BOOL bLast)
+{
+  EC_T_LREAL afTime[16];
+  EC_T_REAL afQ[16 * BENCH_MAX_AXIS];
+  EC_T_DWORD dwCnt = 0;
+  EC_T_DWORD dwAccepted = 0;
+
+  while ((dwCnt < 16) && (*pfPushed + BENCH_TRAJ_STEP * (dwCnt + 1) <= fUntil + 1e-9)) {
+    const EC_T_LREAL fTime = *pfPushed + BENCH_TRAJ_STEP * (dwCnt + 1);
+    afTime[dwCnt] = fTime;
+    for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+      afQ[dwCnt * dwAxisCnt + i] = (EC_T_REAL)(bRamp ? (pfQ0[i] + fTime) : BenchTrajQ(pfQ0[i], i, fTime));
+    }
+    dwCnt++;
+  }
+  if (dwCnt == 0) {
+    return EC_TRUE;
+  }
+  if ((EC_E_NOERROR != MT_TrajPush(pMt, 0, afTime, afQ, EC_NULL, dwCnt, bLast, &dwAccepted)) || (dwAccepted != dwCnt)) {
+    return EC_FALSE;
+  }
+  *pfPushed = afTime[dwCnt - 1];
+  return EC_TRUE;
+}
+
+/* 4) 轴组流式轨迹：完整流跟随 + 欠载受控停止 */
+static EC_T_BOOL BenchTraj(T_EC_DEMO_APP_CONTEXT* pAppContext, CMtSimMaster* pSim, EC_T_DWORD dwAxisCnt)
+{
+  const EC_T_DWORD dwStreamCycles = (EC_T_DWORD)(BENCH_TRAJ_DURATION * 1000000 / BENCH_CYCLE_USEC);
+  EC_T_LREAL afQ0[BENCH_MAX_AXIS];
+  EC_T_REAL afQ1[BENCH_MAX_AXIS];
+  EC_T_LREAL fPushed = 0.0;
+  EC_T_LREAL fMaxErr = 0.0;
+  T_MT_TRAJ_STATUS oStatus;
+  MotorState_ oState;
+  T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+
+  MT_SetRunMode(pMt, MT_RUNMODE_MANUAL);
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    MT_SetAxisUnitScale(pMt, (EC_T_WORD)i, BENCH_TRAJ_CPR, 1.0);
+  }
+  for (EC_T_DWORD c = 0; c < 5; c++) {
+    BenchCycle(pAppContext, pSim);
+  }
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    MT_GetMotorState(pMt, (EC_T_WORD)i, &oState);
+    afQ0[i] = oState.q_fb;
+    afQ1[i] = oState.q_fb;
+  }
+
+  /* 完整流：50Hz 推送，周期 c 之后组时钟为 (c+1)*dt */
+  for (EC_T_DWORD c = 0; c < dwStreamCycles + 50; c++) {
+    if ((c % BENCH_TRAJ_PLAN_CYCLES) == 0) {
+      const EC_T_LREAL fUntil = EC_MIN(BENCH_TRAJ_DURATION, c * BENCH_CYCLE_USEC / 1000000.0 + BENCH_TRAJ_LEAD + BENCH_TRAJ_PLAN_CYCLES * BENCH_CYCLE_USEC / 1000000.0);
+      if (!BenchTrajPush(pMt, dwAxisCnt, afQ0, &fPushed, fUntil, EC_FALSE, (EC_T_BOOL)(fUntil >= BENCH_TRAJ_DURATION))) {
+        printf("N=%u: FAILED traj push at cycle %u\n", dwAxisCnt, c);
+        return EC_FALSE;
+      }
+    }
+    BenchCycle(pAppContext, pSim);
+    const EC_T_LREAL fTime = EC_MIN(BENCH_TRAJ_DURATION, (c + 1) * BENCH_CYCLE_USEC / 1000000.0);
+    for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+      const EC_T_LREAL fErr = pMt->pMotor[i].fCurPos - BenchTrajQ(afQ0[i], i, fTime);
+      fMaxErr = EC_MAX(fMaxErr, (fErr < 0) ? -fErr : fErr);
+    }
+  }
+  for (EC_T_DWORD c = 0; c < 200; c++) {
+    BenchCycle(pAppContext, pSim);
+  }
+  MT_TrajGetStatus(pMt, 0, &oStatus);
+  if ((fMaxErr > BENCH_TRAJ_TOL) || (oStatus.dwState != MT_TRAJ_STATE_HOLD) || (oStatus.dwStreams != 1)
+      || (oStatus.dwUnderruns != 0) || (oStatus.dwAborts != 0) || oStatus.bLatched) {
+    printf("N=%u: FAILED traj stream: max err %.6f rad, state %u, streams %u, underruns %u, aborts %u\n",
+           dwAxisCnt, fMaxErr, oStatus.dwState, oStatus.dwStreams, oStatus.dwUnderruns, oStatus.dwAborts);
+    return EC_FALSE;
+  }
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    MT_GetMotorState(pMt, (EC_T_WORD)i, &oState);
+    if ((fabs(oState.q_fb - afQ0[i]) > BENCH_TRAJ_TOL) || (pMt->pMotor[i].wActState != DRV_DEV_STATE_OP_ENABLED)) {
+      printf("N=%u: FAILED traj end on axis %u: q_fb %.6f, start %.6f\n", dwAxisCnt, i, oState.q_fb, afQ0[i]);
+      return EC_FALSE;
+    }
+  }
+
+  /* 欠载：1 rad/s 的斜坡只推 0.1s 且不结束，应在最后一点之后受控停下并锁定 */
+  fPushed = 0.0;
+  if (!BenchTrajPush(pMt, dwAxisCnt, afQ0, &fPushed, 0.1, EC_TRUE, EC_FALSE)) {
+    printf("N=%u: FAILED traj ramp push\n", dwAxisCnt);
+    return EC_FALSE;
+  }
+  for (EC_T_DWORD c = 0; c < 300; c++) {
+    BenchCycle(pAppContext, pSim);
+  }
+  MT_TrajGetStatus(pMt, 0, &oStatus);
+  if ((oStatus.dwState != MT_TRAJ_STATE_HOLD) || !oStatus.bLatched || (oStatus.dwUnderruns != 1) || (oStatus.dwStreams != 2)) {
+    printf("N=%u: FAILED traj underrun: state %u, latched %d, underruns %u\n",
+           dwAxisCnt, oStatus.dwState, oStatus.bLatched, oStatus.dwUnderruns);
+    return EC_FALSE;
+  }
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    const EC_T_LREAL fOver = pMt->pMotor[i].fCurPos - (afQ0[i] + 0.1);
+    if ((fOver < 0.0) || (fOver > 1.0 / (2.0 * BENCH_TRAJ_STOP_DECEL) + BENCH_TRAJ_TOL)) {
+      printf("N=%u: FAILED traj stop distance on axis %u: %.6f rad\n", dwAxisCnt, i, fOver);
+      return EC_FALSE;
+    }
+  }
+  fPushed = BENCH_TRAJ_STEP;
+  if (EC_E_INVALIDSTATE != MT_TrajPush(pMt, 0, &fPushed, afQ1, EC_NULL, 1, EC_FALSE, EC_NULL)) {
+    printf("N=%u: FAILED traj push accepted while latched\n", dwAxisCnt);
+    return EC_FALSE;
+  }
+
+  /* 复位后交还 MotorCmd_ */
+  MT_TrajReset(pMt, 0);
+  MT_TrajRelease(pMt, 0);
+  BenchCycle(pAppContext, pSim);
+  MT_TrajGetStatus(pMt, 0, &oStatus);
+  if ((oStatus.dwState != MT_TRAJ_STATE_IDLE) || oStatus.bLatched) {
+    printf("N=%u: FAILED traj reset/release: state %u, latched %d\n", dwAxisCnt, oStatus.dwState, oStatus.bLatched);
+    return EC_FALSE;
+  }
+  return EC_TRUE;
+}
+
+/* 5) 多实例：实例 0（2 轴）与实例 1（3 轴）各自一个上下文/仿真主站，同一线程交替跑周期
+ * （实际部署里每个实例有自己的周期线程/核，这里只验证状态互相独立 + 聚合视图）
+ */
+static EC_T_BOOL BenchMultiInstance(EC_T_VOID)
+{
+  static const EC_T_DWORD s_adwAxisCnt[BENCH_MULTI_INST] = { 2, 3 };
+  T_EC_DEMO_APP_CONTEXT aAppContext[BENCH_MULTI_INST];
+  T_MT_CONTEXT aMt[BENCH_MULTI_INST];
+  T_MT_CONTEXT* apMt[BENCH_MULTI_INST];
+  CMtSimMaster aSim[BENCH_MULTI_INST];
+  SLAVE_MOTOR_TYPE aSlave[BENCH_MULTI_INST][BENCH_MAX_AXIS];
+  MotorState_ aState[BENCH_MAX_AXIS];
+  EC_T_UINT64 aqwCycle[BENCH_MULTI_INST];
+  EC_T_DWORD dwAxisCnt = 0;
+  EC_T_DWORD dwCtx = 0;
+  EC_T_WORD wAxis = 0;
+  EC_T_BOOL bOk = EC_TRUE;
+
+  for (EC_T_DWORD n = 0; n < BENCH_MULTI_INST; n++) {
+    OsMemset(&aAppContext[n], 0, sizeof(aAppContext[n]));
+    aAppContext[n].dwInstanceId = n;
+    aAppContext[n].LogParms = G_aLogParms[0];
+    aAppContext[n].AppParms.dwBusCycleTimeUsec = BENCH_CYCLE_USEC;
+    aAppContext[n].pMasterAccess = &aSim[n];
+    aAppContext[n].pMtContext = &aMt[n];
+    apMt[n] = &aMt[n];
+    MT_ContextCreate(&aMt[n], n);
+    for (EC_T_DWORD i = 0; i < s_adwAxisCnt[n]; i++) {
+      aSlave[n][i].wStationAddress = (EC_T_WORD)(BENCH_STATION_BASE + i);    /* 各网段各自编址，站地址可以重复 */
+      aSlave[n][i].wAxisCnt = 1;
+    }
+  }
+  for (EC_T_DWORD n = 0; bOk && (n < BENCH_MULTI_INST); n++) {
+    bOk = (EC_E_NOERROR == MT_ConfigureSlaves(&aMt[n], aSlave[n], s_adwAxisCnt[n]))
+       && (EC_E_NOERROR == MT_Init(&aAppContext[n]))
+       && (EC_E_NOERROR == aSim[n].Create(&aMt[n].oPdo, aSlave[n], s_adwAxisCnt[n], BENCH_CYCLE_USEC))
+       && (EC_E_NOERROR == MT_Prepare(&aAppContext[n])) && (EC_E_NOERROR == MT_Setup(&aAppContext[n]))
+       && (MT_GetAxisCount(&aMt[n]) == s_adwAxisCnt[n]);
+  }
+  if (!bOk) {
+    printf("multi-instance: setup failed\n");
+  }
+
+  /* 两个实例都使能，然后只让实例 1 进 fault：实例 0 必须保持 OP_ENABLED */
+  for (EC_T_DWORD c = 0; bOk && (c < BENCH_ENABLE_TIMEOUT); c++) {
+    BenchCycle(&aAppContext[0], &aSim[0]);
+    BenchCycle(&aAppContext[1], &aSim[1]);
+    if (BenchAllEnabled(&aMt[0], &aSim[0], s_adwAxisCnt[0]) && BenchAllEnabled(&aMt[1], &aSim[1], s_adwAxisCnt[1])) {
+      break;
+    }
+  }
+  if (bOk) {
+    for (EC_T_DWORD i = 0; i < s_adwAxisCnt[1]; i++) {
+      aSim[1].InjectFault(i, BENCH_FAULT_CODE, BENCH_FAULT_HOLD);
+    }
+    for (EC_T_DWORD c = 0; c < 2; c++) {
+      BenchCycle(&aAppContext[0], &aSim[0]);
+      BenchCycle(&aAppContext[1], &aSim[1]);
+    }
+    bOk = BenchAllEnabled(&aMt[0], &aSim[0], s_adwAxisCnt[0]) && (aMt[1].pMotor[0].wActState == DRV_DEV_STATE_MALFUNCTION);
+    if (!bOk) {
+      printf("multi-instance: FAILED fault isolation\n");
+      BenchDumpAxes(&aMt[0], &aSim[0], s_adwAxisCnt[0]);
+    }
+  }
+
+  /* 聚合视图：实例 0 的 2 轴在前，实例 1 的 3 轴在后；周期号按实例给出 */
+  if (bOk) {
+    bOk = (EC_E_NOERROR == MT_GetAggregateStates(apMt, BENCH_MULTI_INST, aState, BENCH_MAX_AXIS, &dwAxisCnt, aqwCycle))
+       && (dwAxisCnt == s_adwAxisCnt[0] + s_adwAxisCnt[1]) && (aqwCycle[0] == aMt[0].qwCycle) && (aqwCycle[1] == aMt[1].qwCycle)
+       && (aState[0].motorstate == aMt[0].pMotorState[0].motorstate)
+       && (aState[s_adwAxisCnt[0]].motorstate == aMt[1].pMotorState[0].motorstate)
+       && (aState[0].motorstate != aState[s_adwAxisCnt[0]].motorstate)
+       && (EC_E_NOERROR == MT_MapGlobalAxis(apMt, BENCH_MULTI_INST, s_adwAxisCnt[0] + 1, &dwCtx, &wAxis)) && (dwCtx == 1) && (wAxis == 1)
+       && (EC_E_NOTFOUND == MT_MapGlobalAxis(apMt, BENCH_MULTI_INST, dwAxisCnt, &dwCtx, &wAxis))
+       && (EC_E_INVALIDSIZE == MT_GetAggregateStates(apMt, BENCH_MULTI_INST, aState, s_adwAxisCnt[0] + 1, &dwAxisCnt, EC_NULL))
+       && (dwAxisCnt == s_adwAxisCnt[0] + 1);
+    if (!bOk) {
+      printf("multi-instance: FAILED aggregate state view\n");
+    }
+  }
+  printf("multi-instance (%u + %u axes): %s\n", s_adwAxisCnt[0], s_adwAxisCnt[1], bOk ? "ok" : "FAILED");
+
+  for (EC_T_DWORD n = 0; n < BENCH_MULTI_INST; n++) {
+    aAppContext[n].pMasterAccess = EC_NULL;
+    MT_ContextDelete(&aMt[n]);
+  }
+  return bOk;
+}
+
+/*-MAIN----------------------------------------------------------------------*/
+int main(int nArgc, char* ppArgv[])
+{
+  static const EC_T_DWORD s_adwAxisCnt[] = { 1, 2, 4, 8, 16, 32, 64 };
+  EC_T_DWORD dwCycles = BENCH_DEFAULT_CYCLES;
+  double fBaseNs = BENCH_DEFAULT_BASE_NS;
+  double fNsPerAxis = BENCH_DEFAULT_NS_PER_AXIS;
+  int nRes = 0;
+
+  if (nArgc > 1) {
+    dwCycles = (EC_T_DWORD)strtoul(ppArgv[1], EC_NULL, 0);
+  }
+  if (dwCycles == 0) {
+    dwCycles = BENCH_DEFAULT_CYCLES;
+  }
+  if (nArgc > 2) {
+    fBaseNs = strtod(ppArgv[2], EC_NULL);
+  }
+  if (nArgc > 3) {
+    fNsPerAxis = strtod(ppArgv[3], EC_NULL);
+  }
+  printf("MtSimBench: %u cycles, bus cycle %u us, limit %.0f + %.0f/axis ns/cycle\n", dwCycles, BENCH_CYCLE_USEC, fBaseNs, fNsPerAxis);
+  printf("%6s %8s %8s %14s %14s %12s\n", "axes", "enable", "reset", "total ns/cyc", "workpd ns/cyc", "ns/axis");
+
+  for (EC_T_DWORD k = 0; k < sizeof(s_adwAxisCnt) / sizeof(s_adwAxisCnt[0]); k++) {
+    const EC_T_DWORD dwAxisCnt = s_adwAxisCnt[k];
+    SLAVE_MOTOR_TYPE aSlave[BENCH_MAX_AXIS];
+    T_EC_DEMO_APP_CONTEXT oAppContext;
+    T_EC_DEMO_APP_CONTEXT* pAppContext = &oAppContext;
+    T_MT_CONTEXT oMt;
+    T_MT_CONTEXT* pMt = &oMt;
+    CMtSimMaster oSim;
+    EC_T_WORD awGroupAxis[BENCH_MAX_AXIS];
+    T_MT_TRAJ_GROUP_CFG oGroup;
+    EC_T_DWORD dwEnableCycles = 0;
+    EC_T_DWORD dwResetCycles = 0;
+    EC_T_BOOL bOk = EC_TRUE;
+
+    OsMemset(&oAppContext, 0, sizeof(oAppContext));
+    oAppContext.LogParms.dwLogLevel = EC_LOG_LEVEL_ERROR;
+    oAppContext.LogParms.pfLogMsg = BenchLogMsg;
+    oAppContext.AppParms.dwBusCycleTimeUsec = BENCH_CYCLE_USEC;
+    oAppContext.pMasterAccess = &oSim;
+    oAppContext.pMtContext = pMt;
+    G_aLogParms[0] = oAppContext.LogParms;
+    MT_ContextCreate(pMt, 0);
+
+    for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+      aSlave[i].wStationAddress = (EC_T_WORD)(BENCH_STATION_BASE + i);
+      aSlave[i].wAxisCnt = 1;
+      awGroupAxis[i] = (EC_T_WORD)i;
+    }
+    OsMemset(&oGroup, 0, sizeof(oGroup));
+    oGroup.dwAxisCnt = dwAxisCnt;
+    oGroup.pwAxis = awGroupAxis;
+    oGroup.fStopDecel = BENCH_TRAJ_STOP_DECEL;
+    /* 仿真主站按绑定表排布过程映像，所以 Create() 放在 MT_ConfigureSlaves/MT_Init 之后、MT_Prepare 之前 */
+    if ((EC_E_NOERROR != MT_ConfigureSlaves(pMt, aSlave, dwAxisCnt)) || (EC_E_NOERROR != MT_ConfigureTrajGroups(pMt, &oGroup, 1))
+        || (EC_E_NOERROR != MT_Init(pAppContext))
+        || (EC_E_NOERROR != oSim.Create(&pMt->oPdo, aSlave, dwAxisCnt, BENCH_CYCLE_USEC))
+        || (EC_E_NOERROR != MT_Prepare(pAppContext)) || (EC_E_NOERROR != MT_Setup(pAppContext))
+        || (MT_GetAxisCount(pMt) != dwAxisCnt)) {
+      printf("N=%u: setup failed\n", dwAxisCnt);
+      return 1;
+    }
+    MT_SetRunMode(pMt, MT_RUNMODE_AUTO);
+
+    /* 1) 上电使能 */
+    dwEnableCycles = BenchRunUntilEnabled(pAppContext, &oSim, dwAxisCnt);
+    if (dwEnableCycles == 0) {
+      printf("N=%u: FAILED to reach OP_ENABLED\n", dwAxisCnt);
+      BenchDumpAxes(pMt, &oSim, dwAxisCnt);
+      bOk = EC_FALSE;
+    }
+
+    /* 2) 故障复位 */
+    if (bOk) {
+      for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+        oSim.InjectFault(i, BENCH_FAULT_CODE, BENCH_FAULT_HOLD);
+      }
+      /* 先确认 demo 看到了 fault，再等恢复 */
+      BenchCycle(pAppContext, &oSim);
+      BenchCycle(pAppContext, &oSim);
+      for (EC_T_DWORD i = 0; bOk && (i < dwAxisCnt); i++) {
+        bOk = (pMt->pMotor[i].wActState == DRV_DEV_STATE_MALFUNCTION);
+      }
+      dwResetCycles = bOk ? BenchRunUntilEnabled(pAppContext, &oSim, dwAxisCnt) : 0;
+      for (EC_T_DWORD i = 0; bOk && (i < dwAxisCnt); i++) {
+        const T_MT_SIM_AXIS* pAxis = oSim.GetAxis(i);
+        bOk = (pAxis->dwFaults == 1) && (pAxis->dwFaultResets == 1) && (pAxis->wErrorCode == 0);
+      }
+      if ((dwResetCycles == 0) || !bOk) {
+        printf("N=%u: FAILED fault reset\n", dwAxisCnt);
+        BenchDumpAxes(pMt, &oSim, dwAxisCnt);
+        bOk = EC_FALSE;
+      }
+    }
+
+    /* 3) SDO 往返 */
+    for (EC_T_DWORD i = 0; bOk && (i < dwAxisCnt); i++) {
+      if (!BenchSdoRoundTrip(pMt, (EC_T_WORD)i)) {
+        printf("N=%u: FAILED SDO round trip on axis %u\n", dwAxisCnt, i);
+        bOk = EC_FALSE;
+      }
+    }
+
+    /* 4) 计时：sim + MT_Workpd，再单独计 sim，差值即 MT_Workpd */
+    auto tStart = std::chrono::steady_clock::now();
+    for (EC_T_DWORD dwCycle = 0; dwCycle < dwCycles; dwCycle++) {
+      BenchCycle(pAppContext, &oSim);
+    }
+    auto tMid = std::chrono::steady_clock::now();
+    for (EC_T_DWORD dwCycle = 0; dwCycle < dwCycles; dwCycle++) {
+      oSim.Cycle();
+    }
+    auto tEnd = std::chrono::steady_clock::now();
+    if (bOk && !BenchAllEnabled(pMt, &oSim, dwAxisCnt)) {
+      printf("N=%u: FAILED axes left OP_ENABLED during the timed run\n", dwAxisCnt);
+      BenchDumpAxes(pMt, &oSim, dwAxisCnt);
+      bOk = EC_FALSE;
+    }
+
+    const double fTotal = std::chrono::duration<double, std::nano>(tMid - tStart).count() / dwCycles;
+    const double fSim = std::chrono::duration<double, std::nano>(tEnd - tMid).count() / dwCycles;
+    printf("%6u %8u %8u %14.1f %14.1f %12.1f\n", dwAxisCnt, dwEnableCycles, dwResetCycles, fTotal,
+           (fTotal > fSim) ? (fTotal - fSim) : 0.0, fTotal / dwAxisCnt);
+    const double fMaxNsPerCycle = fBaseNs + fNsPerAxis * dwAxisCnt;
+    if ((fMaxNsPerCycle > 0) && (fTotal > fMaxNsPerCycle)) {
+      printf("N=%u: FAILED %.1f ns/cycle exceeds limit %.1f\n", dwAxisCnt, fTotal, fMaxNsPerCycle);
+      bOk = EC_FALSE;
+    }
+
+    /* 5) 轴组流式轨迹（会切到手动模式并改单位换算，所以放在计时之后） */
+    if (bOk && !BenchTraj(pAppContext, &oSim, dwAxisCnt)) {
+      bOk = EC_FALSE;
+    }
+    /* 6) kp 下发失败后重试（改写 0 轴命令，所以放在最后；只做一次，会打一条预期的 SDO 失败日志） */
+    if (bOk && (k == 0) && !BenchGainRetry(pMt, &oSim)) {
+      printf("N=%u: FAILED kp retry after a failed SDO\n", dwAxisCnt);
+      bOk = EC_FALSE;
+    }
+    if (!bOk) {
+      nRes = 1;
+    }
+    oAppContext.pMasterAccess = EC_NULL;
+    MT_ContextDelete(pMt);
+  }
+
+  /* 5) 多实例 */
+  if (!BenchMultiInstance()) {
+    nRes = 1;
+  }
+  if (nRes != 0) {
+    printf("FAILED\n");
+  }
+  return nRes;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------------
+ * MtSimHost.cpp
+ *
+ * 作用：MtSimBench 不链接 EC‑Master 库，这里补上 motrotech*.cpp / EcTimer.cpp 用到的少数符号：
+ * - G_aLogParms（EcLogging.h）
+ * - OsPlatformImplSleep / OsQueryMsecCount（EcOs.h，OsSleep 与 CEcTimer 使用）
+ * - EcSnprintf（OsSnprintf）
+ * - ecatGetText（只用于日志，返回错误码的通用描述）
+ * - OsCreateThread / OsDeleteThreadHandle（EcPcapBench：CEcPcapMmapRecorder 的段线程，pthread，忽略优先级与 CPU）
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoApp.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+typedef struct _T_SIM_HOST_THREAD
+{
+  pthread_t         oThread;
+  EC_PF_THREADENTRY pfEntry;
+  EC_T_VOID*        pvParams;
+} T_SIM_HOST_THREAD;
+
+/*-GLOBAL VARIABLES----------------------------------------------------------*/
+EC_T_LOG_PARMS G_aLogParms[MAX_NUMOF_LOG_INSTANCES];
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+EC_T_VOID OsPlatformImplSleep(EC_T_DWORD dwMsec)
+{
+  struct timespec ts;
+  ts.tv_sec = dwMsec / 1000;
+  ts.tv_nsec = (long)(dwMsec % 1000) * 1000000L;
+  nanosleep(&ts, EC_NULL);
+}
+
+EC_T_DWORD OsQueryMsecCount(EC_T_VOID)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (EC_T_DWORD)((EC_T_UINT64)ts.tv_sec * 1000 + (EC_T_UINT64)ts.tv_nsec / 1000000);
+}
+
+EC_T_INT EcSnprintf(EC_T_CHAR* szDest, EC_T_INT nMaxSize, const EC_T_CHAR* szFormat, ...)
+{
+  va_list vaArgs;
+  va_start(vaArgs, szFormat);
+  EC_T_INT nRes = vsnprintf(szDest, (size_t)nMaxSize, szFormat, vaArgs);
+  va_end(vaArgs);
+  return nRes;
+}
+
+static void* SimHostThreadEntry(void* pvThread)
+{
+  T_SIM_HOST_THREAD* pThread = (T_SIM_HOST_THREAD*)pvThread;
+  pThread->pfEntry(pThread->pvParams);
+  return EC_NULL;
+}
+
+EC_T_VOID* OsCreateThread(const EC_T_CHAR* szThreadName, EC_PF_THREADENTRY pfThreadEntry, EC_T_CPUSET cpuAffinityMask,
+                          EC_T_DWORD dwPrio, EC_T_DWORD dwStackSize, EC_T_VOID* pvParams)
+{
+  T_SIM_HOST_THREAD* pThread = new T_SIM_HOST_THREAD;
+  EC_UNREFPARM(szThreadName);
+  EC_UNREFPARM(cpuAffinityMask);
+  EC_UNREFPARM(dwPrio);
+  EC_UNREFPARM(dwStackSize);
+  pThread->pfEntry = pfThreadEntry;
+  pThread->pvParams = pvParams;
+  if (pthread_create(&pThread->oThread, EC_NULL, SimHostThreadEntry, pThread) != 0) {
+    delete pThread;
+    return EC_NULL;
+  }
+  return pThread;
+}
+
+/* 调用方已等到线程函数返回 */
+EC_T_DWORD OsDeleteThreadHandle(EC_T_VOID* pvThreadObject)
+{
+  T_SIM_HOST_THREAD* pThread = (T_SIM_HOST_THREAD*)pvThreadObject;
+  pthread_join(pThread->oThread, EC_NULL);
+  delete pThread;
+  return EC_E_NOERROR;
+}
+
+const EC_T_CHAR* ecatGetText(EC_T_DWORD dwTextId)
+{
+  return (dwTextId == EC_E_NOERROR) ? "No Error" : "Error (see result code)";
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -10,6 +10,23 @@
  *   2) `MT_Workpd()` 在 OP_ENABLED 时支持按 MotorCmd_.q/dq 直接写 0x607A/0x60FF
  *   3) `MT_Workpd()` 读取 0x6064/0x606C 并换算为 rad/rad/s 回填到 MotorState_
  *   4) 可选读取温度/电压对象（0x3008/0x3009/0x300F/0x300B），前提是 ENI 已映射到 TxPDO
+ * - 2026-10-16：kp/kd（0x3500/0x3501）改为经 CEcSdoPipeline 异步下发（合并/批处理，调用方不阻塞），
+ *   并新增 `MT_SdoDownload()/MT_SdoUpload()` 供非 PDO 对象读写；
+ *   kp/kd 只在从站确认后记为生效，失败的由 `MT_ServiceGains()`（非周期线程）重试，周期线程不再发 SDO
+ * - 2026-10-16：PDO 映射改为数据驱动的绑定表（motrotech_pdo.cpp），`MT_Setup()` 不再写死对象号；
+ *   轴/从站数量改为运行时（MT_Init 按配置分配 My_Motor[]/My_Slave[]），MT_Workpd 的 static 数组并入 My_Motor_Type
+ * - 2026-10-16：MT_Workpd 保持按轴直接读写 PDO 指针；试过的 SoA 布局（按字段数组 + 批量换算）
+ *   在 bench 上没有跑赢按轴循环，已移除
+ * - 2026-10-16：主站访问收敛到 CMtMasterAccess（motrotech_master.h，pAppContext->pMasterAccess），
+ *   除 ecatGetText 外本模块不再直接调用 ecat*；无硬件时换成 CMtSimMaster（motrotech_sim.cpp）即可跑完整周期（bench/MtSimBench.cpp）
+ * - 2026-10-16：新增轴组流式轨迹（motrotech_traj.cpp）：规划线程经 `MT_TrajPush()` 批量推送带时间戳的航点，
+ *   周期里组内各轴按同一时钟三次插补；欠载/掉使能时受控停止。MANUAL 下组驱动的轴优先于 MotorCmd_
+ * - 2026-10-16：过程数据共享内存（motrotech_shm.cpp）：周期末整体发布 MotorState_（seqlock + 周期号），
+ *   外部控制器经三缓冲发布 MotorCmd_，周期开始时取用（反馈 -> 命令不超过一个周期）；
+ *   `MT_SetMotorCmd()/MT_GetMotorState()` 同时改为无撕裂（每轴 seqlock / 读已发布快照）
+ * - 2026-10-16：多实例：原来的全局/静态变量（My_Motor[]/My_Slave[]/S_MotorCmd[]/S_ProcessState[]/fTimeSec/
+ *   S_RunMode/轨迹/共享内存...）收进调用方持有的 T_MT_CONTEXT（pAppContext->pMtContext），
+ *   上层接口都带 pMt；一个进程里每个主站实例（网段）一份，`MT_GetAggregateStates()` 给出跨实例的全局轴表
  * =============================================================================
  *
  * =============================================================================
@@ -30,7 +47,7 @@
  *
  * 【最重要的隐含前提】
  *   - 你的 ENI 必须把相关对象映射进 PDO，否则 MT_Setup() 找不到变量 -> 指针为 EC_NULL -> 写不进去。
- *   - 本 demo 假设多轴对象索引按 “base + axis*0x800(OBJOFFSET)” 排布（见 motrotech.h）。
+ *   - 多轴对象索引按 “base + axis*stride” 排布，base/stride 由绑定表给出（见 motrotech_pdo.h）。
  * =============================================================================
  *
  * 运行流程（从上到下建议按这个顺序看）：
@@ -53,10 +70,13 @@
 /*-INCLUDES------------------------------------------------------------------*/
 
 #include "motrotech.h"
+#include "motrotech_traj.h"
+#include "motrotech_shm.h"
 #include "EcDemoApp.h"
 
 /* motrotech.cpp 以 g++ 编译（见 Makefile），所以这里补上标准整型定义给 int64_t 使用 */
 #include <stdint.h>
+#include <time.h>
 
 /* [2026-01-13] 常量：避免依赖 M_PI（不同编译选项下可能未定义） */
 #define MT_PI 3.1415926535897932384626433832795
@@ -95,51 +115,189 @@ static EC_T_INT MtSatToInt32(EC_T_LREAL x)
  * - 这块很可能要“替换/裁剪”（不再依赖 0x6040/0x6041 的 CiA402）
  * - 或者把你们的 mode 映射到 CiA402 的控制字/模式字（取决于从站协议）
  */
-static EC_T_DWORD Process_Commands(T_EC_DEMO_APP_CONTEXT *pAppContext);
+static EC_T_DWORD Process_Commands(T_MT_CONTEXT* pMt, T_EC_DEMO_APP_CONTEXT *pAppContext);
 
 /* 在 stop/shutdown 时等待轴退出 OP_ENABLED（demo
  * 级，逻辑比较粗糙，仅用于“等一等”） */
-static EC_T_VOID CheckMotorStateStop(EC_T_VOID);
+static EC_T_VOID CheckMotorStateStop(T_MT_CONTEXT* pMt);
+
+/* [2026-10-16] 周期开始取入本周期的命令（MT_SetMotorCmd() 写入的 + 控制器经共享内存发布的） */
+static EC_T_VOID MtLoadMotorCmds(T_MT_CONTEXT* pMt);
 
 /*-GLOBAL VARIABLES-----------------------------------------------------------*/
-/* `My_Motor[]`：每个轴的运行时上下文（包含一堆 PDO 指针）
- * `My_Slave[]`：上层配置的 slave 列表（站地址 + 轴数）
+/* [2026-10-16] 多实例：原来这里的 My_Motor[]/My_Slave[]/S_MotorCmd[]/S_ProcessState[]/fTimeSec/S_RunMode 等
+ * 全部移进 T_MT_CONTEXT（见 motrotech.h），本模块不再有可写的全局/静态变量。
  *
- * 注意：My_Motor[] 里“指针成员”的生命周期：
+ * 注意：pMt->pMotor[] 里“指针成员”的生命周期：
  *   - 在 MT_Init()/MT_Prepare() 之后仍然可能为 EC_NULL
  *   - 只有 MT_Setup() 成功根据 ENI 找到对应 PDO entry，才会指向 PdIn/PdOut 内存
  */
-My_Motor_Type My_Motor[MAX_AXIS_NUM];
-SLAVE_MOTOR_TYPE My_Slave[MAX_SLAVE_NUM];
-
-/*-LOCAL VARIABLES-----------------------------------------------------------*/
-/* 轴总数（所有 slave 的轴数累加） */
-static EC_T_INT MotorCount = 0;
-/* slave 数量（本 demo 的 “slave” 计数，通常等于参与控制的从站个数） */
-static EC_T_INT SlaveCount = 0;
-/* 每个轴的“命令输入”（上层通过 MT_SetSwitch 写入） */
-static volatile eStateCmd S_ProcessState[MAX_AXIS_NUM];
-
-/* 你们的“手动控制接口”：上层写 MotorCmd_，周期里写到 PDO；周期里把 PDO 反馈填到 MotorState_ */
-/* 注意：这里不要用 volatile struct，否则 C++ 里结构体拷贝/赋值会被限定符卡住。
- * demo 级场景：上层线程写 cmd、周期线程读 cmd；接受“偶尔读到中间态”的风险。
- * 若你要强一致性：请加锁或做双缓冲（两份 cmd + 版本号）。
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+
+/* [2026-10-16] 目的：释放 pGain
+ * 说明：还有 kp/kd 请求在途（只在 SDO 流水线停止超时、被有意泄漏时出现）则同样泄漏，
+ *       流水线线程之后还会写 aoSdo
  */
-static MotorCmd_           S_MotorCmd[MAX_AXIS_NUM];
-static EC_T_BOOL           S_MotorCmdValid[MAX_AXIS_NUM];
-static MotorState_         S_MotorState[MAX_AXIS_NUM];
-/* 总线周期时间（秒），在 MT_Setup() 里由 dwBusCycleTimeUsec 计算出来 */
-static EC_T_LREAL fTimeSec = 0.0000;
+static EC_T_VOID MtFreeGains(T_MT_CONTEXT* pMt)
+{
+  if (pMt->pGain == EC_NULL) {
+    return;
+  }
+  for (EC_T_DWORD i = 0; i < pMt->dwAxisCap; i++) {
+    for (EC_T_INT k = 0; k < MT_GAIN_CNT; k++) {
+      if (pMt->pGain[i].abBusy[k] && !SDO_PIPE_HANDLE_DONE(&pMt->pGain[i].aoSdo[k])) {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR,
+            "Motrotech: gain SDO still pending on axis %d, leaking gain state\n", (EC_T_INT)i));
+        pMt->pGain = EC_NULL;
+        return;
+      }
+    }
+  }
+  SafeOsFree(pMt->pGain);
+}
 
-/* [2026-01-14] 目的：运行模式开关（默认自动，保持原demo行为） */
-static MT_RUN_MODE S_RunMode = MT_RUNMODE_AUTO;
+/* [2026-10-16] 释放 MT_Init() 分配的运行时数组 */
+static EC_T_VOID MtFreeArrays(T_MT_CONTEXT* pMt)
+{
+  SafeOsFree(pMt->pMotor);
+  SafeOsFree(pMt->pSlave);
+  if (pMt->pProcessState != EC_NULL) {
+    OsFree((EC_T_VOID*)pMt->pProcessState);
+    pMt->pProcessState = EC_NULL;
+  }
+  SafeOsFree(pMt->pMotorCmd);
+  SafeOsFree(pMt->pdwCmdSeq);
+  SafeOsFree(pMt->pdwCmdSeen);
+  SafeOsFree(pMt->pMotorCmdCyc);
+  SafeOsFree(pMt->pbMotorCmdValid);
+  SafeOsFree(pMt->pMotorState);
+  MtFreeGains(pMt);
+  MtTrajDelete(&pMt->oTraj);
+  MtShmDelete(&pMt->oShm);
+  pMt->dwAxisCap = 0;
+  pMt->dwSlaveCap = 0;
+  pMt->nMotorCount = 0;
+  pMt->nSlaveCount = 0;
+}
 
-/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+/* [2026-10-16] 目的：初始化一个实例的上下文（EcDemoApp() 之前、MT_Configure* 之前调用） */
+EC_T_DWORD MT_ContextCreate(T_MT_CONTEXT* pMt, EC_T_DWORD dwInstanceId)
+{
+  if (pMt == EC_NULL) {
+    return EC_E_INVALIDPARM;
+  }
+  OsMemset(pMt, 0, sizeof(T_MT_CONTEXT));
+  pMt->dwInstanceId = dwInstanceId;
+  pMt->eRunMode = MT_RUNMODE_AUTO;
+  return EC_E_NOERROR;
+}
+
+/* [2026-10-16] 目的：释放一个实例的全部分配（EcDemoApp() 返回之后调用，周期线程已停止） */
+EC_T_VOID MT_ContextDelete(T_MT_CONTEXT* pMt)
+{
+  if (pMt == EC_NULL) {
+    return;
+  }
+  MtFreeArrays(pMt);
+  SafeOsFree(pMt->pCfgSlave);
+  pMt->dwCfgSlaveCnt = 0;
+  SafeOsFree(pMt->pwCfgTrajAxis);
+  pMt->dwCfgTrajCnt = 0;
+  MtPdoCtxRelease(&pMt->oPdo);
+  pMt->pAppContext = EC_NULL;
+}
+
+/* [2026-10-16] 目的：保存配置的从站列表（MT_Init() 前调用；dwCnt=0 清除配置） */
+EC_T_DWORD MT_ConfigureSlaves(T_MT_CONTEXT* pMt, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwCnt)
+{
+  SafeOsFree(pMt->pCfgSlave);
+  pMt->dwCfgSlaveCnt = 0;
+  if ((pSlave == EC_NULL) || (dwCnt == 0)) {
+    return EC_E_NOERROR;
+  }
+  pMt->pCfgSlave = (SLAVE_MOTOR_TYPE*)OsMalloc(dwCnt * sizeof(SLAVE_MOTOR_TYPE));
+  if (pMt->pCfgSlave == EC_NULL) {
+    return EC_E_NOMEMORY;
+  }
+  OsMemcpy(pMt->pCfgSlave, pSlave, dwCnt * sizeof(SLAVE_MOTOR_TYPE));
+  pMt->dwCfgSlaveCnt = dwCnt;
+  return EC_E_NOERROR;
+}
+
+/* [2026-10-16] 目的：保存轴组配置（MT_Setup() 前调用；dwCnt=0 清除配置，轴号在 MT_Setup() 里校验） */
+EC_T_DWORD MT_ConfigureTrajGroups(T_MT_CONTEXT* pMt, const T_MT_TRAJ_GROUP_CFG* pCfg, EC_T_DWORD dwCnt)
+{
+  EC_T_DWORD dwAxisTotal = 0;
+
+  SafeOsFree(pMt->pwCfgTrajAxis);
+  pMt->dwCfgTrajCnt = 0;
+  if ((pCfg == EC_NULL) || (dwCnt == 0)) {
+    return EC_E_NOERROR;
+  }
+  if (dwCnt > MT_TRAJ_MAX_GROUPS) {
+    return EC_E_INVALIDPARM;
+  }
+  for (EC_T_DWORD g = 0; g < dwCnt; g++) {
+    if ((pCfg[g].dwAxisCnt == 0) || (pCfg[g].pwAxis == EC_NULL)) {
+      return EC_E_INVALIDPARM;
+    }
+    dwAxisTotal += pCfg[g].dwAxisCnt;
+  }
+  pMt->pwCfgTrajAxis = (EC_T_WORD*)OsMalloc(dwAxisTotal * sizeof(EC_T_WORD));
+  if (pMt->pwCfgTrajAxis == EC_NULL) {
+    return EC_E_NOMEMORY;
+  }
+  dwAxisTotal = 0;
+  for (EC_T_DWORD g = 0; g < dwCnt; g++) {
+    pMt->aCfgTraj[g] = pCfg[g];
+    OsMemcpy(&pMt->pwCfgTrajAxis[dwAxisTotal], pCfg[g].pwAxis, pCfg[g].dwAxisCnt * sizeof(EC_T_WORD));
+    pMt->aCfgTraj[g].pwAxis = &pMt->pwCfgTrajAxis[dwAxisTotal];
+    dwAxisTotal += pCfg[g].dwAxisCnt;
+  }
+  pMt->dwCfgTrajCnt = dwCnt;
+  return EC_E_NOERROR;
+}
+
+/* [2026-10-16] 目的：保存共享内存名（MT_Setup() 前调用；EC_NULL 或 "" 表示不创建） */
+EC_T_DWORD MT_ConfigureShm(T_MT_CONTEXT* pMt, const EC_T_CHAR* szName)
+{
+  pMt->szCfgShm[0] = '\0';
+  if ((szName == EC_NULL) || (szName[0] == '\0')) {
+    return EC_E_NOERROR;
+  }
+  if ((szName[0] != '/') || (OsStrlen(szName) >= MT_SHM_NAME_SIZE)) {
+    return EC_E_INVALIDPARM;
+  }
+  OsStrncpy(pMt->szCfgShm, szName, MT_SHM_NAME_SIZE - 1);
+  pMt->szCfgShm[MT_SHM_NAME_SIZE - 1] = '\0';
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD MT_GetConfiguredSlaveCnt(T_MT_CONTEXT* pMt)
+{
+  return pMt->dwCfgSlaveCnt;
+}
+
+EC_T_DWORD MT_GetAxisCapacity(T_MT_CONTEXT* pMt)
+{
+  return pMt->dwAxisCap;
+}
+
+EC_T_DWORD MT_GetSlaveCapacity(T_MT_CONTEXT* pMt)
+{
+  return pMt->dwSlaveCap;
+}
+
+EC_T_DWORD MT_GetAxisCount(T_MT_CONTEXT* pMt)
+{
+  return (EC_T_DWORD)pMt->nMotorCount;
+}
 
 /******************************************************************************
  * MT_Init
- * 初始化本模块的全局变量/数组。
- * - 清空 `My_Motor[]` / `My_Slave[]`
+ * 初始化本实例（pAppContext->pMtContext）的轴表。
+ * - 清空 `pMt->pMotor[]` / `pMt->pSlave[]`
  * - 给每个轴设置默认状态与默认工作模式（默认 CSP）
  *
  * 被谁调用：`EcDemoApp.cpp -> myAppInit()`
@@ -151,47 +309,101 @@ EC_T_DWORD MT_Init(T_EC_DEMO_APP_CONTEXT *pAppContext) {
             "\n Motrotech: "
             "___________________MT_Init_______________________________"));
 
-  /* 1) 清空“运行时上下文数组”
-   * - My_Motor[]：每轴的 PDO 指针 + 内部状态
-   * - My_Slave[]：从站站地址/轴数（上层会在 myAppPrepare() 里填）
+  T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+  if (pMt == EC_NULL) {
+    return EC_E_INVALIDPARM;
+  }
+
+  /* 1) 分配并清空“运行时上下文数组”
+   * - pMt->pMotor[]：每轴的 PDO 指针 + 内部状态
+   * - pMt->pSlave[]：从站站地址/轴数（配置了从站列表则在这里填好，否则由 myAppPrepare() 填）
+   * [2026-10-16] 容量 = max(配置的轴数/从站数, MAX_AXIS_NUM/MAX_SLAVE_NUM)
    */
-  OsMemset(My_Motor, 0, MAX_AXIS_NUM * sizeof(My_Motor_Type));
-  OsMemset(My_Slave, 0, MAX_SLAVE_NUM * sizeof(SLAVE_MOTOR_TYPE));
-  OsMemset((EC_T_VOID*)S_MotorCmd, 0, MAX_AXIS_NUM * sizeof(MotorCmd_));
-  OsMemset((EC_T_VOID*)S_MotorCmdValid, 0, MAX_AXIS_NUM * sizeof(EC_T_BOOL));
-  OsMemset((EC_T_VOID*)S_MotorState, 0, MAX_AXIS_NUM * sizeof(MotorState_));
+  EC_T_DWORD dwAxisCap = MAX_AXIS_NUM;
+  EC_T_DWORD dwSlaveCap = MAX_SLAVE_NUM;
+  EC_T_DWORD dwCfgAxisCnt = 0;
+  for (EC_T_DWORD dwIndex = 0; dwIndex < pMt->dwCfgSlaveCnt; dwIndex++) {
+    dwCfgAxisCnt += pMt->pCfgSlave[dwIndex].wAxisCnt;
+  }
+  if (dwCfgAxisCnt > dwAxisCap) {
+    dwAxisCap = dwCfgAxisCnt;
+  }
+  if (pMt->dwCfgSlaveCnt > dwSlaveCap) {
+    dwSlaveCap = pMt->dwCfgSlaveCnt;
+  }
+  MtFreeArrays(pMt);
+  pMt->pMotor = (My_Motor_Type*)OsMalloc(dwAxisCap * sizeof(My_Motor_Type));
+  pMt->pSlave = (SLAVE_MOTOR_TYPE*)OsMalloc(dwSlaveCap * sizeof(SLAVE_MOTOR_TYPE));
+  pMt->pProcessState = (volatile eStateCmd*)OsMalloc(dwAxisCap * sizeof(eStateCmd));
+  pMt->pMotorCmd = (MotorCmd_*)OsMalloc(dwAxisCap * sizeof(MotorCmd_));
+  pMt->pdwCmdSeq = (EC_T_DWORD*)OsMalloc(dwAxisCap * sizeof(EC_T_DWORD));
+  pMt->pdwCmdSeen = (EC_T_DWORD*)OsMalloc(dwAxisCap * sizeof(EC_T_DWORD));
+  pMt->pMotorCmdCyc = (MotorCmd_*)OsMalloc(dwAxisCap * sizeof(MotorCmd_));
+  pMt->pbMotorCmdValid = (EC_T_BOOL*)OsMalloc(dwAxisCap * sizeof(EC_T_BOOL));
+  pMt->pMotorState = (MotorState_*)OsMalloc(dwAxisCap * sizeof(MotorState_));
+  pMt->pGain = (T_MT_GAIN*)OsMalloc(dwAxisCap * sizeof(T_MT_GAIN));
+  if ((pMt->pMotor == EC_NULL) || (pMt->pSlave == EC_NULL) || (pMt->pProcessState == EC_NULL) || (pMt->pMotorCmd == EC_NULL)
+      || (pMt->pdwCmdSeq == EC_NULL) || (pMt->pdwCmdSeen == EC_NULL) || (pMt->pMotorCmdCyc == EC_NULL)
+      || (pMt->pbMotorCmdValid == EC_NULL) || (pMt->pMotorState == EC_NULL) || (pMt->pGain == EC_NULL)) {
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "Motrotech: Malloc memory fail"));
+    MtFreeArrays(pMt);
+    return EC_E_NOMEMORY;
+  }
+  pMt->dwAxisCap = dwAxisCap;
+  pMt->dwSlaveCap = dwSlaveCap;
+  pMt->nMotorCount = 0;
+  pMt->nSlaveCount = 0;
+  OsMemset(pMt->pMotor, 0, dwAxisCap * sizeof(My_Motor_Type));
+  OsMemset(pMt->pSlave, 0, dwSlaveCap * sizeof(SLAVE_MOTOR_TYPE));
+  OsMemset((EC_T_VOID*)pMt->pProcessState, 0, dwAxisCap * sizeof(eStateCmd));
+  OsMemset((EC_T_VOID*)pMt->pMotorCmd, 0, dwAxisCap * sizeof(MotorCmd_));
+  OsMemset(pMt->pdwCmdSeq, 0, dwAxisCap * sizeof(EC_T_DWORD));
+  OsMemset(pMt->pdwCmdSeen, 0, dwAxisCap * sizeof(EC_T_DWORD));
+  OsMemset((EC_T_VOID*)pMt->pbMotorCmdValid, 0, dwAxisCap * sizeof(EC_T_BOOL));
+  OsMemset((EC_T_VOID*)pMt->pMotorState, 0, dwAxisCap * sizeof(MotorState_));
+  OsMemset(pMt->pGain, 0, dwAxisCap * sizeof(T_MT_GAIN));
+  if (pMt->dwCfgSlaveCnt > 0) {
+    OsMemcpy(pMt->pSlave, pMt->pCfgSlave, pMt->dwCfgSlaveCnt * sizeof(SLAVE_MOTOR_TYPE));
+  }
+  pMt->pAppContext = pAppContext;
 
   /* 2) 给每个轴设置初值（“默认模式/默认状态”）
    * 注意：这些不是从站真实状态；真实状态必须在 MT_Setup() 映射到 StatusWord 后，
    * 由 Process_Commands() 在周期里读取并解析出来。
    */
-  for (EC_T_DWORD dwIndex = 0; dwIndex < MAX_AXIS_NUM; dwIndex++) {
+  for (EC_T_DWORD dwIndex = 0; dwIndex < pMt->dwAxisCap; dwIndex++) {
     /* 初始状态：既未 ready，也未 enabled。真正状态要等 PDO 输入（StatusWord）到来后解析。 */
-    My_Motor[dwIndex].wReqState = DRV_DEV_STATE_NOT_READY;
-    My_Motor[dwIndex].wActState = DRV_DEV_STATE_NOT_READY;
+    pMt->pMotor[dwIndex].wReqState = DRV_DEV_STATE_NOT_READY;
+    pMt->pMotor[dwIndex].wActState = DRV_DEV_STATE_NOT_READY;
     /* 默认工作模式：CSP（循环同步位置）。如果你的驱动不是 CiA402，应该把这一套换成你们自定义 mode。 */
-    My_Motor[dwIndex].eModesOfOperation = DRV_MODE_OP_CSP;
+    pMt->pMotor[dwIndex].eModesOfOperation = DRV_MODE_OP_CSP;
 
     /* [2026-01-13] 默认单位换算：1 rad = 1 count（即“不换算”）。
      * 工程使用时请调用 MT_SetAxisUnitScale() 配置 encoder_cpr 与 gear_ratio。
      */
-    My_Motor[dwIndex].fCntPerRad = 1.0;
-    My_Motor[dwIndex].fRadPerCnt = 1.0;
+    pMt->pMotor[dwIndex].fCntPerRad = 1.0;
+    pMt->pMotor[dwIndex].fRadPerCnt = 1.0;
+    pMt->pMotor[dwIndex].fCntPerRadReq = 1.0;
 
     /* [2026-01-19] 目的：初始化内存命令结构体的 kp/kd 默认值（匹配 PDF 手册定义）
      * 这样做可以防止程序启动后第一次执行 set 命令时，如果参数没变也会触发一次 SDO 写入。
      */
-    S_MotorCmd[dwIndex].kp = 32.0f;
-    S_MotorCmd[dwIndex].kd = 30.0f;
-    S_MotorCmd[dwIndex].mode = 0; // [2026-01-20] 安全：初始设为 Shutdown 模式，防止开机乱动
+    pMt->pMotorCmd[dwIndex].kp = 32.0f;
+    pMt->pMotorCmd[dwIndex].kd = 30.0f;
+    pMt->pMotorCmd[dwIndex].mode = 0; // [2026-01-20] 安全：初始设为 Shutdown 模式，防止开机乱动
+    pMt->pMotorCmdCyc[dwIndex] = pMt->pMotorCmd[dwIndex];
+    /* [2026-10-16] 说明：驱动默认值即视为已生效，与之不同的要求值才下发 */
+    pMt->pGain[dwIndex].afReq[MT_GAIN_KP] = pMt->pGain[dwIndex].afApplied[MT_GAIN_KP] = 32.0f;
+    pMt->pGain[dwIndex].afReq[MT_GAIN_KD] = pMt->pGain[dwIndex].afApplied[MT_GAIN_KD] = 30.0f;
+    pMt->pMotor[dwIndex].nDirection = 1;
   }
   /* [2026-01-14] 目的：给轴0设置默认单位换算（避免每次手动 scale） */
-  MT_SetAxisUnitScale(0, 131072, 9.0);
+  MT_SetAxisUnitScale(pMt, 0, 131072, 9.0);
 
   return EC_E_NOERROR;
 }
 
-EC_T_BOOL MT_SetAxisUnitScale(EC_T_WORD wAxis, EC_T_LREAL encoder_cpr, EC_T_LREAL gear_ratio)
+EC_T_BOOL MT_SetAxisUnitScale(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_LREAL encoder_cpr, EC_T_LREAL gear_ratio)
 {
   /* [2026-01-13] 作用：配置“rad <-> PUU(count)”换算系数
    *
@@ -203,7 +415,7 @@ EC_T_BOOL MT_SetAxisUnitScale(EC_T_WORD wAxis, EC_T_LREAL encoder_cpr, EC_T_LREA
    *   q_cnt  = q_rad  * cnt_per_rad
    *   dq_cnt = dq_rad * cnt_per_rad
    */
-  if (wAxis >= MAX_AXIS_NUM) {
+  if (wAxis >= pMt->dwAxisCap) {
     return EC_FALSE;
   }
   if ((encoder_cpr <= 0.0) || (gear_ratio <= 0.0)) {
@@ -213,25 +425,28 @@ EC_T_BOOL MT_SetAxisUnitScale(EC_T_WORD wAxis, EC_T_LREAL encoder_cpr, EC_T_LREA
   if (cntPerRad <= 0.0) {
     return EC_FALSE;
   }
-  My_Motor[wAxis].fCntPerRad = cntPerRad;
-  My_Motor[wAxis].fRadPerCnt = 1.0 / cntPerRad;
+  /* [2026-10-16] 修改：不直接改 fCntPerRad/fRadPerCnt（周期线程正在用），只原子写入请求值，
+   * 由 MtLoadMotorCmds() 在周期开始取入，本周期内两项始终成对一致
+   */
+  __atomic_store(&pMt->pMotor[wAxis].fCntPerRadReq, &cntPerRad, __ATOMIC_RELAXED);
   return EC_TRUE;
 }
 
 /******************************************************************************
  * MT_Prepare
  * “准备阶段”：根据上层已填好的
- *`My_Slave[]`，生成每个轴的站地址列表，并检查从站是否存在。
+ *`pMt->pSlave[]`，生成每个轴的站地址列表，并检查从站是否存在。
  *
  * 关键点：
- * - `My_Slave[]` 通常在 `EcDemoApp.cpp -> myAppPrepare()` 里填写（示例里写死
+ * - `pMt->pSlave[]` 通常在 `EcDemoApp.cpp -> myAppPrepare()` 里填写（示例里写死
  *1001/1002）。
  * - 这里用 `ecatIsSlavePresent()` 检查从站是否 present。
- * - 然后把 `My_Motor[].wStationAddress` 填好，并累计 `MotorCount` /
- *`SlaveCount`。
+ *   [2026-10-16] 经 pAppContext->pMasterAccess（实机即 emIsSlavePresent）
+ * - 然后把 `pMt->pMotor[].wStationAddress` 填好，并累计 `pMt->nMotorCount` /
+ *`pMt->nSlaveCount`。
  *
  * 注意：代码里 dwSlaveNum=ecatGetNumConfiguredSlaves()，但访问的是
- *My_Slave[dwSlaveIdx]； 所以要求 `My_Slave[]` 至少填到 dwSlaveNum
+ *pMt->pSlave[dwSlaveIdx]； 所以要求 `pMt->pSlave[]` 至少填到 dwSlaveNum
  *项，否则可能越界（demo 假设配置正确）。
  ******************************************************************************/
 EC_T_DWORD MT_Prepare(T_EC_DEMO_APP_CONTEXT *pAppContext) {
@@ -241,47 +456,65 @@ EC_T_DWORD MT_Prepare(T_EC_DEMO_APP_CONTEXT *pAppContext) {
             "\n Motrotech: "
             "___________________MT_Prepare_______________________________"));
 
-  /* MT_Prepare() 的目标是：把“从站配置(My_Slave[])”摊平成“每轴列表(My_Motor[])”。
-   * 之后 MT_Setup()/MT_Workpd() 都是按轴循环（for i in MotorCount）工作。
+  /* MT_Prepare() 的目标是：把“从站配置(pMt->pSlave[])”摊平成“每轴列表(pMt->pMotor[])”。
+   * 之后 MT_Setup()/MT_Workpd() 都是按轴循环（for i in pMt->nMotorCount）工作。
    */
   EC_T_DWORD dwRetVal;
-  EC_T_DWORD dwSlaveNum = ecatGetNumConfiguredSlaves();
-  /* 这里“按配置从站数”循环，但使用的是 My_Slave[dwSlaveIdx]。
-   * 所以前提是：My_Slave[] 至少填了 dwSlaveNum 项（demo 假设你们填对了）。
+  T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+  CMtMasterAccess* pMaster = pAppContext->pMasterAccess;
+  if ((pMt == EC_NULL) || (pMaster == EC_NULL)) {
+    return EC_E_INVALIDSTATE;
+  }
+  EC_T_DWORD dwSlaveNum = pMaster->GetNumConfiguredSlaves();
+  /* 这里“按配置从站数”循环，但使用的是 pMt->pSlave[dwSlaveIdx]。
+   * [2026-10-16] 不再越界：只走 pMt->pSlave[] 容量内已填写（轴数非 0）的项，轴数超出容量的从站截断
    */
+  if (dwSlaveNum > pMt->dwSlaveCap) {
+    dwSlaveNum = pMt->dwSlaveCap;
+  }
+  pMt->nMotorCount = 0;
+  pMt->nSlaveCount = 0;
   for (EC_T_DWORD dwSlaveIdx = 0; dwSlaveIdx < dwSlaveNum; dwSlaveIdx++) {
+    if (pMt->pSlave[dwSlaveIdx].wAxisCnt == 0) {
+      break;
+    }
+    if ((EC_T_DWORD)pMt->nMotorCount + pMt->pSlave[dwSlaveIdx].wAxisCnt > pMt->dwAxisCap) {
+      EcLogMsg(EC_LOG_LEVEL_ERROR,
+               (pEcLogContext, EC_LOG_LEVEL_ERROR,
+                "ERROR: Slave_%d exceeds axis capacity %d", pMt->pSlave[dwSlaveIdx].wStationAddress, pMt->dwAxisCap));
+      break;
+    }
     EC_T_BOOL bPresent = EC_FALSE;
-    /* ecatIsSlavePresent 的输入是 slaveId（由 station address 转换得到），用于判断从站是否在线/可访问 */
-    EC_T_DWORD dwRes = ecatIsSlavePresent(
-        ecatGetSlaveId(My_Slave[dwSlaveIdx].wStationAddress), &bPresent);
+    /* 判断从站是否在线/可访问（实机：station address -> slaveId -> emIsSlavePresent） */
+    EC_T_DWORD dwRes = pMaster->IsSlavePresent(pMt->pSlave[dwSlaveIdx].wStationAddress, &bPresent);
     if ((EC_E_NOERROR != dwRes) || (EC_TRUE != bPresent)) {
       EcLogMsg(EC_LOG_LEVEL_ERROR,
                (pEcLogContext, EC_LOG_LEVEL_ERROR,
                 "ERROR: Slave_%d is not present (Result = %s 0x%x)",
-                My_Slave[dwSlaveIdx].wStationAddress, ecatGetText(dwRes),
+                pMt->pSlave[dwSlaveIdx].wStationAddress, ecatGetText(dwRes),
                 dwRes));
       dwRetVal = dwRes;
       break;
     }
 
-    /* 生成 My_Motor[]：把“每个轴”绑定到其所属 slave 的 station address */
-    for (EC_T_WORD i = 0; i < My_Slave[dwSlaveIdx].wAxisCnt; i++) {
-      My_Motor[MotorCount + i].wStationAddress =
-          My_Slave[dwSlaveIdx].wStationAddress;
+    /* 生成 pMt->pMotor[]：把“每个轴”绑定到其所属 slave 的 station address */
+    for (EC_T_WORD i = 0; i < pMt->pSlave[dwSlaveIdx].wAxisCnt; i++) {
+      pMt->pMotor[pMt->nMotorCount + i].wStationAddress =
+          pMt->pSlave[dwSlaveIdx].wStationAddress;
     }
-    MotorCount += My_Slave[dwSlaveIdx].wAxisCnt;
-    SlaveCount++;
+    pMt->nMotorCount += pMt->pSlave[dwSlaveIdx].wAxisCnt;
+    pMt->nSlaveCount++;
   }
 
   /* 注意：这里即使发现从站不 present，当前 demo 仍然返回 EC_E_NOERROR（见 return）。
    * 如果你想把它工程化：建议 return dwRetVal，并在上层处理失败（退出/重试/降级）。
    */
   EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO,
-                               "Motrotech: (%d) Axises have find", MotorCount));
+                               "Motrotech: (%d) Axises have find", pMt->nMotorCount));
   /* [2026-01-14] 目的：按实际轴数批量设置默认单位换算（避免每次手动 scale） */
-  for (EC_T_INT i = 0; i < MotorCount; i++)
+  for (EC_T_INT i = 0; i < pMt->nMotorCount; i++)
   {
-      MT_SetAxisUnitScale((EC_T_WORD)i, 131072, 9.0);
+      MT_SetAxisUnitScale(pMt, (EC_T_WORD)i, 131072, 9.0);
   }
   return EC_E_NOERROR;
 }
@@ -297,21 +530,16 @@ EC_T_DWORD MT_Prepare(T_EC_DEMO_APP_CONTEXT *pAppContext) {
  *得到每个变量的：
  *   - 对象索引（wIndex）、子索引（wSubIndex）
  *   - 在过程映像中的位偏移（nBitOffs）
- * - 根据索引匹配我们关心的对象，然后把 `My_Motor[]` 里对应指针指向
+ * - 根据索引匹配我们关心的对象，然后把 `pMt->pMotor[]` 里对应指针指向
  *`pbyPDOut/pbyPDIn + nBitOffs/8`
  *
- * 关键假设：
- * - 多轴对象按 `objectIndex + axis * OBJOFFSET` 排布（例如 axis1 的 ControlWord
- *是 0x6040+0x800）。 如果从站不按这个规则映射，你需要改下面 `if (wIndex == base
- *+ dwAxis*OBJOFFSET)` 的匹配方式。
+ * [2026-10-16] 匹配规则改为绑定表（motrotech_pdo.cpp 的 MtPdoBind）：
+ * - 对象号/子索引/类型/方向/每轴步长都来自配置，不再是这里的 if/else 链
+ * - 结果按 ENI 哈希缓存到文件，ENI 不变时下次启动不再逐从站查询
  *
  * 被谁调用：`EcDemoApp.cpp -> myAppSetup()`
  ******************************************************************************/
 EC_T_DWORD MT_Setup(T_EC_DEMO_APP_CONTEXT *pAppContext) {
-  EC_T_DWORD dwRetVal = EC_E_NOERROR;
-  EC_T_WORD wReadEntries = 0;
-  EC_T_WORD wWriteEntries = 0;
-
   /* 【特别说明：为什么这里全是“指针”】
    *
    * EC‑Master 把所有 PDO 数据放在两块连续内存中：
@@ -323,7 +551,7 @@ EC_T_DWORD MT_Setup(T_EC_DEMO_APP_CONTEXT *pAppContext) {
    *
    * 本函数做的事：把
    *   (对象索引 wIndex + 子索引 wSubIndex)  →  (PdOut/PdIn 的内存地址)
-   * 映射成指针存在 My_Motor[] 里。
+   * 映射成指针存在 pMt->pMotor[] 里。
    *
    * 之后每周期控制时，只要对这些指针写值，主站在 SendAllCycFrames
    * 时就会把值发给从站。
@@ -331,413 +559,65 @@ EC_T_DWORD MT_Setup(T_EC_DEMO_APP_CONTEXT *pAppContext) {
    * 也因此：如果 ENI 没映射某对象，指针会保持为 EC_NULL，后面写不进去 →
    * 电机不会动。
    */
-  EC_T_WORD mySlaveOutVarInfoNum = 0;
-  EC_T_WORD mySlaveInVarInfoNum = 0;
-  EC_T_DWORD MyAxis_num_tmp = 0;
-  EC_T_DWORD MyAxis_num_cnt = 0;
-  EC_T_PROCESS_VAR_INFO_EX *pProcessVarInfoOut = EC_NULL;
-  EC_T_PROCESS_VAR_INFO_EX *pProcessVarInfoIn = EC_NULL;
-  EC_T_CFG_SLAVE_INFO s_SlaveInfo;
-  /* PdIn/PdOut 是 EC‑Master 的“过程映像（ProcessImage）”基地址：
-   * - PdOut：主站写（RxPDO），在 SendAllCycFrames 时发送给从站
-   * - PdIn ：从站写（TxPDO），在 ProcessAllRxFrames 后可读到
-   */
-  EC_T_BYTE *pbyPDIn = ecatGetProcessImageInputPtr();
-  EC_T_BYTE *pbyPDOut = ecatGetProcessImageOutputPtr();
-
   EcLogMsg(EC_LOG_LEVEL_INFO,
            (pEcLogContext, EC_LOG_LEVEL_INFO,
             "\n Motrotech: ___________________MT_Setup______________________"));
 
-  /* PdOut/PdIn 基地址必须有效，否则无法建立指针映射 */
-  if ((pbyPDOut != EC_NULL) && (pbyPDIn != EC_NULL)) {
-    for (EC_T_DWORD dwSlaveIdx = 0; dwSlaveIdx < SlaveCount; dwSlaveIdx++) {
-      /* 防御性：多 slave 情况下，每个 slave 都会重新 OsMalloc 一次；
-       * 必须在进入下一轮前释放上一次分配，避免泄漏。
-       */
-      if (pProcessVarInfoOut != EC_NULL) {
-        OsFree(pProcessVarInfoOut);
-        pProcessVarInfoOut = EC_NULL;
-      }
-      if (pProcessVarInfoIn != EC_NULL) {
-        OsFree(pProcessVarInfoIn);
-        pProcessVarInfoIn = EC_NULL;
-      }
-
-      OsMemset(&s_SlaveInfo, 0, sizeof(EC_T_CFG_SLAVE_INFO));
-      /* ecatGetCfgSlaveInfo 会返回该从站在 ENI 中配置的 PDO/变量数量等信息 */
-      if (ecatGetCfgSlaveInfo(EC_TRUE, My_Slave[dwSlaveIdx].wStationAddress,
-                              &s_SlaveInfo) != EC_E_NOERROR) {
-        EcLogMsg(EC_LOG_LEVEL_ERROR,
-                 (pEcLogContext, EC_LOG_LEVEL_ERROR,
-                  "ERROR: ecatGetCfgSlaveInfo() returns with error."));
-        continue;
-      }
-
-      /********************** PDO_OUT（主站输出 -> 从站输入）
-       * ***********************
-       *
-       * 这里枚举“这个 slave 的所有输出 PDO 变量”（也就是主站要写的那部分）。
-       * 对每个变量，我们用它的 wIndex/wSubIndex 来判断是不是我们关心的对象，
-       * 如果是，就用 nBitOffs 把它定位到 PdOut 里的地址，然后保存到
-       * My_Motor[].xxx 指针。
-       *
-       * 注意：nBitOffs 是“位偏移”，所以要 /8 变成字节偏移。
-       */
-      mySlaveOutVarInfoNum = s_SlaveInfo.wNumProcessVarsOutp;
-      EcLogMsg(EC_LOG_LEVEL_INFO,
-               (pEcLogContext, EC_LOG_LEVEL_INFO,
-                "Motrotech: OutVarInfoNum = %d", mySlaveOutVarInfoNum));
-
-      pProcessVarInfoOut = (EC_T_PROCESS_VAR_INFO_EX *)OsMalloc(
-          sizeof(EC_T_PROCESS_VAR_INFO_EX) * mySlaveOutVarInfoNum);
-      if (pProcessVarInfoOut == EC_NULL) {
-        dwRetVal = EC_E_NOMEMORY;
-        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO,
-                                     "Motrotech: Malloc memory fail"));
-      } else {
-        dwRetVal = ecatGetSlaveOutpVarInfoEx(
-            EC_TRUE, My_Slave[dwSlaveIdx].wStationAddress, mySlaveOutVarInfoNum,
-            pProcessVarInfoOut, &wReadEntries);
-        if (EC_E_NOERROR != dwRetVal) {
-          EcLogMsg(EC_LOG_LEVEL_ERROR,
-                   (pEcLogContext, EC_LOG_LEVEL_ERROR,
-                    "ERROR: emGetSlaveInpVarInfoEx() (Result = %s 0x%x)",
-                    ecatGetText(dwRetVal), dwRetVal));
-        }
-      }
-
-      /* 遍历本 slave 的所有输出变量，逐个判断是否是我们关心的对象。
-       *
-       * 你后续要实现你们的 MotorCmd_（mode/q/dq/tau/kp/kd...）：
-       *   - 就是在这里新增 “if (wIndex/wSubIndex 匹配你们对象)” 然后把指针指向 PdOut。
-       *   - 写入时建议用 EC_SETBITS 写 float32，避免对齐/aliasing 问题。
-       */
-      for (EC_T_DWORD i = 0; i < mySlaveOutVarInfoNum; i++) {
-        for (EC_T_DWORD dwAxis = 0; dwAxis < My_Slave[dwSlaveIdx].wAxisCnt;
-             dwAxis++) {
-          /* MyAxis_num_cnt：累计偏移（前面 slave 的轴数总和）
-           * MyAxis_num_tmp：当前 slave 的第 dwAxis 个轴在全局 My_Motor[]
-           * 中的下标
-           */
-          MyAxis_num_tmp = MyAxis_num_cnt + dwAxis;
-
-          /* 【对象索引如何区分多轴？】
-           * 本 demo 假设：同一 slave 的多轴对象按固定规律排列：
-           *   axis0: baseIndex
-           *   axis1: baseIndex + 0x800
-           *   axis2: baseIndex + 2*0x800
-           * 也就是：wIndex == baseIndex + dwAxis * OBJOFFSET
-           * 如果你实际从站的对象不是这个规律，这里必须改。
-           */
-          if (pProcessVarInfoOut[i].wIndex ==
-              DRV_OBJ_CONTROL_WORD + dwAxis * OBJOFFSET) // 0x6040 - ControlWord
-          {
-            /* 0x6040 ControlWord（主站写 → 驱动读）
-             * - 这是 CiA402 状态机的“命令口”，驱动靠它完成
-             * Shutdown/SwitchOn/EnableOp/FaultReset 等转换。
-             * - 指针指向 PdOut 中该变量所在地址。
-             */
-            My_Motor[MyAxis_num_tmp].pwControlWord =
-                (EC_T_WORD *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            /* 备注：这里用“指针指向 ProcessImage”，后续周期直接 EC_SETWORD 写入即可 */
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pwControlWord = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwControlWord));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_TARGET_POSITION +
-                         dwAxis * OBJOFFSET) // 0x607A - TargetPosition
-          {
-            /* 0x607A TargetPosition（主站写 → 驱动读）
-             * - 在 CSP 等模式下，驱动会跟随该目标位置。
-             * - 只有驱动已进入 Operation Enabled
-             * 后，该目标才会被执行（否则可能忽略或被限制）。
-             */
-            My_Motor[MyAxis_num_tmp].pnTargetPosition =
-                (EC_T_INT *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pnTargetPosition = 0x%08X",
-                      MyAxis_num_tmp,
-                      My_Motor[MyAxis_num_tmp].pnTargetPosition));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_TARGET_VELOCITY +
-                         dwAxis * OBJOFFSET) // 0x60FF - TargetVelocity
-          {
-            /* 0x60FF TargetVelocity（主站写 → 驱动读）
-             * - 在 CSV 等模式下它是主要目标；在某些驱动的 CSP
-             * 实现里也可能作为辅助（取决于厂家）。
-             */
-            My_Motor[MyAxis_num_tmp].pnTargetVelocity =
-                (EC_T_INT *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pnTargetVelocity = 0x%08X",
-                      MyAxis_num_tmp,
-                      My_Motor[MyAxis_num_tmp].pnTargetVelocity));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_TARGET_TORQUE +
-                         dwAxis * OBJOFFSET) // 0x6071 - TargetTorque
-          {
-            My_Motor[MyAxis_num_tmp].pwTargetTorque =
-                (EC_T_WORD *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pwTargetTorque = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwTargetTorque));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_VELOCITY_OFFSET +
-                         dwAxis * OBJOFFSET) // 0x60B1 - Velocity Offset
-          {
-            My_Motor[MyAxis_num_tmp].pnVelocityOffset =
-                (EC_T_INT *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pnVelocityOffset = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pnVelocityOffset));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_TORQUE_OFFSET +
-                         dwAxis * OBJOFFSET) // 0x60B2 - Torque Offset
-          {
-            My_Motor[MyAxis_num_tmp].pwTorqueOffset =
-                (EC_T_SWORD *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pwTorqueOffset = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwTorqueOffset));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_MODES_OF_OPERATION +
-                         dwAxis * OBJOFFSET) // 0x6060 - Mode of Operation
-          {
-            /* 0x6060 Modes of operation（主站写 → 驱动读）
-             * - 选择驱动的工作模式（CSP/CSV/CST/PP 等）。
-             * - 这个对象如果被映射到 PDO，则可以每周期写；否则要用 SDO 下载。
-             */
-            My_Motor[MyAxis_num_tmp].pbyModeOfOperation =
-                (EC_T_BYTE *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pbyModeOfOperation = 0x%08X",
-                      MyAxis_num_tmp,
-                      My_Motor[MyAxis_num_tmp].pbyModeOfOperation));
-          } else if (pProcessVarInfoOut[i].wIndex ==
-                     DRV_OBJ_DIGITAL_OUTPUT +
-                         dwAxis * OBJOFFSET) // 0x7010 - Output 1
-          {
-            if (pProcessVarInfoOut[i].wSubIndex ==
-                DRV_OBJ_DIGITAL_OUTPUT_SUBINDEX_1) // 0x7010/1 - Output subindex
-                                                   // 1
-            {
-              My_Motor[MyAxis_num_tmp].pwOutput_1 =
-                  (EC_T_WORD *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-              EcLogMsg(EC_LOG_LEVEL_INFO,
-                       (pEcLogContext, EC_LOG_LEVEL_INFO,
-                        "Motrotech: MyAxis[%d].pwOutput_1 = 0x%08X",
-                        MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwOutput_1));
-            } else if (pProcessVarInfoOut[i].wSubIndex ==
-                       DRV_OBJ_DIGITAL_OUTPUT_SUBINDEX_2) // 0x7010/2 - Output
-                                                          // subindex 2
-            {
-              My_Motor[MyAxis_num_tmp].pwOutput_2 =
-                  (EC_T_WORD *)&(pbyPDOut[pProcessVarInfoOut[i].nBitOffs / 8]);
-              EcLogMsg(EC_LOG_LEVEL_INFO,
-                       (pEcLogContext, EC_LOG_LEVEL_INFO,
-                        "Motrotech: MyAxis[%d].pwOutput_2 = 0x%08X",
-                        MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwOutput_2));
-            }
-          } else {
-            // EcLogMsg(EC_LOG_LEVEL_INFO,(pEcLogContext,
-            // EC_LOG_LEVEL_INFO,"Motrotech: My_Slave[%d] Output undefine the
-            // index %d / usbindex %d", i, (pProcessVarInfoOut[i].wIndex,
-            // pProcessVarInfoOut[i].wSubIndex));
-          }
-        }
-      }
-
-      /********************** PDO_IN（从站输出 -> 主站输入）
-       * ***********************
-       *
-       * 这里枚举“这个 slave 的所有输入 PDO
-       * 变量”（也就是从站上报给主站的那部分）。 最关键的是：
-       * - 0x6041 StatusWord：驱动的 CiA402 状态（决定下一步该写哪个
-       * ControlWord）
-       * - 0x6064 ActualPosition：用于对齐/监控（demo 在未使能时用它避免跳变）
-       */
-      mySlaveInVarInfoNum = s_SlaveInfo.wNumProcessVarsInp;
-      EcLogMsg(EC_LOG_LEVEL_INFO,
-               (pEcLogContext, EC_LOG_LEVEL_INFO,
-                "Motrotech: InVarInfoNum = %d", mySlaveInVarInfoNum));
-
-      pProcessVarInfoIn = (EC_T_PROCESS_VAR_INFO_EX *)OsMalloc(
-          sizeof(EC_T_PROCESS_VAR_INFO_EX) * mySlaveInVarInfoNum);
-      if (pProcessVarInfoIn == EC_NULL) {
-        dwRetVal = EC_E_NOMEMORY;
-        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO,
-                                     "Motrotech: Malloc memory fail"));
-      } else {
-        dwRetVal = ecatGetSlaveInpVarInfoEx(
-            EC_TRUE, My_Slave[dwSlaveIdx].wStationAddress, mySlaveInVarInfoNum,
-            pProcessVarInfoIn, &wWriteEntries);
-        if (EC_E_NOERROR != dwRetVal) {
-          EcLogMsg(EC_LOG_LEVEL_ERROR,
-                   (pEcLogContext, EC_LOG_LEVEL_ERROR,
-                    "ERROR: emGetSlaveInpVarInfoEx() (Result = %s 0x%x)",
-                    ecatGetText(dwRetVal), dwRetVal));
-        }
-      }
-
-      /* 遍历本 slave 的所有输入变量，逐个判断是否是我们关心的对象。
-       *
-       * 你后续要实现你们的 MotorState_（q_fb/dq_fb/ddq_fb/tau_fb/温度/电压/错误码...）：
-       *   - 就是在这里新增 “if (wIndex/wSubIndex 匹配你们对象)” 然后把指针指向 PdIn。
-       *   - 注意温度/错误码这些常常是 int16/uint32，不一定是 float。
-       */
-      for (int i = 0; i < mySlaveInVarInfoNum; i++) {
-        for (EC_T_DWORD dwAxis = 0; dwAxis < My_Slave[dwSlaveIdx].wAxisCnt;
-             dwAxis++) {
-          MyAxis_num_tmp = MyAxis_num_cnt + dwAxis;
-          if (pProcessVarInfoIn[i].wIndex ==
-              DRV_OBJ_ERROR_CODE + dwAxis * OBJOFFSET) // 0x603F - Error Code
-          {
-            My_Motor[MyAxis_num_tmp].pwErrorCode =
-                (EC_T_WORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pwErrorCode = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwErrorCode));
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_STATUS_WORD +
-                         dwAxis * OBJOFFSET) // 0x6041 - StatusWord
-          {
-            /* 0x6041 StatusWord（从站写 → 主站读）
-             * - 这是 CiA402 状态机“当前态”的依据。
-             * - `Process_Commands()` 每周期都会读它，然后决定写哪个 0x6040
-             * 控制字。
-             */
-            My_Motor[MyAxis_num_tmp].pwStatusWord =
-                (EC_T_WORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pwStatusWord = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwStatusWord));
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_POSITION_ACTUAL_VALUE +
-                         dwAxis * OBJOFFSET) // 0x6064 - ActualPosition
-          {
-            /* 0x6064 ActualPosition（从站写 → 主站读）
-             * - demo 在未使能时，把 TargetPosition 设为
-             * ActualPosition（避免使能瞬间跳变/追赶）。
-             */
-            My_Motor[MyAxis_num_tmp].pnActPosition =
-                (EC_T_INT *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pnActPosition = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pnActPosition));
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_VELOCITY_ACTUAL_VALUE +
-                         dwAxis * OBJOFFSET) // 0x606C - ActualVelocity
-          {
-            My_Motor[MyAxis_num_tmp].pnActVelocity =
-                (EC_T_INT *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pnActVelocity = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pnActVelocity));
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_TORQUE_ACTUAL_VALUE +
-                         dwAxis * OBJOFFSET) // 0x6077 - ActTorque
-          {
-            My_Motor[MyAxis_num_tmp].pwActTorque =
-                (EC_T_WORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pwActTorque = 0x%08X",
-                      MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwActTorque));
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_FOLLOWING_ERROR +
-                         dwAxis * OBJOFFSET) // 0x60F4 - ActualFollowErr
-          {
-            My_Motor[MyAxis_num_tmp].pdwActFollowErr =
-                (EC_T_DWORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-            EcLogMsg(EC_LOG_LEVEL_INFO,
-                     (pEcLogContext, EC_LOG_LEVEL_INFO,
-                      "Motrotech: MyAxis[%d].pdwActFollowErr = 0x%08X",
-                      MyAxis_num_tmp,
-                      My_Motor[MyAxis_num_tmp].pdwActFollowErr));
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_DIGITAL_INPUT +
-                         dwAxis * OBJOFFSET) // 0x6000 - Input 1
-          {
-            if (pProcessVarInfoIn[i].wSubIndex ==
-                DRV_OBJ_DIGITAL_INPUT_SUBINDEX_1) // 0x6000/1 - Input subindex 1
-            {
-              My_Motor[MyAxis_num_tmp].pwInput_1 =
-                  (EC_T_WORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-              EcLogMsg(EC_LOG_LEVEL_INFO,
-                       (pEcLogContext, EC_LOG_LEVEL_INFO,
-                        "Motrotech: MyAxis[%d].pwInput_1 = 0x%08X",
-                        MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwInput_1));
-            } else if (pProcessVarInfoIn[i].wSubIndex ==
-                       DRV_OBJ_DIGITAL_INPUT_SUBINDEX_2) // 0x6000/2 - Input
-                                                         // subindex 2
-            {
-              My_Motor[MyAxis_num_tmp].pwInput_2 =
-                  (EC_T_WORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-              EcLogMsg(EC_LOG_LEVEL_INFO,
-                       (pEcLogContext, EC_LOG_LEVEL_INFO,
-                        "Motrotech: MyAxis[%d].pwInput_2 = 0x%08X",
-                        MyAxis_num_tmp, My_Motor[MyAxis_num_tmp].pwInput_2));
-            }
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_MCU_TEMPERATURE + dwAxis * OBJOFFSET) // 0x3008
-          {
-            My_Motor[MyAxis_num_tmp].psTempMcu =
-                (EC_T_SWORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_MOTOR_TEMPERATURE + dwAxis * OBJOFFSET) // 0x3009
-          {
-            My_Motor[MyAxis_num_tmp].psTempMotor =
-                (EC_T_SWORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_IGBT_TEMPERATURE + dwAxis * OBJOFFSET) // 0x300F
-          {
-            My_Motor[MyAxis_num_tmp].psTempIgbt =
-                (EC_T_SWORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-          } else if (pProcessVarInfoIn[i].wIndex ==
-                     DRV_OBJ_DC_LINK_VOLTAGE + dwAxis * OBJOFFSET) // 0x300B
-          {
-            My_Motor[MyAxis_num_tmp].pwDcLinkVoltage =
-                (EC_T_WORD *)&(pbyPDIn[pProcessVarInfoIn[i].nBitOffs / 8]);
-          } else {
-            // EcLogMsg(EC_LOG_LEVEL_INFO,(pEcLogContext,
-            // EC_LOG_LEVEL_INFO,"Motrotech: My_Slave[%d] Input undefine the
-            // index %d / usbindex %d", i, (pProcessVarInfoIn[i].wIndex,
-            // pProcessVarInfoIn[i].wSubIndex));
-          }
-        }
-      }
-      /* 处理完一个 slave，就把全局轴下标偏移推进（下一个 slave
-       * 的轴会接着往后排） */
-      MyAxis_num_cnt += My_Slave[dwSlaveIdx].wAxisCnt;
-    }
+  T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+  if (pMt == EC_NULL) {
+    return EC_E_INVALIDPARM;
   }
-
-  if (pProcessVarInfoOut != EC_NULL) {
-    OsFree(pProcessVarInfoOut);
-    pProcessVarInfoOut = EC_NULL;
+  EC_T_DWORD dwRetVal = MtPdoBind(&pMt->oPdo, pAppContext, pMt->pSlave, (EC_T_DWORD)pMt->nSlaveCount, pMt->pMotor, (EC_T_DWORD)pMt->nMotorCount);
+  if (EC_E_NOERROR != dwRetVal) {
+    EcLogMsg(EC_LOG_LEVEL_ERROR,
+             (pEcLogContext, EC_LOG_LEVEL_ERROR,
+              "ERROR: MtPdoBind() (Result = %s 0x%x)", ecatGetText(dwRetVal), dwRetVal));
+    /* [2026-10-16] 目的：绑定失败时 pMotor[] 的指针不完整，不能继续进入 SAFEOP/OP，错误返回给 myAppSetup() */
+    return dwRetVal;
   }
 
-  if (pProcessVarInfoIn != EC_NULL) {
-    OsFree(pProcessVarInfoIn);
-    pProcessVarInfoIn = EC_NULL;
+  /* [2026-10-16] 目的：建立轴组（轴号越界/重复时不建组，只打错误，其它功能不受影响） */
+  MtTrajDelete(&pMt->oTraj);
+  dwRetVal = MtTrajCreate(&pMt->oTraj, (EC_T_DWORD)pMt->nMotorCount, pMt->aCfgTraj, pMt->dwCfgTrajCnt);
+  if (EC_E_NOERROR != dwRetVal) {
+    EcLogMsg(EC_LOG_LEVEL_ERROR,
+             (pEcLogContext, EC_LOG_LEVEL_ERROR,
+              "ERROR: MtTrajCreate() %d groups on %d axes (Result = %s 0x%x)",
+              pMt->dwCfgTrajCnt, pMt->nMotorCount, ecatGetText(dwRetVal), dwRetVal));
+    MtTrajCreate(&pMt->oTraj, (EC_T_DWORD)pMt->nMotorCount, EC_NULL, 0);
   }
 
   /* 把周期时间从 usec 换算成秒，后面速度/位置积分会用到
-   * 举例：dwBusCycleTimeUsec=1000 → fTimeSec=0.001s
+   * 举例：dwBusCycleTimeUsec=1000 → pMt->fTimeSec=0.001s
    */
-  fTimeSec = (EC_T_LREAL)pAppContext->AppParms.dwBusCycleTimeUsec / 1000000;
+  pMt->fTimeSec = (EC_T_LREAL)pAppContext->AppParms.dwBusCycleTimeUsec / 1000000;
+
+  /* [2026-10-16] 目的：建立过程数据共享内存（创建失败只打错误，退回进程内快照，周期照常运行） */
+  MtShmDelete(&pMt->oShm);
+  pMt->qwCycle = 0;
+  if (pMt->nMotorCount == 0) {
+    return EC_E_NOERROR;
+  }
+  dwRetVal = MtShmCreate(&pMt->oShm, (pMt->szCfgShm[0] != '\0') ? pMt->szCfgShm : EC_NULL, (EC_T_DWORD)pMt->nMotorCount,
+                         pAppContext->AppParms.dwBusCycleTimeUsec);
+  if ((EC_E_NOERROR != dwRetVal) && (pMt->szCfgShm[0] != '\0')) {
+    EcLogMsg(EC_LOG_LEVEL_ERROR,
+             (pEcLogContext, EC_LOG_LEVEL_ERROR,
+              "ERROR: MtShmCreate(%s) %d axes (Result = %s 0x%x), process data stays process-local",
+              pMt->szCfgShm, pMt->nMotorCount, ecatGetText(dwRetVal), dwRetVal));
+    dwRetVal = MtShmCreate(&pMt->oShm, EC_NULL, (EC_T_DWORD)pMt->nMotorCount, pAppContext->AppParms.dwBusCycleTimeUsec);
+  }
+  if (EC_E_NOERROR != dwRetVal) {
+    EcLogMsg(EC_LOG_LEVEL_ERROR,
+             (pEcLogContext, EC_LOG_LEVEL_ERROR,
+              "ERROR: MtShmCreate() %d axes (Result = %s 0x%x)", pMt->nMotorCount, ecatGetText(dwRetVal), dwRetVal));
+    return dwRetVal;
+  }
+  if (pMt->oShm.bShared) {
+    EcLogMsg(EC_LOG_LEVEL_INFO,
+             (pEcLogContext, EC_LOG_LEVEL_INFO,
+              "Motrotech: process data shared memory %s (%d axes)", pMt->oShm.szName, pMt->nMotorCount));
+  }
 
   return EC_E_NOERROR;
 }
@@ -758,22 +638,28 @@ EC_T_DWORD MT_Setup(T_EC_DEMO_APP_CONTEXT *pAppContext) {
  *是一个经验系数，用来把速度积分成位置；实际工程要用真实单位/插补周期。
  ******************************************************************************/
 /* [2026-01-20] 记录示教限位 */
-EC_T_VOID MT_TeachLimit(EC_T_WORD wAxis, EC_T_BOOL bIsMax) {
-    if (wAxis >= MAX_AXIS_NUM) return;
+EC_T_VOID MT_TeachLimit(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_BOOL bIsMax) {
+    MotorState_ oState;
+    if (!MT_GetMotorState(pMt, wAxis, &oState)) return;
     if (bIsMax) {
-        My_Motor[wAxis].fLimitMax = S_MotorState[wAxis].q_fb;
-        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "Axis %d: TEACH MAX = %d (x1000)\n", wAxis, (EC_T_INT)(My_Motor[wAxis].fLimitMax*1000)));
+        pMt->pMotor[wAxis].fLimitMax = oState.q_fb;
+        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "Axis %d: TEACH MAX = %d (x1000)\n", wAxis, (EC_T_INT)(pMt->pMotor[wAxis].fLimitMax*1000)));
     } else {
-        My_Motor[wAxis].fLimitMin = S_MotorState[wAxis].q_fb;
-        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "Axis %d: TEACH MIN = %d (x1000)\n", wAxis, (EC_T_INT)(My_Motor[wAxis].fLimitMin*1000)));
+        pMt->pMotor[wAxis].fLimitMin = oState.q_fb;
+        EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "Axis %d: TEACH MIN = %d (x1000)\n", wAxis, (EC_T_INT)(pMt->pMotor[wAxis].fLimitMin*1000)));
     }
     // 当两个都设置过且 Min < Max 时，激活保护
-    if (My_Motor[wAxis].fLimitMin < My_Motor[wAxis].fLimitMax) {
-        My_Motor[wAxis].bLimitValid = EC_TRUE;
+    if (pMt->pMotor[wAxis].fLimitMin < pMt->pMotor[wAxis].fLimitMax) {
+        pMt->pMotor[wAxis].bLimitValid = EC_TRUE;
     }
 }
 
 EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
+  /* [2026-10-16] 本实例的轴表（多实例时每个周期线程只碰自己的上下文） */
+  T_MT_CONTEXT* pMt = pAppContext->pMtContext;
+  if (pMt == EC_NULL) {
+    return;
+  }
   /* IncFactor：demo 用于“速度积分成位置”的经验系数（并非严格物理单位）
    * - 这里把总线周期（usec）带进去，得到一个随周期变化的比例因子
    * - 后面用：fCurPos += fCurVel * IncFactor  来生成“目标轨迹位置”（最终写到 0x607A）
@@ -794,6 +680,10 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
    *   - 读 TxPDO，更新 MotorState_[i]
    */
 
+  /* [2026-10-16] 先取入本周期的命令：此后本周期只用 pMt->pMotorCmdCyc，上层/控制器的写入不会混进来 */
+  pMt->qwCycle++;
+  MtLoadMotorCmds(pMt);
+
   /* 【每周期的第一步：根据 MotorCmd_.mode 更新“状态机命令”】
    *
    * demo 约定：
@@ -805,14 +695,14 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
    * - AUTO：自动进入 OP_ENABLED（保持原demo“自动跑”）
    * - MANUAL：按 MotorCmd_.mode 决定 start/shutdown
    */
-  for (EC_T_INT i = 0; i < MotorCount; i++) {
-    if (S_RunMode == MT_RUNMODE_AUTO) {
-      S_ProcessState[i] = COMMAND_START;
+  for (EC_T_INT i = 0; i < pMt->nMotorCount; i++) {
+    if (pMt->eRunMode == MT_RUNMODE_AUTO) {
+      pMt->pProcessState[i] = COMMAND_START;
     } else {
-      if (S_MotorCmdValid[i]) {
-        S_ProcessState[i] = (S_MotorCmd[i].mode == 0) ? COMMAND_SHUTDOWN : COMMAND_START;
+      if (pMt->pbMotorCmdValid[i]) {
+        pMt->pProcessState[i] = (pMt->pMotorCmdCyc[i].mode == 0) ? COMMAND_SHUTDOWN : COMMAND_START;
       }
-      /* 没有效cmd：不改S_ProcessState，维持上一次状态 */
+      /* 没有效cmd：不改pProcessState，维持上一次状态 */
     }
   }
 
@@ -824,85 +714,93 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
    * 只有当 wActState == OP_ENABLED 时，后面的 TargetPosition/Velocity
    * 才会真正驱动电机运动。
    */
-  Process_Commands(pAppContext);
+  Process_Commands(pMt, pAppContext);
 
-  for (EC_T_INT i = 0; i < MotorCount; i++) {
+  /* [2026-10-16] 轴组流式轨迹：状态机之后、按轴逻辑之前推进所有组一个周期
+   * - 就绪 = MANUAL + OP_ENABLED；起点 = 当前设定位置（使能后尚未同步过则取反馈位置）
+   * - 组驱动的轴在下面按轴循环里走最前面的分支
+   */
+  if (pMt->oTraj.dwGroupCnt > 0) {
+    for (EC_T_INT i = 0; i < pMt->nMotorCount; i++) {
+      const My_Motor_Type* pDemoAxis = &pMt->pMotor[i];
+      pMt->oTraj.pbyReady[i] = (EC_T_BYTE)((pMt->eRunMode == MT_RUNMODE_MANUAL) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED));
+      pMt->oTraj.pfAnchorQ[i] = pDemoAxis->bFirstEnable ? pDemoAxis->fCurPos : ((pDemoAxis->pnActPosition) ? (EC_T_LREAL)(*pDemoAxis->pnActPosition) * pDemoAxis->fRadPerCnt : 0.0);
+    }
+    MtTrajCycle(&pMt->oTraj, pMt->fTimeSec);
+  }
+
+  for (EC_T_INT i = 0; i < pMt->nMotorCount; i++) {
     /* pDemoAxis：第 i 个轴的运行时上下文（包含 PDO 指针、状态机状态、轨迹变量等） */
-    My_Motor_Type *pDemoAxis = &My_Motor[i];
-    if (EC_NULL == pDemoAxis)
-      continue;
+    My_Motor_Type *pDemoAxis = &pMt->pMotor[i];
 
-    /* ====== 先读反馈：填充 MotorState_（即使未使能也可读） ====== */
-    MotorState_ st;
-    OsMemset(&st, 0, sizeof(st));
-    if (pDemoAxis->pwStatusWord) {
-      st.motorstate = (EC_T_DWORD)EC_GETWORD(pDemoAxis->pwStatusWord);
-    }
-    if (pDemoAxis->pbyModeOfOperation) {
-      // 0x6061 运行模式显示 (虽然指针名为 pbyModeOfOperation 但在映射时我们通常也映射了 0x6061)
-      // 注意：这里假设 pbyModeOfOperation 指向的是 0x6061，如果 ENI 只映射了 0x6060 则读不到真实模式
-      st.mode = *pDemoAxis->pbyModeOfOperation; 
-    }
-    if (pDemoAxis->pnActPosition) {
-      /* [2026-01-19] 作用：把 0x6064(ActualPosition, int32 PUU) 换算成 rad 回填 */
-      st.q_fb = (EC_T_REAL)((EC_T_LREAL)(*pDemoAxis->pnActPosition) * pDemoAxis->fRadPerCnt);
-    }
-    if (pDemoAxis->pnActVelocity) {
-      /* [2026-01-19] 作用：把 0x606C(ActualVelocity, int32 PUU/s) 换算成 rad/s 回填 */
-      st.dq_fb = (EC_T_REAL)((EC_T_LREAL)(*pDemoAxis->pnActVelocity) * pDemoAxis->fRadPerCnt);
-    }
-    st.ddq_fb = 0.0f; /* 文档：不支持，需由 dq_fb 差分计算 */
-    
+    /* ====== 先读反馈：填充 MotorState_（即使未使能也可读） ======
+     * 直接按字段填（所有成员都赋值）：先 memset 局部变量再整体拷贝会触发 store-forwarding 停顿
+     */
+    MotorState_* pSt = &pMt->pMotorState[i];
+    pSt->motorstate = (pDemoAxis->pwStatusWord) ? (EC_T_DWORD)EC_GETWORD(pDemoAxis->pwStatusWord) : 0;
+    // 0x6061 运行模式显示 (虽然指针名为 pbyModeOfOperation 但在映射时我们通常也映射了 0x6061)
+    // 注意：这里假设 pbyModeOfOperation 指向的是 0x6061，如果 ENI 只映射了 0x6060 则读不到真实模式
+    pSt->mode = (pDemoAxis->pbyModeOfOperation) ? *pDemoAxis->pbyModeOfOperation : 0;
+    /* [2026-01-19] 作用：0x6064/0x606C(int32 PUU) 换算成 rad、rad/s 回填 */
+    pSt->q_fb = (pDemoAxis->pnActPosition) ? (EC_T_REAL)((EC_T_LREAL)(*pDemoAxis->pnActPosition) * pDemoAxis->fRadPerCnt) : 0.0f;
+    pSt->dq_fb = (pDemoAxis->pnActVelocity) ? (EC_T_REAL)((EC_T_LREAL)(*pDemoAxis->pnActVelocity) * pDemoAxis->fRadPerCnt) : 0.0f;
+    pSt->ddq_fb = 0.0f; /* 文档：不支持，需由 dq_fb 差分计算 */
     /* [2026-01-19] 目的：0x6077 实际扭矩 -> N.m (按 0.1% 换算) */
-    if (pDemoAxis->pwActTorque) {
-      st.tau_fb = (EC_T_REAL)(EC_T_SWORD)EC_GETWORD(pDemoAxis->pwActTorque) * 0.001f; 
-    }
-    
+    pSt->tau_fb = (pDemoAxis->pwActTorque) ? (EC_T_REAL)(EC_T_SWORD)EC_GETWORD(pDemoAxis->pwActTorque) * 0.001f : 0.0f;
     /* 温度/电压：只有 ENI 映射了相应对象，指针才会非空 */
-    st.temperature[0] = (pDemoAxis->psTempMcu) ? (*pDemoAxis->psTempMcu) : 0;
-    st.temperature[1] = (pDemoAxis->psTempMotor) ? (*pDemoAxis->psTempMotor) : 0;
-    if (pDemoAxis->pwDcLinkVoltage) {
-      st.vol = (EC_T_REAL)(*pDemoAxis->pwDcLinkVoltage) * 0.1f; // 0.1V 转换
-    }
-    st.sensor[0] = 0;
-    st.sensor[1] = 0;
-    S_MotorState[i] = st;
+    pSt->temperature[0] = (pDemoAxis->psTempMcu) ? (*pDemoAxis->psTempMcu) : 0;
+    pSt->temperature[1] = (pDemoAxis->psTempMotor) ? (*pDemoAxis->psTempMotor) : 0;
+    pSt->vol = (pDemoAxis->pwDcLinkVoltage) ? (EC_T_REAL)(*pDemoAxis->pwDcLinkVoltage) * 0.1f : 0.0f; // 0.1V 转换
+    pSt->sensor[0] = 0;
+    pSt->sensor[1] = 0;
 
     /* Mode of Operation（0x6060）
      * - demo 默认在 MT_Init 中设为 CSP（8）
      * - 如果 0x6060 被映射到 PDO，就在这里每周期刷新一次（很多驱动允许）
+     * - 下面的手动/老化分支可能在同一周期覆盖为别的模式，最后一次写入生效
      */
-    if (EC_NULL != pDemoAxis->pbyModeOfOperation) {
-      /* 写 0x6060 Modes of operation（PDO 映射存在时才可写）
-       * - demo 默认写 CSP(8)
-       * - 如果你们用自定义模式/自定义对象，这里通常会改成写你们的 mode
-       */
-      EC_SETBITS(pDemoAxis->pbyModeOfOperation,
-                 (EC_T_BYTE *)&pDemoAxis->eModesOfOperation, 0, 8);
+    if (pDemoAxis->pbyModeOfOperation != EC_NULL) {
+      *pDemoAxis->pbyModeOfOperation = (EC_T_BYTE)pDemoAxis->eModesOfOperation;
     }
+
     /* 只有在 OP_ENABLED（已使能）时才生成运动命令，否则进行“对齐初始化”：
      * - 先让 TargetPosition = ActualPosition
      * - 避免从站刚使能时出现“目标突变”，导致猛冲/报错
      */
     /* 如果上层提供了 MotorCmd_，则优先使用“手动目标”；否则继续使用 demo 自带往复轨迹 */
-    const EC_T_BOOL bHaveCmd = (i < MAX_AXIS_NUM) ? S_MotorCmdValid[i] : EC_FALSE;
+    const EC_T_BOOL bHaveCmd = pMt->pbMotorCmdValid[i];
     MotorCmd_ cmd;
     OsMemset(&cmd, 0, sizeof(cmd));
     if (bHaveCmd) {
-      cmd = S_MotorCmd[i];
+      cmd = pMt->pMotorCmdCyc[i];
     }
     /* [2026-01-19] 优化：手动模式下增加平滑移动逻辑，防止突跳并实现到达即停 */
-    static EC_T_BOOL bFirstEnable[MAX_AXIS_NUM] = { EC_FALSE };
     if (pDemoAxis->wActState != DRV_DEV_STATE_OP_ENABLED) {
-        bFirstEnable[i] = EC_FALSE; // 未使能时，重置同步标记
+        pDemoAxis->bFirstEnable = EC_FALSE; // 未使能时，重置同步标记
     }
 
-    /* [2026-01-20] 老化测试逻辑：当 mode == 99 时进入自动往复 */
-    static EC_T_INT nDirection[MAX_AXIS_NUM] = { 1 }; // 1: 正向, -1: 反向
-    if ((S_RunMode == MT_RUNMODE_MANUAL) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED) && bHaveCmd && (cmd.mode == 99)) {
-      if (!bFirstEnable[i]) {
-          pDemoAxis->fCurPos = S_MotorState[i].q_fb; 
-          bFirstEnable[i] = EC_TRUE;
+    /* [2026-10-16] 轴组流式轨迹：组驱动的轴（RUN/STOP/HOLD）忽略 MotorCmd_，CSP 写插补位置，速度作前馈 */
+    if ((pMt->eRunMode == MT_RUNMODE_MANUAL) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED) && MtTrajOwns(&pMt->oTraj, (EC_T_DWORD)i)) {
+      pDemoAxis->fCurPos = pMt->oTraj.pfQ[i];
+      pDemoAxis->bFirstEnable = EC_TRUE;
+      if (pDemoAxis->pnTargetPosition != EC_NULL) {
+        EC_SETDWORD(pDemoAxis->pnTargetPosition, MtSatToInt32(pMt->oTraj.pfQ[i] * pDemoAxis->fCntPerRad));
+      }
+      if (pDemoAxis->pnVelocityOffset != EC_NULL) {
+        EC_SETDWORD(pDemoAxis->pnVelocityOffset, MtSatToInt32(pMt->oTraj.pfDq[i] * pDemoAxis->fCntPerRad));
+      }
+      if (pDemoAxis->pwTorqueOffset != EC_NULL) {
+        EC_SETWORD(pDemoAxis->pwTorqueOffset, 0);
+      }
+      if (pDemoAxis->pbyModeOfOperation != EC_NULL) {
+        *pDemoAxis->pbyModeOfOperation = DRV_MODE_OP_CSP;
+      }
+    }
+    /* [2026-01-20] 老化测试逻辑：当 mode == 99 时进入自动往复（方向 pDemoAxis->nDirection，1: 正向, -1: 反向） */
+    else if ((pMt->eRunMode == MT_RUNMODE_MANUAL) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED) && bHaveCmd && (cmd.mode == 99)) {
+      if (!pDemoAxis->bFirstEnable) {
+          pDemoAxis->fCurPos = pSt->q_fb;
+          pDemoAxis->bFirstEnable = EC_TRUE;
       }
 
       // 如果已经示教过，则使用示教限位；否则使用 cmd 传进来的范围
@@ -916,43 +814,43 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
           fMaxLimit = fRange;
       }
 
-      EC_T_LREAL fMaxVel = (cmd.dq > 0) ? (EC_T_LREAL)cmd.dq : 1.0; 
-      EC_T_LREAL fMaxStep = fMaxVel * fTimeSec;
+      EC_T_LREAL fMaxVel = (cmd.dq > 0) ? (EC_T_LREAL)cmd.dq : 1.0;
+      EC_T_LREAL fMaxStep = fMaxVel * pMt->fTimeSec;
 
       // 自动切换方向
       if (pDemoAxis->fCurPos >= fMaxLimit) {
-          nDirection[i] = -1;
+          pDemoAxis->nDirection = -1;
       } else if (pDemoAxis->fCurPos <= fMinLimit) {
-          nDirection[i] = 1;
+          pDemoAxis->nDirection = 1;
       }
 
-      pDemoAxis->fCurPos += (nDirection[i] * fMaxStep);
+      pDemoAxis->fCurPos += (pDemoAxis->nDirection * fMaxStep);
 
       // [修复] 将计算出的老化位置写入电机 PDO (0x607A)
+      const EC_T_LREAL q_cnt = pDemoAxis->fCurPos * pDemoAxis->fCntPerRad;
       if (pDemoAxis->pnTargetPosition != EC_NULL) {
-        const EC_T_LREAL q_cnt = pDemoAxis->fCurPos * pDemoAxis->fCntPerRad;
         EC_SETDWORD(pDemoAxis->pnTargetPosition, MtSatToInt32(q_cnt));
       }
       if (pDemoAxis->pbyModeOfOperation != EC_NULL) {
         *pDemoAxis->pbyModeOfOperation = 8; // 告诉驱动器继续跑在位置模式
       }
     }
-    else if ((S_RunMode == MT_RUNMODE_MANUAL) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED) && bHaveCmd && (cmd.mode != 0)) {
-      
+    else if ((pMt->eRunMode == MT_RUNMODE_MANUAL) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED) && bHaveCmd && (cmd.mode != 0)) {
+
       /* [新增] 同步初始位置：如果刚进入使能状态，将当前反馈位置作为平滑移动的起点 */
-      if (!bFirstEnable[i]) {
-          pDemoAxis->fCurPos = S_MotorState[i].q_fb; 
-          bFirstEnable[i] = EC_TRUE;
+      if (!pDemoAxis->bFirstEnable) {
+          pDemoAxis->fCurPos = pSt->q_fb;
+          pDemoAxis->bFirstEnable = EC_TRUE;
           EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "Axis %d: Position Synchronized to %d (x1000)\n", i, (EC_T_INT)(pDemoAxis->fCurPos*1000)));
       }
 
       // 1. 获取目标位置 (rad)
       EC_T_LREAL fTargetQ = (EC_T_LREAL)cmd.q;
       // 2. 获取设定的最大速度 (rad/s)，如果没有设置 dq，默认给一个安全速度（如 1.0 rad/s）
-      EC_T_LREAL fMaxVel = (cmd.dq > 0) ? (EC_T_LREAL)cmd.dq : 1.0; 
-      
+      EC_T_LREAL fMaxVel = (cmd.dq > 0) ? (EC_T_LREAL)cmd.dq : 1.0;
+
       // 3. 计算本周期允许移动的最大位移 (rad) = 速度 * 周期
-      EC_T_LREAL fMaxStep = fMaxVel * fTimeSec;
+      EC_T_LREAL fMaxStep = fMaxVel * pMt->fTimeSec;
 
       // 4. 平滑更新当前内部位置 fCurPos
       EC_T_LREAL fDiff = fTargetQ - pDemoAxis->fCurPos;
@@ -965,28 +863,27 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       }
 
       // 5. 将平滑后的位置写入 PDO (0x607A)
+      const EC_T_LREAL q_cnt = pDemoAxis->fCurPos * pDemoAxis->fCntPerRad;
       if (pDemoAxis->pnTargetPosition != EC_NULL) {
-        const EC_T_LREAL q_cnt = pDemoAxis->fCurPos * pDemoAxis->fCntPerRad;
         EC_SETDWORD(pDemoAxis->pnTargetPosition, MtSatToInt32(q_cnt));
       }
-      
+
       // 6. 速度偏移 (0x60B1) - 手动模式下通常作为辅助
+      const EC_T_LREAL dq_cnt = (EC_T_LREAL)cmd.dq * pDemoAxis->fCntPerRad;
       if (pDemoAxis->pnVelocityOffset != EC_NULL) {
-        const EC_T_LREAL dq_cnt = (EC_T_LREAL)cmd.dq * pDemoAxis->fCntPerRad;
         EC_SETDWORD(pDemoAxis->pnVelocityOffset, MtSatToInt32(dq_cnt));
       }
-      
+
       // 7. 扭矩偏移 (0x60B2)
       if (pDemoAxis->pwTorqueOffset != EC_NULL) {
-        const EC_T_SWORD tau_raw = (EC_T_SWORD)(cmd.tau * 1000.0f);
-        EC_SETWORD(pDemoAxis->pwTorqueOffset, tau_raw);
+        EC_SETWORD(pDemoAxis->pwTorqueOffset, (EC_T_WORD)(EC_T_SWORD)(cmd.tau * 1000.0f));
       }
-      
+
       // 8. 模式下发 0x6060
       if (pDemoAxis->pbyModeOfOperation != EC_NULL) {
         *pDemoAxis->pbyModeOfOperation = cmd.mode;
       }
-    } else if ((S_RunMode == MT_RUNMODE_AUTO) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED)) {
+    } else if ((pMt->eRunMode == MT_RUNMODE_AUTO) && (pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED)) {
       /* 只有在 Operation Enabled 时，驱动才会执行你写入的目标（否则多半被忽略/限幅） */
       /* 这里的 fCurPos/fCurVel 是 demo 内部单位，最终会换算成驱动对象的单位：
        * - TargetPosition 写入的是 int32（EC_T_INT），通常对应编码器计数/脉冲
@@ -1007,7 +904,7 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       switch (pDemoAxis->eMovingStat) {
       case MOVE_STAT_POS_ACC:
         /* 正向加速阶段：速度逐步增加到 +MAX_VEL */
-        pDemoAxis->fCurVel += fTimeSec * ACC_DEC;
+        pDemoAxis->fCurVel += pMt->fTimeSec * ACC_DEC;
         if (pDemoAxis->fCurVel >= MAX_VEL) {
           pDemoAxis->eMovingStat = MOVE_STAT_POS_CON;
         }
@@ -1015,21 +912,21 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       case MOVE_STAT_POS_CON:
         /* 正向匀速阶段：保持 +MAX_VEL 一段时间（用 dwConRunCnt 计数） */
         pDemoAxis->fCurVel = MAX_VEL;
-        if (pDemoAxis->dwConRunCnt++ > CONRUNSEC / fTimeSec) {
+        if (pDemoAxis->dwConRunCnt++ > CONRUNSEC / pMt->fTimeSec) {
           pDemoAxis->dwConRunCnt = 0;
           pDemoAxis->eMovingStat = MOVE_STAT_POS_DEC;
         }
         break;
       case MOVE_STAT_POS_DEC:
         /* 正向减速阶段：速度逐步减到 0，随后切到反向加速 */
-        pDemoAxis->fCurVel -= fTimeSec * ACC_DEC;
+        pDemoAxis->fCurVel -= pMt->fTimeSec * ACC_DEC;
         if (pDemoAxis->fCurVel <= 0) {
           pDemoAxis->eMovingStat = MOVE_STAT_NEG_ACC;
         }
         break;
       case MOVE_STAT_NEG_ACC:
         /* 反向加速阶段：速度逐步降低到 -MAX_VEL */
-        pDemoAxis->fCurVel -= fTimeSec * ACC_DEC;
+        pDemoAxis->fCurVel -= pMt->fTimeSec * ACC_DEC;
         if (pDemoAxis->fCurVel <= -MAX_VEL) {
           pDemoAxis->eMovingStat = MOVE_STAT_NEG_CON;
         }
@@ -1037,14 +934,14 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       case MOVE_STAT_NEG_CON:
         /* 反向匀速阶段：保持 -MAX_VEL 一段时间 */
         pDemoAxis->fCurVel = -MAX_VEL;
-        if (pDemoAxis->dwConRunCnt++ > CONRUNSEC / fTimeSec) {
+        if (pDemoAxis->dwConRunCnt++ > CONRUNSEC / pMt->fTimeSec) {
           pDemoAxis->dwConRunCnt = 0;
           pDemoAxis->eMovingStat = MOVE_STAT_NEG_DEC;
         }
         break;
       case MOVE_STAT_NEG_DEC:
         /* 反向减速阶段：速度逐步回到 0，随后切回正向加速 */
-        pDemoAxis->fCurVel += fTimeSec * ACC_DEC;
+        pDemoAxis->fCurVel += pMt->fTimeSec * ACC_DEC;
         if (pDemoAxis->fCurVel >= 0) {
           pDemoAxis->eMovingStat = MOVE_STAT_POS_ACC;
         }
@@ -1058,34 +955,28 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       }
 
       /* 位置积分：pos += vel * dt
-       * 注意：这里 dt 没有直接用 fTimeSec，而是用一个经验系数 IncFactor。
+       * 注意：这里 dt 没有直接用 pMt->fTimeSec，而是用一个经验系数 IncFactor。
        * 真实工程里建议明确单位：pos[count] += vel[count/s] * dt[s]。
        */
       pDemoAxis->fCurPos += pDemoAxis->fCurVel * IncFactor;
 
-      /* 写入 PDO：TargetPosition / TargetVelocity /
-       * TargetTorque（如果对应对象已映射） 写入之后并不会立刻到达从站：
+      /* 写入 PDO：TargetPosition / TargetVelocity（如果对应对象已映射）
+       * 写入之后并不会立刻到达从站：
        * - 真正发送发生在 EcMasterJobTask 的 eUsrJob_SendAllCycFrames
        */
+      /* 写 0x607A TargetPosition（int32）：这里写的是“目标”，不是“实际位置” */
       if (pDemoAxis->pnTargetPosition != EC_NULL) {
-        /* 写 0x607A TargetPosition（int32）
-         * - 注意：这里写的是“目标”，不是“实际位置”
-         * - EC_SETDWORD：SDK 封装的 32bit 写入（包含必要的对齐/字节序处理）
-         */
         EC_SETDWORD(pDemoAxis->pnTargetPosition, (EC_T_INT)lPosTmp);
       }
+      /* 写 0x60FF TargetVelocity（int32，单位取决于从站定义） */
       if (pDemoAxis->pnTargetVelocity != EC_NULL) {
-        /* 写 0x60FF TargetVelocity（int32，单位取决于从站定义） */
-        EC_SETDWORD(pDemoAxis->pnTargetVelocity,
-                    (EC_T_INT)(pDemoAxis->fCurVel * INC_PERMM));
+        EC_SETDWORD(pDemoAxis->pnTargetVelocity, (EC_T_INT)(pDemoAxis->fCurVel * INC_PERMM));
       }
       /* demo 原本会写死 0x6071 TargetTorque=200；为了避免误触发扭矩指令，这里不再周期写入。 */
-    } else if ((S_RunMode == MT_RUNMODE_MANUAL) &&(pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED)) {
+    } else if ((pMt->eRunMode == MT_RUNMODE_MANUAL) &&(pDemoAxis->wActState == DRV_DEV_STATE_OP_ENABLED)) {
       /* [2026-01-14] 目的：手动模式但没有有效cmd时，保持不动（目标贴住实际 + 速度清零） */
-      if (pDemoAxis->pnActPosition != EC_NULL) {
-        if (pDemoAxis->pnTargetPosition != EC_NULL) {
-          EC_SETDWORD(pDemoAxis->pnTargetPosition, *pDemoAxis->pnActPosition);
-        }
+      if ((pDemoAxis->pnActPosition != EC_NULL) && (pDemoAxis->pnTargetPosition != EC_NULL)) {
+        EC_SETDWORD(pDemoAxis->pnTargetPosition, *pDemoAxis->pnActPosition);
       }
       if (pDemoAxis->pnTargetVelocity != EC_NULL) {
         EC_SETDWORD(pDemoAxis->pnTargetVelocity, 0);
@@ -1093,12 +984,9 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       pDemoAxis->fCurVel = 0;
     } else {
       /* 未使能时：把内部状态对齐到实际位置，避免一使能就跳变 */
-      // ... 保持你原来的 else 内容 ...
-      /* 未使能时：把内部状态对齐到实际位置，避免一使能就跳变 */
-      /* 注意：这里默认 pnActPosition 已映射；若未映射会解引用空指针（工程化要加保护）
-       * 实际工程建议：
-       *   if (pnActPosition && pnTargetPosition) { ... } else { 报错/降级 }
-       */
+      if (pDemoAxis->pnActPosition == EC_NULL) {
+        continue; /* [2026-10-16] 绑定表可能不含 0x6064，未映射时跳过 */
+      }
       pDemoAxis->fCurPos = (EC_T_LREAL)(*pDemoAxis->pnActPosition) / INC_PERMM;
       pDemoAxis->fCurVel = 0;
       if (pDemoAxis->pnTargetPosition != EC_NULL) {
@@ -1107,85 +995,414 @@ EC_T_VOID MT_Workpd(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       }
     }
   } /* loop through axis list */
+
+  /* [2026-10-16] 整体发布本周期状态并唤醒外部控制器：它在下一周期开始前发布的命令下一周期生效 */
+  {
+    struct timespec oNow;
+    clock_gettime(CLOCK_MONOTONIC, &oNow);
+    MtShmPublish(&pMt->oShm, pMt->qwCycle, (EC_T_UINT64)oNow.tv_sec * 1000000000ULL + (EC_T_UINT64)oNow.tv_nsec, pMt->pMotorState);
+  }
 }
 
 /* [2026-01-14] 目的：设置运行模式（0自动/1手动） */
-EC_T_VOID MT_SetRunMode(MT_RUN_MODE eMode)
+EC_T_VOID MT_SetRunMode(T_MT_CONTEXT* pMt, MT_RUN_MODE eMode)
 {
-  S_RunMode = eMode;
+  pMt->eRunMode = eMode;
 }
 
 /* [2026-01-14] 目的：获取运行模式 */
-MT_RUN_MODE MT_GetRunMode(EC_T_VOID)
+MT_RUN_MODE MT_GetRunMode(T_MT_CONTEXT* pMt)
+{
+  return pMt->eRunMode;
+}
+
+/* [2026-10-16] 目的：轴组流式轨迹的上层接口（规划线程调用，语义见 motrotech_traj.h） */
+EC_T_DWORD MT_TrajGetGroupCnt(T_MT_CONTEXT* pMt)
+{
+  return pMt->oTraj.dwGroupCnt;
+}
+
+EC_T_DWORD MT_TrajPush(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup, const EC_T_LREAL* pfTime, const EC_T_REAL* pfQ, const EC_T_REAL* pfDq,
+                       EC_T_DWORD dwCnt, EC_T_BOOL bLast, EC_T_DWORD* pdwAccepted)
+{
+  return MtTrajPush(&pMt->oTraj, dwGroup, pfTime, pfQ, pfDq, dwCnt, bLast, pdwAccepted);
+}
+
+EC_T_DWORD MT_TrajStop(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup)
+{
+  return MtTrajStop(&pMt->oTraj, dwGroup);
+}
+
+EC_T_DWORD MT_TrajReset(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup)
+{
+  return MtTrajReset(&pMt->oTraj, dwGroup);
+}
+
+EC_T_DWORD MT_TrajRelease(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup)
+{
+  return MtTrajRelease(&pMt->oTraj, dwGroup);
+}
+
+EC_T_DWORD MT_TrajGetStatus(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup, T_MT_TRAJ_STATUS* pStatus)
+{
+  return MtTrajGetStatus(&pMt->oTraj, dwGroup, pStatus);
+}
+
+/* [2026-10-16] 目的：kp/kd 下标 -> 驱动对象（0x3500/0x3501） */
+static const EC_T_WORD S_awGainIndex[MT_GAIN_CNT] = { DRV_OBJ_POSITION_KP, DRV_OBJ_POSITION_KD };
+
+/* [2026-10-16] 目的：处理一次 kp/kd 下发的结果（只在 MT_ServiceGains() 里调用）
+ * - 成功：记为从站已确认的值
+ * - 失败：要求值保持不变，MT_GAIN_RETRY_MSEC 之后重试；同一错误连续出现只打一次日志
+ */
+static EC_T_VOID MtGainResult(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_INT nGain, EC_T_DWORD dwResult)
 {
-  return S_RunMode;
+  T_MT_GAIN* pGain = &pMt->pGain[wAxis];
+  EC_T_WORD  wIndex = S_awGainIndex[nGain];
+
+  if (dwResult == EC_E_NOERROR) {
+    pGain->afApplied[nGain] = pGain->afSent[nGain];
+    pGain->adwLastErr[nGain] = EC_E_NOERROR;
+    EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO,
+        "SDO Write %s(0x%04X) to axis %d (instance %d) OK\n", (nGain == MT_GAIN_KP) ? "KP" : "KD", wIndex, wAxis, (EC_T_INT)pMt->dwInstanceId));
+    return;
+  }
+  if (dwResult != pGain->adwLastErr[nGain]) {
+    EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR,
+        "SDO Write %s(0x%04X) failed for axis %d (instance %d, station %d): %s(0x%x), will retry\n",
+        (nGain == MT_GAIN_KP) ? "KP" : "KD", wIndex, wAxis, (EC_T_INT)pMt->dwInstanceId, pMt->pMotor[wAxis].wStationAddress,
+        ecatGetText(dwResult), dwResult));
+  }
+  pGain->adwLastErr[nGain] = dwResult;
+  pGain->adwRetryMsec[nGain] = OsQueryMsecCount() + MT_GAIN_RETRY_MSEC;
 }
 
-/* 上层写入每轴 MotorCmd_（demo 级：无锁，直接覆盖） */
-EC_T_VOID MT_SetMotorCmd(EC_T_WORD wAxis, const MotorCmd_* pCmd)
+/* [2026-10-16] 目的：周期开始取入本周期的命令（只在周期线程，MT_Workpd() 开头调用）
+ * - MT_SetMotorCmd()：按轴 seqlock 读，写入中或读的过程中被改写的轴本周期不取（下周期再取），
+ *   没有新写入的轴沿用上次的命令
+ * - MT_SetAxisUnitScale()：换算系数有变化的轴在此更新 fCntPerRad/fRadPerCnt
+ * - 控制器（共享内存）：取最新发布的一块，标了有效的轴覆盖上面的结果；
+ *   kp/kd 有变化时只记到 pGain[].afReq（不加锁、不打日志），由 MT_ServiceGains() 在非周期线程下发
+ */
+static EC_T_VOID MtLoadMotorCmds(T_MT_CONTEXT* pMt)
 {
-  if ((pCmd == EC_NULL) || (wAxis >= MAX_AXIS_NUM)) {
+  const T_MT_SHM_CMD_BLK* pBlk = EC_NULL;
+  const EC_T_BYTE*        pbyValid = EC_NULL;
+  const MotorCmd_*        pShmCmd = EC_NULL;
+  MotorCmd_               oCmd;
+  EC_T_DWORD              dwSeq = 0;
+  EC_T_LREAL              fCntPerRad = 0.0;
+
+  for (EC_T_INT i = 0; i < pMt->nMotorCount; i++) {
+    __atomic_load(&pMt->pMotor[i].fCntPerRadReq, &fCntPerRad, __ATOMIC_RELAXED);
+    if (fCntPerRad != pMt->pMotor[i].fCntPerRad) {
+      pMt->pMotor[i].fCntPerRad = fCntPerRad;
+      pMt->pMotor[i].fRadPerCnt = 1.0 / fCntPerRad;
+    }
+
+    dwSeq = __atomic_load_n(&pMt->pdwCmdSeq[i], __ATOMIC_ACQUIRE);
+    if ((dwSeq & 1) || (dwSeq == pMt->pdwCmdSeen[i])) {
+      continue;
+    }
+    oCmd = pMt->pMotorCmd[i];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&pMt->pdwCmdSeq[i], __ATOMIC_RELAXED) != dwSeq) {
+      continue;
+    }
+    pMt->pdwCmdSeen[i] = dwSeq;
+    pMt->pMotorCmdCyc[i] = oCmd;
+    pMt->pbMotorCmdValid[i] = EC_TRUE;
+  }
+
+  pBlk = MtShmTakeCmd(&pMt->oShm, pMt->qwCycle, &pbyValid, &pShmCmd);
+  if ((pBlk == EC_NULL) || (pMt->oShm.dwAxisCnt != (EC_T_DWORD)pMt->nMotorCount)) {
     return;
   }
+  for (EC_T_INT i = 0; i < pMt->nMotorCount; i++) {
+    if (pbyValid[i] == 0) {
+      continue;
+    }
+    oCmd = pShmCmd[i];
+    if (oCmd.kp != pMt->pMotorCmdCyc[i].kp) {
+      __atomic_store(&pMt->pGain[i].afReq[MT_GAIN_KP], &oCmd.kp, __ATOMIC_RELAXED);
+    }
+    if (oCmd.kd != pMt->pMotorCmdCyc[i].kd) {
+      __atomic_store(&pMt->pGain[i].afReq[MT_GAIN_KD], &oCmd.kd, __ATOMIC_RELAXED);
+    }
+    pMt->pMotorCmdCyc[i] = oCmd;
+    pMt->pbMotorCmdValid[i] = EC_TRUE;
+  }
+}
 
-  /* [2026-01-19] 目的：处理 kp (0x3500) 和 kd (0x3501) 的 SDO 异步下发
+/* 上层写入每轴 MotorCmd_
+ * [2026-10-16] 修改：按轴 seqlock 写（CAS 抢到奇数序号即独占），周期线程不会取到写了一半的命令；
+ * kp/kd 有变化时记到 pGain[].afReq，放开序号之后调用 MT_ServiceGains() 下发（失败的由后续调用重试）
+ */
+EC_T_VOID MT_SetMotorCmd(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, const MotorCmd_* pCmd)
+{
+  EC_T_DWORD dwSeq = 0;
+
+  if ((pMt == EC_NULL) || (pCmd == EC_NULL) || (wAxis >= pMt->dwAxisCap)) {
+    return;
+  }
+
+  do {
+    dwSeq = __atomic_load_n(&pMt->pdwCmdSeq[wAxis], __ATOMIC_RELAXED);
+  } while ((dwSeq & 1)
+           || !__atomic_compare_exchange_n(&pMt->pdwCmdSeq[wAxis], &dwSeq, dwSeq + 1, EC_FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  /* [2026-01-19] 目的：处理 kp (0x3500) 和 kd (0x3501) 的 SDO 下发
    * 说明：由于这两个字段是配置类参数，且不支持 PDO 映射，因此需要通过 CoE SDO 下载。
-   * 此函数由交互线程（CmdThread）调用，SDO 写入是阻塞的，但不会影响主控制周期的实时性。
+   * [2026-10-16] 修改：只记录要求值，由 MT_ServiceGains() 下发，从站确认之前不算生效。
    */
-  EC_T_DWORD dwSlaveId = ecatGetSlaveId(My_Motor[wAxis].wStationAddress);
+  if (pCmd->kp != pMt->pMotorCmd[wAxis].kp) {
+    __atomic_store(&pMt->pGain[wAxis].afReq[MT_GAIN_KP], &pCmd->kp, __ATOMIC_RELAXED);
+  }
+  if (pCmd->kd != pMt->pMotorCmd[wAxis].kd) {
+    __atomic_store(&pMt->pGain[wAxis].afReq[MT_GAIN_KD], &pCmd->kd, __ATOMIC_RELAXED);
+  }
+  pMt->pMotorCmd[wAxis] = *pCmd;
 
-  // 1. 处理 KP 变更
-  if (pCmd->kp != S_MotorCmd[wAxis].kp) {
-      EC_T_REAL fVal = pCmd->kp;
-      // 下载到索引 0x3500, 子索引 0
-      EC_T_DWORD dwRes = ecatCoeSdoDownload(dwSlaveId, 0x3500, 0, (EC_T_BYTE*)&fVal, sizeof(EC_T_REAL), 1000, 0);
-      if (dwRes != EC_E_NOERROR) {
-          EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, 
-              "SDO Write KP(0x3500) failed for axis %d: %s(0x%x)\n", wAxis, ecatGetText(dwRes), dwRes));
-      } else {
-          /* [2026-01-19] 修正：由于 EcLogMsg 可能不支持浮点格式化，改为打印 10 倍整数 */
-          EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "SDO Write KP=%d (x10) to axis %d OK\n", (EC_T_INT)(fVal*10), wAxis));
-      }
+  __atomic_store_n(&pMt->pdwCmdSeq[wAxis], dwSeq + 2, __ATOMIC_RELEASE);
+
+  MT_ServiceGains(pMt);
+}
+
+/* [2026-10-16] 目的：kp/kd 下发（见 motrotech.h），只在非周期线程调用
+ * - 每个对象同时只有一个请求在途（pGain[].aoSdo），完成后才比较/下发下一个值
+ * - 流水线运行时 SdoDownload 入队即返回；未运行时在这里阻塞到往返结束，返回时 handle 已完成
+ */
+EC_T_VOID MT_ServiceGains(T_MT_CONTEXT* pMt)
+{
+  T_EC_DEMO_APP_CONTEXT* pAppContext = EC_NULL;
+  T_MT_GAIN*             pGain = EC_NULL;
+  EC_T_DWORD             dwIdle = 0;
+  EC_T_DWORD             dwRes = EC_E_NOERROR;
+  EC_T_REAL              fReq = 0.0f;
+
+  if ((pMt == EC_NULL) || (pMt->pGain == EC_NULL)) {
+    return;
+  }
+  pAppContext = pMt->pAppContext;
+  if ((pAppContext == EC_NULL) || (pAppContext->pMasterAccess == EC_NULL)) {
+    return;
+  }
+  if (!__atomic_compare_exchange_n(&pMt->dwGainSvc, &dwIdle, 1, EC_FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    return;
   }
 
-  // 2. 处理 KD 变更
-  if (pCmd->kd != S_MotorCmd[wAxis].kd) {
-      EC_T_REAL fVal = pCmd->kd;
-      // 下载到索引 0x3501, 子索引 0
-      EC_T_DWORD dwRes = ecatCoeSdoDownload(dwSlaveId, 0x3501, 0, (EC_T_BYTE*)&fVal, sizeof(EC_T_REAL), 1000, 0);
+  for (EC_T_INT i = 0; i < pMt->nMotorCount; i++) {
+    pGain = &pMt->pGain[i];
+    for (EC_T_INT k = 0; k < MT_GAIN_CNT; k++) {
+      if (pGain->abBusy[k]) {
+        if (!SDO_PIPE_HANDLE_DONE(&pGain->aoSdo[k])) {
+          continue;
+        }
+        pGain->abBusy[k] = EC_FALSE;
+        MtGainResult(pMt, (EC_T_WORD)i, k, pGain->aoSdo[k].dwResult);
+      }
+      __atomic_load(&pGain->afReq[k], &fReq, __ATOMIC_RELAXED);
+      if ((fReq == pGain->afApplied[k])
+          || ((pGain->adwLastErr[k] != EC_E_NOERROR) && ((EC_T_INT)(OsQueryMsecCount() - pGain->adwRetryMsec[k]) < 0))) {
+        continue;
+      }
+
+      /* [2026-01-19] 修正：由于 EcLogMsg 可能不支持浮点格式化，改为打印 10 倍整数 */
+      EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "SDO queue 0x%04X=%d (x10) to axis %d\n",
+          S_awGainIndex[k], (EC_T_INT)(fReq*10), i));
+      pGain->afSent[k] = fReq;
+      pGain->aoSdo[k].bDone = EC_FALSE;
+      pGain->abBusy[k] = EC_TRUE;
+      dwRes = pAppContext->pMasterAccess->SdoDownload(pMt->pMotor[i].wStationAddress, S_awGainIndex[k], 0,
+                                                      (const EC_T_BYTE*)&pGain->afSent[k], sizeof(EC_T_REAL), &pGain->aoSdo[k]);
       if (dwRes != EC_E_NOERROR) {
-          EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, 
-              "SDO Write KD(0x3501) failed for axis %d: %s(0x%x)\n", wAxis, ecatGetText(dwRes), dwRes));
-      } else {
-          /* [2026-01-19] 修正：由于 EcLogMsg 可能不支持浮点格式化，改为打印 10 倍整数 */
-          EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO, "SDO Write KD=%d (x10) to axis %d OK\n", (EC_T_INT)(fVal*10), wAxis));
+        /* 未受理（如流水线队列满）：不会完成 handle，按失败处理 */
+        pGain->abBusy[k] = EC_FALSE;
+        MtGainResult(pMt, (EC_T_WORD)i, k, dwRes);
+      } else if (SDO_PIPE_HANDLE_DONE(&pGain->aoSdo[k])) {
+        /* 阻塞式下载（流水线未运行）：返回时已完成 */
+        pGain->abBusy[k] = EC_FALSE;
+        MtGainResult(pMt, (EC_T_WORD)i, k, pGain->aoSdo[k].dwResult);
       }
+    }
   }
 
-  S_MotorCmd[wAxis] = *pCmd;
-  S_MotorCmdValid[wAxis] = EC_TRUE;
+  __atomic_store_n(&pMt->dwGainSvc, 0, __ATOMIC_RELEASE);
 }
 
-/* 上层读取每轴 MotorState_（demo 级：无锁，读取到的是“最近一次周期刷新”的快照） */
-EC_T_BOOL MT_GetMotorState(EC_T_WORD wAxis, MotorState_* pStateOut)
+/* [2026-10-16] 目的：按轴号异步下载任意对象（站地址取自 pMt->pMotor[]） */
+EC_T_DWORD MT_SdoDownload(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                          const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen, T_SDO_PIPE_HANDLE* pHandle)
 {
-  if ((pStateOut == EC_NULL) || (wAxis >= MAX_AXIS_NUM)) {
+  if (wAxis >= pMt->dwAxisCap) {
+    return EC_E_INVALIDPARM;
+  }
+  if ((pMt->pAppContext == EC_NULL) || (pMt->pAppContext->pMasterAccess == EC_NULL)) {
+    return EC_E_INVALIDSTATE;
+  }
+  return pMt->pAppContext->pMasterAccess->SdoDownload(pMt->pMotor[wAxis].wStationAddress, wIndex, bySubIndex, pbyData, dwDataLen, pHandle);
+}
+
+/* [2026-10-16] 目的：按轴号异步上传任意对象（结果写入 pbyData，长度见 pHandle->dwOutDataLen） */
+EC_T_DWORD MT_SdoUpload(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                        EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen, T_SDO_PIPE_HANDLE* pHandle)
+{
+  if (wAxis >= pMt->dwAxisCap) {
+    return EC_E_INVALIDPARM;
+  }
+  if ((pMt->pAppContext == EC_NULL) || (pMt->pAppContext->pMasterAccess == EC_NULL)) {
+    return EC_E_INVALIDSTATE;
+  }
+  return pMt->pAppContext->pMasterAccess->SdoUpload(pMt->pMotor[wAxis].wStationAddress, wIndex, bySubIndex, pbyData, dwDataLen, pHandle);
+}
+
+/* 上层读取每轴 MotorState_（读取到的是“最近一次周期刷新”的快照）
+ * [2026-10-16] 修改：读周期末发布的快照（seqlock），不再读周期线程正在写的工作区
+ */
+EC_T_BOOL MT_GetMotorState(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, MotorState_* pStateOut)
+{
+  EC_T_BOOL bRes = EC_FALSE;
+
+  if ((pStateOut == EC_NULL) || (wAxis >= pMt->dwAxisCap)) {
     return EC_FALSE;
   }
-  *pStateOut = S_MotorState[wAxis];
-  return EC_TRUE;
+  if (!MtShmAcquire(&pMt->oShm)) {
+    OsMemset(pStateOut, 0, sizeof(MotorState_)); /* MT_Setup() 之前：周期线程从未写过 */
+    return EC_TRUE;
+  }
+  if (wAxis >= pMt->oShm.dwAxisCnt) {
+    OsMemset(pStateOut, 0, sizeof(MotorState_)); /* 不存在的轴 */
+    bRes = EC_TRUE;
+  } else {
+    bRes = (EC_E_NOERROR == MtShmReadState(&pMt->oShm, wAxis, 1, pStateOut, EC_NULL, EC_NULL, EC_NULL)) ? EC_TRUE : EC_FALSE;
+  }
+  MtShmRelease(&pMt->oShm);
+  return bRes;
+}
+
+/* [2026-10-16] 目的：一次读全部轴（同一周期）的快照，dwCnt 不能超过轴数 */
+EC_T_DWORD MT_GetMotorStates(T_MT_CONTEXT* pMt, MotorState_* aStateOut, EC_T_DWORD dwCnt, EC_T_UINT64* pqwCycle)
+{
+  EC_T_DWORD dwRes = EC_E_NOERROR;
+
+  if ((aStateOut == EC_NULL) || (dwCnt == 0)) {
+    return EC_E_INVALIDPARM;
+  }
+  if (!MtShmAcquire(&pMt->oShm)) {
+    return EC_E_INVALIDSTATE;
+  }
+  if (dwCnt > pMt->oShm.dwAxisCnt) {
+    dwRes = EC_E_INVALIDPARM;
+  } else {
+    dwRes = MtShmReadState(&pMt->oShm, 0, dwCnt, aStateOut, pqwCycle, EC_NULL, EC_NULL);
+  }
+  MtShmRelease(&pMt->oShm);
+  return dwRes;
+}
+
+/* [2026-10-16] 目的：共享内存统计（各字段单独读取，彼此之间不保证同一周期） */
+EC_T_DWORD MT_GetShmStats(T_MT_CONTEXT* pMt, EC_T_UINT64* pqwCycle, EC_T_UINT64* pqwCmdTaken, EC_T_UINT64* pqwCmdLate, EC_T_UINT64* pqwCmdRejected)
+{
+  const T_MT_SHM_HDR* pHdr = EC_NULL;
+
+  if (!MtShmAcquire(&pMt->oShm)) {
+    return EC_E_INVALIDSTATE;
+  }
+  pHdr = pMt->oShm.pHdr;
+  if (pqwCycle != EC_NULL) {
+    *pqwCycle = __atomic_load_n(&pHdr->qwCycle, __ATOMIC_RELAXED);
+  }
+  if (pqwCmdTaken != EC_NULL) {
+    *pqwCmdTaken = __atomic_load_n(&pHdr->qwCmdTaken, __ATOMIC_RELAXED);
+  }
+  if (pqwCmdLate != EC_NULL) {
+    *pqwCmdLate = __atomic_load_n(&pHdr->qwCmdLate, __ATOMIC_RELAXED);
+  }
+  if (pqwCmdRejected != EC_NULL) {
+    *pqwCmdRejected = __atomic_load_n(&pHdr->qwCmdRejected, __ATOMIC_RELAXED);
+  }
+  MtShmRelease(&pMt->oShm);
+  return EC_E_NOERROR;
+}
+
+/* [2026-10-16] 目的：跨实例聚合状态（逐实例读已发布快照，按 apMt[] 顺序拼接，语义见 motrotech.h） */
+EC_T_DWORD MT_GetAggregateStates(T_MT_CONTEXT* const* apMt, EC_T_DWORD dwCtxCnt, MotorState_* aStateOut, EC_T_DWORD dwMaxAxis,
+                                 EC_T_DWORD* pdwAxisCnt, EC_T_UINT64* aqwCycle)
+{
+  EC_T_DWORD dwRes = EC_E_NOERROR;
+  EC_T_DWORD dwAxisCnt = 0;
+
+  if ((apMt == EC_NULL) || (aStateOut == EC_NULL) || (pdwAxisCnt == EC_NULL)) {
+    return EC_E_INVALIDPARM;
+  }
+  for (EC_T_DWORD c = 0; c < dwCtxCnt; c++) {
+    T_MT_CONTEXT* pMt = apMt[c];
+    EC_T_DWORD    dwCnt = 0;
+
+    if (aqwCycle != EC_NULL) {
+      aqwCycle[c] = 0;
+    }
+    if ((pMt == EC_NULL) || !MtShmAcquire(&pMt->oShm)) {
+      continue; /* 尚未 MT_Setup() / 正在退出：0 轴 */
+    }
+    dwCnt = pMt->oShm.dwAxisCnt;
+    if (dwAxisCnt + dwCnt > dwMaxAxis) {
+      dwCnt = dwMaxAxis - dwAxisCnt;
+      dwRes = EC_E_INVALIDSIZE;
+    }
+    if (dwCnt > 0) {
+      EC_T_DWORD dwReadRes = MtShmReadState(&pMt->oShm, 0, dwCnt, &aStateOut[dwAxisCnt],
+                                            (aqwCycle != EC_NULL) ? &aqwCycle[c] : EC_NULL, EC_NULL, EC_NULL);
+      if (dwReadRes != EC_E_NOERROR) {
+        MtShmRelease(&pMt->oShm);
+        *pdwAxisCnt = dwAxisCnt;
+        return dwReadRes;
+      }
+      dwAxisCnt += dwCnt;
+    }
+    MtShmRelease(&pMt->oShm);
+    if (dwRes != EC_E_NOERROR) {
+      break;
+    }
+  }
+  *pdwAxisCnt = dwAxisCnt;
+  return dwRes;
+}
+
+/* [2026-10-16] 目的：全局轴号 -> (实例下标, 实例内轴号)，与 MT_GetAggregateStates() 同样按已发布的轴数计 */
+EC_T_DWORD MT_MapGlobalAxis(T_MT_CONTEXT* const* apMt, EC_T_DWORD dwCtxCnt, EC_T_DWORD dwGlobalAxis,
+                            EC_T_DWORD* pdwCtx, EC_T_WORD* pwAxis)
+{
+  if ((apMt == EC_NULL) || (pdwCtx == EC_NULL) || (pwAxis == EC_NULL)) {
+    return EC_E_INVALIDPARM;
+  }
+  for (EC_T_DWORD c = 0; c < dwCtxCnt; c++) {
+    EC_T_DWORD dwCnt = 0;
+    if ((apMt[c] != EC_NULL) && MtShmAcquire(&apMt[c]->oShm)) {
+      dwCnt = apMt[c]->oShm.dwAxisCnt;
+      MtShmRelease(&apMt[c]->oShm);
+    }
+    if (dwGlobalAxis < dwCnt) {
+      *pdwCtx = c;
+      *pwAxis = (EC_T_WORD)dwGlobalAxis;
+      return EC_E_NOERROR;
+    }
+    dwGlobalAxis -= dwCnt;
+  }
+  return EC_E_NOTFOUND;
 }
 
 /* 设置指定轴的 Operation Mode（0x6060）。
  * 注意：若 0x6060 没映射到 PDO，需要用 CoE SDO 下载（此处仅留 TODO）。
  */
-EC_T_DWORD MT_MT_SetAxisOpMod(EC_T_WORD wAxis, MC_T_CIA402_OPMODE eMode) {
+EC_T_DWORD MT_SetAxisOpMod(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, MC_T_CIA402_OPMODE eMode) {
   EC_T_DWORD dwRes = EC_E_NOERROR;
-  My_Motor_Type *pDemoAxis = &My_Motor[wAxis];
-  if (EC_NULL == pDemoAxis) {
+  if (wAxis >= pMt->dwAxisCap) {
     dwRes = EC_E_NOTFOUND;
     return dwRes;
   }
+  My_Motor_Type *pDemoAxis = &pMt->pMotor[wAxis];
   pDemoAxis->eModesOfOperation = eMode;
   if (EC_NULL != pDemoAxis->pbyModeOfOperation) {
     EC_SETBITS(pDemoAxis->pbyModeOfOperation,
@@ -1198,36 +1415,36 @@ EC_T_DWORD MT_MT_SetAxisOpMod(EC_T_WORD wAxis, MC_T_CIA402_OPMODE eMode) {
 
 /******************************************************************************
  * MT_SetSwitch
- * 上层“广播式”下发命令：把 command 写入每个轴的 `S_ProcessState[]`。
+ * 上层“广播式”下发命令：把 command 写入每个轴的 `pMt->pProcessState[]`。
  * - 在 `MT_Workpd()` 每周期调用的 `Process_Commands()` 会把该命令转换成目标状态
  *wReqState。
  * - stop/shutdown 时会额外调用 `CheckMotorStateStop()` 等待轴退出
  *OP_ENABLED（demo 级）。
  ******************************************************************************/
-EC_T_VOID MT_SetSwitch(eStateCmd command) {
-  for (EC_T_INT mIndex = 0; mIndex < MotorCount; mIndex++) {
-    if (mIndex < MotorCount) {
+EC_T_VOID MT_SetSwitch(T_MT_CONTEXT* pMt, eStateCmd command) {
+  for (EC_T_INT mIndex = 0; mIndex < pMt->nMotorCount; mIndex++) {
+    if (mIndex < pMt->nMotorCount) {
       switch (command) {
       case COMMAND_SHUTDOWN:
-        S_ProcessState[mIndex] = COMMAND_SHUTDOWN;
+        pMt->pProcessState[mIndex] = COMMAND_SHUTDOWN;
         break;
       case COMMAND_START:
-        S_ProcessState[mIndex] = COMMAND_START;
+        pMt->pProcessState[mIndex] = COMMAND_START;
         break;
       case COMMAND_RESET:
-        S_ProcessState[mIndex] = COMMAND_RESET;
+        pMt->pProcessState[mIndex] = COMMAND_RESET;
         break;
       case COMMAND_HALT:
-        S_ProcessState[mIndex] = COMMAND_HALT;
+        pMt->pProcessState[mIndex] = COMMAND_HALT;
         break;
       case COMMAND_PAUSE:
-        S_ProcessState[mIndex] = COMMAND_PAUSE;
+        pMt->pProcessState[mIndex] = COMMAND_PAUSE;
         break;
       case COMMAND_QUICKSTOP:
-        S_ProcessState[mIndex] = COMMAND_QUICKSTOP;
+        pMt->pProcessState[mIndex] = COMMAND_QUICKSTOP;
         break;
       case COMMAND_STOP:
-        S_ProcessState[mIndex] = COMMAND_STOP;
+        pMt->pProcessState[mIndex] = COMMAND_STOP;
         break;
       case COMMAND_NONE:
         break;
@@ -1235,7 +1452,7 @@ EC_T_VOID MT_SetSwitch(eStateCmd command) {
     }
   }
   if (COMMAND_STOP == command || COMMAND_SHUTDOWN == command) {
-    CheckMotorStateStop();
+    CheckMotorStateStop(pMt);
   }
 }
 
@@ -1244,7 +1461,7 @@ EC_T_VOID MT_SetSwitch(eStateCmd command) {
  * 简化版 CiA402 状态机：
  * - 前提：master 必须处于 OP 状态（否则不做任何控制）
  * - 对每个轴：
- *   1) 根据 `S_ProcessState[mIndex]` 计算期望状态 `wReqState`
+ *   1) 根据 `pMt->pProcessState[mIndex]` 计算期望状态 `wReqState`
  *   2) 读 StatusWord（0x6041），解析出当前状态 `wActState`
  *   3) 如果未达到目标态，写
  *ControlWord（0x6040）触发状态转换（shutdown/switchon/enable op/fault
@@ -1252,16 +1469,16 @@ EC_T_VOID MT_SetSwitch(eStateCmd command) {
  *
  * 说明：这不是完整的 CiA402 状态机实现，只覆盖 demo 需要的最小路径。
  ******************************************************************************/
-static EC_T_DWORD Process_Commands(T_EC_DEMO_APP_CONTEXT *pAppContext) {
+static EC_T_DWORD Process_Commands(T_MT_CONTEXT* pMt, T_EC_DEMO_APP_CONTEXT *pAppContext) {
   EC_T_WORD wControl;
   EC_T_DWORD S_dwStatus;
   /* 只有主站在 OP 状态才做驱动控制，否则避免写 PDO 造成异常 */
-  if (eEcatState_OP != ecatGetMasterState())
+  if ((pAppContext->pMasterAccess == EC_NULL) || (eEcatState_OP != pAppContext->pMasterAccess->GetMasterState()))
     return EC_E_NOERROR;
 
-  for (EC_T_INT mIndex = 0; mIndex < MotorCount; mIndex++) {
+  for (EC_T_INT mIndex = 0; mIndex < pMt->nMotorCount; mIndex++) {
     /* pDemoAxis：第 mIndex 个轴（你可以理解为“轴编号”） */
-    My_Motor_Type *pDemoAxis = &My_Motor[mIndex];
+    My_Motor_Type *pDemoAxis = &pMt->pMotor[mIndex];
     /* 如果 StatusWord 没映射到 PDO，这个轴就无法跑状态机（也就无法使能运动） */
     if (pDemoAxis->pwStatusWord != EC_NULL) {
       /* 1) 上层命令（COMMAND_START/SHUTDOWN/STOP...）→ 目标状态 wReqState
@@ -1269,7 +1486,7 @@ static EC_T_DWORD Process_Commands(T_EC_DEMO_APP_CONTEXT *pAppContext) {
        * - SHUTDOWN → 希望到 READY_TO_SWITCHON（退回安全态）
        * - 其他     → 希望保持 SWITCHED_ON（示例默认）
        */
-      switch (S_ProcessState[mIndex]) {
+      switch (pMt->pProcessState[mIndex]) {
       case COMMAND_SHUTDOWN:
         /* 退回 READY_TO_SWITCHON：本 demo 用 shutdown 控制字推进到更安全的状态 */
         pDemoAxis->wReqState = DRV_DEV_STATE_READY_TO_SWITCHON;
@@ -1437,9 +1654,10 @@ static EC_T_DWORD Process_Commands(T_EC_DEMO_APP_CONTEXT *pAppContext) {
       }
     }
 
-    /* 4) 写控制字（0x6040）到 PdOut：下一次 SendAllCycFrames 时就会送到从站 */
+    /* 4) 写控制字（0x6040）：写进 PdOut，下一次 SendAllCycFrames 时就会送到从站
+     * （0x6040 未映射的轴不写）
+     */
     if (pDemoAxis->pwControlWord != EC_NULL) {
-      /* 真正“落地”的动作：把 wControl 写进 0x6040 ControlWord */
       EC_SETWORD(pDemoAxis->pwControlWord, wControl);
     }
   }
@@ -1453,7 +1671,7 @@ static EC_T_DWORD Process_Commands(T_EC_DEMO_APP_CONTEXT *pAppContext) {
  * 工程化使用需要更严谨的停止逻辑（例如依据速度为 0、状态机到 switched on/ready
  * 等）。
  */
-static EC_T_VOID CheckMotorStateStop(EC_T_VOID) {
+static EC_T_VOID CheckMotorStateStop(T_MT_CONTEXT* pMt) {
   CEcTimer oTimeout;
   /* 最多等 2 秒，避免死等 */
   oTimeout.Start(2000);
@@ -1461,8 +1679,8 @@ static EC_T_VOID CheckMotorStateStop(EC_T_VOID) {
 
   do {
     MovingStop = 0;
-    for (EC_T_INT mIndex = 0; mIndex < MotorCount; mIndex++) {
-      My_Motor_Type *pDemoAxis = &My_Motor[mIndex];
+    for (EC_T_INT mIndex = 0; mIndex < pMt->nMotorCount; mIndex++) {
+      My_Motor_Type *pDemoAxis = &pMt->pMotor[mIndex];
       /* 这里的判断写法比较绕：
        *   !(OP_ENABLED != wActState)  等价于  (wActState == OP_ENABLED)
        * demo 的意思是：统计“还有多少轴仍在 OP_ENABLED”，如果还有就继续等
@@ -16,11 +16,15 @@
  *   `MT_Init()` / `MT_Prepare()` / `MT_Setup()` / `MT_Workpd()`。
  *
  * 重要假设/限制：
- * - 该示例假设“每个轴的对象索引”按固定偏移排布：Axis0 用 0x6040、Axis1 用 0x6040+0x800 ...，
- *   即 `OBJOFFSET = 0x800`。这不是 EtherCAT 通用规则，而是你们从站/ENI 的约定写法；
- *   如果你的从站对象不按这个规律，必须改 `MT_Setup()` 的匹配规则。
+ * - 每个轴的对象索引按“基址 + 轴号 * 步长”排布（默认步长 0x800：Axis0 用 0x6040、Axis1 用 0x6840 ...）。
+ *   [2026-10-16] 对象集合/步长/类型已改为绑定表（见 motrotech_pdo.h），从 busi.yaml 读取；
+ *   新增或调整对象只改配置，不再改 `MT_Setup()`。
  * - 这里用到的对象（0x6040/0x6041/0x607A/...）必须被映射进 PDO，否则指针会保持为 EC_NULL。
  *
+ * [2026-10-16] 多实例：所有轴表/命令/状态都在调用方持有的 T_MT_CONTEXT 里（每个主站实例一份，
+ *   pAppContext->pMtContext 指向它），一个进程可以同时驱动多个 EtherCAT 网段；
+ *   MT_GetAggregateStates() 把各实例的状态按实例顺序拼成一张全局轴表。
+ *
  * 说明：本文件仅为示例代码，不保证覆盖所有驱动/所有状态转换；工程化使用前需要结合实际伺服手册完善。
  *---------------------------------------------------------------------------*/
 #ifndef __MOTROTECH_H__
@@ -30,43 +34,30 @@
 #include "EcNotification.h"
 #include "EcDemoParms.h"
 #include "EcSlaveInfo.h"
+#include "EcSdoPipeline.h"
+#include "motrotech_pdo.h"
+#include "motrotech_master.h"
+#include "motrotech_traj.h"
+#include "motrotech_shm.h"
+
+/* [2026-10-16] MotorCmd_/MotorState_ 定义在 motrotech_shm.h（也是共享内存布局的一部分） */
 
-/* [2026-01-19] 目的：按照最新《电机协议字段支持性详细分析表》更新发送结构体 */
-typedef struct _MotorCmd_
-{
-    EC_T_BYTE  mode;      /* 控制模式 0x6060: 0x08:CSP, 0x09:CSV, 0x0A:CST 等 */
-    EC_T_REAL  q;         /* 关节目标位置 (rad) -> 对应 0x607A */
-    EC_T_REAL  dq;        /* 关节目标速度 (rad/s) -> 对应 0x60B1 (Velocity Offset) */
-    EC_T_REAL  tau;       /* 关节前馈力矩 (N.m) -> 对应 0x60B2 (Torque Offset) */
-    EC_T_REAL  kp;        /* 关节刚度系数 (rad/s) -> 对应 0x3500 (SDO) */
-    EC_T_REAL  kd;        /* 阻尼系数 (rad/s) -> 对应 0x3501 (SDO) */
-    EC_T_DWORD reserve;   /* 预留 */
-} MotorCmd_;
-
-/* [2026-01-19] 目的：按照最新《电机协议字段支持性详细分析表》更新接收结构体 */
-typedef struct _MotorState_
-{
-    EC_T_BYTE  mode;              /* 电机当前模式 0x6061 */
-    EC_T_REAL  q_fb;              /* 关节反馈位置 (rad) -> 0x6064 */
-    EC_T_REAL  dq_fb;             /* 关节反馈速度 (rad/s) -> 0x606C */
-    EC_T_REAL  ddq_fb;            /* 关节反馈加速度 (需差分计算) */
-    EC_T_REAL  tau_fb;            /* 关节反馈力矩 (N.m) -> 0x6077 */
-    EC_T_WORD  temperature[2];    /* [0]:MCU温度 0x3008, [1]:电机温度 0x3009 */
-    EC_T_REAL  vol;               /* 母线电压 (V) -> 0x300B */
-    EC_T_DWORD sensor[2];         /* 预留传感器数据 */
-    EC_T_DWORD motorstate;        /* 电机状态 (0x6041 状态字或错误码) */
-} MotorState_;
 /*-DEFINES-------------------------------------------------------------------*/
 #define MOTROTECH_VERS_MAJ             0   /* major version */             
 #define MOTROTECH_VERS_MIN             0   /* minor version */             
 #define MOTROTECH_VERS_SERVICEPACK     6   /* service pack */           
 #define MOTROTECH_VERS_BUILD           0   /* build number */   
 
+/* [2026-10-16] 不再是数组上限：pMotor[]/pSlave[] 在 MT_Init() 按配置的从站列表分配，
+ * 这两个值只是最小容量（未配置从站列表时 myAppPrepare() 仍按旧方式直接填 pSlave[]）
+ */
 #define MAX_SLAVE_NUM             8
 #define MAX_AXIS_NUM              8
 
-/* 一个 slave 上可能有多个轴（多轴伺服/多通道），该示例用 “对象索引 + 轴号 * OBJOFFSET” 来区分各轴对象 */
-#define OBJOFFSET                 0x800
+/* 一个 slave 上可能有多个轴（多轴伺服/多通道），用 “对象索引 + 轴号 * 步长” 来区分各轴对象；
+ * 默认步长，实际以绑定表的 wAxisStride 为准
+ */
+#define OBJOFFSET                 MT_PDO_DEFAULT_STRIDE
 
 /* 故障复位相关：示例里通过计数方式在 reset 与 disable voltage 之间切换，避免一直刷 reset */
 #define COUNTLIMIT                10       /* Reset Fault cycle count limit */
@@ -119,6 +110,10 @@ typedef struct _MotorState_
 #define DRV_OBJ_IGBT_TEMPERATURE            0x300F
 #define DRV_OBJ_DC_LINK_VOLTAGE             0x300B
 
+/* [2026-10-16] 配置类对象（不支持 PDO 映射，只能 SDO 下载；REAL32） */
+#define DRV_OBJ_POSITION_KP                 0x3500
+#define DRV_OBJ_POSITION_KD                 0x3501
+
 #define DRV_OBJ_DIGITAL_INPUT               0x6000
 #define DRV_OBJ_DIGITAL_INPUT_SUBINDEX_1    0x1
 #define DRV_OBJ_DIGITAL_INPUT_SUBINDEX_2    0x2
@@ -324,6 +319,7 @@ typedef struct _Motor_Type
 	/* [2026-01-13] 作用：把上层 rad/rad/s 与驱动对象的 PUU(count)/PUU/s 对齐 */
 	EC_T_LREAL  fCntPerRad;           /* PUU(count)/rad：q(rad) * fCntPerRad -> 0x607A int32 */
 	EC_T_LREAL  fRadPerCnt;           /* rad/PUU(count)：q_cnt * fRadPerCnt -> q_fb(rad) */
+	EC_T_LREAL  fCntPerRadReq;        /* [2026-10-16] MT_SetAxisUnitScale() 原子写入，周期开始取入上面两项（两项只由周期线程写） */
 
 	MC_T_CIA402_STATE   wReqState;
 	MC_T_CIA402_STATE   wActState;
@@ -337,6 +333,8 @@ typedef struct _Motor_Type
     EC_T_LREAL          fLimitMin;    /* [2026-01-20] 软件左限位 */
     EC_T_LREAL          fLimitMax;    /* [2026-01-20] 软件右限位 */
     EC_T_BOOL           bLimitValid;  /* 限位是否已示教有效 */
+    EC_T_BOOL           bFirstEnable; /* [2026-10-16] 手动模式：使能后是否已把 fCurPos 同步到反馈位置（原 MT_Workpd 内 static 数组） */
+    EC_T_INT            nDirection;   /* [2026-10-16] 老化往复方向 1/-1（原 MT_Workpd 内 static 数组） */
 } My_Motor_Type;
 
 /* 一个 slave（按固定站地址）对应多少轴（wAxisCnt） */
@@ -346,45 +344,190 @@ typedef struct _SLAVE_MOTOR_TYPE
 	EC_T_WORD           wAxisCnt;
 }SLAVE_MOTOR_TYPE;
 
-extern My_Motor_Type       My_Motor[MAX_AXIS_NUM];
-extern SLAVE_MOTOR_TYPE    My_Slave[MAX_SLAVE_NUM];
+/* [2026-01-14] 目的：运行模式选择（启动后选择） */
+typedef enum _MT_RUN_MODE
+{
+    MT_RUNMODE_AUTO   = 0,  /* 自动：走原demo轨迹 */
+    MT_RUNMODE_MANUAL = 1   /* 手动：只响应 MotorCmd_/命令线程 */
+} MT_RUN_MODE;
+
+/* [2026-10-16] 目的：每轴 kp/kd（0x3500/0x3501，只能走 SDO）的下发状态，下标 MT_GAIN_KP/MT_GAIN_KD
+ * - afReq：要求的值，MT_SetMotorCmd()/周期线程（控制器命令）有变化时原子写入，不加锁、不打日志
+ * - 其余成员只由 MT_ServiceGains()（非周期线程）读写：afApplied 只在 SDO 成功后更新，失败的稍后重试
+ */
+#define MT_GAIN_KP          0
+#define MT_GAIN_KD          1
+#define MT_GAIN_CNT         2
+#define MT_GAIN_RETRY_MSEC  500     /* 下发失败后至少隔这么久再重试 */
 
-/* 下面这组函数与 EcMasterDemoDc 的 myApp* 回调一一对应：
- * - Init：初始化本模块的静态变量/数组
- * - Prepare：根据上层填写的 `My_Slave[]`，生成 `My_Motor[]` 的站地址列表（并检查从站是否 present）
- * - Setup：在 master 已配置网络后，查出每个 PDO 变量的偏移并建立指针映射
+typedef struct _T_MT_GAIN
+{
+    EC_T_REAL               afReq[MT_GAIN_CNT];
+    EC_T_REAL               afSent[MT_GAIN_CNT];        /* 在途请求的值 */
+    EC_T_REAL               afApplied[MT_GAIN_CNT];     /* 从站已确认的值（初值为驱动默认值） */
+    EC_T_BOOL               abBusy[MT_GAIN_CNT];        /* aoSdo 在途，完成前不能释放 */
+    EC_T_DWORD              adwLastErr[MT_GAIN_CNT];    /* 上次失败的结果，连续相同的错误只打一次 */
+    EC_T_DWORD              adwRetryMsec[MT_GAIN_CNT];  /* 失败后最早的重试时刻（OsQueryMsecCount） */
+    T_SDO_PIPE_HANDLE       aoSdo[MT_GAIN_CNT];
+} T_MT_GAIN;
+
+/* [2026-10-16] 目的：一个主站实例（一个 EtherCAT 网段）的全部轴控制状态，原来是本模块的全局/静态变量
+ * - 调用方持有（栈上/静态均可），MT_ContextCreate() 初始化，MT_ContextDelete() 释放；
+ *   EcDemoApp() 之前把地址填进 AppContext.pMtContext，MT_Init/Prepare/Setup/Workpd 从那里取
+ * - Configure 部分在 EcDemoApp() 之前写入；其余由 MT_Init()/MT_Setup() 分配，周期线程独占写
+ * - 不同实例之间没有共享的可写数据，各自的周期线程互不加锁
+ */
+typedef struct _T_MT_CONTEXT
+{
+    EC_T_DWORD              dwInstanceId;       /* 主站实例号（与 AppContext.dwInstanceId 相同） */
+    T_EC_DEMO_APP_CONTEXT*  pAppContext;        /* MT_Init() 记下，供非周期接口（MT_SetMotorCmd/MT_Sdo*）取主站访问/SDO 流水线 */
+
+    /*-配置（MT_Configure* 拷贝，busi.yaml）------------------------------------*/
+    SLAVE_MOTOR_TYPE*       pCfgSlave;          /* 从站列表，MT_Init() 用它决定容量并填 pSlave[] */
+    EC_T_DWORD              dwCfgSlaveCnt;
+    T_MT_TRAJ_GROUP_CFG     aCfgTraj[MT_TRAJ_MAX_GROUPS];
+    EC_T_DWORD              dwCfgTrajCnt;
+    EC_T_WORD*              pwCfgTrajAxis;      /* 所有组的轴号连续存放，aCfgTraj[g].pwAxis 指向其中一段 */
+    EC_T_CHAR               szCfgShm[MT_SHM_NAME_SIZE];
+    T_MT_PDO_CTX            oPdo;               /* PDO 绑定表 + 解析结果/缓存 */
+
+    /*-轴表（MT_Init 按容量分配）----------------------------------------------*/
+    My_Motor_Type*          pMotor;             /* 每轴运行时上下文（PDO 指针在 MT_Setup() 之后才有效） */
+    SLAVE_MOTOR_TYPE*       pSlave;             /* 从站站地址/轴数 */
+    EC_T_DWORD              dwAxisCap;
+    EC_T_DWORD              dwSlaveCap;
+    EC_T_INT                nMotorCount;        /* 轴总数（所有 slave 的轴数累加） */
+    EC_T_INT                nSlaveCount;
+    volatile eStateCmd*     pProcessState;      /* 每轴的“命令输入”（MT_SetSwitch 写入） */
+
+    /*-命令/状态：pMotorCmd 由 MT_SetMotorCmd() 按轴 seqlock（pdwCmdSeq，奇数：写入中）写入，
+     * pMotorCmdCyc/pbMotorCmdValid/pMotorState 只由周期线程写（见 MtLoadMotorCmds）----*/
+    MotorCmd_*              pMotorCmd;
+    EC_T_DWORD*             pdwCmdSeq;
+    EC_T_DWORD*             pdwCmdSeen;         /* 周期线程已取入的序号 */
+    MotorCmd_*              pMotorCmdCyc;
+    EC_T_BOOL*              pbMotorCmdValid;
+    MotorState_*            pMotorState;        /* 周期线程工作区，周期末整体发布到 oShm */
+    T_MT_GAIN*              pGain;              /* 每轴 kp/kd 下发状态（见 T_MT_GAIN） */
+    EC_T_DWORD              dwGainSvc;          /* MT_ServiceGains() 正在执行（CAS 抢占，同时只有一个线程处理） */
+
+    /*-周期运行时-------------------------------------------------------------*/
+    EC_T_LREAL              fTimeSec;           /* 总线周期（秒），MT_Setup() 由 dwBusCycleTimeUsec 算出 */
+    MT_RUN_MODE             eRunMode;
+    T_MT_TRAJ               oTraj;
+    T_MT_SHM                oShm;
+    EC_T_UINT64             qwCycle;            /* MT_Workpd() 周期号（从 1 开始），随状态发布 */
+} T_MT_CONTEXT;
+
+/* [2026-10-16] 目的：初始化/释放一个实例的上下文（Create 清零并设默认运行模式 AUTO；Delete 释放全部分配） */
+EC_T_DWORD MT_ContextCreate(T_MT_CONTEXT* pMt, EC_T_DWORD dwInstanceId);
+EC_T_VOID  MT_ContextDelete(T_MT_CONTEXT* pMt);
+
+/* [2026-10-16] 目的：从站列表来自配置（busi.yaml 的 ethercat_demo.slaves / instances[].slaves），在 EcDemoApp() 启动前调用
+ * - MT_Init() 按此列表分配 pMotor[]/pSlave[] 并填好 pSlave[]
+ * - dwCnt=0 表示未配置，myAppPrepare() 使用内置的默认站地址
+ */
+EC_T_DWORD MT_ConfigureSlaves(T_MT_CONTEXT* pMt, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwCnt);
+EC_T_DWORD MT_GetConfiguredSlaveCnt(T_MT_CONTEXT* pMt);
+/* [2026-10-16] 目的：轴组配置来自 busi.yaml 的 ethercat_demo.traj_groups，在 EcDemoApp() 启动前调用（拷贝配置） */
+EC_T_DWORD MT_ConfigureTrajGroups(T_MT_CONTEXT* pMt, const T_MT_TRAJ_GROUP_CFG* pCfg, EC_T_DWORD dwCnt);
+EC_T_DWORD MT_GetAxisCapacity(T_MT_CONTEXT* pMt);
+EC_T_DWORD MT_GetSlaveCapacity(T_MT_CONTEXT* pMt);
+EC_T_DWORD MT_GetAxisCount(T_MT_CONTEXT* pMt);
+
+/* 下面这组函数与 EcMasterDemoDc 的 myApp* 回调一一对应（[2026-10-16] 都作用于 pAppContext->pMtContext）：
+ * - Init：分配并初始化本实例的轴表
+ * - Prepare：根据上层填写的 `pSlave[]`，生成 `pMotor[]` 的站地址列表（并检查从站是否 present）
+ * - Setup：在 master 已配置网络后，按绑定表查出每个 PDO 变量的偏移并建立指针映射
  * - Workpd：每个周期运行（写 0x6060/0x6040/0x607A/0x60FF 等）
  */
 EC_T_DWORD MT_Init(T_EC_DEMO_APP_CONTEXT* pAppContext);
 EC_T_DWORD MT_Prepare(T_EC_DEMO_APP_CONTEXT* pAppContext);
 EC_T_DWORD MT_Setup(T_EC_DEMO_APP_CONTEXT*   pAppContext);
 EC_T_VOID  MT_Workpd(T_EC_DEMO_APP_CONTEXT* pAppContext);
-EC_T_DWORD MT_SetAxisOpMod(EC_T_WORD wAxis, MC_T_CIA402_OPMODE eMode);
-EC_T_VOID  MT_SetSwitch(eStateCmd command);
-
-/* [2026-01-14] 目的：运行模式选择（启动后选择） */
-typedef enum _MT_RUN_MODE
-{
-    MT_RUNMODE_AUTO   = 0,  /* 自动：走原demo轨迹 */
-    MT_RUNMODE_MANUAL = 1   /* 手动：只响应 MotorCmd_/命令线程 */
-} MT_RUN_MODE;
+EC_T_DWORD MT_SetAxisOpMod(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, MC_T_CIA402_OPMODE eMode);
+EC_T_VOID  MT_SetSwitch(T_MT_CONTEXT* pMt, eStateCmd command);
 
 /* [2026-01-14] 目的：设置/获取当前运行模式（0自动/1手动） */
-EC_T_VOID   MT_SetRunMode(MT_RUN_MODE eMode);
-MT_RUN_MODE MT_GetRunMode(EC_T_VOID);
+EC_T_VOID   MT_SetRunMode(T_MT_CONTEXT* pMt, MT_RUN_MODE eMode);
+MT_RUN_MODE MT_GetRunMode(T_MT_CONTEXT* pMt);
+
+/* 上层接口：每轴写命令/读状态
+ * [2026-10-16] 不再有撕裂/混周期：
+ * - MT_SetMotorCmd：每轴 seqlock，周期线程只取完整写入的命令（写入中则下周期再取），多个调用线程之间互斥
+ * - MT_GetMotorState/MT_GetMotorStates：读周期线程每周期整体发布的快照（与共享内存同一份），
+ *   MT_GetMotorStates 的所有轴来自同一周期（*pqwCycle，可为 EC_NULL）；MT_Setup() 之前读到全 0
+ */
+EC_T_VOID  MT_SetMotorCmd(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, const MotorCmd_* pCmd);
 
-/* 上层接口：每轴写命令/读状态（demo 级，无锁；如需强一致性请自行加锁/双缓冲） */
-EC_T_VOID  MT_SetMotorCmd(EC_T_WORD wAxis, const MotorCmd_* pCmd);
-EC_T_BOOL  MT_GetMotorState(EC_T_WORD wAxis, MotorState_* pStateOut);
-EC_T_VOID  MT_TeachLimit(EC_T_WORD wAxis, EC_T_BOOL bIsMax);
+/* [2026-10-16] 目的：把要求的 kp/kd 下发到从站（只在非周期线程调用，例如 EcDemoApp() 主循环，MT_SetMotorCmd() 也会调用）
+ * - 与从站已确认的值不同的轴经 SDO 下发；SDO 流水线未运行时在调用线程里阻塞下发
+ * - 失败（含流水线队列满/未受理）不丢：要求值保持，MT_GAIN_RETRY_MSEC 之后再次下发
+ * - 多个线程同时调用时只有一个执行，其余直接返回
+ */
+EC_T_VOID  MT_ServiceGains(T_MT_CONTEXT* pMt);
+EC_T_BOOL  MT_GetMotorState(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, MotorState_* pStateOut);
+EC_T_DWORD MT_GetMotorStates(T_MT_CONTEXT* pMt, MotorState_* aStateOut, EC_T_DWORD dwCnt, EC_T_UINT64* pqwCycle);
+
+/* [2026-10-16] 目的：过程数据共享内存（外部控制器进程，见 motrotech_shm.h），在 EcDemoApp() 启动前调用
+ * - szName："/xxx" 形式的 POSIX 共享内存名，EC_NULL 或 "" 表示不创建（快照只在进程内）
+ * - MT_Setup() 按实际轴数创建；共享内存创建失败时只打错误，退回进程内快照
+ * - 控制器发布的命令与 MT_SetMotorCmd() 同等对待（同一周期两者都有新命令时控制器的生效）；
+ *   kp/kd 只在 SDO 流水线运行时由周期线程入队，否则忽略
+ */
+EC_T_DWORD MT_ConfigureShm(T_MT_CONTEXT* pMt, const EC_T_CHAR* szName);
+/* 取共享内存头里的统计（控制器命令取到/迟到/拒绝数、当前周期），未创建返回 EC_E_INVALIDSTATE */
+EC_T_DWORD MT_GetShmStats(T_MT_CONTEXT* pMt, EC_T_UINT64* pqwCycle, EC_T_UINT64* pqwCmdTaken, EC_T_UINT64* pqwCmdLate, EC_T_UINT64* pqwCmdRejected);
+EC_T_VOID  MT_TeachLimit(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_BOOL bIsMax);
+
+/* [2026-10-16] 目的：轴组流式轨迹（规划线程 50~100Hz 批量推送航点，周期线程插补；详见 motrotech_traj.h）
+ * - 只在 MANUAL 下生效；组驱动的轴（RUN/STOP/HOLD）忽略 MotorCmd_
+ * - pfQ/pfDq 按点连续，每点依次为组内各轴（rad、rad/s），pfDq 可为 EC_NULL
+ * - 推送返回 EC_E_INVALIDSTATE：组因欠载/掉使能锁定，MT_TrajReset() 后重新开始
+ * - 规划器用 MT_TrajGetStatus().fBufferedSec 控制提前量（建议 >= 两个规划周期）
+ */
+EC_T_DWORD MT_TrajGetGroupCnt(T_MT_CONTEXT* pMt);
+EC_T_DWORD MT_TrajPush(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup, const EC_T_LREAL* pfTime, const EC_T_REAL* pfQ, const EC_T_REAL* pfDq,
+                       EC_T_DWORD dwCnt, EC_T_BOOL bLast, EC_T_DWORD* pdwAccepted);
+EC_T_DWORD MT_TrajStop(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup);
+EC_T_DWORD MT_TrajReset(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup);
+EC_T_DWORD MT_TrajRelease(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup);
+EC_T_DWORD MT_TrajGetStatus(T_MT_CONTEXT* pMt, EC_T_DWORD dwGroup, T_MT_TRAJ_STATUS* pStatus);
+
+/* [2026-10-16] 目的：非 PDO 对象的异步 SDO 读写（经 CEcSdoPipeline 排队，调用线程不阻塞）
+ * - pHandle 可为 EC_NULL；非空时由调用方持有，完成后 bDone=EC_TRUE，可用 CEcSdoPipeline::Wait() 等待
+ * - 同一对象未执行的写入会被新值覆盖（只下发最新值）
+ * - Upload 的 pbyData 在完成前必须保持有效
+ * - 返回：EC_E_NOERROR 表示已受理；流水线未启动时在调用线程里阻塞执行，返回前 handle 已完成；
+ *   没有主站访问接口（pAppContext->pMasterAccess）时返回 EC_E_INVALIDSTATE
+ */
+EC_T_DWORD MT_SdoDownload(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                          const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen, T_SDO_PIPE_HANDLE* pHandle);
+EC_T_DWORD MT_SdoUpload(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                        EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen, T_SDO_PIPE_HANDLE* pHandle);
 
 /* 设置每轴单位换算：encoder_cpr(计数/转) 与 gear_ratio(减速比，电机转/输出转)
  * 换算关系：
  *   cnt_per_rad = encoder_cpr * gear_ratio / (2*pi)
  *   q_cnt  = q_rad  * cnt_per_rad
  *   dq_cnt = dq_rad * cnt_per_rad
+ * [2026-10-16] 可在周期运行中从任意线程调用：新系数在下一周期开始时生效
+ */
+EC_T_BOOL  MT_SetAxisUnitScale(T_MT_CONTEXT* pMt, EC_T_WORD wAxis, EC_T_LREAL encoder_cpr, EC_T_LREAL gear_ratio);
+
+/* [2026-10-16] 目的：跨实例的聚合状态视图（一个进程驱动多个网段时，上层看到一张全局轴表）
+ * - 全局轴号 = 按 apMt[] 顺序把各实例的轴依次排下去（实例 0 的轴在前）
+ * - MT_GetAggregateStates：逐实例读已发布快照（同一实例内的轴来自同一周期，实例之间不保证同一周期，
+ *   各实例的周期号写入 aqwCycle[]，可为 EC_NULL）；尚未 MT_Setup() 的实例按 0 轴计；
+ *   *pdwAxisCnt 返回实际填入的轴数，dwMaxAxis 不够时截断并返回 EC_E_INVALIDSIZE
+ * - MT_MapGlobalAxis：全局轴号 -> (实例下标, 实例内轴号)，超出范围返回 EC_E_NOTFOUND
+ * - 可在任意线程调用（与各实例线程的 MT_Setup()/MT_ContextDelete() 并发也安全）：逐实例 MtShmAcquire()，
+ *   正在建立/删除共享内存的实例按 0 轴计；MT_GetMotorState(s)/MT_GetShmStats() 同样如此
  */
-EC_T_BOOL  MT_SetAxisUnitScale(EC_T_WORD wAxis, EC_T_LREAL encoder_cpr, EC_T_LREAL gear_ratio);
+EC_T_DWORD MT_GetAggregateStates(T_MT_CONTEXT* const* apMt, EC_T_DWORD dwCtxCnt, MotorState_* aStateOut, EC_T_DWORD dwMaxAxis,
+                                 EC_T_DWORD* pdwAxisCnt, EC_T_UINT64* aqwCycle);
+EC_T_DWORD MT_MapGlobalAxis(T_MT_CONTEXT* const* apMt, EC_T_DWORD dwCtxCnt, EC_T_DWORD dwGlobalAxis,
+                            EC_T_DWORD* pdwCtx, EC_T_WORD* pwAxis);
 
 #endif /* INC_MOTROTECH */
 /*-END OF SOURCE FILE--------------------------------------------------------*/
\ No newline at end of file
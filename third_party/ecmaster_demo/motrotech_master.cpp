@@ -0,0 +1,107 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_master.cpp
+ *
+ * CMtEcMasterAccess：CMtMasterAccess 的 EC‑Master 实现（见 motrotech_master.h）。
+ * - 全部按 pAppContext->dwInstanceId 调用 em*（不再隐含 INSTANCE_MASTER_DEFAULT）
+ * - SDO：流水线运行时入队（异步）；否则阻塞调用 emCoeSdoDownload/Upload，返回前完成 handle/回调
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech.h"
+#include "EcDemoApp.h"
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+/* 阻塞式 SDO 的完成通知（与流水线完成时的顺序一致：先填 handle，再回调） */
+static EC_T_VOID MtSdoComplete(T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext,
+                               EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                               EC_T_DWORD dwResult, EC_T_DWORD dwOutDataLen)
+{
+  if (pHandle != EC_NULL) {
+    pHandle->dwResult = dwResult;
+    pHandle->dwOutDataLen = dwOutDataLen;
+    SDO_PIPE_HANDLE_SET_DONE(pHandle);
+  }
+  if (pfnDone != EC_NULL) {
+    pfnDone(pvContext, wStationAddress, wIndex, bySubIndex, dwResult);
+  }
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+CMtEcMasterAccess::CMtEcMasterAccess(T_EC_DEMO_APP_CONTEXT* pAppContext)
+  : m_pAppContext(pAppContext)
+{
+}
+
+EC_T_BYTE* CMtEcMasterAccess::GetProcessImageInputPtr(EC_T_VOID)
+{
+  return emGetProcessImageInputPtr(m_pAppContext->dwInstanceId);
+}
+
+EC_T_BYTE* CMtEcMasterAccess::GetProcessImageOutputPtr(EC_T_VOID)
+{
+  return emGetProcessImageOutputPtr(m_pAppContext->dwInstanceId);
+}
+
+EC_T_STATE CMtEcMasterAccess::GetMasterState(EC_T_VOID)
+{
+  return emGetMasterState(m_pAppContext->dwInstanceId);
+}
+
+EC_T_DWORD CMtEcMasterAccess::GetNumConfiguredSlaves(EC_T_VOID)
+{
+  return emGetNumConfiguredSlaves(m_pAppContext->dwInstanceId);
+}
+
+EC_T_DWORD CMtEcMasterAccess::IsSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL* pbPresent)
+{
+  return emIsSlavePresent(m_pAppContext->dwInstanceId, emGetSlaveId(m_pAppContext->dwInstanceId, wStationAddress), pbPresent);
+}
+
+EC_T_DWORD CMtEcMasterAccess::GetCfgSlaveInfo(EC_T_WORD wStationAddress, EC_T_CFG_SLAVE_INFO* pSlaveInfo)
+{
+  return emGetCfgSlaveInfo(m_pAppContext->dwInstanceId, EC_TRUE, wStationAddress, pSlaveInfo);
+}
+
+EC_T_DWORD CMtEcMasterAccess::GetSlaveVarInfo(EC_T_BOOL bOutput, EC_T_WORD wStationAddress, EC_T_WORD wNumOfVarsToRead,
+                                              EC_T_PROCESS_VAR_INFO_EX* pVarInfo, EC_T_WORD* pwReadEntries)
+{
+  if (bOutput) {
+    return emGetSlaveOutpVarInfoEx(m_pAppContext->dwInstanceId, EC_TRUE, wStationAddress, wNumOfVarsToRead, pVarInfo, pwReadEntries);
+  }
+  return emGetSlaveInpVarInfoEx(m_pAppContext->dwInstanceId, EC_TRUE, wStationAddress, wNumOfVarsToRead, pVarInfo, pwReadEntries);
+}
+
+EC_T_DWORD CMtEcMasterAccess::SdoDownload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                          const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                          T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext)
+{
+  CEcSdoPipeline* pPipeline = m_pAppContext->pSdoPipeline;
+  EC_T_DWORD dwRes = EC_E_NOERROR;
+
+  if ((pPipeline != EC_NULL) && pPipeline->IsRunning()) {
+    return pPipeline->Write(wStationAddress, wIndex, bySubIndex, pbyData, dwDataLen, pHandle, pfnDone, pvContext);
+  }
+  dwRes = emCoeSdoDownload(m_pAppContext->dwInstanceId, emGetSlaveId(m_pAppContext->dwInstanceId, wStationAddress),
+                           wIndex, bySubIndex, (EC_T_BYTE*)pbyData, dwDataLen, SDO_PIPE_DEFAULT_TIMEOUT, 0);
+  MtSdoComplete(pHandle, pfnDone, pvContext, wStationAddress, wIndex, bySubIndex, dwRes, 0);
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD CMtEcMasterAccess::SdoUpload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                        EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                        T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext)
+{
+  CEcSdoPipeline* pPipeline = m_pAppContext->pSdoPipeline;
+  EC_T_DWORD dwOutDataLen = 0;
+  EC_T_DWORD dwRes = EC_E_NOERROR;
+
+  if ((pPipeline != EC_NULL) && pPipeline->IsRunning()) {
+    return pPipeline->Read(wStationAddress, wIndex, bySubIndex, pbyData, dwDataLen, pHandle, pfnDone, pvContext);
+  }
+  dwRes = emCoeSdoUpload(m_pAppContext->dwInstanceId, emGetSlaveId(m_pAppContext->dwInstanceId, wStationAddress),
+                         wIndex, bySubIndex, pbyData, dwDataLen, &dwOutDataLen, SDO_PIPE_DEFAULT_TIMEOUT, 0);
+  MtSdoComplete(pHandle, pfnDone, pvContext, wStationAddress, wIndex, bySubIndex, dwRes, dwOutDataLen);
+  return EC_E_NOERROR;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
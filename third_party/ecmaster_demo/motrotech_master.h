@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_master.h
+ *
+ * 作用：motrotech 访问主站的薄接口（把 motrotech*.cpp 与 EC‑Master SDK 解耦）。
+ *
+ * - motrotech 只用到主站的少数几类功能：过程映像基地址、从站变量表（位偏移）、主站状态、
+ *   从站是否 present、CoE SDO 读写；这些都收敛到 `CMtMasterAccess` 的虚函数里
+ * - 实机：`CMtEcMasterAccess` 转发到 em*（按 pAppContext->dwInstanceId），SDO 走 CEcSdoPipeline，
+ *   流水线未启动时退回阻塞式 emCoeSdoDownload/Upload（同步完成）
+ * - 无硬件：`CMtSimMaster`（motrotech_sim.h）模拟过程映像和 CiA402 驱动，用于 bench/MtSimBench.cpp
+ * - EcDemoApp() 在 myAppInit() 之前创建 pAppContext->pMasterAccess，motrotech 从这里取接口，不再直接调用 ecat*
+ *
+ * 接口只在启动阶段（MT_Prepare/MT_Setup）和非周期路径（SDO）上有虚调用，周期里只调 GetMasterState() 一次。
+ *---------------------------------------------------------------------------*/
+#ifndef __MOTROTECH_MASTER_H__
+#define __MOTROTECH_MASTER_H__     1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoParms.h"
+#include "EcSdoPipeline.h"
+
+/*-CLASS---------------------------------------------------------------------*/
+class CMtMasterAccess
+{
+public:
+    virtual ~CMtMasterAccess() {}
+
+    /* 过程映像（PdIn：从站 -> 主站，PdOut：主站 -> 从站），未配置时为 EC_NULL */
+    virtual EC_T_BYTE*  GetProcessImageInputPtr(EC_T_VOID) = 0;
+    virtual EC_T_BYTE*  GetProcessImageOutputPtr(EC_T_VOID) = 0;
+    virtual EC_T_STATE  GetMasterState(EC_T_VOID) = 0;
+
+    /* 从站按固定站地址访问 */
+    virtual EC_T_DWORD  GetNumConfiguredSlaves(EC_T_VOID) = 0;
+    virtual EC_T_DWORD  IsSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL* pbPresent) = 0;
+    virtual EC_T_DWORD  GetCfgSlaveInfo(EC_T_WORD wStationAddress, EC_T_CFG_SLAVE_INFO* pSlaveInfo) = 0;
+    /* bOutput=EC_TRUE：RxPDO 变量（PdOut），否则 TxPDO 变量（PdIn） */
+    virtual EC_T_DWORD  GetSlaveVarInfo(EC_T_BOOL bOutput, EC_T_WORD wStationAddress, EC_T_WORD wNumOfVarsToRead,
+                                        EC_T_PROCESS_VAR_INFO_EX* pVarInfo, EC_T_WORD* pwReadEntries) = 0;
+
+    /* CoE SDO，语义同 CEcSdoPipeline::Write/Read：
+     * - 返回 EC_E_NOERROR 表示已受理，完成时置 pHandle->bDone 并调用 pfnDone（可能在调用线程里同步完成）；
+     *   其它返回值表示未受理，不会再有回调
+     * - 实机流水线未运行时在调用线程里阻塞到 SDO 往返结束，不要在周期线程里调用
+     * - Upload 的 pbyData 在完成前必须保持有效
+     */
+    virtual EC_T_DWORD  SdoDownload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                    const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                    T_SDO_PIPE_HANDLE* pHandle = EC_NULL, EC_PF_SDO_PIPE_DONE pfnDone = EC_NULL, EC_T_VOID* pvContext = EC_NULL) = 0;
+    virtual EC_T_DWORD  SdoUpload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                  EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                  T_SDO_PIPE_HANDLE* pHandle = EC_NULL, EC_PF_SDO_PIPE_DONE pfnDone = EC_NULL, EC_T_VOID* pvContext = EC_NULL) = 0;
+};
+
+/* EC‑Master 实现（实机） */
+class CMtEcMasterAccess : public CMtMasterAccess
+{
+public:
+    explicit CMtEcMasterAccess(T_EC_DEMO_APP_CONTEXT* pAppContext);
+
+    virtual EC_T_BYTE*  GetProcessImageInputPtr(EC_T_VOID);
+    virtual EC_T_BYTE*  GetProcessImageOutputPtr(EC_T_VOID);
+    virtual EC_T_STATE  GetMasterState(EC_T_VOID);
+    virtual EC_T_DWORD  GetNumConfiguredSlaves(EC_T_VOID);
+    virtual EC_T_DWORD  IsSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL* pbPresent);
+    virtual EC_T_DWORD  GetCfgSlaveInfo(EC_T_WORD wStationAddress, EC_T_CFG_SLAVE_INFO* pSlaveInfo);
+    virtual EC_T_DWORD  GetSlaveVarInfo(EC_T_BOOL bOutput, EC_T_WORD wStationAddress, EC_T_WORD wNumOfVarsToRead,
+                                        EC_T_PROCESS_VAR_INFO_EX* pVarInfo, EC_T_WORD* pwReadEntries);
+    virtual EC_T_DWORD  SdoDownload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                    const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                    T_SDO_PIPE_HANDLE* pHandle = EC_NULL, EC_PF_SDO_PIPE_DONE pfnDone = EC_NULL, EC_T_VOID* pvContext = EC_NULL);
+    virtual EC_T_DWORD  SdoUpload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                  EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                  T_SDO_PIPE_HANDLE* pHandle = EC_NULL, EC_PF_SDO_PIPE_DONE pfnDone = EC_NULL, EC_T_VOID* pvContext = EC_NULL);
+
+private:
+    T_EC_DEMO_APP_CONTEXT* m_pAppContext;
+};
+
+#endif /* __MOTROTECH_MASTER_H__ */
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,567 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_pdo.cpp
+ *
+ * 数据驱动的 PDO 绑定（见 motrotech_pdo.h）。
+ *
+ * 解析流程（MtPdoBind）：
+ *   1) 计算 key = FNV-1a 64(ENI 内容 + 绑定表 + 从站列表)
+ *   2) 缓存文件存在且 key 一致 -> 直接套用缓存里的 (轴, 绑定, 位偏移)
+ *   3) 否则逐从站查询输入/输出变量表（变量表缓冲区复用，不再每个从站 malloc 一次），
+ *      每个变量按绑定表匹配：axis = (wIndex - base) / stride，须整除且小于该从站轴数
+ *   4) 把结果写入 My_Motor[] 的命名指针 / 扩展变量表，并回写缓存文件
+ * 主站查询都经 pAppContext->pMasterAccess（实机 EC‑Master / 仿真 CMtSimMaster 共用本文件）
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech.h"
+#include "EcDemoApp.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_PDO_CACHE_MAGIC      0x4350544D      /* "MTPC" */
+#define MT_PDO_CACHE_VERSION    1
+#define MT_PDO_FIELD_NONE       (-1)
+
+#define MT_FNV64_OFFSET         0xCBF29CE484222325ULL
+#define MT_FNV64_PRIME          0x00000100000001B3ULL
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* My_Motor_Type 里可被绑定表引用的指针字段 */
+typedef struct _T_MT_PDO_FIELD
+{
+  const EC_T_CHAR* szName;
+  size_t           nMemberOffs;   /* offsetof(My_Motor_Type, pXxx) */
+  EC_T_BYTE        byType;
+  EC_T_BYTE        byDir;
+} T_MT_PDO_FIELD;
+
+/* 缓存文件：头 + dwEntryCnt 个条目 */
+typedef struct _T_MT_PDO_CACHE_HDR
+{
+  EC_T_DWORD  dwMagic;
+  EC_T_DWORD  dwVersion;
+  EC_T_UINT64 qwKey;
+  EC_T_DWORD  dwEntryCnt;
+  EC_T_DWORD  dwReserved;
+} T_MT_PDO_CACHE_HDR;
+
+typedef struct _T_MT_PDO_CACHE_ENTRY
+{
+  EC_T_WORD   wAxis;
+  EC_T_WORD   wBinding;
+  EC_T_DWORD  dwBitOffs;
+} T_MT_PDO_CACHE_ENTRY;
+
+/*-LOCAL VARIABLES-----------------------------------------------------------*/
+#define MT_PDO_FIELD(name, member, type, dir) { name, offsetof(My_Motor_Type, member), type, dir }
+static const T_MT_PDO_FIELD S_aField[] = {
+  MT_PDO_FIELD("control_word",      pwControlWord,      MT_PDO_TYPE_U16, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("target_position",   pnTargetPosition,   MT_PDO_TYPE_S32, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("target_velocity",   pnTargetVelocity,   MT_PDO_TYPE_S32, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("target_torque",     pwTargetTorque,     MT_PDO_TYPE_U16, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("velocity_offset",   pnVelocityOffset,   MT_PDO_TYPE_S32, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("torque_offset",     pwTorqueOffset,     MT_PDO_TYPE_S16, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("mode_of_operation", pbyModeOfOperation, MT_PDO_TYPE_U8,  MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("output_1",          pwOutput_1,         MT_PDO_TYPE_U16, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("output_2",          pwOutput_2,         MT_PDO_TYPE_U16, MT_PDO_DIR_OUT),
+  MT_PDO_FIELD("error_code",        pwErrorCode,        MT_PDO_TYPE_U16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("status_word",       pwStatusWord,       MT_PDO_TYPE_U16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("actual_position",   pnActPosition,      MT_PDO_TYPE_S32, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("actual_velocity",   pnActVelocity,      MT_PDO_TYPE_S32, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("actual_torque",     pwActTorque,        MT_PDO_TYPE_U16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("following_error",   pdwActFollowErr,    MT_PDO_TYPE_U32, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("input_1",           pwInput_1,          MT_PDO_TYPE_U16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("input_2",           pwInput_2,          MT_PDO_TYPE_U16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("temp_mcu",          psTempMcu,          MT_PDO_TYPE_S16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("temp_motor",        psTempMotor,        MT_PDO_TYPE_S16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("temp_igbt",         psTempIgbt,         MT_PDO_TYPE_S16, MT_PDO_DIR_IN),
+  MT_PDO_FIELD("dc_link_voltage",   pwDcLinkVoltage,    MT_PDO_TYPE_U16, MT_PDO_DIR_IN),
+};
+#define MT_PDO_FIELD_CNT ((EC_T_INT)(sizeof(S_aField) / sizeof(S_aField[0])))
+
+/* 内置默认表：与原 MT_Setup() 写死的对象集合一致（busi.yaml 未配置 pdo_bindings 时使用） */
+static const T_MT_PDO_BINDING S_aDefaultBinding[] = {
+  { "control_word",      DRV_OBJ_CONTROL_WORD,          MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_OUT },
+  { "target_position",   DRV_OBJ_TARGET_POSITION,       MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S32, MT_PDO_DIR_OUT },
+  { "target_velocity",   DRV_OBJ_TARGET_VELOCITY,       MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S32, MT_PDO_DIR_OUT },
+  { "target_torque",     DRV_OBJ_TARGET_TORQUE,         MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_OUT },
+  { "velocity_offset",   DRV_OBJ_VELOCITY_OFFSET,       MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S32, MT_PDO_DIR_OUT },
+  { "torque_offset",     DRV_OBJ_TORQUE_OFFSET,         MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S16, MT_PDO_DIR_OUT },
+  { "mode_of_operation", DRV_OBJ_MODES_OF_OPERATION,    MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U8,  MT_PDO_DIR_OUT },
+  { "output_1",          DRV_OBJ_DIGITAL_OUTPUT,        DRV_OBJ_DIGITAL_OUTPUT_SUBINDEX_1, MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_OUT },
+  { "output_2",          DRV_OBJ_DIGITAL_OUTPUT,        DRV_OBJ_DIGITAL_OUTPUT_SUBINDEX_2, MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_OUT },
+  { "error_code",        DRV_OBJ_ERROR_CODE,            MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_IN  },
+  { "status_word",       DRV_OBJ_STATUS_WORD,           MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_IN  },
+  { "actual_position",   DRV_OBJ_POSITION_ACTUAL_VALUE, MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S32, MT_PDO_DIR_IN  },
+  { "actual_velocity",   DRV_OBJ_VELOCITY_ACTUAL_VALUE, MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S32, MT_PDO_DIR_IN  },
+  { "actual_torque",     DRV_OBJ_TORQUE_ACTUAL_VALUE,   MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_IN  },
+  { "following_error",   DRV_OBJ_FOLLOWING_ERROR,       MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U32, MT_PDO_DIR_IN  },
+  { "input_1",           DRV_OBJ_DIGITAL_INPUT,         DRV_OBJ_DIGITAL_INPUT_SUBINDEX_1,  MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_IN  },
+  { "input_2",           DRV_OBJ_DIGITAL_INPUT,         DRV_OBJ_DIGITAL_INPUT_SUBINDEX_2,  MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_IN  },
+  { "temp_mcu",          DRV_OBJ_MCU_TEMPERATURE,       MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S16, MT_PDO_DIR_IN  },
+  { "temp_motor",        DRV_OBJ_MOTOR_TEMPERATURE,     MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S16, MT_PDO_DIR_IN  },
+  { "temp_igbt",         DRV_OBJ_IGBT_TEMPERATURE,      MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_S16, MT_PDO_DIR_IN  },
+  { "dc_link_voltage",   DRV_OBJ_DC_LINK_VOLTAGE,       MT_PDO_SUBINDEX_ANY,               MT_PDO_DEFAULT_STRIDE, MT_PDO_TYPE_U16, MT_PDO_DIR_IN  },
+};
+
+/* [2026-10-16] 绑定表/解析结果/缓存路径移到 T_MT_PDO_CTX（每个主站实例一份） */
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_VOID MtPdoLoadDefaults(T_MT_PDO_CTX* pPdo)
+{
+  OsMemset(pPdo->aBinding, 0, sizeof(pPdo->aBinding));
+  pPdo->dwBindingCnt = (EC_T_DWORD)(sizeof(S_aDefaultBinding) / sizeof(S_aDefaultBinding[0]));
+  OsMemcpy(pPdo->aBinding, S_aDefaultBinding, sizeof(S_aDefaultBinding));
+}
+
+EC_T_INT MtPdoTypeBits(EC_T_BYTE byType)
+{
+  switch (byType) {
+  case MT_PDO_TYPE_U8:
+  case MT_PDO_TYPE_S8:     return 8;
+  case MT_PDO_TYPE_U16:
+  case MT_PDO_TYPE_S16:    return 16;
+  case MT_PDO_TYPE_U32:
+  case MT_PDO_TYPE_S32:
+  case MT_PDO_TYPE_REAL32: return 32;
+  default:                 return 0;
+  }
+}
+
+static EC_T_INT MtPdoFindField(const T_MT_PDO_BINDING* pBinding)
+{
+  for (EC_T_INT i = 0; i < MT_PDO_FIELD_CNT; i++) {
+    if (OsStrcmp(S_aField[i].szName, pBinding->szName) == 0) {
+      return i;
+    }
+  }
+  return MT_PDO_FIELD_NONE;
+}
+
+static EC_T_UINT64 MtFnv64(EC_T_UINT64 qwHash, const EC_T_VOID* pvData, EC_T_DWORD dwLen)
+{
+  const EC_T_BYTE* pbyData = (const EC_T_BYTE*)pvData;
+  for (EC_T_DWORD i = 0; i < dwLen; i++) {
+    qwHash ^= pbyData[i];
+    qwHash *= MT_FNV64_PRIME;
+  }
+  return qwHash;
+}
+
+/* key = ENI 内容 + 绑定表 + 从站列表；ENI 以文件名给出时哈希文件内容（文件名不变但内容改了也要失效） */
+static EC_T_UINT64 MtPdoCacheKey(const T_MT_PDO_CTX* pPdo, T_EC_DEMO_APP_CONTEXT* pAppContext, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwSlaveCnt)
+{
+  EC_T_UINT64 qwKey = MT_FNV64_OFFSET;
+  T_EC_DEMO_APP_PARMS* pAppParms = &pAppContext->AppParms;
+
+  if ((pAppParms->eCnfType == eCnfType_Filename) && (pAppParms->pbyCnfData != EC_NULL)) {
+    FILE* pFile = (FILE*)OsFopen((const char*)pAppParms->pbyCnfData, "rb");
+    if (pFile != EC_NULL) {
+      EC_T_BYTE abyBuf[4096];
+      size_t nRead = 0;
+      while ((nRead = OsFread(abyBuf, 1, sizeof(abyBuf), pFile)) > 0) {
+        qwKey = MtFnv64(qwKey, abyBuf, (EC_T_DWORD)nRead);
+      }
+      OsFclose(pFile);
+    } else {
+      qwKey = MtFnv64(qwKey, pAppParms->pbyCnfData, pAppParms->dwCnfDataLen);
+    }
+  } else if (pAppParms->pbyCnfData != EC_NULL) {
+    qwKey = MtFnv64(qwKey, pAppParms->pbyCnfData, pAppParms->dwCnfDataLen);
+  }
+  qwKey = MtFnv64(qwKey, pPdo->aBinding, pPdo->dwBindingCnt * (EC_T_DWORD)sizeof(T_MT_PDO_BINDING));
+  for (EC_T_DWORD i = 0; i < dwSlaveCnt; i++) {
+    qwKey = MtFnv64(qwKey, &pSlave[i].wStationAddress, sizeof(pSlave[i].wStationAddress));
+    qwKey = MtFnv64(qwKey, &pSlave[i].wAxisCnt, sizeof(pSlave[i].wAxisCnt));
+  }
+  return qwKey;
+}
+
+/* 读缓存：key 不一致/文件损坏返回 EC_FALSE；成功时 *ppEntry 由调用方 OsFree */
+static EC_T_BOOL MtPdoCacheLoad(const T_MT_PDO_CTX* pPdo, EC_T_UINT64 qwKey, T_MT_PDO_CACHE_ENTRY** ppEntry, EC_T_DWORD* pdwEntryCnt)
+{
+  T_MT_PDO_CACHE_HDR oHdr;
+  T_MT_PDO_CACHE_ENTRY* pEntry = EC_NULL;
+  EC_T_BOOL bOk = EC_FALSE;
+  FILE* pFile = EC_NULL;
+
+  if (pPdo->szCachePath[0] == '\0') {
+    return EC_FALSE;
+  }
+  pFile = (FILE*)OsFopen(pPdo->szCachePath, "rb");
+  if (pFile == EC_NULL) {
+    return EC_FALSE;
+  }
+  if ((OsFread(&oHdr, sizeof(oHdr), 1, pFile) == 1) && (oHdr.dwMagic == MT_PDO_CACHE_MAGIC)
+      && (oHdr.dwVersion == MT_PDO_CACHE_VERSION) && (oHdr.qwKey == qwKey)
+      && (oHdr.dwEntryCnt <= pPdo->dwVarAxisCnt * pPdo->dwBindingCnt)) {
+    pEntry = (T_MT_PDO_CACHE_ENTRY*)OsMalloc(sizeof(T_MT_PDO_CACHE_ENTRY) * (oHdr.dwEntryCnt + 1));
+    if ((pEntry != EC_NULL) && (OsFread(pEntry, sizeof(T_MT_PDO_CACHE_ENTRY), oHdr.dwEntryCnt, pFile) == oHdr.dwEntryCnt)) {
+      *ppEntry = pEntry;
+      *pdwEntryCnt = oHdr.dwEntryCnt;
+      pEntry = EC_NULL;
+      bOk = EC_TRUE;
+    }
+  }
+  OsFclose(pFile);
+  SafeOsFree(pEntry);
+  return bOk;
+}
+
+static EC_T_VOID MtPdoCacheStore(const T_MT_PDO_CTX* pPdo, EC_T_UINT64 qwKey, const T_MT_PDO_CACHE_ENTRY* pEntry, EC_T_DWORD dwEntryCnt)
+{
+  T_MT_PDO_CACHE_HDR oHdr;
+  FILE* pFile = EC_NULL;
+
+  if (pPdo->szCachePath[0] == '\0') {
+    return;
+  }
+  pFile = (FILE*)OsFopen(pPdo->szCachePath, "wb");
+  if (pFile == EC_NULL) {
+    return;
+  }
+  OsMemset(&oHdr, 0, sizeof(oHdr));
+  oHdr.dwMagic    = MT_PDO_CACHE_MAGIC;
+  oHdr.dwVersion  = MT_PDO_CACHE_VERSION;
+  oHdr.qwKey      = qwKey;
+  oHdr.dwEntryCnt = dwEntryCnt;
+  OsFwrite(&oHdr, sizeof(oHdr), 1, pFile);
+  if (dwEntryCnt > 0) {
+    OsFwrite(pEntry, sizeof(T_MT_PDO_CACHE_ENTRY), dwEntryCnt, pFile);
+  }
+  OsFclose(pFile);
+}
+
+/* 在一个从站的变量表里匹配绑定，结果追加到 pEntry[] */
+static EC_T_VOID MtPdoMatchVars(const T_MT_PDO_CTX* pPdo, const EC_T_PROCESS_VAR_INFO_EX* pVarInfo, EC_T_WORD wVarCnt,
+                                EC_T_BYTE byDir, EC_T_DWORD dwFirstAxis, EC_T_WORD wAxisCnt,
+                                T_MT_PDO_CACHE_ENTRY* pEntry, EC_T_DWORD* pdwEntryCnt)
+{
+  for (EC_T_WORD v = 0; v < wVarCnt; v++) {
+    const EC_T_PROCESS_VAR_INFO_EX* pVar = &pVarInfo[v];
+    for (EC_T_DWORD b = 0; b < pPdo->dwBindingCnt; b++) {
+      const T_MT_PDO_BINDING* pBinding = &pPdo->aBinding[b];
+      EC_T_DWORD dwAxis = 0;
+
+      if ((pBinding->byDir != byDir) || (pVar->wIndex < pBinding->wIndex)) {
+        continue;
+      }
+      if ((pBinding->wSubIndex != MT_PDO_SUBINDEX_ANY) && (pBinding->wSubIndex != pVar->wSubIndex)) {
+        continue;
+      }
+      if (pBinding->wAxisStride == 0) {
+        if (pVar->wIndex != pBinding->wIndex) {
+          continue;
+        }
+      } else {
+        EC_T_DWORD dwDelta = (EC_T_DWORD)(pVar->wIndex - pBinding->wIndex);
+        if ((dwDelta % pBinding->wAxisStride) != 0) {
+          continue;
+        }
+        dwAxis = dwDelta / pBinding->wAxisStride;
+      }
+      if ((dwAxis >= wAxisCnt) || (dwFirstAxis + dwAxis >= pPdo->dwVarAxisCnt)) {
+        continue;
+      }
+      if (pVar->nBitSize != MtPdoTypeBits(pBinding->byType)) {
+        EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING,
+            "Motrotech: PDO %s 0x%04X:%d is %d bit, binding expects %d bit, ignored\n",
+            pBinding->szName, pVar->wIndex, pVar->wSubIndex, pVar->nBitSize, MtPdoTypeBits(pBinding->byType)));
+        continue;
+      }
+      /* 与原 if/else 链一致：一个变量只绑定到第一条匹配的绑定 */
+      pEntry[*pdwEntryCnt].wAxis     = (EC_T_WORD)(dwFirstAxis + dwAxis);
+      pEntry[*pdwEntryCnt].wBinding  = (EC_T_WORD)b;
+      pEntry[*pdwEntryCnt].dwBitOffs = (EC_T_DWORD)pVar->nBitOffs;
+      (*pdwEntryCnt)++;
+      break;
+    }
+  }
+}
+
+/* 逐从站查询变量表并匹配（无缓存或缓存失效时）
+ * [2026-10-16] 说明：单个从站查询失败时跳过该从站继续（本次运行按部分绑定），*pdwFailedCnt 返回失败的从站数，
+ * 调用方据此不写缓存，避免一次偶发失败被缓存下来、之后每次启动都是不完整的绑定 */
+static EC_T_DWORD MtPdoResolve(const T_MT_PDO_CTX* pPdo, T_EC_DEMO_APP_CONTEXT* pAppContext, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwSlaveCnt,
+                               T_MT_PDO_CACHE_ENTRY* pEntry, EC_T_DWORD* pdwEntryCnt, EC_T_DWORD* pdwFailedCnt)
+{
+  EC_T_DWORD dwRetVal = EC_E_NOERROR;
+  EC_T_PROCESS_VAR_INFO_EX* pVarInfo = EC_NULL;
+  EC_T_WORD wVarInfoCap = 0;
+  EC_T_DWORD dwFirstAxis = 0;
+  CMtMasterAccess* pMaster = pAppContext->pMasterAccess;
+
+  *pdwFailedCnt = 0;
+  for (EC_T_DWORD dwSlaveIdx = 0; dwSlaveIdx < dwSlaveCnt; dwSlaveIdx++) {
+    EC_T_CFG_SLAVE_INFO oSlaveInfo;
+    const EC_T_WORD wStation = pSlave[dwSlaveIdx].wStationAddress;
+
+    OsMemset(&oSlaveInfo, 0, sizeof(EC_T_CFG_SLAVE_INFO));
+    if (pMaster->GetCfgSlaveInfo(wStation, &oSlaveInfo) != EC_E_NOERROR) {
+      EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "ERROR: GetCfgSlaveInfo() returns with error."));
+      dwFirstAxis += pSlave[dwSlaveIdx].wAxisCnt;
+      (*pdwFailedCnt)++;
+      continue;
+    }
+
+    /* 变量表缓冲区按最大需求增长，所有从站复用 */
+    EC_T_WORD wNeed = (oSlaveInfo.wNumProcessVarsOutp > oSlaveInfo.wNumProcessVarsInp) ? oSlaveInfo.wNumProcessVarsOutp : oSlaveInfo.wNumProcessVarsInp;
+    if (wNeed > wVarInfoCap) {
+      SafeOsFree(pVarInfo);
+      wVarInfoCap = 0;
+      pVarInfo = (EC_T_PROCESS_VAR_INFO_EX*)OsMalloc(sizeof(EC_T_PROCESS_VAR_INFO_EX) * wNeed);
+      if (pVarInfo == EC_NULL) {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR, "Motrotech: Malloc memory fail"));
+        dwRetVal = EC_E_NOMEMORY;
+        break;
+      }
+      wVarInfoCap = wNeed;
+    }
+
+    EC_T_BOOL bSlaveFailed = EC_FALSE;
+    for (EC_T_BYTE byDir = MT_PDO_DIR_OUT; byDir <= MT_PDO_DIR_IN; byDir++) {
+      EC_T_WORD wVarCnt = (byDir == MT_PDO_DIR_OUT) ? oSlaveInfo.wNumProcessVarsOutp : oSlaveInfo.wNumProcessVarsInp;
+      EC_T_WORD wEntries = 0;
+      EC_T_DWORD dwRes = EC_E_NOERROR;
+
+      if (wVarCnt == 0) {
+        continue;
+      }
+      dwRes = pMaster->GetSlaveVarInfo((byDir == MT_PDO_DIR_OUT) ? EC_TRUE : EC_FALSE, wStation, wVarCnt, pVarInfo, &wEntries);
+      if (dwRes != EC_E_NOERROR) {
+        EcLogMsg(EC_LOG_LEVEL_ERROR, (pEcLogContext, EC_LOG_LEVEL_ERROR,
+            "ERROR: GetSlaveVarInfo(%s) (Result = %s 0x%x)", (byDir == MT_PDO_DIR_OUT) ? "Outp" : "Inp", ecatGetText(dwRes), dwRes));
+        bSlaveFailed = EC_TRUE;
+        continue;
+      }
+      MtPdoMatchVars(pPdo, pVarInfo, wEntries, byDir, dwFirstAxis, pSlave[dwSlaveIdx].wAxisCnt, pEntry, pdwEntryCnt);
+    }
+    if (bSlaveFailed) {
+      (*pdwFailedCnt)++;
+    }
+    dwFirstAxis += pSlave[dwSlaveIdx].wAxisCnt;
+  }
+
+  SafeOsFree(pVarInfo);
+  return dwRetVal;
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+EC_T_DWORD MT_SetPdoBindings(T_MT_PDO_CTX* pPdo, const T_MT_PDO_BINDING* pBinding, EC_T_DWORD dwCnt)
+{
+  if ((pBinding == EC_NULL) || (dwCnt == 0)) {
+    MtPdoLoadDefaults(pPdo);
+    return EC_E_NOERROR;
+  }
+  if (dwCnt > MT_PDO_MAX_BINDINGS) {
+    return EC_E_INVALIDSIZE;
+  }
+  for (EC_T_DWORD i = 0; i < dwCnt; i++) {
+    if ((pBinding[i].szName[0] == '\0') || (MtPdoTypeBits(pBinding[i].byType) == 0) || (pBinding[i].byDir > MT_PDO_DIR_IN)) {
+      return EC_E_INVALIDPARM;
+    }
+  }
+  /* 整表清零再拷贝：名字后面的填充字节参与缓存 key 计算，必须确定 */
+  OsMemset(pPdo->aBinding, 0, sizeof(pPdo->aBinding));
+  for (EC_T_DWORD i = 0; i < dwCnt; i++) {
+    pPdo->aBinding[i] = pBinding[i];
+    pPdo->aBinding[i].szName[MT_PDO_NAME_LEN - 1] = '\0';
+  }
+  pPdo->dwBindingCnt = dwCnt;
+  return EC_E_NOERROR;
+}
+
+EC_T_VOID MT_SetPdoCachePath(T_MT_PDO_CTX* pPdo, const EC_T_CHAR* szPath)
+{
+  OsMemset(pPdo->szCachePath, 0, sizeof(pPdo->szCachePath));
+  if (szPath != EC_NULL) {
+    OsStrncpy(pPdo->szCachePath, szPath, sizeof(pPdo->szCachePath) - 1);
+  }
+}
+
+EC_T_VOID MtPdoCtxRelease(T_MT_PDO_CTX* pPdo)
+{
+  SafeOsFree(pPdo->ppbyVar);
+  pPdo->dwVarAxisCnt = 0;
+}
+
+EC_T_BOOL MT_PdoTypeFromName(const EC_T_CHAR* szName, EC_T_BYTE* pbyType)
+{
+  static const struct { const EC_T_CHAR* szName; EC_T_BYTE byType; } s_aType[] = {
+    { "u8", MT_PDO_TYPE_U8 },   { "s8", MT_PDO_TYPE_S8 },
+    { "u16", MT_PDO_TYPE_U16 }, { "s16", MT_PDO_TYPE_S16 },
+    { "u32", MT_PDO_TYPE_U32 }, { "s32", MT_PDO_TYPE_S32 },
+    { "real32", MT_PDO_TYPE_REAL32 }, { "f32", MT_PDO_TYPE_REAL32 },
+  };
+  for (EC_T_DWORD i = 0; i < sizeof(s_aType) / sizeof(s_aType[0]); i++) {
+    if (OsStrcmp(s_aType[i].szName, szName) == 0) {
+      *pbyType = s_aType[i].byType;
+      return EC_TRUE;
+    }
+  }
+  return EC_FALSE;
+}
+
+EC_T_BOOL MT_PdoDirFromName(const EC_T_CHAR* szName, EC_T_BYTE* pbyDir)
+{
+  if (OsStrcmp(szName, "out") == 0) {
+    *pbyDir = MT_PDO_DIR_OUT;
+    return EC_TRUE;
+  }
+  if (OsStrcmp(szName, "in") == 0) {
+    *pbyDir = MT_PDO_DIR_IN;
+    return EC_TRUE;
+  }
+  return EC_FALSE;
+}
+
+const T_MT_PDO_BINDING* MT_GetPdoBinding(T_MT_PDO_CTX* pPdo, EC_T_DWORD dwIdx, EC_T_BOOL* pbExtra)
+{
+  if (pPdo->dwBindingCnt == 0) {
+    MtPdoLoadDefaults(pPdo);
+  }
+  if (dwIdx >= pPdo->dwBindingCnt) {
+    return EC_NULL;
+  }
+  if (pbExtra != EC_NULL) {
+    *pbExtra = (MtPdoFindField(&pPdo->aBinding[dwIdx]) == MT_PDO_FIELD_NONE);
+  }
+  return &pPdo->aBinding[dwIdx];
+}
+
+EC_T_BOOL MT_GetPdoVar(const T_MT_PDO_CTX* pPdo, EC_T_WORD wAxis, const EC_T_CHAR* szName, EC_T_LREAL* pfVal)
+{
+  if ((pPdo->ppbyVar == EC_NULL) || (wAxis >= pPdo->dwVarAxisCnt) || (szName == EC_NULL) || (pfVal == EC_NULL)) {
+    return EC_FALSE;
+  }
+  for (EC_T_DWORD b = 0; b < pPdo->dwBindingCnt; b++) {
+    if (OsStrcmp(pPdo->aBinding[b].szName, szName) != 0) {
+      continue;
+    }
+    const EC_T_BYTE* pbyVar = pPdo->ppbyVar[wAxis * pPdo->dwBindingCnt + b];
+    if (pbyVar == EC_NULL) {
+      return EC_FALSE;
+    }
+    switch (pPdo->aBinding[b].byType) {
+    case MT_PDO_TYPE_U8:  *pfVal = (EC_T_LREAL)(*pbyVar); break;
+    case MT_PDO_TYPE_S8:  *pfVal = (EC_T_LREAL)(*(const EC_T_SBYTE*)pbyVar); break;
+    case MT_PDO_TYPE_U16: *pfVal = (EC_T_LREAL)EC_GETWORD(pbyVar); break;
+    case MT_PDO_TYPE_S16: *pfVal = (EC_T_LREAL)(EC_T_SWORD)EC_GETWORD(pbyVar); break;
+    case MT_PDO_TYPE_U32: *pfVal = (EC_T_LREAL)EC_GETDWORD(pbyVar); break;
+    case MT_PDO_TYPE_S32: *pfVal = (EC_T_LREAL)(EC_T_INT)EC_GETDWORD(pbyVar); break;
+    case MT_PDO_TYPE_REAL32: {
+      EC_T_DWORD dwRaw = EC_GETDWORD(pbyVar);
+      EC_T_REAL fRaw = 0;
+      OsMemcpy(&fRaw, &dwRaw, sizeof(fRaw));
+      *pfVal = (EC_T_LREAL)fRaw;
+      break;
+    }
+    default: return EC_FALSE;
+    }
+    return EC_TRUE;
+  }
+  return EC_FALSE;
+}
+
+/******************************************************************************
+ * MtPdoBind
+ * 按绑定表建立 pMotor[0..dwAxisCnt) 的 PDO 指针（由 MT_Setup() 调用）。
+ * - pSlave[] 的轴按顺序摊平到 pMotor[]（与 MT_Prepare() 一致）
+ * - 命名字段写入 My_Motor_Type 的对应指针；所有绑定（含扩展变量）都记录到 pPdo->ppbyVar
+ ******************************************************************************/
+EC_T_DWORD MtPdoBind(T_MT_PDO_CTX* pPdo, T_EC_DEMO_APP_CONTEXT* pAppContext, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwSlaveCnt,
+                     My_Motor_Type* pMotor, EC_T_DWORD dwAxisCnt)
+{
+  EC_T_DWORD dwRetVal = EC_E_NOERROR;
+  EC_T_BYTE* pbyPDIn = EC_NULL;
+  EC_T_BYTE* pbyPDOut = EC_NULL;
+  T_MT_PDO_CACHE_ENTRY* pEntry = EC_NULL;
+  EC_T_DWORD dwEntryCnt = 0;
+  EC_T_DWORD dwExtraCnt = 0;
+  EC_T_UINT64 qwKey = 0;
+
+  if (pAppContext->pMasterAccess == EC_NULL) {
+    return EC_E_INVALIDSTATE;
+  }
+  pbyPDIn = pAppContext->pMasterAccess->GetProcessImageInputPtr();
+  pbyPDOut = pAppContext->pMasterAccess->GetProcessImageOutputPtr();
+  if ((pbyPDIn == EC_NULL) || (pbyPDOut == EC_NULL)) {
+    return EC_E_INVALIDSTATE;
+  }
+  if (pPdo->dwBindingCnt == 0) {
+    MtPdoLoadDefaults(pPdo);
+  }
+
+  /* 1) 解析结果表按当前轴数/绑定数重新分配 */
+  MtPdoCtxRelease(pPdo);
+  if (dwAxisCnt == 0) {
+    return EC_E_NOERROR;
+  }
+  pPdo->ppbyVar = (EC_T_BYTE**)OsMalloc(sizeof(EC_T_BYTE*) * dwAxisCnt * pPdo->dwBindingCnt);
+  if (pPdo->ppbyVar == EC_NULL) {
+    return EC_E_NOMEMORY;
+  }
+  OsMemset(pPdo->ppbyVar, 0, sizeof(EC_T_BYTE*) * dwAxisCnt * pPdo->dwBindingCnt);
+  pPdo->dwVarAxisCnt = dwAxisCnt;
+
+  /* 2) 绑定名 -> My_Motor_Type 字段；类型/方向与字段不符时降级为扩展变量，避免按错误宽度访问 */
+  for (EC_T_DWORD b = 0; b < pPdo->dwBindingCnt; b++) {
+    pPdo->anField[b] = MtPdoFindField(&pPdo->aBinding[b]);
+    if ((pPdo->anField[b] != MT_PDO_FIELD_NONE)
+        && ((S_aField[pPdo->anField[b]].byType != pPdo->aBinding[b].byType) || (S_aField[pPdo->anField[b]].byDir != pPdo->aBinding[b].byDir))) {
+      EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING,
+          "Motrotech: PDO binding %s type/dir does not match the field, treated as extra variable\n", pPdo->aBinding[b].szName));
+      pPdo->anField[b] = MT_PDO_FIELD_NONE;
+    }
+    if (pPdo->anField[b] == MT_PDO_FIELD_NONE) {
+      dwExtraCnt++;
+    }
+  }
+
+  /* 3) 缓存命中直接套用，否则查询 master 并回写缓存 */
+  qwKey = MtPdoCacheKey(pPdo, pAppContext, pSlave, dwSlaveCnt);
+  if (MtPdoCacheLoad(pPdo, qwKey, &pEntry, &dwEntryCnt)) {
+    EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO,
+        "Motrotech: PDO bindings loaded from cache %s (%d entries)", pPdo->szCachePath, dwEntryCnt));
+  } else {
+    pEntry = (T_MT_PDO_CACHE_ENTRY*)OsMalloc(sizeof(T_MT_PDO_CACHE_ENTRY) * dwAxisCnt * pPdo->dwBindingCnt);
+    if (pEntry == EC_NULL) {
+      return EC_E_NOMEMORY;
+    }
+    EC_T_DWORD dwFailedCnt = 0;
+    dwEntryCnt = 0;
+    dwRetVal = MtPdoResolve(pPdo, pAppContext, pSlave, dwSlaveCnt, pEntry, &dwEntryCnt, &dwFailedCnt);
+    if ((dwRetVal == EC_E_NOERROR) && (dwFailedCnt == 0)) {
+      MtPdoCacheStore(pPdo, qwKey, pEntry, dwEntryCnt);
+    } else if (dwFailedCnt > 0) {
+      EcLogMsg(EC_LOG_LEVEL_WARNING, (pEcLogContext, EC_LOG_LEVEL_WARNING,
+          "Motrotech: %d slave(s) not resolved, PDO bindings incomplete and not cached\n", dwFailedCnt));
+    }
+  }
+
+  /* 4) 落地：(轴, 绑定, 位偏移) -> 指针 */
+  for (EC_T_DWORD i = 0; i < dwEntryCnt; i++) {
+    const T_MT_PDO_CACHE_ENTRY* pE = &pEntry[i];
+    if ((pE->wAxis >= dwAxisCnt) || (pE->wBinding >= pPdo->dwBindingCnt)) {
+      continue;
+    }
+    const T_MT_PDO_BINDING* pBinding = &pPdo->aBinding[pE->wBinding];
+    EC_T_BYTE* pbyVar = ((pBinding->byDir == MT_PDO_DIR_OUT) ? pbyPDOut : pbyPDIn) + pE->dwBitOffs / 8;
+
+    pPdo->ppbyVar[pE->wAxis * pPdo->dwBindingCnt + pE->wBinding] = pbyVar;
+    if (pPdo->anField[pE->wBinding] != MT_PDO_FIELD_NONE) {
+      EC_T_BYTE** ppbyMember = (EC_T_BYTE**)((EC_T_BYTE*)&pMotor[pE->wAxis] + S_aField[pPdo->anField[pE->wBinding]].nMemberOffs);
+      *ppbyMember = pbyVar;
+    }
+  }
+  EcLogMsg(EC_LOG_LEVEL_INFO, (pEcLogContext, EC_LOG_LEVEL_INFO,
+      "Motrotech: %d PDO variables bound (%d bindings, %d extra, %d axes)", dwEntryCnt, pPdo->dwBindingCnt, dwExtraCnt, dwAxisCnt));
+
+  SafeOsFree(pEntry);
+  return dwRetVal;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
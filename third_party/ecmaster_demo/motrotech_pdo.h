@@ -0,0 +1,93 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_pdo.h
+ *
+ * 作用：数据驱动的 PDO 绑定表（替代 MT_Setup() 里按对象号写死的 if/else 链）。
+ *
+ * - 每条绑定描述一个 PDO 变量：名字、对象索引、子索引、数据类型、方向（输入/输出）、每轴索引步长
+ *   例：{ "status_word", 0x6041, ANY, u16, in, 0x800 } 表示 Axis0=0x6041、Axis1=0x6841 ...
+ * - 名字若是 `My_Motor_Type` 中已知的字段（见 motrotech_pdo.cpp 的字段表），解析后直接写入该指针；
+ *   未知名字作为“扩展变量”保存，用 `MT_GetPdoVar()` 按名字读取（不需要改代码）
+ * - 绑定表来自 busi.yaml（`ethercat_demo.pdo_bindings`，由 BasicService 解析后调用 `MT_SetPdoBindings()`）；
+ *   未配置时使用内置默认表（与原来写死的对象集合一致，步长 0x800）
+ * - 解析结果（轴号, 绑定号, 位偏移）可缓存到文件，key 为 ENI 内容 + 绑定表 + 从站列表的哈希；
+ *   下次启动哈希一致时直接套用，跳过逐从站查询变量表；有从站查询失败（部分绑定）时不写缓存
+ * - [2026-10-16] 绑定表/解析结果/缓存路径放在 T_MT_PDO_CTX 里（每个主站实例一份，见 T_MT_CONTEXT::oPdo），
+ *   不同网段可以用不同的绑定表和缓存文件
+ *---------------------------------------------------------------------------*/
+#ifndef __MOTROTECH_PDO_H__
+#define __MOTROTECH_PDO_H__     1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcDemoParms.h"
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_PDO_NAME_LEN             32          /* 绑定名最大长度（含结尾 0） */
+#define MT_PDO_MAX_BINDINGS         64          /* 绑定表最大条数 */
+#define MT_PDO_SUBINDEX_ANY         0xFFFF      /* 不区分子索引 */
+#define MT_PDO_DEFAULT_STRIDE       0x800       /* 默认每轴对象索引步长（原 OBJOFFSET） */
+
+/* 变量数据类型（决定位宽校验与扩展变量的读取方式） */
+#define MT_PDO_TYPE_U8              1
+#define MT_PDO_TYPE_S8              2
+#define MT_PDO_TYPE_U16             3
+#define MT_PDO_TYPE_S16             4
+#define MT_PDO_TYPE_U32             5
+#define MT_PDO_TYPE_S32             6
+#define MT_PDO_TYPE_REAL32          7
+
+/* 方向：OUT=主站写（RxPDO, PdOut），IN=主站读（TxPDO, PdIn） */
+#define MT_PDO_DIR_OUT              0
+#define MT_PDO_DIR_IN               1
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+typedef struct _T_MT_PDO_BINDING
+{
+    EC_T_CHAR   szName[MT_PDO_NAME_LEN];    /* 字段名（如 "status_word"）或自定义扩展名 */
+    EC_T_WORD   wIndex;                     /* Axis0 的对象索引 */
+    EC_T_WORD   wSubIndex;                  /* 子索引，MT_PDO_SUBINDEX_ANY=不区分 */
+    EC_T_WORD   wAxisStride;                /* 每轴索引步长，0=每个从站只有一份（只绑到该从站第 0 轴） */
+    EC_T_BYTE   byType;                     /* MT_PDO_TYPE_* */
+    EC_T_BYTE   byDir;                      /* MT_PDO_DIR_* */
+} T_MT_PDO_BINDING;
+
+/* [2026-10-16] 一个主站实例的绑定状态（调用方持有，清零即为“未配置，使用内置默认表”） */
+typedef struct _T_MT_PDO_CTX
+{
+    T_MT_PDO_BINDING aBinding[MT_PDO_MAX_BINDINGS];   /* 当前生效的绑定表（dwBindingCnt==0 时首次使用前装入默认表） */
+    EC_T_DWORD  dwBindingCnt;
+    EC_T_INT    anField[MT_PDO_MAX_BINDINGS];       /* 每条绑定对应的字段表下标，-1=扩展变量 */
+    EC_T_BYTE** ppbyVar;                            /* [axis * dwBindingCnt + binding] -> ProcessImage 地址（含扩展变量） */
+    EC_T_DWORD  dwVarAxisCnt;
+    EC_T_CHAR   szCachePath[256];                   /* 缓存文件路径，空串=不缓存 */
+} T_MT_PDO_CTX;
+
+/*-FUNCTION DECLARATIONS-----------------------------------------------------*/
+/* 配置接口（在 EcDemoApp() 启动前调用）
+ * - MT_SetPdoBindings(EC_NULL, 0) 恢复内置默认表
+ * - MT_SetPdoCachePath("") 关闭缓存
+ */
+EC_T_DWORD  MT_SetPdoBindings(T_MT_PDO_CTX* pPdo, const T_MT_PDO_BINDING* pBinding, EC_T_DWORD dwCnt);
+EC_T_VOID   MT_SetPdoCachePath(T_MT_PDO_CTX* pPdo, const EC_T_CHAR* szPath);
+/* 释放 MtPdoBind() 分配的解析结果（绑定表/缓存路径保留） */
+EC_T_VOID   MtPdoCtxRelease(T_MT_PDO_CTX* pPdo);
+
+/* 配置文件里的类型/方向字符串转换（"u8/s8/u16/s16/u32/s32/real32"、"in/out"） */
+EC_T_BOOL   MT_PdoTypeFromName(const EC_T_CHAR* szName, EC_T_BYTE* pbyType);
+EC_T_BOOL   MT_PdoDirFromName(const EC_T_CHAR* szName, EC_T_BYTE* pbyDir);
+
+/* 按名字读取某轴的 PDO 变量（任意绑定均可，含扩展变量）；未绑定时返回 EC_FALSE */
+EC_T_BOOL   MT_GetPdoVar(const T_MT_PDO_CTX* pPdo, EC_T_WORD wAxis, const EC_T_CHAR* szName, EC_T_LREAL* pfVal);
+
+/* 遍历绑定表；pbExtra 非空时返回该绑定是否为扩展变量（不对应 My_Motor_Type 字段） */
+const T_MT_PDO_BINDING* MT_GetPdoBinding(T_MT_PDO_CTX* pPdo, EC_T_DWORD dwIdx, EC_T_BOOL* pbExtra);
+
+/* MT_PDO_TYPE_* 的位宽，未知类型返回 0（仿真主站按它排布过程映像） */
+EC_T_INT    MtPdoTypeBits(EC_T_BYTE byType);
+
+/* 由 MT_Setup() 调用：按绑定表把 ProcessImage 地址写入 pMotor[] 的指针成员 */
+EC_T_DWORD  MtPdoBind(T_MT_PDO_CTX* pPdo, T_EC_DEMO_APP_CONTEXT* pAppContext,
+                      const struct _SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwSlaveCnt,
+                      struct _Motor_Type* pMotor, EC_T_DWORD dwAxisCnt);
+
+#endif /* __MOTROTECH_PDO_H__ */
+/*-END OF SOURCE FILE--------------------------------------------------------*/
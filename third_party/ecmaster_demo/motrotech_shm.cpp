@@ -0,0 +1,402 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_shm.cpp
+ *
+ * 过程数据共享内存实现（见 motrotech_shm.h）。
+ *
+ * 状态 seqlock：写者先把序号改成奇数，release 屏障后写数据，再以 release 写回偶数；
+ * 读者 acquire 读序号（奇数则重读），拷贝数据，acquire 屏障后再读序号，两次相同才算一致。
+ * 命令三缓冲：前台块（周期线程）、中间块（共享）、后备块（控制器）三者始终是 {0,1,2} 的一个排列，
+ * 双方只通过对 dwCmdMiddle 的原子交换换块，谁都不会等对方。
+ * 唤醒：dwCycleFutex 与 dwWaiters 都用 seq_cst 访问（发布方先加计数再看等待者，等待方先加等待者再看计数），
+ * 不会丢唤醒；没有等待者时发布不进系统调用。
+ * 进程内发布：MtShmCreate() 把句柄填好后最后写 pPublished；MtShmAcquire() 先加 dwUsers 再读 pPublished，
+ * MtShmDelete() 先清 pPublished 再等 dwUsers 归 0（都用 seq_cst，和唤醒同理），之后才改句柄、解除映射，
+ * 读者不会读到半建好或已解除映射的段。
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stddef.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_SHM_READ_RETRY       10000   /* MtShmReadState()：写者一直在写入中时放弃 */
+
+#define MT_SHM_LOAD_ACQ(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define MT_SHM_STORE_REL(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/* 布局即协议：头固定 256 字节（seqlock/futex/命令交换各占一条 cache line） */
+static_assert(sizeof(T_MT_SHM_HDR) == 256, "T_MT_SHM_HDR layout changed, bump MT_SHM_VERSION");
+static_assert(sizeof(T_MT_SHM_CMD_BLK) == 24, "T_MT_SHM_CMD_BLK layout changed, bump MT_SHM_VERSION");
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_DWORD MtShmCmdBlkSize(EC_T_DWORD dwAxisCnt)
+{
+  return (EC_T_DWORD)(sizeof(T_MT_SHM_CMD_BLK) + ((dwAxisCnt + 7) & ~7u) + dwAxisCnt * sizeof(MotorCmd_) + 63) & ~63u;
+}
+
+static T_MT_SHM_CMD_BLK* MtShmCmdBlk(const T_MT_SHM* pShm, EC_T_DWORD dwIdx)
+{
+  const T_MT_SHM_HDR* pHdr = pShm->pHdr;
+  return (T_MT_SHM_CMD_BLK*)((EC_T_BYTE*)pHdr + pHdr->dwCmdOffset + dwIdx * pHdr->dwCmdBlkSize);
+}
+
+static EC_T_BYTE* MtShmCmdValid(T_MT_SHM_CMD_BLK* pBlk)
+{
+  return (EC_T_BYTE*)(pBlk + 1);
+}
+
+static MotorCmd_* MtShmCmdArray(T_MT_SHM_CMD_BLK* pBlk)
+{
+  return (MotorCmd_*)(MtShmCmdValid(pBlk) + ((pBlk->dwAxisCnt + 7) & ~7u));
+}
+
+static EC_T_VOID MtShmFutexWakeAll(T_MT_SHM_HDR* pHdr)
+{
+  /* 不加 FUTEX_PRIVATE_FLAG：等待者在别的进程 */
+  syscall(SYS_futex, &pHdr->dwCycleFutex, FUTEX_WAKE, INT_MAX, EC_NULL, EC_NULL, 0);
+}
+
+static EC_T_UINT64 MtShmNowNsec(EC_T_VOID)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (EC_T_UINT64)ts.tv_sec * 1000000000ULL + (EC_T_UINT64)ts.tv_nsec;
+}
+
+/* 句柄清零，pPublished/dwUsers 除外（读者可能正在 MtShmAcquire() 里读写它们） */
+static EC_T_VOID MtShmReset(T_MT_SHM* pShm)
+{
+  OsMemset(pShm, 0, offsetof(T_MT_SHM, pPublished));
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+EC_T_DWORD MtShmCreate(T_MT_SHM* pShm, const EC_T_CHAR* szName, EC_T_DWORD dwAxisCnt, EC_T_DWORD dwCycleUsec)
+{
+  const EC_T_DWORD dwStateOffset = sizeof(T_MT_SHM_HDR);
+  const EC_T_DWORD dwCmdOffset = (dwStateOffset + dwAxisCnt * (EC_T_DWORD)sizeof(MotorState_) + 63) & ~63u;
+  const EC_T_DWORD dwCmdBlkSize = MtShmCmdBlkSize(dwAxisCnt);
+  const EC_T_DWORD dwSize = dwCmdOffset + 3 * dwCmdBlkSize;
+  T_MT_SHM_HDR* pHdr = EC_NULL;
+  EC_T_VOID* pvMap = MAP_FAILED;
+  int nFd = -1;
+
+  MtShmReset(pShm);
+  if ((dwAxisCnt == 0) || (dwAxisCnt > MT_SHM_MAX_AXIS)
+      || ((szName != EC_NULL) && ((szName[0] != '/') || (OsStrlen(szName) >= MT_SHM_NAME_SIZE)))) {
+    return EC_E_INVALIDPARM;
+  }
+  if (szName != EC_NULL) {
+    /* 上次异常退出留下的同名段：控制器仍映射着旧段也不受影响（它会看到 dwServerAlive=0） */
+    shm_unlink(szName);
+    nFd = shm_open(szName, O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (nFd < 0) {
+      return EC_E_OPENFAILED;
+    }
+    if (ftruncate(nFd, (off_t)dwSize) != 0) {
+      close(nFd);
+      shm_unlink(szName);
+      return EC_E_NOMEMORY;
+    }
+    pvMap = mmap(EC_NULL, dwSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, nFd, 0);
+    close(nFd);
+    if (pvMap == MAP_FAILED) {
+      shm_unlink(szName);
+      return EC_E_NOMEMORY;
+    }
+    OsSnprintf(pShm->szName, sizeof(pShm->szName), "%s", szName);
+    pShm->bShared = EC_TRUE;
+  } else {
+    pvMap = mmap(EC_NULL, dwSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (pvMap == MAP_FAILED) {
+      return EC_E_NOMEMORY;
+    }
+  }
+
+  /* 新段内容为 0：只填非 0 字段，魔数最后写 */
+  pHdr = (T_MT_SHM_HDR*)pvMap;
+  pHdr->dwVersion = MT_SHM_VERSION;
+  pHdr->dwSize = dwSize;
+  pHdr->dwAxisCnt = dwAxisCnt;
+  pHdr->dwCycleUsec = dwCycleUsec;
+  pHdr->dwStateSize = sizeof(MotorState_);
+  pHdr->dwCmdSize = sizeof(MotorCmd_);
+  pHdr->dwStateOffset = dwStateOffset;
+  pHdr->dwCmdOffset = dwCmdOffset;
+  pHdr->dwCmdBlkSize = dwCmdBlkSize;
+  pHdr->dwServerPid = (EC_T_DWORD)getpid();
+  pHdr->dwServerAlive = 1;
+  pHdr->dwCmdMiddle = 1;                /* 前台 0（周期线程）、中间 1、后备 2（控制器） */
+  pHdr->dwCmdBack = 2;
+  MT_SHM_STORE_REL(&pHdr->dwMagic, (EC_T_DWORD)MT_SHM_MAGIC);
+
+  pShm->pHdr = pHdr;
+  pShm->dwMapSize = dwSize;
+  pShm->bServer = EC_TRUE;
+  pShm->pState = (MotorState_*)((EC_T_BYTE*)pHdr + dwStateOffset);
+  pShm->dwAxisCnt = dwAxisCnt;
+  pShm->dwCmdIdx = 0;
+  /* 句柄填完整之后才发布给进程内的其它线程 */
+  __atomic_store_n(&pShm->pPublished, pHdr, __ATOMIC_SEQ_CST);
+  return EC_E_NOERROR;
+}
+
+EC_T_VOID MtShmDelete(T_MT_SHM* pShm)
+{
+  T_MT_SHM_HDR* pHdr = pShm->pHdr;
+
+  if (pHdr == EC_NULL) {
+    return;
+  }
+  /* 撤下发布，等进程内读者（MtShmAcquire()）退出；持有期间只拷贝快照，不会等很久 */
+  __atomic_store_n(&pShm->pPublished, (T_MT_SHM_HDR*)EC_NULL, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&pShm->dwUsers, __ATOMIC_SEQ_CST) != 0) {
+    sched_yield();
+  }
+  /* 再让等待中的控制器醒来并看到服务端已退出 */
+  MT_SHM_STORE_REL(&pHdr->dwServerAlive, 0);
+  __atomic_add_fetch(&pHdr->dwCycleFutex, 1, __ATOMIC_SEQ_CST);
+  MtShmFutexWakeAll(pHdr);
+  munmap(pHdr, pShm->dwMapSize);
+  if (pShm->bShared) {
+    shm_unlink(pShm->szName);
+  }
+  MtShmReset(pShm);
+}
+
+EC_T_BOOL MtShmAcquire(T_MT_SHM* pShm)
+{
+  __atomic_add_fetch(&pShm->dwUsers, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&pShm->pPublished, __ATOMIC_SEQ_CST) == EC_NULL) {
+    __atomic_sub_fetch(&pShm->dwUsers, 1, __ATOMIC_RELEASE);
+    return EC_FALSE;
+  }
+  return EC_TRUE;
+}
+
+EC_T_VOID MtShmRelease(T_MT_SHM* pShm)
+{
+  __atomic_sub_fetch(&pShm->dwUsers, 1, __ATOMIC_RELEASE);
+}
+
+EC_T_VOID MtShmPublish(T_MT_SHM* pShm, EC_T_UINT64 qwCycle, EC_T_UINT64 qwTimeNsec, const MotorState_* aState)
+{
+  T_MT_SHM_HDR* pHdr = pShm->pHdr;
+  EC_T_DWORD dwSeq = 0;
+
+  if (pHdr == EC_NULL) {
+    return;
+  }
+  dwSeq = pHdr->dwStateSeq;   /* 只有周期线程写 */
+
+  __atomic_store_n(&pHdr->dwStateSeq, dwSeq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  pHdr->qwCycle = qwCycle;
+  pHdr->qwTimeNsec = qwTimeNsec;
+  pHdr->qwCmdSeq = pShm->qwCmdSeq;
+  pHdr->qwCmdCycle = pShm->qwCmdCycle;
+  OsMemcpy(pShm->pState, aState, pShm->dwAxisCnt * sizeof(MotorState_));
+  MT_SHM_STORE_REL(&pHdr->dwStateSeq, dwSeq + 2);
+
+  __atomic_add_fetch(&pHdr->dwCycleFutex, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&pHdr->dwWaiters, __ATOMIC_SEQ_CST) != 0) {
+    MtShmFutexWakeAll(pHdr);
+  }
+}
+
+const T_MT_SHM_CMD_BLK* MtShmTakeCmd(T_MT_SHM* pShm, EC_T_UINT64 qwCycle, const EC_T_BYTE** ppbyValid, const MotorCmd_** ppCmd)
+{
+  T_MT_SHM_HDR* pHdr = pShm->pHdr;
+  T_MT_SHM_CMD_BLK* pBlk = EC_NULL;
+  EC_T_DWORD dwOld = 0;
+
+  if ((pHdr == EC_NULL) || ((__atomic_load_n(&pHdr->dwCmdMiddle, __ATOMIC_RELAXED) & MT_SHM_CMD_FRESH) == 0)) {
+    return EC_NULL;
+  }
+  /* 把当前前台块换成中间块（清掉 FRESH），acquire：看到控制器发布前写的整块 */
+  dwOld = __atomic_exchange_n(&pHdr->dwCmdMiddle, pShm->dwCmdIdx, __ATOMIC_ACQ_REL);
+  pShm->dwCmdIdx = dwOld & MT_SHM_CMD_IDX_MASK;
+  pBlk = MtShmCmdBlk(pShm, pShm->dwCmdIdx);
+  if (pBlk->dwAxisCnt != pShm->dwAxisCnt) {
+    pHdr->qwCmdRejected = pHdr->qwCmdRejected + 1;
+    return EC_NULL;
+  }
+  pHdr->qwCmdTaken = pHdr->qwCmdTaken + 1;
+  if (qwCycle > pBlk->qwStateCycle + 1) {
+    pHdr->qwCmdLate = pHdr->qwCmdLate + 1;
+  }
+  pShm->qwCmdSeq = pBlk->qwSeq;
+  pShm->qwCmdCycle = qwCycle;
+  *ppbyValid = MtShmCmdValid(pBlk);
+  *ppCmd = MtShmCmdArray(pBlk);
+  return pBlk;
+}
+
+EC_T_DWORD MtShmOpen(T_MT_SHM* pShm, const EC_T_CHAR* szName)
+{
+  T_MT_SHM_HDR* pHdr = EC_NULL;
+  EC_T_VOID* pvMap = MAP_FAILED;
+  struct stat oStat;
+  int nFd = -1;
+
+  MtShmReset(pShm);
+  if ((szName == EC_NULL) || (OsStrlen(szName) >= MT_SHM_NAME_SIZE)) {
+    return EC_E_INVALIDPARM;
+  }
+  nFd = shm_open(szName, O_RDWR, 0);
+  if (nFd < 0) {
+    return (errno == ENOENT) ? EC_E_NOTFOUND : EC_E_OPENFAILED;
+  }
+  if ((fstat(nFd, &oStat) != 0) || (oStat.st_size < (off_t)sizeof(T_MT_SHM_HDR))) {
+    close(nFd);
+    return EC_E_BUSY;                   /* 服务端还没 ftruncate */
+  }
+  pvMap = mmap(EC_NULL, (size_t)oStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, nFd, 0);
+  close(nFd);
+  if (pvMap == MAP_FAILED) {
+    return EC_E_NOMEMORY;
+  }
+  pHdr = (T_MT_SHM_HDR*)pvMap;
+  if (MT_SHM_LOAD_ACQ(&pHdr->dwMagic) != MT_SHM_MAGIC) {
+    munmap(pvMap, (size_t)oStat.st_size);
+    return EC_E_BUSY;
+  }
+  if ((pHdr->dwVersion != MT_SHM_VERSION) || (pHdr->dwSize != (EC_T_DWORD)oStat.st_size)
+      || (pHdr->dwStateSize != sizeof(MotorState_)) || (pHdr->dwCmdSize != sizeof(MotorCmd_))
+      || (pHdr->dwAxisCnt == 0) || (pHdr->dwAxisCnt > MT_SHM_MAX_AXIS)) {
+    munmap(pvMap, (size_t)oStat.st_size);
+    return EC_E_INVALIDPARM;
+  }
+  OsSnprintf(pShm->szName, sizeof(pShm->szName), "%s", szName);
+  pShm->pHdr = pHdr;
+  pShm->dwMapSize = pHdr->dwSize;
+  pShm->bShared = EC_TRUE;
+  pShm->pState = (MotorState_*)((EC_T_BYTE*)pHdr + pHdr->dwStateOffset);
+  pShm->dwAxisCnt = pHdr->dwAxisCnt;
+  pShm->dwCmdIdx = pHdr->dwCmdBack & MT_SHM_CMD_IDX_MASK;
+  pShm->dwLastFutex = __atomic_load_n(&pHdr->dwCycleFutex, __ATOMIC_SEQ_CST);
+  return EC_E_NOERROR;
+}
+
+EC_T_VOID MtShmClose(T_MT_SHM* pShm)
+{
+  if (pShm->pHdr != EC_NULL) {
+    munmap(pShm->pHdr, pShm->dwMapSize);
+  }
+  MtShmReset(pShm);
+}
+
+EC_T_DWORD MtShmPostCmd(T_MT_SHM* pShm, const MotorCmd_* aCmd, const EC_T_BYTE* pbyValid, EC_T_DWORD dwCnt,
+                        EC_T_UINT64 qwSeq, EC_T_UINT64 qwStateCycle)
+{
+  T_MT_SHM_HDR* pHdr = pShm->pHdr;
+  T_MT_SHM_CMD_BLK* pBlk = EC_NULL;
+  EC_T_BYTE* pbyBlkValid = EC_NULL;
+  EC_T_DWORD dwOld = 0;
+
+  if ((pHdr == EC_NULL) || (aCmd == EC_NULL) || (dwCnt > pShm->dwAxisCnt)) {
+    return EC_E_INVALIDPARM;
+  }
+  pBlk = MtShmCmdBlk(pShm, pShm->dwCmdIdx);
+  pBlk->qwSeq = qwSeq;
+  pBlk->qwStateCycle = qwStateCycle;
+  pBlk->dwAxisCnt = pShm->dwAxisCnt;
+  pbyBlkValid = MtShmCmdValid(pBlk);
+  for (EC_T_DWORD i = 0; i < pShm->dwAxisCnt; i++) {
+    pbyBlkValid[i] = (EC_T_BYTE)((i < dwCnt) && ((pbyValid == EC_NULL) || (pbyValid[i] != 0)));
+  }
+  OsMemcpy(MtShmCmdArray(pBlk), aCmd, dwCnt * sizeof(MotorCmd_));
+
+  /* release：整块写完后才可见；换回来的块（可能是周期线程没来得及取的旧块）作为新的后备块 */
+  dwOld = __atomic_exchange_n(&pHdr->dwCmdMiddle, pShm->dwCmdIdx | MT_SHM_CMD_FRESH, __ATOMIC_ACQ_REL);
+  pShm->dwCmdIdx = dwOld & MT_SHM_CMD_IDX_MASK;
+  pHdr->dwCmdBack = pShm->dwCmdIdx;
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD MtShmWaitCycle(T_MT_SHM* pShm, EC_T_DWORD dwTimeoutMsec)
+{
+  T_MT_SHM_HDR* pHdr = pShm->pHdr;
+  const EC_T_UINT64 qwDeadline = MtShmNowNsec() + (EC_T_UINT64)dwTimeoutMsec * 1000000ULL;
+  EC_T_UINT64 qwNow = 0;
+  EC_T_DWORD dwVal = 0;
+  struct timespec ts;
+
+  if (pHdr == EC_NULL) {
+    return EC_E_INVALIDSTATE;
+  }
+  for (;;) {
+    dwVal = __atomic_load_n(&pHdr->dwCycleFutex, __ATOMIC_SEQ_CST);
+    if (MT_SHM_LOAD_ACQ(&pHdr->dwServerAlive) == 0) {
+      return EC_E_INVALIDSTATE;
+    }
+    if (dwVal != pShm->dwLastFutex) {
+      pShm->dwLastFutex = dwVal;
+      return EC_E_NOERROR;
+    }
+    qwNow = MtShmNowNsec();
+    if (qwNow >= qwDeadline) {
+      return EC_E_TIMEOUT;
+    }
+    ts.tv_sec = (time_t)((qwDeadline - qwNow) / 1000000000ULL);
+    ts.tv_nsec = (long)((qwDeadline - qwNow) % 1000000000ULL);
+
+    /* 先登记等待者再复查计数：发布方加计数后一定能看到这里的登记 */
+    __atomic_add_fetch(&pHdr->dwWaiters, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pHdr->dwCycleFutex, __ATOMIC_SEQ_CST) == dwVal) {
+      syscall(SYS_futex, &pHdr->dwCycleFutex, FUTEX_WAIT, dwVal, &ts, EC_NULL, 0);
+    }
+    __atomic_sub_fetch(&pHdr->dwWaiters, 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+EC_T_DWORD MtShmReadState(const T_MT_SHM* pShm, EC_T_DWORD dwFirst, EC_T_DWORD dwCnt, MotorState_* aState,
+                          EC_T_UINT64* pqwCycle, EC_T_UINT64* pqwTimeNsec, EC_T_UINT64* pqwCmdSeq)
+{
+  T_MT_SHM_HDR* pHdr = pShm->pHdr;
+
+  if ((pHdr == EC_NULL) || (aState == EC_NULL) || (dwFirst > pShm->dwAxisCnt) || (dwCnt > pShm->dwAxisCnt - dwFirst)) {
+    return EC_E_INVALIDPARM;
+  }
+  for (EC_T_DWORD dwTry = 0; dwTry < MT_SHM_READ_RETRY; dwTry++) {
+    const EC_T_DWORD dwSeq = MT_SHM_LOAD_ACQ(&pHdr->dwStateSeq);
+    EC_T_UINT64 qwCycle = 0;
+    EC_T_UINT64 qwTimeNsec = 0;
+    EC_T_UINT64 qwCmdSeq = 0;
+
+    if (dwSeq & 1) {
+      continue;                         /* 写入中 */
+    }
+    qwCycle = pHdr->qwCycle;
+    qwTimeNsec = pHdr->qwTimeNsec;
+    qwCmdSeq = pHdr->qwCmdSeq;
+    OsMemcpy(aState, &pShm->pState[dwFirst], dwCnt * sizeof(MotorState_));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&pHdr->dwStateSeq, __ATOMIC_RELAXED) != dwSeq) {
+      continue;                         /* 读的过程中被新一周期覆盖 */
+    }
+    if (pqwCycle != EC_NULL) {
+      *pqwCycle = qwCycle;
+    }
+    if (pqwTimeNsec != EC_NULL) {
+      *pqwTimeNsec = qwTimeNsec;
+    }
+    if (pqwCmdSeq != EC_NULL) {
+      *pqwCmdSeq = qwCmdSeq;
+    }
+    return EC_E_NOERROR;
+  }
+  return EC_E_BUSY;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,172 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_shm.h
+ *
+ * 作用：过程数据共享内存接口（外部控制器进程与周期线程之间交换 MotorState_/MotorCmd_）。
+ *
+ * - 一段 POSIX 共享内存（shm_open，名字形如 "/motrotech"），布局：头 + 全部轴的 MotorState_ + 3 块命令区
+ * - 状态：周期线程每周期在 MT_Workpd() 末尾整体发布（seqlock），并带周期号/时间戳；
+ *   读者拿到的快照一定来自同一个周期（写到一半或读的过程中被覆盖会重读）
+ * - 命令：三缓冲（单生产者：外部控制器；单消费者：周期线程），互不等待；
+ *   控制器写完整块后一次原子交换发布，周期线程每周期开始取最新一块，中间未取到的块被覆盖（只用最新）。
+ *   每块带控制器自己的序号 qwSeq 和它所依据的状态周期号 qwStateCycle，周期线程把生效的序号/周期号随状态发布回去
+ * - 唤醒：状态发布后周期计数 +1 并 FUTEX_WAKE（有等待者才进系统调用），控制器 MtShmWaitCycle() 与总线同相位运行，无需轮询
+ * - 时延：控制器在周期 N 的状态发布后计算并发布命令，周期 N+1 开始时生效（随 N+1 的 PdOut 发出），
+ *   即反馈 -> 命令不超过一个周期；命令依据的状态早于上一周期时计入 qwCmdLate
+ * - 控制器崩溃在写命令中途不影响周期线程（只会写坏它自己的后备块）；周期线程退出时 dwServerAlive=0 并唤醒所有等待者
+ *
+ * 线程/进程约定：
+ * - MtShmCreate/MtShmDelete/MtShmPublish/MtShmTakeCmd：服务端（周期线程所在进程；Publish/TakeCmd 只在周期线程）
+ * - MtShmOpen/MtShmClose/MtShmPostCmd/MtShmWaitCycle：控制器（每段共享内存只能有一个命令生产者）
+ * - MtShmReadState：任意进程/线程，可多个读者；服务端进程里周期线程以外的线程（跨实例聚合、统计）
+ *   先 MtShmAcquire() 再读，MtShmDelete() 会等它们 MtShmRelease() 之后才解除映射
+ * - szName 为 EC_NULL 时只在进程内分配（不创建共享内存），进程内 MT_GetMotorState() 照样读一致快照
+ *
+ * 本模块只依赖 EcOs.h 与 POSIX（不依赖 EC‑Master 库），控制器进程包含本头文件、链接 motrotech_shm.cpp 即可。
+ *---------------------------------------------------------------------------*/
+#ifndef __MOTROTECH_SHM_H__
+#define __MOTROTECH_SHM_H__     1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcOs.h"
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* [2026-01-19] 目的：按照最新《电机协议字段支持性详细分析表》更新发送结构体
+ * [2026-10-16] 定义从 motrotech.h 移到这里（共享内存布局的一部分，外部进程只需包含本头文件）
+ */
+typedef struct _MotorCmd_
+{
+    EC_T_BYTE  mode;      /* 控制模式 0x6060: 0x08:CSP, 0x09:CSV, 0x0A:CST 等 */
+    EC_T_REAL  q;         /* 关节目标位置 (rad) -> 对应 0x607A */
+    EC_T_REAL  dq;        /* 关节目标速度 (rad/s) -> 对应 0x60B1 (Velocity Offset) */
+    EC_T_REAL  tau;       /* 关节前馈力矩 (N.m) -> 对应 0x60B2 (Torque Offset) */
+    EC_T_REAL  kp;        /* 关节刚度系数 (rad/s) -> 对应 0x3500 (SDO) */
+    EC_T_REAL  kd;        /* 阻尼系数 (rad/s) -> 对应 0x3501 (SDO) */
+    EC_T_DWORD reserve;   /* 预留 */
+} MotorCmd_;
+
+/* [2026-01-19] 目的：按照最新《电机协议字段支持性详细分析表》更新接收结构体 */
+typedef struct _MotorState_
+{
+    EC_T_BYTE  mode;              /* 电机当前模式 0x6061 */
+    EC_T_REAL  q_fb;              /* 关节反馈位置 (rad) -> 0x6064 */
+    EC_T_REAL  dq_fb;             /* 关节反馈速度 (rad/s) -> 0x606C */
+    EC_T_REAL  ddq_fb;            /* 关节反馈加速度 (需差分计算) */
+    EC_T_REAL  tau_fb;            /* 关节反馈力矩 (N.m) -> 0x6077 */
+    EC_T_WORD  temperature[2];    /* [0]:MCU温度 0x3008, [1]:电机温度 0x3009 */
+    EC_T_REAL  vol;               /* 母线电压 (V) -> 0x300B */
+    EC_T_DWORD sensor[2];         /* 预留传感器数据 */
+    EC_T_DWORD motorstate;        /* 电机状态 (0x6041 状态字或错误码) */
+} MotorState_;
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_SHM_MAGIC                0x4D545348  /* "MTSH" */
+#define MT_SHM_VERSION              1
+#define MT_SHM_NAME_SIZE            64
+#define MT_SHM_MAX_AXIS             256
+#define MT_SHM_CMD_IDX_MASK         0x3         /* T_MT_SHM_HDR::dwCmdMiddle：块号 */
+#define MT_SHM_CMD_FRESH            0x4         /* T_MT_SHM_HDR::dwCmdMiddle：控制器发布后尚未取走 */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* 共享内存头（布局即协议，改动需要升 MT_SHM_VERSION） */
+typedef struct _T_MT_SHM_HDR
+{
+    /* 服务端创建时写入，之后只读 */
+    EC_T_DWORD      dwMagic;            /* MT_SHM_MAGIC，最后写入（控制器据此判断已初始化） */
+    EC_T_DWORD      dwVersion;
+    EC_T_DWORD      dwSize;             /* 整段字节数 */
+    EC_T_DWORD      dwAxisCnt;
+    EC_T_DWORD      dwCycleUsec;        /* 总线周期 */
+    EC_T_DWORD      dwStateSize;        /* sizeof(MotorState_) */
+    EC_T_DWORD      dwCmdSize;          /* sizeof(MotorCmd_) */
+    EC_T_DWORD      dwStateOffset;      /* MotorState_[dwAxisCnt] 的偏移 */
+    EC_T_DWORD      dwCmdOffset;        /* 3 块 T_MT_SHM_CMD_BLK 的偏移 */
+    EC_T_DWORD      dwCmdBlkSize;       /* 每块字节数 */
+    EC_T_DWORD      dwServerPid;
+    volatile EC_T_DWORD dwServerAlive;  /* MtShmDelete() 清零 */
+    EC_T_BYTE       abyPad0[16];
+
+    /* 状态 seqlock（奇数：写入中）：保护下面几个字段和 MotorState_[] */
+    volatile EC_T_DWORD dwStateSeq;
+    EC_T_DWORD      dwReserved0;
+    EC_T_UINT64     qwCycle;            /* 状态所在周期（从 1 开始） */
+    EC_T_UINT64     qwTimeNsec;         /* 发布时刻 CLOCK_MONOTONIC */
+    EC_T_UINT64     qwCmdSeq;           /* 已生效的最新命令块 qwSeq（0：还没有） */
+    EC_T_UINT64     qwCmdCycle;         /* 该命令块生效的周期 */
+    EC_T_BYTE       abyPad1[24];
+
+    /* 周期唤醒：每次发布后 +1；dwWaiters：正在 futex 等待的控制器线程数 */
+    volatile EC_T_DWORD dwCycleFutex;
+    volatile EC_T_DWORD dwWaiters;
+    EC_T_BYTE       abyPad2[56];
+
+    /* 命令三缓冲的中间块：低 2 位块号，MT_SHM_CMD_FRESH 表示控制器发布后周期线程尚未取走 */
+    volatile EC_T_DWORD dwCmdMiddle;
+    EC_T_DWORD      dwCmdBack;          /* 控制器的后备块号（只由控制器写，放在这里以便控制器重开后接着用） */
+    /* 服务端统计（周期线程写，各字段单独读取） */
+    volatile EC_T_UINT64 qwCmdTaken;    /* 取到的命令块 */
+    volatile EC_T_UINT64 qwCmdLate;     /* 依据的状态早于上一周期的命令块 */
+    volatile EC_T_UINT64 qwCmdRejected; /* 轴数不符的命令块 */
+    EC_T_BYTE       abyPad3[32];
+} T_MT_SHM_HDR;
+
+/* 命令块：头 + abyValid[dwAxisCnt]（向上取 8）+ MotorCmd_[dwAxisCnt] */
+typedef struct _T_MT_SHM_CMD_BLK
+{
+    EC_T_UINT64     qwSeq;              /* 控制器自己的序号（建议递增，周期线程原样回传） */
+    EC_T_UINT64     qwStateCycle;       /* 计算本命令所依据的状态周期号（MtShmReadState 得到的） */
+    EC_T_DWORD      dwAxisCnt;
+    EC_T_DWORD      dwReserved;
+} T_MT_SHM_CMD_BLK;
+
+/* 一段共享内存的进程内句柄（服务端/控制器各自一份） */
+typedef struct _T_MT_SHM
+{
+    T_MT_SHM_HDR*   pHdr;
+    EC_T_DWORD      dwMapSize;
+    EC_T_BOOL       bServer;
+    EC_T_BOOL       bShared;            /* EC_FALSE：进程内分配（szName 为 EC_NULL） */
+    EC_T_CHAR       szName[MT_SHM_NAME_SIZE];
+    MotorState_*    pState;             /* [dwAxisCnt] */
+    EC_T_DWORD      dwAxisCnt;
+    EC_T_DWORD      dwCmdIdx;           /* 服务端：当前持有的（前台）块；控制器：后备块 */
+    EC_T_DWORD      dwLastFutex;        /* 控制器：上次 MtShmWaitCycle() 返回时的周期计数 */
+    EC_T_UINT64     qwCmdSeq;           /* 服务端：最新生效的命令，下次发布时写入头 */
+    EC_T_UINT64     qwCmdCycle;
+    /* [2026-10-16] 服务端进程内的发布：Create 填完句柄后最后写 pPublished，Delete 先清 pPublished、等 dwUsers
+     * （MtShmAcquire() 持有者）归 0 再解除映射；两者必须在最后（Create/Delete 清零句柄时不碰它们） */
+    T_MT_SHM_HDR*   pPublished;
+    volatile EC_T_DWORD dwUsers;
+} T_MT_SHM;
+
+/*-FUNCTION DECLARATIONS-----------------------------------------------------*/
+/* 服务端：创建（同名旧段先删除），szName 为 EC_NULL 时只在进程内分配；pShm 首次使用前须清零（pPublished/dwUsers） */
+EC_T_DWORD  MtShmCreate(T_MT_SHM* pShm, const EC_T_CHAR* szName, EC_T_DWORD dwAxisCnt, EC_T_DWORD dwCycleUsec);
+/* 服务端：先撤下发布，等 MtShmAcquire() 的持有者全部释放后再解除映射 */
+EC_T_VOID   MtShmDelete(T_MT_SHM* pShm);
+/* 服务端进程内其它线程：返回 EC_TRUE 时映射及 pState/dwAxisCnt 在 MtShmRelease() 之前有效；
+ * 未创建/正在删除返回 EC_FALSE（不需要 Release），持有期间只做拷贝，不要阻塞 */
+EC_T_BOOL   MtShmAcquire(T_MT_SHM* pShm);
+EC_T_VOID   MtShmRelease(T_MT_SHM* pShm);
+/* 周期线程：发布全部轴的状态（aState[dwAxisCnt]）并唤醒等待者（Publish/TakeCmd 在未创建时什么也不做） */
+EC_T_VOID   MtShmPublish(T_MT_SHM* pShm, EC_T_UINT64 qwCycle, EC_T_UINT64 qwTimeNsec, const MotorState_* aState);
+/* 周期线程：取控制器发布的最新命令块，没有新块返回 EC_NULL；
+ * *ppbyValid 指向 abyValid[]（非 0：该轴有命令），*ppCmd 指向 MotorCmd_[] */
+const T_MT_SHM_CMD_BLK* MtShmTakeCmd(T_MT_SHM* pShm, EC_T_UINT64 qwCycle, const EC_T_BYTE** ppbyValid, const MotorCmd_** ppCmd);
+
+/* 控制器：打开服务端创建的段（服务端尚未初始化完返回 EC_E_BUSY，版本/布局不符返回 EC_E_INVALIDPARM） */
+EC_T_DWORD  MtShmOpen(T_MT_SHM* pShm, const EC_T_CHAR* szName);
+EC_T_VOID   MtShmClose(T_MT_SHM* pShm);
+/* 控制器：发布命令（aCmd[dwCnt]，pbyValid 为 EC_NULL 表示全部 dwCnt 个轴），dwCnt 不能超过轴数 */
+EC_T_DWORD  MtShmPostCmd(T_MT_SHM* pShm, const MotorCmd_* aCmd, const EC_T_BYTE* pbyValid, EC_T_DWORD dwCnt,
+                         EC_T_UINT64 qwSeq, EC_T_UINT64 qwStateCycle);
+/* 控制器：等下一次状态发布（上次返回之后已发布过则立即返回）；
+ * EC_E_TIMEOUT：dwTimeoutMsec 内没有发布，EC_E_INVALIDSTATE：服务端已退出 */
+EC_T_DWORD  MtShmWaitCycle(T_MT_SHM* pShm, EC_T_DWORD dwTimeoutMsec);
+
+/* 任意一方：读轴 [dwFirst, dwFirst+dwCnt) 的一致快照（pqwCycle/pqwTimeNsec/pqwCmdSeq 可为 EC_NULL）；
+ * 服务端一直在写入中（崩溃在发布中途）时返回 EC_E_BUSY */
+EC_T_DWORD  MtShmReadState(const T_MT_SHM* pShm, EC_T_DWORD dwFirst, EC_T_DWORD dwCnt, MotorState_* aState,
+                           EC_T_UINT64* pqwCycle, EC_T_UINT64* pqwTimeNsec, EC_T_UINT64* pqwCmdSeq);
+
+#endif /* __MOTROTECH_SHM_H__ */
+/*-END OF SOURCE FILE--------------------------------------------------------*/
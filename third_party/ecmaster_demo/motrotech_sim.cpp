@@ -0,0 +1,657 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_sim.cpp
+ *
+ * CMtSimMaster：内存过程映像 + CiA402 驱动模型（见 motrotech_sim.h）。
+ *
+ * 过程映像排布（Create）：
+ *   从站按顺序、从站内按轴、轴内按绑定表顺序紧凑排布（字节对齐，不做自然对齐，与常见 ENI 一样
+ *   会出现非对齐的 int32），输出在 PdOut、输入在 PdIn；每个变量生成一条 EC_T_PROCESS_VAR_INFO_EX。
+ *   绑定表里模型认识的对象（按 Axis0 对象号 + 位宽匹配）记下字节偏移，其余变量保持 0。
+ *
+ * 驱动模型（Cycle -> StepAxis）：
+ *   控制字取自上一周期 PdOut（主站不在 OP 时视为 0 = disable voltage），
+ *   先推进状态机，再按 0x6060 做一阶位置/速度响应，最后刷新 PdIn。
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech_sim.h"
+
+#include <math.h>
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_SIM_STAT_REMOTE          0x0200      /* 0x6041 bit 9：remote */
+#define MT_SIM_QS_STOP_VEL          1.0         /* quick stop：|v| 低于此值（count/s）视为已停 */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* 模型认识的对象（Axis0 对象号） */
+typedef struct _T_MT_SIM_OBJ
+{
+  EC_T_WORD   wIndex;
+  EC_T_BYTE   byDir;
+  EC_T_INT    nBits;
+  EC_T_INT    nField;                   /* MT_SIM_OUT_* / MT_SIM_IN_* */
+} T_MT_SIM_OBJ;
+
+/*-LOCAL VARIABLES-----------------------------------------------------------*/
+static const T_MT_SIM_OBJ S_aSimObj[] = {
+  { DRV_OBJ_CONTROL_WORD,          MT_PDO_DIR_OUT, 16, MT_SIM_OUT_CTRL      },
+  { DRV_OBJ_TARGET_POSITION,       MT_PDO_DIR_OUT, 32, MT_SIM_OUT_TGTPOS    },
+  { DRV_OBJ_TARGET_VELOCITY,       MT_PDO_DIR_OUT, 32, MT_SIM_OUT_TGTVEL    },
+  { DRV_OBJ_VELOCITY_OFFSET,       MT_PDO_DIR_OUT, 32, MT_SIM_OUT_VELOFFS   },
+  { DRV_OBJ_TORQUE_OFFSET,         MT_PDO_DIR_OUT, 16, MT_SIM_OUT_TRQOFFS   },
+  { DRV_OBJ_MODES_OF_OPERATION,    MT_PDO_DIR_OUT, 8,  MT_SIM_OUT_MODE      },
+  { DRV_OBJ_ERROR_CODE,            MT_PDO_DIR_IN,  16, MT_SIM_IN_ERROR      },
+  { DRV_OBJ_STATUS_WORD,           MT_PDO_DIR_IN,  16, MT_SIM_IN_STATUS     },
+  { DRV_OBJ_POSITION_ACTUAL_VALUE, MT_PDO_DIR_IN,  32, MT_SIM_IN_ACTPOS     },
+  { DRV_OBJ_VELOCITY_ACTUAL_VALUE, MT_PDO_DIR_IN,  32, MT_SIM_IN_ACTVEL     },
+  { DRV_OBJ_TORQUE_ACTUAL_VALUE,   MT_PDO_DIR_IN,  16, MT_SIM_IN_ACTTRQ     },
+  { DRV_OBJ_FOLLOWING_ERROR,       MT_PDO_DIR_IN,  32, MT_SIM_IN_FOLLOWERR  },
+  { DRV_OBJ_MCU_TEMPERATURE,       MT_PDO_DIR_IN,  16, MT_SIM_IN_TEMPMCU    },
+  { DRV_OBJ_MOTOR_TEMPERATURE,     MT_PDO_DIR_IN,  16, MT_SIM_IN_TEMPMOTOR  },
+  { DRV_OBJ_IGBT_TEMPERATURE,      MT_PDO_DIR_IN,  16, MT_SIM_IN_TEMPIGBT   },
+  { DRV_OBJ_DC_LINK_VOLTAGE,       MT_PDO_DIR_IN,  16, MT_SIM_IN_DCLINK     },
+};
+#define MT_SIM_OBJ_CNT ((EC_T_INT)(sizeof(S_aSimObj) / sizeof(S_aSimObj[0])))
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static const T_MT_SIM_OBJ* MtSimFindObj(const T_MT_PDO_BINDING* pBinding)
+{
+  for (EC_T_INT i = 0; i < MT_SIM_OBJ_CNT; i++) {
+    if ((S_aSimObj[i].wIndex == pBinding->wIndex) && (S_aSimObj[i].byDir == pBinding->byDir)
+        && (S_aSimObj[i].nBits == MtPdoTypeBits(pBinding->byType))) {
+      return &S_aSimObj[i];
+    }
+  }
+  return EC_NULL;
+}
+
+static EC_T_WORD MtSimDataType(EC_T_BYTE byType)
+{
+  switch (byType) {
+  case MT_PDO_TYPE_U8:     return DEFTYPE_UNSIGNED8;
+  case MT_PDO_TYPE_S8:     return DEFTYPE_INTEGER8;
+  case MT_PDO_TYPE_U16:    return DEFTYPE_UNSIGNED16;
+  case MT_PDO_TYPE_S16:    return DEFTYPE_INTEGER16;
+  case MT_PDO_TYPE_U32:    return DEFTYPE_UNSIGNED32;
+  case MT_PDO_TYPE_S32:    return DEFTYPE_INTEGER32;
+  case MT_PDO_TYPE_REAL32: return DEFTYPE_REAL32;
+  default:                 return 0;
+  }
+}
+
+/* 与实机一致：先填 handle，再回调 */
+static EC_T_VOID MtSimSdoComplete(T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext,
+                                  EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                  EC_T_DWORD dwResult, EC_T_DWORD dwOutDataLen)
+{
+  if (pHandle != EC_NULL) {
+    pHandle->dwResult = dwResult;
+    pHandle->dwOutDataLen = dwOutDataLen;
+    SDO_PIPE_HANDLE_SET_DONE(pHandle);
+  }
+  if (pfnDone != EC_NULL) {
+    pfnDone(pvContext, wStationAddress, wIndex, bySubIndex, dwResult);
+  }
+}
+
+static EC_T_INT MtSimSatToInt32(EC_T_LREAL x)
+{
+  if (x > 2147483647.0)  return (EC_T_INT)2147483647;
+  if (x < -2147483648.0) return (EC_T_INT)(-2147483647 - 1);
+  return (EC_T_INT)x;
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+CMtSimMaster::CMtSimMaster()
+{
+  DefaultParms(&m_oParms);
+  m_eMasterState = eEcatState_UNKNOWN;
+  m_fCycleSec = 0;
+  m_fPosAlpha = 0;
+  m_fVelAlpha = 0;
+  m_pbyPdIn = EC_NULL;
+  m_pbyPdOut = EC_NULL;
+  m_dwPdInSize = 0;
+  m_dwPdOutSize = 0;
+  m_pSlave = EC_NULL;
+  m_dwSlaveCnt = 0;
+  m_pAxis = EC_NULL;
+  m_dwAxisCnt = 0;
+  OsMemset(m_aSdoObj, 0, sizeof(m_aSdoObj));
+  m_dwSdoObjCnt = 0;
+}
+
+CMtSimMaster::~CMtSimMaster()
+{
+  Delete();
+}
+
+EC_T_VOID CMtSimMaster::DefaultParms(T_MT_SIM_PARMS* pParms)
+{
+  OsMemset(pParms, 0, sizeof(T_MT_SIM_PARMS));
+  pParms->fPosTauSec     = 0.002;
+  pParms->fVelTauSec     = 0.005;
+  pParms->fTrqPerAcc     = 0.00001;
+  pParms->dwBootCycles   = 10;
+  pParms->sTempMcu       = 45;
+  pParms->sTempMotor     = 38;
+  pParms->sTempIgbt      = 41;
+  pParms->wDcLinkVoltage = 480;
+}
+
+EC_T_DWORD CMtSimMaster::Create(T_MT_PDO_CTX* pPdo, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwSlaveCnt, EC_T_DWORD dwCycleTimeUsec,
+                                const T_MT_SIM_PARMS* pParms)
+{
+  EC_T_DWORD dwRetVal = EC_E_NOERROR;
+  EC_T_DWORD dwAxisCnt = 0;
+  EC_T_DWORD dwVarCnt[2] = { 0, 0 };
+  EC_T_DWORD dwBits[2] = { 0, 0 };
+  const T_MT_PDO_BINDING* pBinding = EC_NULL;
+
+  Delete();
+  if ((pPdo == EC_NULL) || (pSlave == EC_NULL) || (dwSlaveCnt == 0) || (dwCycleTimeUsec == 0)) {
+    return EC_E_INVALIDPARM;
+  }
+  if (pParms != EC_NULL) {
+    m_oParms = *pParms;
+  }
+  m_fCycleSec = (EC_T_LREAL)dwCycleTimeUsec / 1000000;
+  m_fPosAlpha = (m_oParms.fPosTauSec > 0) ? (1.0 - exp(-m_fCycleSec / m_oParms.fPosTauSec)) : 1.0;
+  m_fVelAlpha = (m_oParms.fVelTauSec > 0) ? (1.0 - exp(-m_fCycleSec / m_oParms.fVelTauSec)) : 1.0;
+
+  /* 1) 统计：每从站每方向变量数、过程映像大小 */
+  for (EC_T_DWORD s = 0; s < dwSlaveCnt; s++) {
+    dwAxisCnt += pSlave[s].wAxisCnt;
+  }
+  m_pSlave = (T_MT_SIM_SLAVE*)OsMalloc(dwSlaveCnt * sizeof(T_MT_SIM_SLAVE));
+  m_pAxis = (T_MT_SIM_AXIS*)OsMalloc((dwAxisCnt + 1) * sizeof(T_MT_SIM_AXIS));
+  if ((m_pSlave == EC_NULL) || (m_pAxis == EC_NULL)) {
+    dwRetVal = EC_E_NOMEMORY;
+    goto Exit;
+  }
+  OsMemset(m_pSlave, 0, dwSlaveCnt * sizeof(T_MT_SIM_SLAVE));
+  OsMemset(m_pAxis, 0, (dwAxisCnt + 1) * sizeof(T_MT_SIM_AXIS));
+  m_dwSlaveCnt = dwSlaveCnt;
+  m_dwAxisCnt = dwAxisCnt;
+
+  for (EC_T_DWORD s = 0; s < dwSlaveCnt; s++) {
+    T_MT_SIM_SLAVE* pSim = &m_pSlave[s];
+    EC_T_DWORD adwCnt[2] = { 0, 0 };
+
+    pSim->wStationAddress = pSlave[s].wStationAddress;
+    pSim->wAxisCnt = pSlave[s].wAxisCnt;
+    pSim->bPresent = EC_TRUE;
+    for (EC_T_DWORD b = 0; (pBinding = MT_GetPdoBinding(pPdo, b, EC_NULL)) != EC_NULL; b++) {
+      EC_T_DWORD dwCopies = (pBinding->wAxisStride == 0) ? 1 : pSlave[s].wAxisCnt;
+      if (pSlave[s].wAxisCnt == 0) {
+        dwCopies = 0;
+      }
+      adwCnt[pBinding->byDir] += dwCopies;
+      dwBits[pBinding->byDir] += dwCopies * (EC_T_DWORD)MtPdoTypeBits(pBinding->byType);
+    }
+    if ((adwCnt[MT_PDO_DIR_OUT] > 0xFFFF) || (adwCnt[MT_PDO_DIR_IN] > 0xFFFF)) {
+      dwRetVal = EC_E_INVALIDSIZE;
+      goto Exit;
+    }
+    pSim->wNumVarsOutp = (EC_T_WORD)adwCnt[MT_PDO_DIR_OUT];
+    pSim->wNumVarsInp = (EC_T_WORD)adwCnt[MT_PDO_DIR_IN];
+    pSim->pVarOutp = (EC_T_PROCESS_VAR_INFO_EX*)OsMalloc((adwCnt[MT_PDO_DIR_OUT] + 1) * sizeof(EC_T_PROCESS_VAR_INFO_EX));
+    pSim->pVarInp = (EC_T_PROCESS_VAR_INFO_EX*)OsMalloc((adwCnt[MT_PDO_DIR_IN] + 1) * sizeof(EC_T_PROCESS_VAR_INFO_EX));
+    if ((pSim->pVarOutp == EC_NULL) || (pSim->pVarInp == EC_NULL)) {
+      dwRetVal = EC_E_NOMEMORY;
+      goto Exit;
+    }
+    dwVarCnt[MT_PDO_DIR_OUT] += adwCnt[MT_PDO_DIR_OUT];
+    dwVarCnt[MT_PDO_DIR_IN] += adwCnt[MT_PDO_DIR_IN];
+  }
+  m_dwPdOutSize = (dwBits[MT_PDO_DIR_OUT] + 7) / 8;
+  m_dwPdInSize = (dwBits[MT_PDO_DIR_IN] + 7) / 8;
+  m_pbyPdOut = (EC_T_BYTE*)OsMalloc(m_dwPdOutSize + 8);
+  m_pbyPdIn = (EC_T_BYTE*)OsMalloc(m_dwPdInSize + 8);
+  if ((m_pbyPdOut == EC_NULL) || (m_pbyPdIn == EC_NULL)) {
+    dwRetVal = EC_E_NOMEMORY;
+    goto Exit;
+  }
+  OsMemset(m_pbyPdOut, 0, m_dwPdOutSize + 8);
+  OsMemset(m_pbyPdIn, 0, m_dwPdInSize + 8);
+
+  /* 2) 排布：从站 -> 轴 -> 绑定；stride=0 的绑定每从站一份（跟在第 0 轴后面） */
+  {
+    EC_T_DWORD adwBitOffs[2] = { 0, 0 };
+    EC_T_DWORD dwFirstAxis = 0;
+
+    for (EC_T_DWORD s = 0; s < dwSlaveCnt; s++) {
+      T_MT_SIM_SLAVE* pSim = &m_pSlave[s];
+      EC_T_DWORD adwVar[2] = { 0, 0 };
+
+      pSim->dwFirstAxis = dwFirstAxis;
+      for (EC_T_WORD a = 0; a < pSim->wAxisCnt; a++) {
+        T_MT_SIM_AXIS* pAxis = &m_pAxis[dwFirstAxis + a];
+
+        pAxis->wStationAddress = pSim->wStationAddress;
+        for (EC_T_INT f = 0; f < MT_SIM_OUT_CNT; f++) {
+          pAxis->adwOutOffs[f] = MT_SIM_NOT_MAPPED;
+        }
+        for (EC_T_INT f = 0; f < MT_SIM_IN_CNT; f++) {
+          pAxis->adwInOffs[f] = MT_SIM_NOT_MAPPED;
+        }
+        pAxis->eState = DRV_DEV_STATE_NOT_READY;
+
+        for (EC_T_DWORD b = 0; (pBinding = MT_GetPdoBinding(pPdo, b, EC_NULL)) != EC_NULL; b++) {
+          if ((pBinding->wAxisStride == 0) && (a != 0)) {
+            continue;
+          }
+          const EC_T_BYTE byDir = pBinding->byDir;
+          EC_T_PROCESS_VAR_INFO_EX* pVar = (byDir == MT_PDO_DIR_OUT) ? &pSim->pVarOutp[adwVar[byDir]] : &pSim->pVarInp[adwVar[byDir]];
+          const T_MT_SIM_OBJ* pObj = MtSimFindObj(pBinding);
+
+          OsMemset(pVar, 0, sizeof(EC_T_PROCESS_VAR_INFO_EX));
+          OsSnprintf(pVar->szName, sizeof(pVar->szName), "Sim %d.Axis%d.%s", pSim->wStationAddress, a, pBinding->szName);
+          pVar->wDataType    = MtSimDataType(pBinding->byType);
+          pVar->wFixedAddr   = pSim->wStationAddress;
+          pVar->nBitSize     = MtPdoTypeBits(pBinding->byType);
+          pVar->nBitOffs     = (EC_T_INT)adwBitOffs[byDir];
+          pVar->bIsInputData = (byDir == MT_PDO_DIR_IN) ? EC_TRUE : EC_FALSE;
+          pVar->wIndex       = (EC_T_WORD)(pBinding->wIndex + a * pBinding->wAxisStride);
+          pVar->wSubIndex    = (pBinding->wSubIndex == MT_PDO_SUBINDEX_ANY) ? 0 : pBinding->wSubIndex;
+          pVar->wPdoIndex    = (EC_T_WORD)(((byDir == MT_PDO_DIR_OUT) ? 0x1600 : 0x1A00) + a);
+          if (pObj != EC_NULL) {
+            if (byDir == MT_PDO_DIR_OUT) {
+              pAxis->adwOutOffs[pObj->nField] = adwBitOffs[byDir] / 8;
+            } else {
+              pAxis->adwInOffs[pObj->nField] = adwBitOffs[byDir] / 8;
+            }
+          }
+          adwBitOffs[byDir] += (EC_T_DWORD)pVar->nBitSize;
+          adwVar[byDir]++;
+        }
+      }
+      dwFirstAxis += pSim->wAxisCnt;
+    }
+  }
+  m_eMasterState = eEcatState_OP;
+
+Exit:
+  if (dwRetVal != EC_E_NOERROR) {
+    Delete();
+  }
+  return dwRetVal;
+}
+
+EC_T_VOID CMtSimMaster::Delete(EC_T_VOID)
+{
+  if (m_pSlave != EC_NULL) {
+    for (EC_T_DWORD s = 0; s < m_dwSlaveCnt; s++) {
+      SafeOsFree(m_pSlave[s].pVarInp);
+      SafeOsFree(m_pSlave[s].pVarOutp);
+    }
+  }
+  SafeOsFree(m_pSlave);
+  SafeOsFree(m_pAxis);
+  SafeOsFree(m_pbyPdIn);
+  SafeOsFree(m_pbyPdOut);
+  m_dwSlaveCnt = 0;
+  m_dwAxisCnt = 0;
+  m_dwPdInSize = 0;
+  m_dwPdOutSize = 0;
+  m_dwSdoObjCnt = 0;
+  m_eMasterState = eEcatState_UNKNOWN;
+}
+
+EC_T_VOID CMtSimMaster::Cycle(EC_T_VOID)
+{
+  for (EC_T_DWORD i = 0; i < m_dwAxisCnt; i++) {
+    StepAxis(&m_pAxis[i]);
+  }
+}
+
+EC_T_VOID CMtSimMaster::SetSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL bPresent)
+{
+  T_MT_SIM_SLAVE* pSim = FindSlave(wStationAddress);
+  if (pSim != EC_NULL) {
+    pSim->bPresent = bPresent;
+  }
+}
+
+EC_T_DWORD CMtSimMaster::InjectFault(EC_T_DWORD dwAxis, EC_T_WORD wErrorCode, EC_T_DWORD dwHoldCycles)
+{
+  if (dwAxis >= m_dwAxisCnt) {
+    return EC_E_INVALIDPARM;
+  }
+  T_MT_SIM_AXIS* pAxis = &m_pAxis[dwAxis];
+  if (pAxis->eState != DRV_DEV_STATE_MALFUNCTION) {
+    pAxis->eState = DRV_DEV_STATE_MALFCT_REACTION;
+    pAxis->dwFaults++;
+  }
+  pAxis->wErrorCode = wErrorCode;
+  pAxis->dwFaultHold = dwHoldCycles;
+  return EC_E_NOERROR;
+}
+
+T_MT_SIM_SLAVE* CMtSimMaster::FindSlave(EC_T_WORD wStationAddress)
+{
+  for (EC_T_DWORD s = 0; s < m_dwSlaveCnt; s++) {
+    if (m_pSlave[s].wStationAddress == wStationAddress) {
+      return &m_pSlave[s];
+    }
+  }
+  return EC_NULL;
+}
+
+/* CiA402 状态机（一个周期一次转换；fault reset 需要 bit7 上升沿） */
+EC_T_VOID CMtSimMaster::StepStateMachine(T_MT_SIM_AXIS* pAxis, EC_T_WORD wCtrl)
+{
+  const EC_T_BOOL bResetEdge = ((wCtrl & DRV_CRTL_FAULT_RESET) != 0) && ((pAxis->wLastCtrl & DRV_CRTL_FAULT_RESET) == 0);
+
+  switch (pAxis->eState) {
+  case DRV_DEV_STATE_NOT_READY:
+    /* 上电自检，完成后自动进入 Switch on disabled（transition 1） */
+    if (pAxis->dwBootCnt >= m_oParms.dwBootCycles) {
+      pAxis->eState = DRV_DEV_STATE_SWITCHON_DIS;
+    } else {
+      pAxis->dwBootCnt++;
+    }
+    return;
+  case DRV_DEV_STATE_MALFCT_REACTION:
+    /* fault reaction 完成（transition 14） */
+    pAxis->eState = DRV_DEV_STATE_MALFUNCTION;
+    return;
+  case DRV_DEV_STATE_MALFUNCTION:
+    if (pAxis->dwFaultHold > 0) {
+      pAxis->dwFaultHold--;
+      return;
+    }
+    if (bResetEdge) {
+      /* transition 15 */
+      pAxis->eState = DRV_DEV_STATE_SWITCHON_DIS;
+      pAxis->wErrorCode = 0;
+      pAxis->dwFaultResets++;
+    }
+    return;
+  default:
+    break;
+  }
+
+  if ((wCtrl & DRV_CTRL_CMD_DIS_VOLTAGE_MASK) == DRV_CTRL_CMD_DIS_VOLTAGE) {
+    /* transition 7, 9, 10, 12 */
+    pAxis->eState = DRV_DEV_STATE_SWITCHON_DIS;
+  } else if ((wCtrl & DRV_CTRL_CMD_QUICK_STOP_MASK) == DRV_CTRL_CMD_QUICK_STOP) {
+    /* transition 11（OE -> quick stop），7/10（ready/switched on -> switch on disabled） */
+    if (pAxis->eState == DRV_DEV_STATE_OP_ENABLED) {
+      pAxis->eState = DRV_DEV_STATE_QUICK_STOP;
+    } else if (pAxis->eState != DRV_DEV_STATE_QUICK_STOP) {
+      pAxis->eState = DRV_DEV_STATE_SWITCHON_DIS;
+    }
+  } else if ((wCtrl & 0x0087) == DRV_CTRL_CMD_SHUTDOWN) {
+    /* transition 2, 6, 8 */
+    if (pAxis->eState != DRV_DEV_STATE_QUICK_STOP) {
+      pAxis->eState = DRV_DEV_STATE_READY_TO_SWITCHON;
+    }
+  } else if ((wCtrl & DRV_CTRL_CMD_MASK) == DRV_CTRL_CMD_SWITCHON) {
+    /* transition 3（ready -> switched on），5（OE -> switched on） */
+    if ((pAxis->eState == DRV_DEV_STATE_READY_TO_SWITCHON) || (pAxis->eState == DRV_DEV_STATE_OP_ENABLED)) {
+      pAxis->eState = DRV_DEV_STATE_SWITCHED_ON;
+    }
+  } else if ((wCtrl & DRV_CTRL_CMD_MASK) == DRV_CTRL_CMD_ENA_OPERATION) {
+    /* transition 4, 16；ready 时先走 transition 3，下个周期再进 OE */
+    if (pAxis->eState == DRV_DEV_STATE_READY_TO_SWITCHON) {
+      pAxis->eState = DRV_DEV_STATE_SWITCHED_ON;
+    } else if ((pAxis->eState == DRV_DEV_STATE_SWITCHED_ON) || (pAxis->eState == DRV_DEV_STATE_QUICK_STOP)) {
+      pAxis->eState = DRV_DEV_STATE_OP_ENABLED;
+    }
+  }
+}
+
+/* 一阶位置/速度响应，dt = 总线周期 */
+EC_T_VOID CMtSimMaster::StepMotion(T_MT_SIM_AXIS* pAxis)
+{
+  const EC_T_LREAL fPrevVel = pAxis->fVel;
+  EC_T_LREAL fTrqOffs = 0;
+
+  pAxis->dwFollowErr = 0;
+  switch (pAxis->eState) {
+  case DRV_DEV_STATE_OP_ENABLED: {
+    const EC_T_DWORD* pdwOffs = pAxis->adwOutOffs;
+    EC_T_BYTE byMode = DRV_MODE_OP_CSP;
+
+    if (pdwOffs[MT_SIM_OUT_MODE] != MT_SIM_NOT_MAPPED) {
+      byMode = m_pbyPdOut[pdwOffs[MT_SIM_OUT_MODE]];
+    }
+    if (pdwOffs[MT_SIM_OUT_TRQOFFS] != MT_SIM_NOT_MAPPED) {
+      fTrqOffs = (EC_T_LREAL)(EC_T_SWORD)EC_GETWORD(m_pbyPdOut + pdwOffs[MT_SIM_OUT_TRQOFFS]);
+    }
+    if (byMode == DRV_MODE_OP_CSV) {
+      EC_T_LREAL fTgtVel = 0;
+      if (pdwOffs[MT_SIM_OUT_TGTVEL] != MT_SIM_NOT_MAPPED) {
+        fTgtVel += (EC_T_LREAL)(EC_T_INT)EC_GETDWORD(m_pbyPdOut + pdwOffs[MT_SIM_OUT_TGTVEL]);
+      }
+      if (pdwOffs[MT_SIM_OUT_VELOFFS] != MT_SIM_NOT_MAPPED) {
+        fTgtVel += (EC_T_LREAL)(EC_T_INT)EC_GETDWORD(m_pbyPdOut + pdwOffs[MT_SIM_OUT_VELOFFS]);
+      }
+      pAxis->fVel += (fTgtVel - pAxis->fVel) * m_fVelAlpha;
+      pAxis->fPos += pAxis->fVel * m_fCycleSec;
+    } else if ((byMode == DRV_MODE_OP_CSP) && (pdwOffs[MT_SIM_OUT_TGTPOS] != MT_SIM_NOT_MAPPED)) {
+      const EC_T_LREAL fTgtPos = (EC_T_LREAL)(EC_T_INT)EC_GETDWORD(m_pbyPdOut + pdwOffs[MT_SIM_OUT_TGTPOS]);
+      const EC_T_LREAL fNewPos = pAxis->fPos + (fTgtPos - pAxis->fPos) * m_fPosAlpha;
+      pAxis->fVel = (fNewPos - pAxis->fPos) / m_fCycleSec;
+      pAxis->fPos = fNewPos;
+      pAxis->dwFollowErr = (EC_T_DWORD)fabs(fTgtPos - fNewPos);
+    } else {
+      /* 其它模式（CST/PP/...）不建模：速度按一阶衰减到 0 */
+      pAxis->fVel -= pAxis->fVel * m_fVelAlpha;
+      pAxis->fPos += pAxis->fVel * m_fCycleSec;
+    }
+    break;
+  }
+  case DRV_DEV_STATE_QUICK_STOP:
+    pAxis->fVel -= pAxis->fVel * m_fVelAlpha;
+    pAxis->fPos += pAxis->fVel * m_fCycleSec;
+    if (fabs(pAxis->fVel) < MT_SIM_QS_STOP_VEL) {
+      /* quick stop option code 2：停稳后进入 switch on disabled（transition 12） */
+      pAxis->fVel = 0;
+      pAxis->eState = DRV_DEV_STATE_SWITCHON_DIS;
+    }
+    break;
+  default:
+    /* 未使能 / fault：无力矩，轴停住（模型里不考虑惯性滑行） */
+    pAxis->fVel = 0;
+    break;
+  }
+  pAxis->fTrq = fTrqOffs + (pAxis->fVel - fPrevVel) / m_fCycleSec * m_oParms.fTrqPerAcc;
+}
+
+EC_T_WORD CMtSimMaster::StatusWord(const T_MT_SIM_AXIS* pAxis)
+{
+  switch (pAxis->eState) {
+  case DRV_DEV_STATE_NOT_READY:          return 0x0000;
+  case DRV_DEV_STATE_SWITCHON_DIS:       return 0x0040 | MT_SIM_STAT_REMOTE;
+  case DRV_DEV_STATE_READY_TO_SWITCHON:  return 0x0031 | MT_SIM_STAT_REMOTE;
+  case DRV_DEV_STATE_SWITCHED_ON:        return 0x0033 | MT_SIM_STAT_REMOTE;
+  case DRV_DEV_STATE_OP_ENABLED:         return 0x0037 | MT_SIM_STAT_REMOTE;
+  case DRV_DEV_STATE_QUICK_STOP:         return 0x0017 | MT_SIM_STAT_REMOTE;
+  case DRV_DEV_STATE_MALFCT_REACTION:    return 0x001F | MT_SIM_STAT_REMOTE;
+  case DRV_DEV_STATE_MALFUNCTION:        return 0x0018 | MT_SIM_STAT_REMOTE;
+  default:                               return 0x0000;
+  }
+}
+
+EC_T_VOID CMtSimMaster::StepAxis(T_MT_SIM_AXIS* pAxis)
+{
+  const EC_T_DWORD* pdwOffs = pAxis->adwInOffs;
+  EC_T_WORD wCtrl = 0;
+
+  /* SAFEOP 及以下：输出无效，驱动按 disable voltage 处理 */
+  if ((m_eMasterState == eEcatState_OP) && (pAxis->adwOutOffs[MT_SIM_OUT_CTRL] != MT_SIM_NOT_MAPPED)) {
+    wCtrl = EC_GETWORD(m_pbyPdOut + pAxis->adwOutOffs[MT_SIM_OUT_CTRL]);
+  }
+  StepStateMachine(pAxis, wCtrl);
+  StepMotion(pAxis);
+  pAxis->wLastCtrl = wCtrl;
+
+  if (pdwOffs[MT_SIM_IN_ERROR] != MT_SIM_NOT_MAPPED) {
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_ERROR], pAxis->wErrorCode);
+  }
+  if (pdwOffs[MT_SIM_IN_STATUS] != MT_SIM_NOT_MAPPED) {
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_STATUS], StatusWord(pAxis));
+  }
+  if (pdwOffs[MT_SIM_IN_ACTPOS] != MT_SIM_NOT_MAPPED) {
+    EC_SETDWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_ACTPOS], (EC_T_DWORD)MtSimSatToInt32(pAxis->fPos));
+  }
+  if (pdwOffs[MT_SIM_IN_ACTVEL] != MT_SIM_NOT_MAPPED) {
+    EC_SETDWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_ACTVEL], (EC_T_DWORD)MtSimSatToInt32(pAxis->fVel));
+  }
+  if (pdwOffs[MT_SIM_IN_ACTTRQ] != MT_SIM_NOT_MAPPED) {
+    EC_T_LREAL fTrq = (pAxis->fTrq > 32767.0) ? 32767.0 : ((pAxis->fTrq < -32768.0) ? -32768.0 : pAxis->fTrq);
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_ACTTRQ], (EC_T_WORD)(EC_T_SWORD)fTrq);
+  }
+  if (pdwOffs[MT_SIM_IN_FOLLOWERR] != MT_SIM_NOT_MAPPED) {
+    EC_SETDWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_FOLLOWERR], pAxis->dwFollowErr);
+  }
+  if (pdwOffs[MT_SIM_IN_TEMPMCU] != MT_SIM_NOT_MAPPED) {
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_TEMPMCU], (EC_T_WORD)m_oParms.sTempMcu);
+  }
+  if (pdwOffs[MT_SIM_IN_TEMPMOTOR] != MT_SIM_NOT_MAPPED) {
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_TEMPMOTOR], (EC_T_WORD)m_oParms.sTempMotor);
+  }
+  if (pdwOffs[MT_SIM_IN_TEMPIGBT] != MT_SIM_NOT_MAPPED) {
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_TEMPIGBT], (EC_T_WORD)m_oParms.sTempIgbt);
+  }
+  if (pdwOffs[MT_SIM_IN_DCLINK] != MT_SIM_NOT_MAPPED) {
+    EC_SETWORD(m_pbyPdIn + pdwOffs[MT_SIM_IN_DCLINK], m_oParms.wDcLinkVoltage);
+  }
+}
+
+/*-CMtMasterAccess-----------------------------------------------------------*/
+EC_T_DWORD CMtSimMaster::IsSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL* pbPresent)
+{
+  T_MT_SIM_SLAVE* pSim = FindSlave(wStationAddress);
+  if ((pSim == EC_NULL) || (pbPresent == EC_NULL)) {
+    return EC_E_NOTFOUND;
+  }
+  *pbPresent = pSim->bPresent;
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD CMtSimMaster::GetCfgSlaveInfo(EC_T_WORD wStationAddress, EC_T_CFG_SLAVE_INFO* pSlaveInfo)
+{
+  T_MT_SIM_SLAVE* pSim = FindSlave(wStationAddress);
+  if ((pSim == EC_NULL) || (pSlaveInfo == EC_NULL)) {
+    return EC_E_NOTFOUND;
+  }
+  OsMemset(pSlaveInfo, 0, sizeof(EC_T_CFG_SLAVE_INFO));
+  pSlaveInfo->dwSlaveId = (EC_T_DWORD)(pSim - m_pSlave);
+  OsSnprintf(pSlaveInfo->abyDeviceName, sizeof(pSlaveInfo->abyDeviceName), "MtSim CiA402 x%d", pSim->wAxisCnt);
+  pSlaveInfo->bIsPresent = pSim->bPresent;
+  pSlaveInfo->wStationAddress = pSim->wStationAddress;
+  pSlaveInfo->wAutoIncAddress = (EC_T_WORD)(0 - (EC_T_WORD)pSlaveInfo->dwSlaveId);
+  pSlaveInfo->wNumProcessVarsInp = pSim->wNumVarsInp;
+  pSlaveInfo->wNumProcessVarsOutp = pSim->wNumVarsOutp;
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD CMtSimMaster::GetSlaveVarInfo(EC_T_BOOL bOutput, EC_T_WORD wStationAddress, EC_T_WORD wNumOfVarsToRead,
+                                         EC_T_PROCESS_VAR_INFO_EX* pVarInfo, EC_T_WORD* pwReadEntries)
+{
+  T_MT_SIM_SLAVE* pSim = FindSlave(wStationAddress);
+  if ((pSim == EC_NULL) || (pVarInfo == EC_NULL) || (pwReadEntries == EC_NULL)) {
+    return EC_E_NOTFOUND;
+  }
+  const EC_T_WORD wAvail = bOutput ? pSim->wNumVarsOutp : pSim->wNumVarsInp;
+  const EC_T_WORD wCnt = (wNumOfVarsToRead < wAvail) ? wNumOfVarsToRead : wAvail;
+  OsMemcpy(pVarInfo, bOutput ? pSim->pVarOutp : pSim->pVarInp, wCnt * sizeof(EC_T_PROCESS_VAR_INFO_EX));
+  *pwReadEntries = wCnt;
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD CMtSimMaster::SdoDownload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                     const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                     T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext)
+{
+  T_MT_SIM_SLAVE* pSim = FindSlave(wStationAddress);
+  T_MT_SIM_SDO_OBJ* pObj = EC_NULL;
+  EC_T_DWORD dwResult = EC_E_NOERROR;
+
+  if ((pbyData == EC_NULL) || (dwDataLen == 0) || (dwDataLen > MT_SIM_SDO_DATA_LEN)) {
+    return EC_E_INVALIDSIZE;
+  }
+  if ((pSim == EC_NULL) || !pSim->bPresent) {
+    dwResult = EC_E_SLAVE_NOT_PRESENT;
+    goto Exit;
+  }
+  for (EC_T_DWORD i = 0; i < m_dwSdoObjCnt; i++) {
+    if ((m_aSdoObj[i].wStationAddress == wStationAddress) && (m_aSdoObj[i].wIndex == wIndex) && (m_aSdoObj[i].bySubIndex == bySubIndex)) {
+      pObj = &m_aSdoObj[i];
+      break;
+    }
+  }
+  if (pObj == EC_NULL) {
+    if (m_dwSdoObjCnt >= MT_SIM_SDO_OBJ_CNT) {
+      dwResult = EC_E_NOMEMORY;
+      goto Exit;
+    }
+    pObj = &m_aSdoObj[m_dwSdoObjCnt++];
+    pObj->wStationAddress = wStationAddress;
+    pObj->wIndex = wIndex;
+    pObj->bySubIndex = bySubIndex;
+  }
+  OsMemcpy(pObj->abyData, pbyData, dwDataLen);
+  pObj->dwDataLen = dwDataLen;
+
+Exit:
+  MtSimSdoComplete(pHandle, pfnDone, pvContext, wStationAddress, wIndex, bySubIndex, dwResult, 0);
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD CMtSimMaster::SdoUpload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                   EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                   T_SDO_PIPE_HANDLE* pHandle, EC_PF_SDO_PIPE_DONE pfnDone, EC_T_VOID* pvContext)
+{
+  T_MT_SIM_SLAVE* pSim = FindSlave(wStationAddress);
+  const EC_T_BYTE* pbySrc = EC_NULL;
+  EC_T_DWORD dwSrcLen = 0;
+  EC_T_DWORD dwResult = EC_E_NOERROR;
+
+  if ((pbyData == EC_NULL) || (dwDataLen == 0)) {
+    return EC_E_INVALIDSIZE;
+  }
+  if ((pSim == EC_NULL) || !pSim->bPresent) {
+    dwResult = EC_E_SLAVE_NOT_PRESENT;
+    goto Exit;
+  }
+  /* 1) 下载过的对象 */
+  for (EC_T_DWORD i = 0; i < m_dwSdoObjCnt; i++) {
+    if ((m_aSdoObj[i].wStationAddress == wStationAddress) && (m_aSdoObj[i].wIndex == wIndex) && (m_aSdoObj[i].bySubIndex == bySubIndex)) {
+      pbySrc = m_aSdoObj[i].abyData;
+      dwSrcLen = m_aSdoObj[i].dwDataLen;
+      break;
+    }
+  }
+  /* 2) 本站已映射的 PDO 变量（当前过程映像里的值） */
+  for (EC_T_INT nDir = 0; (pbySrc == EC_NULL) && (nDir < 2); nDir++) {
+    const EC_T_PROCESS_VAR_INFO_EX* pVar = (nDir == 0) ? pSim->pVarInp : pSim->pVarOutp;
+    const EC_T_WORD wCnt = (nDir == 0) ? pSim->wNumVarsInp : pSim->wNumVarsOutp;
+    for (EC_T_WORD v = 0; v < wCnt; v++) {
+      if ((pVar[v].wIndex == wIndex) && (pVar[v].wSubIndex == bySubIndex)) {
+        pbySrc = ((nDir == 0) ? m_pbyPdIn : m_pbyPdOut) + pVar[v].nBitOffs / 8;
+        dwSrcLen = (EC_T_DWORD)pVar[v].nBitSize / 8;
+        break;
+      }
+    }
+  }
+  if (pbySrc == EC_NULL) {
+    dwResult = EC_E_SDO_ABORTCODE_INDEX;
+    goto Exit;
+  }
+  if (dwSrcLen > dwDataLen) {
+    dwResult = EC_E_INVALIDSIZE;
+    dwSrcLen = 0;
+    goto Exit;
+  }
+  OsMemcpy(pbyData, pbySrc, dwSrcLen);
+
+Exit:
+  MtSimSdoComplete(pHandle, pfnDone, pvContext, wStationAddress, wIndex, bySubIndex, dwResult, dwSrcLen);
+  return EC_E_NOERROR;
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
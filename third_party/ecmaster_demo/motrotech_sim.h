@@ -0,0 +1,181 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_sim.h
+ *
+ * 作用：无硬件的 CMtMasterAccess 实现 —— 内存里的过程映像 + CiA402 驱动模型。
+ *
+ * - Create() 按实例的 PDO 绑定表（MT_GetPdoBinding）给每个从站/轴排布变量，生成与 ENI 等价的
+ *   变量表（EC_T_PROCESS_VAR_INFO_EX），MT_Setup()/MtPdoBind() 走的是与实机完全相同的解析路径
+ * - 每轴一个驱动模型：
+ *   - 0x6040 -> 0x6041 状态机（Not ready -> Switch on disabled -> Ready -> Switched on -> Operation enabled，
+ *     quick stop、disable voltage、fault reaction / fault，fault reset 按 bit7 上升沿）
+ *   - InjectFault()：进入 fault reaction -> fault，0x603F 给出错误码；保持 dwHoldCycles 个周期内复位无效
+ *   - OE 时一阶响应：CSP 位置 pos += (target - pos) * (1 - e^(-dt/tau))，CSV 速度同理后积分成位置；
+ *     反馈 0x6064/0x606C/0x6077/0x60F4，温度/母线电压为常量
+ * - Cycle() 相当于一次 ProcessAllRxFrames：用上一周期 PdOut 推进模型并刷新 PdIn，在 MT_Workpd() 之前调用
+ * - SDO：下载写入仿真对象表，上传先查对象表、再查本站已映射的 PDO 变量；同步完成（handle + 回调）
+ *
+ * 只依赖 motrotech.h 的类型与绑定表，不需要 EC‑Master 库（bench/MtSimBench.cpp 在 x86 上直接链接）。
+ *---------------------------------------------------------------------------*/
+#ifndef __MOTROTECH_SIM_H__
+#define __MOTROTECH_SIM_H__     1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech.h"
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_SIM_NOT_MAPPED           0xFFFFFFFF  /* 变量不在过程映像里 */
+#define MT_SIM_SDO_OBJ_CNT          64          /* 仿真对象表容量（所有从站共用） */
+#define MT_SIM_SDO_DATA_LEN         8           /* 单个仿真对象最大字节数 */
+
+/* 模型关心的输出对象（PdOut） */
+#define MT_SIM_OUT_CTRL             0           /* 0x6040 */
+#define MT_SIM_OUT_TGTPOS           1           /* 0x607A */
+#define MT_SIM_OUT_TGTVEL           2           /* 0x60FF */
+#define MT_SIM_OUT_VELOFFS          3           /* 0x60B1 */
+#define MT_SIM_OUT_TRQOFFS          4           /* 0x60B2 */
+#define MT_SIM_OUT_MODE             5           /* 0x6060 */
+#define MT_SIM_OUT_CNT              6
+
+/* 模型刷新的输入对象（PdIn） */
+#define MT_SIM_IN_ERROR             0           /* 0x603F */
+#define MT_SIM_IN_STATUS            1           /* 0x6041 */
+#define MT_SIM_IN_ACTPOS            2           /* 0x6064 */
+#define MT_SIM_IN_ACTVEL            3           /* 0x606C */
+#define MT_SIM_IN_ACTTRQ            4           /* 0x6077 */
+#define MT_SIM_IN_FOLLOWERR         5           /* 0x60F4 */
+#define MT_SIM_IN_TEMPMCU           6           /* 0x3008 */
+#define MT_SIM_IN_TEMPMOTOR         7           /* 0x3009 */
+#define MT_SIM_IN_TEMPIGBT          8           /* 0x300F */
+#define MT_SIM_IN_DCLINK            9           /* 0x300B */
+#define MT_SIM_IN_CNT               10
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+typedef struct _T_MT_SIM_PARMS
+{
+    EC_T_LREAL  fPosTauSec;                 /* CSP 位置响应时间常数（s） */
+    EC_T_LREAL  fVelTauSec;                 /* CSV / quick stop 速度响应时间常数（s） */
+    EC_T_LREAL  fTrqPerAcc;                 /* 0x6077（0.1%）/ 加速度（count/s^2） */
+    EC_T_DWORD  dwBootCycles;               /* 上电后 Not ready 保持的周期数 */
+    EC_T_SWORD  sTempMcu;                   /* 0x3008 */
+    EC_T_SWORD  sTempMotor;                 /* 0x3009 */
+    EC_T_SWORD  sTempIgbt;                  /* 0x300F */
+    EC_T_WORD   wDcLinkVoltage;             /* 0x300B（0.1V） */
+} T_MT_SIM_PARMS;
+
+/* 一个仿真轴：变量在过程映像里的字节偏移 + 驱动模型状态 */
+typedef struct _T_MT_SIM_AXIS
+{
+    EC_T_WORD           wStationAddress;
+    EC_T_DWORD          adwOutOffs[MT_SIM_OUT_CNT];     /* PdOut 字节偏移，MT_SIM_NOT_MAPPED=未映射 */
+    EC_T_DWORD          adwInOffs[MT_SIM_IN_CNT];       /* PdIn 字节偏移 */
+
+    MC_T_CIA402_STATE   eState;
+    EC_T_WORD           wLastCtrl;                      /* 上一周期控制字（fault reset 上升沿） */
+    EC_T_WORD           wErrorCode;                     /* 0x603F */
+    EC_T_DWORD          dwBootCnt;
+    EC_T_DWORD          dwFaultHold;                    /* 剩余多少周期内复位无效 */
+    EC_T_LREAL          fPos;                           /* count */
+    EC_T_LREAL          fVel;                           /* count/s */
+    EC_T_LREAL          fTrq;                           /* 0.1% */
+    EC_T_DWORD          dwFollowErr;                    /* count */
+
+    EC_T_DWORD          dwFaults;                       /* 进入 fault 的次数 */
+    EC_T_DWORD          dwFaultResets;                  /* fault reset 成功次数 */
+} T_MT_SIM_AXIS;
+
+/* 一个仿真从站：CMtMasterAccess::GetCfgSlaveInfo/GetSlaveVarInfo 返回的变量表 */
+typedef struct _T_MT_SIM_SLAVE
+{
+    EC_T_WORD                   wStationAddress;
+    EC_T_WORD                   wAxisCnt;
+    EC_T_DWORD                  dwFirstAxis;
+    EC_T_BOOL                   bPresent;
+    EC_T_WORD                   wNumVarsInp;
+    EC_T_WORD                   wNumVarsOutp;
+    EC_T_PROCESS_VAR_INFO_EX*   pVarInp;
+    EC_T_PROCESS_VAR_INFO_EX*   pVarOutp;
+} T_MT_SIM_SLAVE;
+
+typedef struct _T_MT_SIM_SDO_OBJ
+{
+    EC_T_WORD   wStationAddress;
+    EC_T_WORD   wIndex;
+    EC_T_BYTE   bySubIndex;
+    EC_T_DWORD  dwDataLen;
+    EC_T_BYTE   abyData[MT_SIM_SDO_DATA_LEN];
+} T_MT_SIM_SDO_OBJ;
+
+/*-CLASS---------------------------------------------------------------------*/
+class CMtSimMaster : public CMtMasterAccess
+{
+public:
+    CMtSimMaster();
+    virtual ~CMtSimMaster();
+
+    static EC_T_VOID DefaultParms(T_MT_SIM_PARMS* pParms);
+
+    /* 按从站列表与绑定表建立过程映像/变量表，所有轴处于 Not ready，主站状态 OP
+     * [2026-10-16] pPdo：要仿真的实例的绑定表（&T_MT_CONTEXT::oPdo，只在 Create() 里读）
+     */
+    EC_T_DWORD  Create(T_MT_PDO_CTX* pPdo, const SLAVE_MOTOR_TYPE* pSlave, EC_T_DWORD dwSlaveCnt, EC_T_DWORD dwCycleTimeUsec,
+                       const T_MT_SIM_PARMS* pParms = EC_NULL);
+    EC_T_VOID   Delete(EC_T_VOID);
+
+    /* 一个总线周期：读 PdOut -> 推进驱动模型 -> 写 PdIn（在 MT_Workpd() 之前调用） */
+    EC_T_VOID   Cycle(EC_T_VOID);
+
+    EC_T_VOID   SetMasterState(EC_T_STATE eState) { m_eMasterState = eState; }
+    EC_T_VOID   SetSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL bPresent);
+    EC_T_DWORD  InjectFault(EC_T_DWORD dwAxis, EC_T_WORD wErrorCode, EC_T_DWORD dwHoldCycles = 0);
+
+    EC_T_DWORD  GetAxisCount(EC_T_VOID) { return m_dwAxisCnt; }
+    const T_MT_SIM_AXIS* GetAxis(EC_T_DWORD dwAxis) { return (dwAxis < m_dwAxisCnt) ? &m_pAxis[dwAxis] : EC_NULL; }
+    EC_T_DWORD  GetInputSize(EC_T_VOID) { return m_dwPdInSize; }
+    EC_T_DWORD  GetOutputSize(EC_T_VOID) { return m_dwPdOutSize; }
+
+    /* CMtMasterAccess */
+    virtual EC_T_BYTE*  GetProcessImageInputPtr(EC_T_VOID) { return m_pbyPdIn; }
+    virtual EC_T_BYTE*  GetProcessImageOutputPtr(EC_T_VOID) { return m_pbyPdOut; }
+    virtual EC_T_STATE  GetMasterState(EC_T_VOID) { return m_eMasterState; }
+    virtual EC_T_DWORD  GetNumConfiguredSlaves(EC_T_VOID) { return m_dwSlaveCnt; }
+    virtual EC_T_DWORD  IsSlavePresent(EC_T_WORD wStationAddress, EC_T_BOOL* pbPresent);
+    virtual EC_T_DWORD  GetCfgSlaveInfo(EC_T_WORD wStationAddress, EC_T_CFG_SLAVE_INFO* pSlaveInfo);
+    virtual EC_T_DWORD  GetSlaveVarInfo(EC_T_BOOL bOutput, EC_T_WORD wStationAddress, EC_T_WORD wNumOfVarsToRead,
+                                        EC_T_PROCESS_VAR_INFO_EX* pVarInfo, EC_T_WORD* pwReadEntries);
+    virtual EC_T_DWORD  SdoDownload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                    const EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                    T_SDO_PIPE_HANDLE* pHandle = EC_NULL, EC_PF_SDO_PIPE_DONE pfnDone = EC_NULL, EC_T_VOID* pvContext = EC_NULL);
+    virtual EC_T_DWORD  SdoUpload(EC_T_WORD wStationAddress, EC_T_WORD wIndex, EC_T_BYTE bySubIndex,
+                                  EC_T_BYTE* pbyData, EC_T_DWORD dwDataLen,
+                                  T_SDO_PIPE_HANDLE* pHandle = EC_NULL, EC_PF_SDO_PIPE_DONE pfnDone = EC_NULL, EC_T_VOID* pvContext = EC_NULL);
+
+private:
+    T_MT_SIM_SLAVE* FindSlave(EC_T_WORD wStationAddress);
+    EC_T_VOID   StepAxis(T_MT_SIM_AXIS* pAxis);
+    EC_T_VOID   StepStateMachine(T_MT_SIM_AXIS* pAxis, EC_T_WORD wCtrl);
+    EC_T_VOID   StepMotion(T_MT_SIM_AXIS* pAxis);
+    EC_T_WORD   StatusWord(const T_MT_SIM_AXIS* pAxis);
+
+private:
+    T_MT_SIM_PARMS      m_oParms;
+    EC_T_STATE          m_eMasterState;
+    EC_T_LREAL          m_fCycleSec;
+    EC_T_LREAL          m_fPosAlpha;                    /* 1 - e^(-dt/tau) */
+    EC_T_LREAL          m_fVelAlpha;
+
+    EC_T_BYTE*          m_pbyPdIn;
+    EC_T_BYTE*          m_pbyPdOut;
+    EC_T_DWORD          m_dwPdInSize;
+    EC_T_DWORD          m_dwPdOutSize;
+
+    T_MT_SIM_SLAVE*     m_pSlave;
+    EC_T_DWORD          m_dwSlaveCnt;
+    T_MT_SIM_AXIS*      m_pAxis;
+    EC_T_DWORD          m_dwAxisCnt;
+
+    T_MT_SIM_SDO_OBJ    m_aSdoObj[MT_SIM_SDO_OBJ_CNT];
+    EC_T_DWORD          m_dwSdoObjCnt;
+};
+
+#endif /* __MOTROTECH_SIM_H__ */
+/*-END OF SOURCE FILE--------------------------------------------------------*/
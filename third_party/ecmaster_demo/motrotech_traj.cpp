@@ -0,0 +1,520 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_traj.cpp
+ *
+ * 轴组流式轨迹实现（见 motrotech_traj.h）。
+ *
+ * 插补：段 [t0,t1] 上三次 Hermite（位置、速度连续），段终点切线在取点时确定一次；
+ * 受控停止：各轴从当前速度 v_i 按同一时长 T = max|v_i| / stop_decel 线性减速到 0，
+ * 组内各轴同时停下（与插补共用组时钟）。
+ *---------------------------------------------------------------------------*/
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "motrotech_traj.h"
+
+/*-DEFINES-------------------------------------------------------------------*/
+/* 航点标志（T_MT_TRAJ_GROUP::pbyPtFlags） */
+#define MT_TRAJ_PT_DQ           0x01    /* 带速度 */
+#define MT_TRAJ_PT_LAST         0x02    /* 流的终点 */
+
+/* 生产者 <-> 周期线程（单生产者/单消费者） */
+#define MT_TRAJ_LOAD_ACQ(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define MT_TRAJ_STORE_REL(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*-LOCAL FUNCTIONS-----------------------------------------------------------*/
+static EC_T_DWORD MtTrajRoundPow2(EC_T_DWORD dwVal)
+{
+  EC_T_DWORD dwPow2 = 2;
+
+  while ((dwPow2 < dwVal) && (dwPow2 < 0x80000000UL)) {
+    dwPow2 <<= 1;
+  }
+  return dwPow2;
+}
+
+static EC_T_VOID MtTrajGroupDelete(T_MT_TRAJ_GROUP* pGroup)
+{
+  SafeOsFree(pGroup->pwAxis);
+  SafeOsFree(pGroup->pfPtTime);
+  SafeOsFree(pGroup->pfPtQ);
+  SafeOsFree(pGroup->pfPtDq);
+  SafeOsFree(pGroup->pbyPtFlags);
+  SafeOsFree(pGroup->pfSegQ0);
+  SafeOsFree(pGroup->pfSegQ1);
+  SafeOsFree(pGroup->pfSegM0);
+  SafeOsFree(pGroup->pfSegM1);
+  SafeOsFree(pGroup->pfStopDecel);
+  OsMemset(pGroup, 0, sizeof(T_MT_TRAJ_GROUP));
+}
+
+static EC_T_BOOL MtTrajGroupCreate(T_MT_TRAJ_GROUP* pGroup, const T_MT_TRAJ_GROUP_CFG* pCfg)
+{
+  const EC_T_DWORD dwAxisCnt = pCfg->dwAxisCnt;
+  const EC_T_DWORD dwLen = MtTrajRoundPow2((pCfg->dwQueueLen == 0) ? MT_TRAJ_DEFAULT_QUEUE : pCfg->dwQueueLen);
+
+  OsMemset(pGroup, 0, sizeof(T_MT_TRAJ_GROUP));
+  pGroup->dwAxisCnt = dwAxisCnt;
+  pGroup->dwQueueLen = dwLen;
+  pGroup->fStopDecel = (pCfg->fStopDecel > 0.0) ? pCfg->fStopDecel : MT_TRAJ_DEFAULT_STOP_DECEL;
+  pGroup->pwAxis      = (EC_T_WORD*)OsMalloc(sizeof(EC_T_WORD) * dwAxisCnt);
+  pGroup->pfPtTime    = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwLen);
+  pGroup->pfPtQ       = (EC_T_REAL*)OsMalloc(sizeof(EC_T_REAL) * dwLen * dwAxisCnt);
+  pGroup->pfPtDq      = (EC_T_REAL*)OsMalloc(sizeof(EC_T_REAL) * dwLen * dwAxisCnt);
+  pGroup->pbyPtFlags  = (EC_T_BYTE*)OsMalloc(dwLen);
+  pGroup->pfSegQ0     = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pGroup->pfSegQ1     = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pGroup->pfSegM0     = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pGroup->pfSegM1     = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pGroup->pfStopDecel = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  if ((pGroup->pwAxis == EC_NULL) || (pGroup->pfPtTime == EC_NULL) || (pGroup->pfPtQ == EC_NULL)
+      || (pGroup->pfPtDq == EC_NULL) || (pGroup->pbyPtFlags == EC_NULL) || (pGroup->pfSegQ0 == EC_NULL)
+      || (pGroup->pfSegQ1 == EC_NULL) || (pGroup->pfSegM0 == EC_NULL) || (pGroup->pfSegM1 == EC_NULL)
+      || (pGroup->pfStopDecel == EC_NULL)) {
+    MtTrajGroupDelete(pGroup);
+    return EC_FALSE;
+  }
+  OsMemcpy(pGroup->pwAxis, pCfg->pwAxis, sizeof(EC_T_WORD) * dwAxisCnt);
+  OsMemset(pGroup->pfSegQ1, 0, sizeof(EC_T_LREAL) * dwAxisCnt);
+  OsMemset(pGroup->pfSegM1, 0, sizeof(EC_T_LREAL) * dwAxisCnt);
+  pGroup->dwState = MT_TRAJ_STATE_IDLE;
+  return EC_TRUE;
+}
+
+/* 取环里下一个航点作为新段终点（上一段终点变成起点），环空返回 EC_FALSE */
+static EC_T_BOOL MtTrajLoadSeg(T_MT_TRAJ_GROUP* pGroup, EC_T_DWORD dwWr)
+{
+  const EC_T_DWORD dwRd = pGroup->dwRd;
+  const EC_T_DWORD dwMask = pGroup->dwQueueLen - 1;
+  const EC_T_DWORD dwAxisCnt = pGroup->dwAxisCnt;
+  const EC_T_DWORD dwSlot = dwRd & dwMask;
+  const EC_T_BYTE byFlags = pGroup->pbyPtFlags[dwSlot];
+  const EC_T_REAL* pfQ = &pGroup->pfPtQ[dwSlot * dwAxisCnt];
+  const EC_T_REAL* pfQ2 = EC_NULL;
+  EC_T_LREAL fT2 = 0.0;
+
+  if (dwRd == dwWr) {
+    return EC_FALSE;
+  }
+  pGroup->fSegT0 = pGroup->fSegT1;
+  pGroup->fSegT1 = pGroup->pfPtTime[dwSlot];
+  pGroup->bSegLast = (EC_T_BOOL)((byFlags & MT_TRAJ_PT_LAST) != 0);
+  if (((byFlags & (MT_TRAJ_PT_DQ | MT_TRAJ_PT_LAST)) == 0) && ((dwRd + 1) != dwWr)) {
+    /* 有后继点：非均匀 Catmull‑Rom，m1 = (q2 - q0) / (t2 - t0) */
+    pfQ2 = &pGroup->pfPtQ[((dwRd + 1) & dwMask) * dwAxisCnt];
+    fT2 = pGroup->pfPtTime[(dwRd + 1) & dwMask];
+  }
+  for (EC_T_DWORD k = 0; k < dwAxisCnt; k++) {
+    const EC_T_LREAL fQ0 = pGroup->pfSegQ1[k];
+    const EC_T_LREAL fQ1 = (EC_T_LREAL)pfQ[k];
+
+    pGroup->pfSegQ0[k] = fQ0;
+    pGroup->pfSegM0[k] = pGroup->pfSegM1[k];
+    pGroup->pfSegQ1[k] = fQ1;
+    if (byFlags & MT_TRAJ_PT_DQ) {
+      pGroup->pfSegM1[k] = (EC_T_LREAL)pGroup->pfPtDq[dwSlot * dwAxisCnt + k];
+    } else if (byFlags & MT_TRAJ_PT_LAST) {
+      pGroup->pfSegM1[k] = 0.0;
+    } else if (pfQ2 != EC_NULL) {
+      pGroup->pfSegM1[k] = ((EC_T_LREAL)pfQ2[k] - fQ0) / (fT2 - pGroup->fSegT0);
+    } else {
+      pGroup->pfSegM1[k] = (fQ1 - fQ0) / (pGroup->fSegT1 - pGroup->fSegT0);
+    }
+  }
+  MT_TRAJ_STORE_REL(&pGroup->dwRd, dwRd + 1);
+  pGroup->qwPoints++;
+  return EC_TRUE;
+}
+
+/* 以轴当前设定值为起点（速度 0、t=0）开始新流 */
+static EC_T_VOID MtTrajStart(T_MT_TRAJ* pTraj, T_MT_TRAJ_GROUP* pGroup, EC_T_DWORD dwWr)
+{
+  for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+    pGroup->pfSegQ1[k] = pTraj->pfAnchorQ[pGroup->pwAxis[k]];
+    pGroup->pfSegM1[k] = 0.0;
+  }
+  pGroup->fSegT1 = 0.0;
+  pGroup->fTime = 0.0;
+  pGroup->bSegLast = EC_FALSE;
+  MtTrajLoadSeg(pGroup, dwWr);
+  pGroup->dwState = MT_TRAJ_STATE_RUN;
+  pGroup->dwStreams++;
+}
+
+/* 段终点（位置、切线）写到输出 */
+static EC_T_VOID MtTrajOutSegEnd(T_MT_TRAJ* pTraj, T_MT_TRAJ_GROUP* pGroup, EC_T_BOOL bZeroVel)
+{
+  for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+    const EC_T_WORD wAxis = pGroup->pwAxis[k];
+    pTraj->pfQ[wAxis] = pGroup->pfSegQ1[k];
+    pTraj->pfDq[wAxis] = bZeroVel ? 0.0 : pGroup->pfSegM1[k];
+  }
+}
+
+/* 从当前输出速度开始受控停止：各轴同一时长线性减速到 0 */
+static EC_T_VOID MtTrajBeginStop(T_MT_TRAJ* pTraj, T_MT_TRAJ_GROUP* pGroup)
+{
+  EC_T_LREAL fMaxVel = 0.0;
+
+  for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+    const EC_T_LREAL fVel = pTraj->pfDq[pGroup->pwAxis[k]];
+    fMaxVel = EC_MAX(fMaxVel, (fVel < 0.0) ? -fVel : fVel);
+  }
+  pGroup->fStopRemain = fMaxVel / pGroup->fStopDecel;
+  for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+    const EC_T_WORD wAxis = pGroup->pwAxis[k];
+    pGroup->pfStopDecel[k] = (pGroup->fStopRemain > 0.0) ? (pTraj->pfDq[wAxis] / pGroup->fStopRemain) : 0.0;
+  }
+  pGroup->dwState = MT_TRAJ_STATE_STOP;
+}
+
+static EC_T_VOID MtTrajStopStep(T_MT_TRAJ* pTraj, T_MT_TRAJ_GROUP* pGroup, EC_T_LREAL fDt)
+{
+  const EC_T_LREAL fStep = EC_MIN(fDt, pGroup->fStopRemain);
+  const EC_T_BOOL bDone = (EC_T_BOOL)(fDt >= pGroup->fStopRemain);
+
+  for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+    const EC_T_WORD wAxis = pGroup->pwAxis[k];
+    const EC_T_LREAL fVel0 = pTraj->pfDq[wAxis];
+    const EC_T_LREAL fVel1 = bDone ? 0.0 : (fVel0 - pGroup->pfStopDecel[k] * fStep);
+
+    pTraj->pfQ[wAxis] += 0.5 * (fVel0 + fVel1) * fStep;
+    pTraj->pfDq[wAxis] = fVel1;
+  }
+  pGroup->fStopRemain -= fStep;
+  if (bDone) {
+    pGroup->fStopRemain = 0.0;
+    pGroup->dwState = MT_TRAJ_STATE_HOLD;
+  }
+}
+
+/* 推进组时钟 fDt 并插补；到流终点转 HOLD，欠载转受控停止 */
+static EC_T_VOID MtTrajRunStep(T_MT_TRAJ* pTraj, T_MT_TRAJ_GROUP* pGroup, EC_T_DWORD dwWr, EC_T_LREAL fDt)
+{
+  pGroup->fTime += fDt;
+  while (pGroup->fTime > pGroup->fSegT1) {
+    if (pGroup->bSegLast) {
+      MtTrajOutSegEnd(pTraj, pGroup, EC_TRUE);
+      pGroup->fTime = pGroup->fSegT1;
+      pGroup->dwState = MT_TRAJ_STATE_HOLD;
+      return;
+    }
+    if (!MtTrajLoadSeg(pGroup, dwWr)) {
+      const EC_T_LREAL fOver = pGroup->fTime - pGroup->fSegT1;
+
+      MtTrajOutSegEnd(pTraj, pGroup, EC_FALSE);
+      pGroup->fTime = pGroup->fSegT1;
+      pGroup->dwUnderruns++;
+      MT_TRAJ_STORE_REL(&pGroup->bLatched, EC_TRUE);
+      MtTrajBeginStop(pTraj, pGroup);
+      MtTrajStopStep(pTraj, pGroup, fOver);
+      return;
+    }
+  }
+  {
+    const EC_T_LREAL fH = pGroup->fSegT1 - pGroup->fSegT0;
+    const EC_T_LREAL fS = (pGroup->fTime - pGroup->fSegT0) / fH;
+    const EC_T_LREAL fS2 = fS * fS;
+    const EC_T_LREAL fS3 = fS2 * fS;
+    const EC_T_LREAL fH00 = 2.0 * fS3 - 3.0 * fS2 + 1.0;
+    const EC_T_LREAL fH10 = (fS3 - 2.0 * fS2 + fS) * fH;
+    const EC_T_LREAL fH01 = 3.0 * fS2 - 2.0 * fS3;
+    const EC_T_LREAL fH11 = (fS3 - fS2) * fH;
+    const EC_T_LREAL fD00 = (6.0 * fS2 - 6.0 * fS) / fH;
+    const EC_T_LREAL fD10 = 3.0 * fS2 - 4.0 * fS + 1.0;
+    const EC_T_LREAL fD11 = 3.0 * fS2 - 2.0 * fS;
+
+    for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+      const EC_T_WORD wAxis = pGroup->pwAxis[k];
+      const EC_T_LREAL fQ0 = pGroup->pfSegQ0[k];
+      const EC_T_LREAL fQ1 = pGroup->pfSegQ1[k];
+      const EC_T_LREAL fM0 = pGroup->pfSegM0[k];
+      const EC_T_LREAL fM1 = pGroup->pfSegM1[k];
+
+      pTraj->pfQ[wAxis] = fH00 * fQ0 + fH10 * fM0 + fH01 * fQ1 + fH11 * fM1;
+      pTraj->pfDq[wAxis] = fD00 * (fQ0 - fQ1) + fD10 * fM0 + fD11 * fM1;
+    }
+  }
+}
+
+static EC_T_VOID MtTrajGroupCycle(T_MT_TRAJ* pTraj, T_MT_TRAJ_GROUP* pGroup, EC_T_LREAL fDt)
+{
+  /* 先读请求再读写位置：dwFlushTo 不会超过随后读到的 dwWr */
+  const EC_T_DWORD dwStopReq = MT_TRAJ_LOAD_ACQ(&pGroup->dwStopReq);
+  const EC_T_DWORD dwResetReq = MT_TRAJ_LOAD_ACQ(&pGroup->dwResetReq);
+  const EC_T_DWORD dwReleaseReq = MT_TRAJ_LOAD_ACQ(&pGroup->dwReleaseReq);
+  const EC_T_DWORD dwWr = MT_TRAJ_LOAD_ACQ(&pGroup->dwWr);
+  EC_T_BOOL bReady = EC_TRUE;
+
+  if ((dwStopReq != pGroup->dwStopAck) || (dwResetReq != pGroup->dwResetAck)) {
+    const EC_T_DWORD dwFlushTo = MT_TRAJ_LOAD_ACQ(&pGroup->dwFlushTo);
+
+    if ((dwFlushTo - pGroup->dwRd) <= (dwWr - pGroup->dwRd)) {
+      MT_TRAJ_STORE_REL(&pGroup->dwRd, dwFlushTo);
+    }
+    if (pGroup->dwState == MT_TRAJ_STATE_RUN) {
+      MtTrajBeginStop(pTraj, pGroup);
+    }
+    if (dwResetReq != pGroup->dwResetAck) {
+      MT_TRAJ_STORE_REL(&pGroup->bLatched, EC_FALSE);
+    }
+    pGroup->dwStopAck = dwStopReq;
+    pGroup->dwResetAck = dwResetReq;
+  }
+  if (dwReleaseReq != pGroup->dwReleaseAck) {
+    if (pGroup->dwState == MT_TRAJ_STATE_HOLD) {
+      pGroup->dwState = MT_TRAJ_STATE_IDLE;
+    }
+    pGroup->dwReleaseAck = dwReleaseReq;
+  }
+
+  for (EC_T_DWORD k = 0; k < pGroup->dwAxisCnt; k++) {
+    bReady = bReady && (pTraj->pbyReady[pGroup->pwAxis[k]] != 0);
+  }
+
+  switch (pGroup->dwState) {
+  case MT_TRAJ_STATE_IDLE:
+  case MT_TRAJ_STATE_HOLD:
+    if (!bReady) {
+      pGroup->dwState = MT_TRAJ_STATE_IDLE;
+    } else if (!pGroup->bLatched && (pGroup->dwRd != dwWr)) {
+      MtTrajStart(pTraj, pGroup, dwWr);
+      MtTrajRunStep(pTraj, pGroup, dwWr, fDt);
+    }
+    break;
+  case MT_TRAJ_STATE_RUN:
+    if (!bReady) {
+      /* 流运行中有轴掉出就绪：其余轴受控停止，组锁定 */
+      pGroup->dwAborts++;
+      MT_TRAJ_STORE_REL(&pGroup->bLatched, EC_TRUE);
+      MtTrajBeginStop(pTraj, pGroup);
+      MtTrajStopStep(pTraj, pGroup, fDt);
+    } else {
+      MtTrajRunStep(pTraj, pGroup, dwWr, fDt);
+    }
+    break;
+  case MT_TRAJ_STATE_STOP:
+    MtTrajStopStep(pTraj, pGroup, fDt);
+    break;
+  default:
+    break;
+  }
+}
+
+static T_MT_TRAJ_GROUP* MtTrajGetGroup(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup)
+{
+  if ((pTraj == EC_NULL) || (dwGroup >= pTraj->dwGroupCnt)) {
+    return EC_NULL;
+  }
+  return &pTraj->aGroup[dwGroup];
+}
+
+/*-FUNCTION DEFINITIONS------------------------------------------------------*/
+EC_T_DWORD MtTrajCreate(T_MT_TRAJ* pTraj, EC_T_DWORD dwAxisCnt, const T_MT_TRAJ_GROUP_CFG* pCfg, EC_T_DWORD dwGroupCnt)
+{
+  OsMemset(pTraj, 0, sizeof(T_MT_TRAJ));
+  if (dwAxisCnt == 0) {
+    return EC_E_NOERROR;
+  }
+  if ((dwGroupCnt > MT_TRAJ_MAX_GROUPS) || ((dwGroupCnt > 0) && (pCfg == EC_NULL))) {
+    return EC_E_INVALIDPARM;
+  }
+  pTraj->pnAxisGroup = (EC_T_INT*)OsMalloc(sizeof(EC_T_INT) * dwAxisCnt);
+  pTraj->pbyReady    = (EC_T_BYTE*)OsMalloc(dwAxisCnt);
+  pTraj->pfAnchorQ   = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pTraj->pfQ         = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pTraj->pfDq        = (EC_T_LREAL*)OsMalloc(sizeof(EC_T_LREAL) * dwAxisCnt);
+  pTraj->dwAxisCnt = dwAxisCnt;
+  if ((pTraj->pnAxisGroup == EC_NULL) || (pTraj->pbyReady == EC_NULL) || (pTraj->pfAnchorQ == EC_NULL)
+      || (pTraj->pfQ == EC_NULL) || (pTraj->pfDq == EC_NULL)) {
+    MtTrajDelete(pTraj);
+    return EC_E_NOMEMORY;
+  }
+  OsMemset(pTraj->pbyReady, 0, dwAxisCnt);
+  OsMemset(pTraj->pfAnchorQ, 0, sizeof(EC_T_LREAL) * dwAxisCnt);
+  OsMemset(pTraj->pfQ, 0, sizeof(EC_T_LREAL) * dwAxisCnt);
+  OsMemset(pTraj->pfDq, 0, sizeof(EC_T_LREAL) * dwAxisCnt);
+  for (EC_T_DWORD i = 0; i < dwAxisCnt; i++) {
+    pTraj->pnAxisGroup[i] = -1;
+  }
+
+  /* 轴号必须在范围内，且一个轴最多属于一个组 */
+  for (EC_T_DWORD g = 0; g < dwGroupCnt; g++) {
+    if ((pCfg[g].dwAxisCnt == 0) || (pCfg[g].pwAxis == EC_NULL)) {
+      MtTrajDelete(pTraj);
+      return EC_E_INVALIDPARM;
+    }
+    for (EC_T_DWORD k = 0; k < pCfg[g].dwAxisCnt; k++) {
+      const EC_T_WORD wAxis = pCfg[g].pwAxis[k];
+      if ((wAxis >= dwAxisCnt) || (pTraj->pnAxisGroup[wAxis] >= 0)) {
+        MtTrajDelete(pTraj);
+        return EC_E_INVALIDPARM;
+      }
+      pTraj->pnAxisGroup[wAxis] = (EC_T_INT)g;
+    }
+  }
+  for (EC_T_DWORD g = 0; g < dwGroupCnt; g++) {
+    if (!MtTrajGroupCreate(&pTraj->aGroup[g], &pCfg[g])) {
+      MtTrajDelete(pTraj);
+      return EC_E_NOMEMORY;
+    }
+    pTraj->dwGroupCnt = g + 1;
+  }
+  return EC_E_NOERROR;
+}
+
+EC_T_VOID MtTrajDelete(T_MT_TRAJ* pTraj)
+{
+  for (EC_T_DWORD g = 0; g < MT_TRAJ_MAX_GROUPS; g++) {
+    MtTrajGroupDelete(&pTraj->aGroup[g]);
+  }
+  SafeOsFree(pTraj->pnAxisGroup);
+  SafeOsFree(pTraj->pbyReady);
+  SafeOsFree(pTraj->pfAnchorQ);
+  SafeOsFree(pTraj->pfQ);
+  SafeOsFree(pTraj->pfDq);
+  pTraj->dwAxisCnt = 0;
+  pTraj->dwGroupCnt = 0;
+}
+
+EC_T_DWORD MtTrajPush(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup, const EC_T_LREAL* pfTime, const EC_T_REAL* pfQ,
+                      const EC_T_REAL* pfDq, EC_T_DWORD dwCnt, EC_T_BOOL bLast, EC_T_DWORD* pdwAccepted)
+{
+  T_MT_TRAJ_GROUP* pGroup = MtTrajGetGroup(pTraj, dwGroup);
+  EC_T_DWORD dwAxisCnt = 0;
+  EC_T_DWORD dwWr = 0;
+  EC_T_DWORD dwFree = 0;
+  EC_T_DWORD dwTake = 0;
+  EC_T_LREAL fPrevTime = 0.0;
+
+  if (pdwAccepted != EC_NULL) {
+    *pdwAccepted = 0;
+  }
+  if ((pGroup == EC_NULL) || (pfTime == EC_NULL) || (pfQ == EC_NULL)) {
+    return EC_E_INVALIDPARM;
+  }
+  if (MT_TRAJ_LOAD_ACQ(&pGroup->bLatched)) {
+    return EC_E_INVALIDSTATE;
+  }
+  if (pGroup->bPushClosed) {
+    pGroup->fPushTime = 0.0;
+    pGroup->bPushClosed = EC_FALSE;
+  }
+
+  /* 整批先校验：时间严格递增，位置/速度不是 NaN */
+  dwAxisCnt = pGroup->dwAxisCnt;
+  fPrevTime = pGroup->fPushTime;
+  for (EC_T_DWORD j = 0; j < dwCnt; j++) {
+    if (!(pfTime[j] > fPrevTime)) {
+      return EC_E_INVALIDPARM;
+    }
+    fPrevTime = pfTime[j];
+    for (EC_T_DWORD k = 0; k < dwAxisCnt; k++) {
+      if ((pfQ[j * dwAxisCnt + k] != pfQ[j * dwAxisCnt + k])
+          || ((pfDq != EC_NULL) && (pfDq[j * dwAxisCnt + k] != pfDq[j * dwAxisCnt + k]))) {
+        return EC_E_INVALIDPARM;
+      }
+    }
+  }
+
+  dwWr = pGroup->dwWr;
+  dwFree = pGroup->dwQueueLen - (dwWr - MT_TRAJ_LOAD_ACQ(&pGroup->dwRd));
+  dwTake = EC_MIN(dwCnt, dwFree);
+  for (EC_T_DWORD j = 0; j < dwTake; j++) {
+    const EC_T_DWORD dwSlot = (dwWr + j) & (pGroup->dwQueueLen - 1);
+    EC_T_BYTE byFlags = 0;
+
+    pGroup->pfPtTime[dwSlot] = pfTime[j];
+    OsMemcpy(&pGroup->pfPtQ[dwSlot * dwAxisCnt], &pfQ[j * dwAxisCnt], sizeof(EC_T_REAL) * dwAxisCnt);
+    if (pfDq != EC_NULL) {
+      OsMemcpy(&pGroup->pfPtDq[dwSlot * dwAxisCnt], &pfDq[j * dwAxisCnt], sizeof(EC_T_REAL) * dwAxisCnt);
+      byFlags |= MT_TRAJ_PT_DQ;
+    }
+    if (bLast && (dwTake == dwCnt) && ((j + 1) == dwTake)) {
+      byFlags |= MT_TRAJ_PT_LAST;
+      pGroup->bPushClosed = EC_TRUE;
+    }
+    pGroup->pbyPtFlags[dwSlot] = byFlags;
+  }
+  if (dwTake > 0) {
+    pGroup->fPushTime = pfTime[dwTake - 1];
+    MT_TRAJ_STORE_REL(&pGroup->dwWr, dwWr + dwTake);
+  }
+  if (pdwAccepted != EC_NULL) {
+    *pdwAccepted = dwTake;
+  }
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD MtTrajStop(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup)
+{
+  T_MT_TRAJ_GROUP* pGroup = MtTrajGetGroup(pTraj, dwGroup);
+
+  if (pGroup == EC_NULL) {
+    return EC_E_INVALIDPARM;
+  }
+  pGroup->fPushTime = 0.0;
+  pGroup->bPushClosed = EC_FALSE;
+  MT_TRAJ_STORE_REL(&pGroup->dwFlushTo, pGroup->dwWr);
+  MT_TRAJ_STORE_REL(&pGroup->dwStopReq, pGroup->dwStopReq + 1);
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD MtTrajReset(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup)
+{
+  T_MT_TRAJ_GROUP* pGroup = MtTrajGetGroup(pTraj, dwGroup);
+
+  if (pGroup == EC_NULL) {
+    return EC_E_INVALIDPARM;
+  }
+  pGroup->fPushTime = 0.0;
+  pGroup->bPushClosed = EC_FALSE;
+  MT_TRAJ_STORE_REL(&pGroup->dwFlushTo, pGroup->dwWr);
+  MT_TRAJ_STORE_REL(&pGroup->dwResetReq, pGroup->dwResetReq + 1);
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD MtTrajRelease(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup)
+{
+  T_MT_TRAJ_GROUP* pGroup = MtTrajGetGroup(pTraj, dwGroup);
+
+  if (pGroup == EC_NULL) {
+    return EC_E_INVALIDPARM;
+  }
+  MT_TRAJ_STORE_REL(&pGroup->dwReleaseReq, pGroup->dwReleaseReq + 1);
+  return EC_E_NOERROR;
+}
+
+EC_T_DWORD MtTrajGetStatus(const T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup, T_MT_TRAJ_STATUS* pStatus)
+{
+  const T_MT_TRAJ_GROUP* pGroup = MtTrajGetGroup((T_MT_TRAJ*)pTraj, dwGroup);
+  EC_T_DWORD dwRd = 0;
+
+  if ((pGroup == EC_NULL) || (pStatus == EC_NULL)) {
+    return EC_E_INVALIDPARM;
+  }
+  dwRd = MT_TRAJ_LOAD_ACQ(&pGroup->dwRd);
+  pStatus->dwState = MT_TRAJ_LOAD_ACQ(&pGroup->dwState);
+  pStatus->bLatched = MT_TRAJ_LOAD_ACQ(&pGroup->bLatched);
+  pStatus->fTime = pGroup->fTime;
+  pStatus->dwQueued = MT_TRAJ_LOAD_ACQ(&pGroup->dwWr) - dwRd;
+  pStatus->dwFree = pGroup->dwQueueLen - pStatus->dwQueued;
+  if (pStatus->dwState == MT_TRAJ_STATE_RUN) {
+    pStatus->fBufferedSec = EC_MAX(0.0, pGroup->fPushTime - pStatus->fTime);
+  } else {
+    /* 尚未开始的流从 t=0 算起 */
+    pStatus->fBufferedSec = (pStatus->dwQueued > 0) ? pGroup->fPushTime : 0.0;
+  }
+  pStatus->dwStreams = pGroup->dwStreams;
+  pStatus->dwUnderruns = pGroup->dwUnderruns;
+  pStatus->dwAborts = pGroup->dwAborts;
+  pStatus->qwPoints = pGroup->qwPoints;
+  return EC_E_NOERROR;
+}
+
+EC_T_VOID MtTrajCycle(T_MT_TRAJ* pTraj, EC_T_LREAL fDt)
+{
+  for (EC_T_DWORD g = 0; g < pTraj->dwGroupCnt; g++) {
+    MtTrajGroupCycle(pTraj, &pTraj->aGroup[g], fDt);
+  }
+}
+
+/*-END OF SOURCE FILE--------------------------------------------------------*/
@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------
+ * motrotech_traj.h
+ *
+ * 作用：轴组的流式轨迹（时间戳航点队列 + 周期插补）。
+ *
+ * - 上层规划器以 50~100Hz 运行，每次推送一批（例如未来 50ms 的）带时间戳的航点：
+ *   t（s，流内相对时间）、每轴 q（rad）、可选每轴 dq（rad/s）
+ * - 每组一条有界的单生产者/单消费者环（规划线程写，周期线程读），不加锁、不分配内存
+ * - 周期线程每周期把组时钟推进 dt，按三次 Hermite 在相邻航点间插补，组内各轴共用同一个时钟（同步）；
+ *   航点切线：给了 dq 就用 dq；否则有后继点时用非均匀 Catmull‑Rom，流末点为 0，其余退回割线
+ * - 流开始：队列里有点、组内轴全部就绪（MANUAL + OP_ENABLED）时以当前设定值为起点、速度 0、t=0
+ * - 欠载（插补到队尾但流没有结束）：各轴按同一时长线性减速到 0（受控停止，最大减速度 stop_decel），
+ *   随后保持，组锁定（bLatched）直到规划器 MtTrajReset()
+ * - 流运行中组内任一轴掉出就绪：同样受控停止 + 锁定（计入 dwAborts）
+ * - 流正常结束（最后一批带 bLast）后保持终点；再推送新点即开始新流
+ * - 组处于 RUN/STOP/HOLD 时由组驱动其轴（MtTrajOwns()），MotorCmd_ 对这些轴不生效；
+ *   MtTrajRelease() 把轴还给 MotorCmd_（释放前先把 MotorCmd_.q 设到当前位置，否则轴会走向旧的 q）
+ *
+ * 线程约定：
+ * - MtTrajCreate/MtTrajDelete：setup 阶段（MT_Setup），周期线程未使用本组时
+ * - MtTrajPush/MtTrajStop/MtTrajReset/MtTrajRelease：每组只能有一个生产者线程
+ * - MtTrajCycle：周期线程
+ * - MtTrajGetStatus：任意线程（各字段单独读取，不保证彼此一致）
+ *
+ * 本模块只依赖 EcOs.h（不依赖 EC‑Master 库），可单独链接到 bench。
+ *---------------------------------------------------------------------------*/
+#ifndef __MOTROTECH_TRAJ_H__
+#define __MOTROTECH_TRAJ_H__     1
+
+/*-INCLUDES------------------------------------------------------------------*/
+#include "EcOs.h"
+
+/*-DEFINES-------------------------------------------------------------------*/
+#define MT_TRAJ_MAX_GROUPS          8
+#define MT_TRAJ_DEFAULT_QUEUE       256     /* 航点数，向上取 2 的幂 */
+#define MT_TRAJ_DEFAULT_STOP_DECEL  20.0    /* rad/s^2 */
+
+/* 组状态 */
+#define MT_TRAJ_STATE_IDLE          0       /* 不驱动轴（轴由 MotorCmd_ 控制） */
+#define MT_TRAJ_STATE_RUN           1       /* 插补中 */
+#define MT_TRAJ_STATE_STOP          2       /* 受控停止中（欠载/中止/MtTrajStop） */
+#define MT_TRAJ_STATE_HOLD          3       /* 保持最后设定值 */
+
+/*-TYPEDEFS------------------------------------------------------------------*/
+/* 组配置（busi.yaml ethercat_demo.traj_groups，轴号从 0 开始，与 MT_SetMotorCmd 一致） */
+typedef struct _T_MT_TRAJ_GROUP_CFG
+{
+    EC_T_DWORD      dwAxisCnt;
+    const EC_T_WORD* pwAxis;            /* [dwAxisCnt] */
+    EC_T_DWORD      dwQueueLen;         /* 0：MT_TRAJ_DEFAULT_QUEUE */
+    EC_T_LREAL      fStopDecel;         /* rad/s^2，<=0：MT_TRAJ_DEFAULT_STOP_DECEL */
+} T_MT_TRAJ_GROUP_CFG;
+
+typedef struct _T_MT_TRAJ_STATUS
+{
+    EC_T_DWORD      dwState;            /* MT_TRAJ_STATE_* */
+    EC_T_BOOL       bLatched;           /* 欠载/中止后锁定，MtTrajReset() 之前拒绝推送 */
+    EC_T_LREAL      fTime;              /* 当前流时间（s） */
+    EC_T_LREAL      fBufferedSec;       /* 已推送但尚未插补到的时长（s），规划器据此控制提前量 */
+    EC_T_DWORD      dwQueued;           /* 环里未消费的航点数 */
+    EC_T_DWORD      dwFree;             /* 环里剩余空位 */
+    EC_T_DWORD      dwStreams;          /* 已开始的流 */
+    EC_T_DWORD      dwUnderruns;
+    EC_T_DWORD      dwAborts;
+    EC_T_UINT64     qwPoints;           /* 已消费的航点 */
+} T_MT_TRAJ_STATUS;
+
+/* 一个组：航点环 + 插补状态 */
+typedef struct _T_MT_TRAJ_GROUP
+{
+    /* 配置（MtTrajCreate 之后只读） */
+    EC_T_DWORD      dwAxisCnt;
+    EC_T_WORD*      pwAxis;             /* [dwAxisCnt] 轴号 */
+    EC_T_DWORD      dwQueueLen;         /* 2 的幂 */
+    EC_T_LREAL      fStopDecel;
+
+    /* 航点环：dwWr 只由生产者写，dwRd 只由周期线程写（自由递增，按 dwQueueLen-1 取模） */
+    EC_T_LREAL*     pfPtTime;           /* [dwQueueLen] */
+    EC_T_REAL*      pfPtQ;              /* [dwQueueLen * dwAxisCnt] */
+    EC_T_REAL*      pfPtDq;             /* [dwQueueLen * dwAxisCnt]，MT_TRAJ_PT_DQ 时有效 */
+    EC_T_BYTE*      pbyPtFlags;         /* [dwQueueLen] MT_TRAJ_PT_* */
+    EC_T_DWORD      dwWr;
+    EC_T_DWORD      dwRd;
+
+    /* 生产者私有 */
+    EC_T_LREAL      fPushTime;          /* 本流最后推送的时间，新流从 0 开始 */
+    EC_T_BOOL       bPushClosed;        /* 上一批带 bLast：下一次推送开始新流 */
+
+    /* 生产者 -> 周期线程的请求（计数不等即有请求；先写 dwFlushTo 再 release 计数） */
+    EC_T_DWORD      dwFlushTo;          /* 丢弃到此写位置为止的航点 */
+    EC_T_DWORD      dwStopReq;
+    EC_T_DWORD      dwResetReq;
+    EC_T_DWORD      dwReleaseReq;
+    EC_T_DWORD      dwStopAck;
+    EC_T_DWORD      dwResetAck;
+    EC_T_DWORD      dwReleaseAck;
+
+    /* 插补状态（周期线程私有，状态/计数供 MtTrajGetStatus 读取） */
+    EC_T_DWORD      dwState;
+    EC_T_BOOL       bLatched;
+    EC_T_LREAL      fTime;              /* 组时钟 */
+    EC_T_LREAL      fSegT0;             /* 当前段 [fSegT0, fSegT1] */
+    EC_T_LREAL      fSegT1;
+    EC_T_BOOL       bSegLast;           /* 段终点是流的最后一个点 */
+    EC_T_LREAL*     pfSegQ0;            /* [dwAxisCnt] 段起点/终点位置与切线 */
+    EC_T_LREAL*     pfSegQ1;
+    EC_T_LREAL*     pfSegM0;
+    EC_T_LREAL*     pfSegM1;
+    EC_T_LREAL*     pfStopDecel;        /* [dwAxisCnt] 受控停止时各轴减速度（带符号） */
+    EC_T_LREAL      fStopRemain;        /* 受控停止剩余时间（s） */
+    EC_T_DWORD      dwStreams;
+    EC_T_DWORD      dwUnderruns;
+    EC_T_DWORD      dwAborts;
+    EC_T_UINT64     qwPoints;
+} T_MT_TRAJ_GROUP;
+
+typedef struct _T_MT_TRAJ
+{
+    EC_T_DWORD      dwAxisCnt;
+    EC_T_DWORD      dwGroupCnt;
+    T_MT_TRAJ_GROUP aGroup[MT_TRAJ_MAX_GROUPS];
+    EC_T_INT*       pnAxisGroup;        /* [dwAxisCnt] 轴所属组，-1：不属于任何组 */
+
+    /* MtTrajCycle() 之前由调用方填写 */
+    EC_T_BYTE*      pbyReady;           /* [dwAxisCnt] 轴可被组驱动（MANUAL + OP_ENABLED） */
+    EC_T_LREAL*     pfAnchorQ;          /* [dwAxisCnt] 轴当前设定位置（rad），新流的起点 */
+
+    /* MtTrajCycle() 的输出，MtTrajOwns() 的轴有效 */
+    EC_T_LREAL*     pfQ;                /* [dwAxisCnt] rad */
+    EC_T_LREAL*     pfDq;               /* [dwAxisCnt] rad/s */
+} T_MT_TRAJ;
+
+/*-FUNCTION DECLARATIONS-----------------------------------------------------*/
+/* dwGroupCnt=0 时只分配按轴数组，MtTrajCycle() 为空操作；轴号越界或重复属于多个组返回 EC_E_INVALIDPARM */
+EC_T_DWORD  MtTrajCreate(T_MT_TRAJ* pTraj, EC_T_DWORD dwAxisCnt, const T_MT_TRAJ_GROUP_CFG* pCfg, EC_T_DWORD dwGroupCnt);
+EC_T_VOID   MtTrajDelete(T_MT_TRAJ* pTraj);
+
+/* 生产者：推送一批航点
+ * - pfTime[dwCnt]：流内时间（s），必须 > 0 且严格递增（跨批次也是）
+ * - pfQ[dwCnt * dwAxisCnt]、pfDq（可为 EC_NULL）：按点连续，每点依次为组内各轴
+ * - bLast：本批最后一个点是流的终点（到达后保持，不算欠载）
+ * 环满时只收下能放下的部分（*pdwAccepted），bLast 只在整批收下时生效；
+ * 锁定中返回 EC_E_INVALIDSTATE（先 MtTrajReset）
+ */
+EC_T_DWORD  MtTrajPush(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup, const EC_T_LREAL* pfTime, const EC_T_REAL* pfQ,
+                       const EC_T_REAL* pfDq, EC_T_DWORD dwCnt, EC_T_BOOL bLast, EC_T_DWORD* pdwAccepted);
+/* 生产者：受控停止并丢弃已推送的点；之后推送的点开始新流 */
+EC_T_DWORD  MtTrajStop(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup);
+/* 生产者：同 MtTrajStop，并在周期线程处理后解除锁定 */
+EC_T_DWORD  MtTrajReset(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup);
+/* 生产者：HOLD 的组回到 IDLE，轴交还 MotorCmd_（RUN/STOP 中的组不受影响） */
+EC_T_DWORD  MtTrajRelease(T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup);
+EC_T_DWORD  MtTrajGetStatus(const T_MT_TRAJ* pTraj, EC_T_DWORD dwGroup, T_MT_TRAJ_STATUS* pStatus);
+
+/* 周期：推进所有组 fDt 秒，输出 pfQ[]/pfDq[] */
+EC_T_VOID   MtTrajCycle(T_MT_TRAJ* pTraj, EC_T_LREAL fDt);
+
+/* 轴 dwAxis 本周期由组驱动（MtTrajCycle 之后调用） */
+static EC_INLINESTART EC_T_BOOL MtTrajOwns(const T_MT_TRAJ* pTraj, EC_T_DWORD dwAxis)
+{
+    EC_T_INT nGroup = 0;
+
+    if (dwAxis >= pTraj->dwAxisCnt) {
+        return EC_FALSE;
+    }
+    nGroup = pTraj->pnAxisGroup[dwAxis];
+    return (EC_T_BOOL)((nGroup >= 0) && (pTraj->aGroup[nGroup].dwState != MT_TRAJ_STATE_IDLE));
+} EC_INLINESTOP
+
+#endif /* __MOTROTECH_TRAJ_H__ */
+/*-END OF SOURCE FILE--------------------------------------------------------*/